@@ -0,0 +1,102 @@
+// Cost of latency_histogram::record from many threads, and of the percentile queries.
+//
+//   bench_latency_histogram [records per thread] [max threads]
+//
+// Reported per thread count: nanoseconds per record into one shared histogram and into one
+// histogram per thread, followed by the query cost and the serialized size of the result.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "extl/latency_histogram.hpp"
+
+namespace {
+
+constexpr std::uint64_t highest = 3'600'000'000'000; // one hour in nanoseconds
+
+// A cheap xorshift spread of latencies from ~100 ns to ~1 ms with a long tail.
+std::uint64_t sample(std::uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return 100 + ((state & 0xfffff) >> (state >> 60));
+}
+
+template <class F>
+double run(unsigned threads, std::uint64_t per_thread, F&& body) {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> start{false};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!start.load(std::memory_order_acquire)) {
+            }
+            body(t);
+        });
+    }
+    while (ready.load() != threads) {
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& w : workers)
+        w.join();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return ns / static_cast<double>(per_thread);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::uint64_t per_thread = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+    const unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 64;
+
+    auto shared = extl::latency_histogram::create(highest);
+    if (!shared) {
+        std::fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    std::printf("buckets: %zu\n\nns per record\n%-16s", shared->bucket_count(), "threads");
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        thread_counts.push_back(t);
+        std::printf(" %8u", t);
+    }
+
+    std::printf("\n%-16s", "shared");
+    for (unsigned t : thread_counts) {
+        std::printf(" %8.2f", run(t, per_thread, [&](unsigned id) {
+            std::uint64_t state = 0x9e3779b97f4a7c15ull + id;
+            for (std::uint64_t i = 0; i < per_thread; ++i)
+                shared->record(sample(state));
+        }));
+    }
+    std::printf("\n%-16s", "per thread");
+    for (unsigned t : thread_counts) {
+        std::vector<extl::latency_histogram> locals;
+        for (unsigned i = 0; i < t; ++i)
+            locals.push_back(std::move(*extl::latency_histogram::create(highest)));
+        std::printf(" %8.2f", run(t, per_thread, [&](unsigned id) {
+            std::uint64_t state = 0x9e3779b97f4a7c15ull + id;
+            for (std::uint64_t i = 0; i < per_thread; ++i)
+                locals[id].record(sample(state));
+        }));
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+    const std::uint64_t p50 = shared->value_at_percentile(50.0);
+    const std::uint64_t p99 = shared->value_at_percentile(99.0);
+    const std::uint64_t p999 = shared->value_at_percentile(99.9);
+    const double query_us =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / 3;
+    std::printf("\n\np50 %llu ns, p99 %llu ns, p99.9 %llu ns (%.1f us per query)\nserialized: %zu bytes\n",
+                static_cast<unsigned long long>(p50), static_cast<unsigned long long>(p99),
+                static_cast<unsigned long long>(p999), query_us, shared->serialized_size());
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Throughput of the ExTL locks against the standard ones under contention.
+//
+//   bench_locks [milliseconds per run] [max threads]
+//
+// Every thread repeatedly takes the lock, updates a cache line of
+// protected data, releases it and does a little private work. Reported per lock and thread
+// count: million acquisitions per second, and fairness as the ratio of the least to the most
+// acquisitions any one thread made (1.0 is perfectly fair).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "extl/config.hpp"
+#include "extl/mutex.hpp"
+#include "extl/spinlock.hpp"
+
+namespace {
+
+struct alignas(extl::cache_line_size) protected_data {
+    std::uint64_t words[extl::cache_line_size / sizeof(std::uint64_t)] = {};
+};
+
+struct alignas(extl::cache_line_size) per_thread {
+    std::uint64_t ops = 0;
+};
+
+// Scoped exclusive and shared acquisition, so that mcs_lock fits the same loop.
+template <class Lock, class F>
+void exclusive(Lock& lock, F&& f) {
+    std::lock_guard hold(lock);
+    f();
+}
+
+template <class F>
+void exclusive(extl::mcs_lock& lock, F&& f) {
+    extl::mcs_lock::guard hold(lock);
+    f();
+}
+
+template <class Lock, class F>
+void shared(Lock& lock, F&& f) {
+    std::shared_lock hold(lock);
+    f();
+}
+
+inline void private_work(std::uint64_t& seed) {
+    for (int i = 0; i < 16; ++i)
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+}
+
+struct result {
+    double mops;
+    double fairness;
+};
+
+// Runs `threads` threads for `duration`. Out of every 16 operations, `reads_per_16` are shared
+// acquisitions, the rest exclusive.
+template <class Lock>
+result run(unsigned threads, std::chrono::milliseconds duration, unsigned reads_per_16) {
+    auto lock = std::make_unique<Lock>();
+    auto data = std::make_unique<protected_data>();
+    std::vector<per_thread> counts(threads);
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::uint64_t seed = t + 1;
+            std::uint64_t ops = 0;
+            volatile std::uint64_t sink = 0;
+            ready.fetch_add(1);
+            while (!start.load(std::memory_order_acquire)) {
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                if constexpr (requires { lock->lock_shared(); }) {
+                    if ((ops & 15) < reads_per_16) {
+                        shared(*lock, [&] { sink = data->words[0] + data->words[7]; });
+                        ++ops;
+                        private_work(seed);
+                        continue;
+                    }
+                }
+                exclusive(*lock, [&] {
+                    for (auto& w : data->words)
+                        ++w;
+                });
+                ++ops;
+                private_work(seed);
+            }
+            counts[t].ops = ops;
+            (void)sink;
+        });
+    }
+    while (ready.load() != threads) {
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(duration);
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& w : workers)
+        w.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::uint64_t total = 0;
+    std::uint64_t least = UINT64_MAX;
+    std::uint64_t most = 0;
+    for (const auto& c : counts) {
+        total += c.ops;
+        least = std::min(least, c.ops);
+        most = std::max(most, c.ops);
+    }
+    return {static_cast<double>(total) / seconds / 1e6, most == 0 ? 0.0 : static_cast<double>(least) / most};
+}
+
+template <class Lock>
+void row(const char* name, const std::vector<unsigned>& thread_counts, std::chrono::milliseconds duration,
+         unsigned reads_per_16) {
+    std::printf("%-16s", name);
+    for (unsigned threads : thread_counts) {
+        const result r = run<Lock>(threads, duration, reads_per_16);
+        std::printf(" %8.2f/%4.2f", r.mops, r.fairness);
+    }
+    std::printf("\n");
+}
+
+void header(const char* title, const std::vector<unsigned>& thread_counts) {
+    std::printf("\n%s (Mops/s / fairness)\n%-16s", title, "threads");
+    for (unsigned threads : thread_counts)
+        std::printf(" %13u", threads);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::chrono::milliseconds duration(argc > 1 ? std::atoi(argv[1]) : 200);
+    const unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 64;
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2)
+        thread_counts.push_back(t);
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+    header("exclusive", thread_counts);
+    row<std::mutex>("std::mutex", thread_counts, duration, 0);
+    row<extl::spinlock>("spinlock", thread_counts, duration, 0);
+    row<extl::ticket_lock>("ticket_lock", thread_counts, duration, 0);
+    row<extl::mcs_lock>("mcs_lock", thread_counts, duration, 0);
+    row<extl::adaptive_mutex>("adaptive_mutex", thread_counts, duration, 0);
+
+    header("90% shared", thread_counts);
+    row<std::shared_mutex>("std::shared_mtx", thread_counts, duration, 14);
+    row<extl::rw_lock>("rw_lock", thread_counts, duration, 14);
+    return 0;
+}
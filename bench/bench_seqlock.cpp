@@ -0,0 +1,129 @@
+// Read cost of a shared snapshot while one thread keeps rewriting it.
+//
+//   bench_seqlock [milliseconds per run] [max readers]
+//
+// One writer stores a 64-byte snapshot in a loop; each reader repeatedly copies it out. Reported
+// per scheme and reader count: nanoseconds per read, averaged over all readers.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "extl/mutex.hpp"
+#include "extl/seqlock.hpp"
+
+namespace {
+
+struct snapshot {
+    std::uint64_t fields[8];
+};
+
+inline snapshot make(std::uint64_t s) noexcept {
+    snapshot out;
+    for (auto& f : out.fields)
+        f = s;
+    return out;
+}
+
+// A mutex-protected value with the seqlock interface, for comparison.
+template <class Lock>
+class locked {
+public:
+    void store(const snapshot& s) noexcept {
+        std::lock_guard hold(lock_);
+        value_ = s;
+    }
+    snapshot load() const noexcept {
+        std::lock_guard hold(lock_);
+        return value_;
+    }
+
+private:
+    mutable Lock lock_;
+    snapshot value_{};
+};
+
+struct rw_locked {
+    void store(const snapshot& s) noexcept {
+        std::lock_guard hold(lock);
+        value = s;
+    }
+    snapshot load() const noexcept {
+        lock.lock_shared();
+        snapshot copy = value;
+        lock.unlock_shared();
+        return copy;
+    }
+
+    mutable extl::rw_lock lock;
+    snapshot value{};
+};
+
+template <class Shared>
+double run(unsigned readers, std::chrono::milliseconds duration) {
+    auto shared = std::make_unique<Shared>();
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<std::uint64_t> sink{0};
+
+    std::thread writer([&] {
+        for (std::uint64_t s = 0; !stop.load(std::memory_order_relaxed); ++s)
+            shared->store(make(s));
+    });
+    std::vector<std::thread> threads;
+    for (unsigned r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            std::uint64_t n = 0;
+            std::uint64_t acc = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                acc += shared->load().fields[7];
+                ++n;
+            }
+            reads.fetch_add(n);
+            sink.fetch_add(acc);
+        });
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& t : threads)
+        t.join();
+    writer.join();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return reads.load() == 0 ? 0.0 : ns * readers / static_cast<double>(reads.load());
+}
+
+template <class Shared>
+void row(const char* name, const std::vector<unsigned>& reader_counts, std::chrono::milliseconds duration) {
+    std::printf("%-16s", name);
+    for (unsigned readers : reader_counts)
+        std::printf(" %9.1f", run<Shared>(readers, duration));
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::chrono::milliseconds duration(argc > 1 ? std::atoi(argv[1]) : 200);
+    const unsigned max_readers = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 32;
+
+    std::vector<unsigned> reader_counts;
+    for (unsigned r = 1; r <= max_readers; r *= 2)
+        reader_counts.push_back(r);
+    std::printf("hardware threads: %u\n\nns per read\n%-16s", std::thread::hardware_concurrency(), "readers");
+    for (unsigned readers : reader_counts)
+        std::printf(" %9u", readers);
+    std::printf("\n");
+
+    row<locked<std::mutex>>("std::mutex", reader_counts, duration);
+    row<rw_locked>("rw_lock", reader_counts, duration);
+    row<extl::seqlock<snapshot>>("seqlock", reader_counts, duration);
+    row<extl::seqlock_ring<snapshot>>("seqlock_ring", reader_counts, duration);
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Cost of counting from many threads: one shared std::atomic against sharded_counter and stats.
+//
+//   bench_sharded_counter [increments per thread] [max threads]
+//
+// Reported per scheme and thread count: nanoseconds per increment as seen by each thread.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "extl/sharded_counter.hpp"
+
+namespace {
+
+template <class F>
+double run(unsigned threads, std::uint64_t per_thread, F&& increment) {
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> start{false};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            ready.fetch_add(1);
+            while (!start.load(std::memory_order_acquire)) {
+            }
+            for (std::uint64_t i = 0; i < per_thread; ++i)
+                increment(i);
+        });
+    }
+    while (ready.load() != threads) {
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& w : workers)
+        w.join();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    return ns / static_cast<double>(per_thread);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::uint64_t per_thread = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 64;
+
+    auto counter = extl::sharded_counter::create();
+    auto samples = extl::stats::create();
+    if (!counter || !samples) {
+        std::fprintf(stderr, "allocation failed\n");
+        return 1;
+    }
+    std::atomic<std::uint64_t> shared{0};
+
+    std::printf("hardware threads: %u, shards: %zu\n\nns per increment\n%-16s", std::thread::hardware_concurrency(),
+                counter->shard_count(), "threads");
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        thread_counts.push_back(t);
+        std::printf(" %8u", t);
+    }
+
+    std::printf("\n%-16s", "std::atomic");
+    for (unsigned t : thread_counts)
+        std::printf(" %8.2f", run(t, per_thread, [&](std::uint64_t) { shared.fetch_add(1, std::memory_order_relaxed); }));
+    std::printf("\n%-16s", "sharded_counter");
+    for (unsigned t : thread_counts)
+        std::printf(" %8.2f", run(t, per_thread, [&](std::uint64_t) { counter->add(); }));
+    std::printf("\n%-16s", "stats::record");
+    for (unsigned t : thread_counts)
+        std::printf(" %8.2f", run(t, per_thread, [&](std::uint64_t i) { samples->record(i & 4095); }));
+    std::printf("\n");
+
+    return shared.load() + counter->value() == 0 ? 1 : 0;
+}
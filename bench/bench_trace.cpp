@@ -0,0 +1,59 @@
+// Cost of EXTL_TRACE_SCOPE on a hot path, with tracing enabled and switched off at run time.
+//
+//   bench_trace [scopes] [output.json]
+//
+// Reported: nanoseconds per scope (one begin and one end event). With an output path, the trace
+// left in the ring is written there for loading into ui.perfetto.dev.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "extl/trace.hpp"
+
+namespace {
+
+EXTL_NO_INLINE void traced(std::uint64_t& sink, std::uint64_t i) {
+    EXTL_TRACE_SCOPE("traced");
+    sink += i;
+}
+
+EXTL_NO_INLINE void untraced(std::uint64_t& sink, std::uint64_t i) { sink += i; }
+
+template <class F>
+double per_call(std::uint64_t calls, F&& f) {
+    std::uint64_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < calls; ++i)
+        f(sink, i);
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    std::fprintf(stderr, "%s", sink == 1 ? " " : "");
+    return ns / static_cast<double>(calls);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::uint64_t calls = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000'000;
+
+    const double baseline = per_call(calls, untraced);
+    extl::trace::set_enabled(true);
+    const double enabled = per_call(calls, traced);
+    extl::trace::set_enabled(false);
+    const double disabled = per_call(calls, traced);
+    extl::trace::set_enabled(true);
+
+    std::printf("ns per call\n%-12s %8.2f\n%-12s %8.2f\n%-12s %8.2f\n", "untraced", baseline, "enabled", enabled,
+                "disabled", disabled);
+
+    if (argc > 2) {
+        std::FILE* out = std::fopen(argv[2], "w");
+        if (out == nullptr || !extl::trace::write_chrome_json(out)) {
+            std::fprintf(stderr, "cannot write %s\n", argv[2]);
+            return 1;
+        }
+        std::fclose(out);
+    }
+    return 0;
+}
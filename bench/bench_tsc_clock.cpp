@@ -0,0 +1,47 @@
+// Cost of reading the time: tsc_clock against steady_clock and clock_gettime, plus the raw and
+// serializing counter reads.
+//
+//   bench_tsc_clock [reads]
+//
+// Reported: nanoseconds per read, and the calibrated counter rate.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "extl/tsc_clock.hpp"
+
+namespace {
+
+template <class F>
+double per_read(std::uint64_t reads, F&& read) {
+    std::uint64_t sink = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < reads; ++i)
+        sink += static_cast<std::uint64_t>(read());
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+    std::fprintf(stderr, "%s", sink == 1 ? " " : "");
+    return ns / static_cast<double>(reads);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::uint64_t reads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20'000'000;
+
+    extl::tsc_clock::now(); // calibrates
+    std::printf("invariant TSC: %s, counter in use: %s, %.3f MHz\n\nns per read\n",
+                extl::tsc_clock::invariant_tsc() ? "yes" : "no", extl::tsc_clock::uses_counter() ? "yes" : "no",
+                extl::tsc_clock::ticks_per_second() / 1e6);
+
+    auto row = [](const char* name, double ns) { std::printf("%-24s %8.2f\n", name, ns); };
+    row("steady_clock::now",
+        per_read(reads, [] { return std::chrono::steady_clock::now().time_since_epoch().count(); }));
+    row("clock_gettime", per_read(reads, [] { return extl::detail::tsc::monotonic_ns(); }));
+    row("tsc_clock::now", per_read(reads, [] { return extl::tsc_clock::now().time_since_epoch().count(); }));
+    row("tsc_clock::ticks", per_read(reads, [] { return extl::tsc_clock::ticks(); }));
+    row("tsc_clock::ticks_begin", per_read(reads, [] { return extl::tsc_clock::ticks_begin(); }));
+    row("tsc_clock::ticks_end", per_read(reads, [] { return extl::tsc_clock::ticks_end(); }));
+    return 0;
+}
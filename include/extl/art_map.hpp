@@ -0,0 +1,1029 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+namespace detail::art {
+
+// ---------------------------------------------------------------------------------------
+// Nodes
+// Inner nodes come in four sizes and grow or shrink as children come and go:
+//   node4, node16  sorted key bytes next to child pointers (node16 is searched with SSE2)
+//   node48         a 256-entry byte index into 48 child pointers
+//   node256        one child pointer per byte value
+// Every inner node carries a compressed path (the bytes shared by all keys below it). Only the
+// first max_prefix bytes are stored; lookups skip longer prefixes optimistically and verify the
+// whole key at the leaf, which always holds the full key. A key that ends exactly at an inner
+// node, because it is a prefix of other keys, is that node's terminal leaf.
+// ---------------------------------------------------------------------------------------
+
+inline constexpr std::uint32_t max_prefix = 8;
+
+enum class node_type : std::uint8_t { node4, node16, node48, node256 };
+
+struct bytes {
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+};
+
+// Key bytes follow the header; the value follows the key at its own alignment.
+struct leaf {
+    std::size_t key_size;
+
+    unsigned char* key() noexcept { return reinterpret_cast<unsigned char*>(this + 1); }
+    bytes key_bytes() const noexcept { return {reinterpret_cast<const unsigned char*>(this + 1), key_size}; }
+};
+
+struct inner;
+
+// Child pointer tagged in its low bit: set for leaves.
+class ref {
+public:
+    ref() noexcept = default;
+    static ref of(leaf* l) noexcept { return ref(reinterpret_cast<std::uintptr_t>(l) | 1); }
+    static ref of(inner* n) noexcept { return ref(reinterpret_cast<std::uintptr_t>(n)); }
+
+    explicit operator bool() const noexcept { return bits_ != 0; }
+    bool is_leaf() const noexcept { return bits_ & 1; }
+    leaf* as_leaf() const noexcept { return reinterpret_cast<leaf*>(bits_ & ~std::uintptr_t{1}); }
+    inner* as_inner() const noexcept { return reinterpret_cast<inner*>(bits_); }
+
+private:
+    explicit ref(std::uintptr_t bits) noexcept : bits_(bits) {}
+
+    std::uintptr_t bits_ = 0;
+};
+
+struct inner {
+    node_type type;
+    std::uint16_t count = 0;
+    std::uint32_t prefix_len = 0;
+    unsigned char prefix[max_prefix] = {};
+    ref terminal;
+};
+
+struct node4 : inner {
+    unsigned char keys[4];
+    ref children[4];
+};
+struct node16 : inner {
+    unsigned char keys[16];
+    ref children[16];
+};
+struct node48 : inner {
+    unsigned char index[256]; // Child slot + 1, or 0.
+    ref children[48];
+};
+struct node256 : inner {
+    ref children[256];
+};
+
+template <class N>
+inline N* make_node() noexcept {
+    N* n = allocate<N>(1);
+    if (n == nullptr)
+        return nullptr;
+    std::construct_at(n);
+    if constexpr (std::is_same_v<N, node4>)
+        n->type = node_type::node4;
+    else if constexpr (std::is_same_v<N, node16>)
+        n->type = node_type::node16;
+    else if constexpr (std::is_same_v<N, node48>)
+        n->type = node_type::node48;
+    else
+        n->type = node_type::node256;
+    return n;
+}
+
+inline void free_node(inner* n) noexcept {
+    switch (n->type) {
+    case node_type::node4:
+        deallocate(static_cast<node4*>(n));
+        break;
+    case node_type::node16:
+        deallocate(static_cast<node16*>(n));
+        break;
+    case node_type::node48:
+        deallocate(static_cast<node48*>(n));
+        break;
+    case node_type::node256:
+        deallocate(static_cast<node256*>(n));
+        break;
+    }
+}
+
+inline void copy_header(inner* dst, const inner* src) noexcept {
+    dst->count = src->count;
+    dst->prefix_len = src->prefix_len;
+    std::memcpy(dst->prefix, src->prefix, max_prefix);
+    dst->terminal = src->terminal;
+}
+
+// Number of keys[0, count) below b; lower_bound16 needs all 16 bytes of keys readable.
+inline unsigned lower_bound(const unsigned char* keys, unsigned count, unsigned char b) noexcept {
+    unsigned i = 0;
+    while (i < count && keys[i] < b)
+        ++i;
+    return i;
+}
+
+inline unsigned lower_bound16(const unsigned char* keys, unsigned count, unsigned char b) noexcept {
+#if EXTL_HAS_SSE2
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i k = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), bias);
+    const __m128i x = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(b)), bias);
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(k, x))) & ((1u << count) - 1);
+    return static_cast<unsigned>(std::popcount(mask));
+#else
+    return lower_bound(keys, count, b);
+#endif
+}
+
+inline ref* find_child(inner* n, unsigned char b) noexcept {
+    switch (n->type) {
+    case node_type::node4: {
+        auto* x = static_cast<node4*>(n);
+        for (unsigned i = 0; i < x->count; ++i) {
+            if (x->keys[i] == b)
+                return &x->children[i];
+        }
+        return nullptr;
+    }
+    case node_type::node16: {
+        auto* x = static_cast<node16*>(n);
+#if EXTL_HAS_SSE2
+        const __m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(x->keys)));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq)) & ((1u << x->count) - 1);
+        return mask != 0 ? &x->children[std::countr_zero(mask)] : nullptr;
+#else
+        for (unsigned i = 0; i < x->count; ++i) {
+            if (x->keys[i] == b)
+                return &x->children[i];
+        }
+        return nullptr;
+#endif
+    }
+    case node_type::node48: {
+        auto* x = static_cast<node48*>(n);
+        return x->index[b] != 0 ? &x->children[x->index[b] - 1] : nullptr;
+    }
+    case node_type::node256: {
+        auto* x = static_cast<node256*>(n);
+        return x->children[b] ? &x->children[b] : nullptr;
+    }
+    }
+    return nullptr;
+}
+
+// Calls f(byte, child) for every child in byte order until f returns false.
+template <class F>
+inline bool for_each_child(const inner* n, F&& f) {
+    switch (n->type) {
+    case node_type::node4:
+    case node_type::node16: {
+        const unsigned char* keys = n->type == node_type::node4 ? static_cast<const node4*>(n)->keys
+                                                                : static_cast<const node16*>(n)->keys;
+        const ref* children = n->type == node_type::node4 ? static_cast<const node4*>(n)->children
+                                                          : static_cast<const node16*>(n)->children;
+        for (unsigned i = 0; i < n->count; ++i) {
+            if (!f(keys[i], children[i]))
+                return false;
+        }
+        return true;
+    }
+    case node_type::node48: {
+        auto* x = static_cast<const node48*>(n);
+        for (unsigned b = 0; b < 256; ++b) {
+            if (x->index[b] != 0 && !f(static_cast<unsigned char>(b), x->children[x->index[b] - 1]))
+                return false;
+        }
+        return true;
+    }
+    case node_type::node256: {
+        auto* x = static_cast<const node256*>(n);
+        for (unsigned b = 0; b < 256; ++b) {
+            if (x->children[b] && !f(static_cast<unsigned char>(b), x->children[b]))
+                return false;
+        }
+        return true;
+    }
+    }
+    return true;
+}
+
+inline ref first_child(const inner* n) noexcept {
+    ref first;
+    for_each_child(n, [&](unsigned char, ref child) {
+        first = child;
+        return false;
+    });
+    return first;
+}
+
+// Leaf with the smallest key below r; its key spells out every compressed prefix on the way.
+inline const leaf* min_leaf(ref r) noexcept {
+    while (!r.is_leaf()) {
+        const inner* n = r.as_inner();
+        if (n->terminal)
+            return n->terminal.as_leaf();
+        r = first_child(n);
+    }
+    return r.as_leaf();
+}
+
+template <class N>
+inline void insert_sorted(N* n, unsigned char b, ref child) noexcept {
+    unsigned i;
+    if constexpr (std::is_same_v<N, node16>)
+        i = lower_bound16(n->keys, n->count, b);
+    else
+        i = lower_bound(n->keys, n->count, b);
+    std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+    std::memmove(static_cast<void*>(n->children + i + 1), n->children + i, (n->count - i) * sizeof(ref));
+    n->keys[i] = b;
+    n->children[i] = child;
+    ++n->count;
+}
+
+template <class N>
+inline void erase_sorted(N* n, unsigned i) noexcept {
+    std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+    std::memmove(static_cast<void*>(n->children + i), n->children + i + 1, (n->count - i - 1) * sizeof(ref));
+    --n->count;
+}
+
+// Replaces the node in slot with the next larger kind. Returns false if allocation failed.
+inline bool grow(ref& slot) noexcept {
+    inner* n = slot.as_inner();
+    switch (n->type) {
+    case node_type::node4: {
+        auto* old = static_cast<node4*>(n);
+        auto* x = make_node<node16>();
+        if (x == nullptr)
+            return false;
+        copy_header(x, old);
+        std::memcpy(x->keys, old->keys, old->count);
+        std::memcpy(static_cast<void*>(x->children), old->children, old->count * sizeof(ref));
+        slot = ref::of(x);
+        break;
+    }
+    case node_type::node16: {
+        auto* old = static_cast<node16*>(n);
+        auto* x = make_node<node48>();
+        if (x == nullptr)
+            return false;
+        copy_header(x, old);
+        for (unsigned i = 0; i < old->count; ++i) {
+            x->index[old->keys[i]] = static_cast<unsigned char>(i + 1);
+            x->children[i] = old->children[i];
+        }
+        slot = ref::of(x);
+        break;
+    }
+    case node_type::node48: {
+        auto* old = static_cast<node48*>(n);
+        auto* x = make_node<node256>();
+        if (x == nullptr)
+            return false;
+        copy_header(x, old);
+        for (unsigned b = 0; b < 256; ++b) {
+            if (old->index[b] != 0)
+                x->children[b] = old->children[old->index[b] - 1];
+        }
+        slot = ref::of(x);
+        break;
+    }
+    case node_type::node256:
+        return true;
+    }
+    free_node(n);
+    return true;
+}
+
+// Adds child under the absent byte b. Returns false if the node had to grow and could not; the
+// tree is unchanged then.
+inline bool add_child(ref& slot, unsigned char b, ref child) noexcept {
+    inner* n = slot.as_inner();
+    switch (n->type) {
+    case node_type::node4:
+        if (n->count == 4)
+            return grow(slot) && add_child(slot, b, child);
+        insert_sorted(static_cast<node4*>(n), b, child);
+        return true;
+    case node_type::node16:
+        if (n->count == 16)
+            return grow(slot) && add_child(slot, b, child);
+        insert_sorted(static_cast<node16*>(n), b, child);
+        return true;
+    case node_type::node48: {
+        if (n->count == 48)
+            return grow(slot) && add_child(slot, b, child);
+        auto* x = static_cast<node48*>(n);
+        unsigned i = 0;
+        while (x->children[i])
+            ++i;
+        x->children[i] = child;
+        x->index[b] = static_cast<unsigned char>(i + 1);
+        ++x->count;
+        return true;
+    }
+    case node_type::node256:
+        static_cast<node256*>(n)->children[b] = child;
+        ++n->count;
+        return true;
+    }
+    return false;
+}
+
+// Replaces the node in slot with the next smaller kind, if that allocation succeeds.
+inline void shrink(ref& slot) noexcept {
+    inner* n = slot.as_inner();
+    switch (n->type) {
+    case node_type::node16: {
+        auto* old = static_cast<node16*>(n);
+        auto* x = make_node<node4>();
+        if (x == nullptr)
+            return;
+        copy_header(x, old);
+        std::memcpy(x->keys, old->keys, old->count);
+        std::memcpy(static_cast<void*>(x->children), old->children, old->count * sizeof(ref));
+        slot = ref::of(x);
+        break;
+    }
+    case node_type::node48: {
+        auto* old = static_cast<node48*>(n);
+        auto* x = make_node<node16>();
+        if (x == nullptr)
+            return;
+        copy_header(x, old);
+        unsigned j = 0;
+        for (unsigned b = 0; b < 256; ++b) {
+            if (old->index[b] != 0) {
+                x->keys[j] = static_cast<unsigned char>(b);
+                x->children[j++] = old->children[old->index[b] - 1];
+            }
+        }
+        slot = ref::of(x);
+        break;
+    }
+    case node_type::node256: {
+        auto* old = static_cast<node256*>(n);
+        auto* x = make_node<node48>();
+        if (x == nullptr)
+            return;
+        copy_header(x, old);
+        unsigned j = 0;
+        for (unsigned b = 0; b < 256; ++b) {
+            if (old->children[b]) {
+                x->index[b] = static_cast<unsigned char>(j + 1);
+                x->children[j++] = old->children[b];
+            }
+        }
+        slot = ref::of(x);
+        break;
+    }
+    case node_type::node4:
+        return;
+    }
+    free_node(n);
+}
+
+// Removes the child under b and shrinks the node once it falls well below the smaller kind's
+// capacity (the gap avoids flapping between kinds).
+inline void remove_child(ref& slot, unsigned char b) noexcept {
+    inner* n = slot.as_inner();
+    switch (n->type) {
+    case node_type::node4: {
+        auto* x = static_cast<node4*>(n);
+        unsigned i = 0;
+        while (x->keys[i] != b)
+            ++i;
+        erase_sorted(x, i);
+        return;
+    }
+    case node_type::node16: {
+        auto* x = static_cast<node16*>(n);
+        erase_sorted(x, lower_bound16(x->keys, x->count, b));
+        if (x->count == 3)
+            shrink(slot);
+        return;
+    }
+    case node_type::node48: {
+        auto* x = static_cast<node48*>(n);
+        x->children[x->index[b] - 1] = ref();
+        x->index[b] = 0;
+        if (--x->count == 12)
+            shrink(slot);
+        return;
+    }
+    case node_type::node256: {
+        auto* x = static_cast<node256*>(n);
+        x->children[b] = ref();
+        if (--x->count == 37)
+            shrink(slot);
+        return;
+    }
+    }
+}
+
+// Removes a node4 left with a single entry: a lone terminal or leaf child takes its place, and a
+// lone inner child absorbs the node's prefix and edge byte.
+inline void collapse(ref& slot) noexcept {
+    inner* n = slot.as_inner();
+    if (n->type != node_type::node4)
+        return;
+    auto* x = static_cast<node4*>(n);
+    if (x->count == 0) {
+        slot = x->terminal;
+    } else if (x->count == 1 && !x->terminal) {
+        const ref child = x->children[0];
+        if (!child.is_leaf()) {
+            inner* c = child.as_inner();
+            unsigned char merged[max_prefix];
+            std::uint32_t len = std::min(x->prefix_len, max_prefix);
+            std::memcpy(merged, x->prefix, len);
+            if (len < max_prefix)
+                merged[len++] = x->keys[0];
+            const std::uint32_t rest = std::min(c->prefix_len, max_prefix - len);
+            std::memcpy(merged + len, c->prefix, rest);
+            std::memcpy(c->prefix, merged, max_prefix);
+            c->prefix_len += x->prefix_len + 1;
+        }
+        slot = child;
+    } else {
+        return;
+    }
+    free_node(x);
+}
+
+inline void set_prefix(inner* n, const unsigned char* p, std::size_t len) noexcept {
+    n->prefix_len = static_cast<std::uint32_t>(len);
+    std::memcpy(n->prefix, p, std::min<std::size_t>(len, max_prefix));
+}
+
+// Index of the first byte where n's compressed path differs from k at depth (or where k ends);
+// n->prefix_len if the whole path matches.
+inline std::size_t prefix_mismatch(const inner* n, bytes k, std::size_t depth) noexcept {
+    const std::size_t stored = std::min(n->prefix_len, max_prefix);
+    const std::size_t available = k.size - depth;
+    std::size_t i = 0;
+    for (; i < stored; ++i) {
+        if (i == available || n->prefix[i] != k.data[depth + i])
+            return i;
+    }
+    if (n->prefix_len > max_prefix) {
+        const bytes m = min_leaf(ref::of(const_cast<inner*>(n)))->key_bytes();
+        for (; i < n->prefix_len; ++i) {
+            if (i == available || m.data[depth + i] != k.data[depth + i])
+                return i;
+        }
+    }
+    return i;
+}
+
+inline bool equal(bytes a, bytes b) noexcept {
+    return a.size == b.size && (a.size == 0 || std::memcmp(a.data, b.data, a.size) == 0);
+}
+
+inline int compare(bytes a, bytes b) noexcept {
+    const std::size_t n = std::min(a.size, b.size);
+    const int c = n == 0 ? 0 : std::memcmp(a.data, b.data, n);
+    if (c != 0)
+        return c;
+    return a.size < b.size ? -1 : (a.size > b.size ? 1 : 0);
+}
+
+// ---------------------------------------------------------------------------------------
+// Key encoding
+// Keys are compared as byte strings. Integers are stored big-endian with the sign bit flipped,
+// so byte order equals numeric order.
+// ---------------------------------------------------------------------------------------
+template <class Key>
+struct key_traits;
+
+template <>
+struct key_traits<std::string_view> {
+    struct encoded {
+        bytes b;
+        bytes view() const noexcept { return b; }
+    };
+    static encoded encode(std::string_view k) noexcept {
+        return {{reinterpret_cast<const unsigned char*>(k.data()), k.size()}};
+    }
+    static std::string_view decode(bytes b) noexcept { return {reinterpret_cast<const char*>(b.data), b.size}; }
+};
+
+template <std::integral I>
+struct key_traits<I> {
+    using unsigned_type = std::make_unsigned_t<I>;
+    static constexpr unsigned_type sign_flip =
+        std::is_signed_v<I> ? unsigned_type(unsigned_type{1} << (sizeof(I) * 8 - 1)) : unsigned_type{0};
+
+    struct encoded {
+        unsigned char data[sizeof(I)];
+        bytes view() const noexcept { return {data, sizeof(I)}; }
+    };
+    static encoded encode(I k) noexcept {
+        encoded e;
+        const auto u = static_cast<unsigned_type>(static_cast<unsigned_type>(k) ^ sign_flip);
+        for (std::size_t i = 0; i < sizeof(I); ++i)
+            e.data[i] = static_cast<unsigned char>(u >> (8 * (sizeof(I) - 1 - i)));
+        return e;
+    }
+    static I decode(bytes b) noexcept {
+        unsigned_type u = 0;
+        for (std::size_t i = 0; i < sizeof(I); ++i)
+            u = static_cast<unsigned_type>((u << 8) | b.data[i]);
+        return static_cast<I>(static_cast<unsigned_type>(u ^ sign_flip));
+    }
+};
+
+} // namespace detail::art
+
+// ---------------------------------------------------------------------------------------
+// art_map
+// Ordered map over an adaptive radix tree (Leis et al., "The Adaptive Radix Tree"). Key is
+// std::string_view, for arbitrary byte strings compared lexicographically, or an integer type.
+// The map copies keys into its leaves, so string_view keys need not outlive the insertion.
+//
+// Lookups cost one node per key byte not covered by path compression, independent of the number
+// of keys, and never compare whole keys except once at the leaf. Inner nodes adapt their fan-out
+// from 4 to 256 children, which keeps sparse levels small. Traversal is in key order: for_each,
+// scan_range and scan_prefix call f(key, value), and stop early if f returns false.
+// ---------------------------------------------------------------------------------------
+template <class Key, class T>
+class art_map {
+    using traits = detail::art::key_traits<Key>;
+    using bytes = detail::art::bytes;
+    using leaf = detail::art::leaf;
+    using ref = detail::art::ref;
+    using inner = detail::art::inner;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = std::size_t;
+
+    art_map() noexcept = default;
+
+    art_map(const art_map&) = delete;
+    art_map& operator=(const art_map&) = delete;
+
+    art_map(art_map&& other) noexcept
+        : root_(std::exchange(other.root_, ref())), size_(std::exchange(other.size_, 0)) {}
+
+    art_map& operator=(art_map&& other) noexcept {
+        if (this != &other) {
+            clear();
+            root_ = std::exchange(other.root_, ref());
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~art_map() { clear(); }
+
+    static expected<art_map, errc> copy(const art_map& other) noexcept
+        requires std::is_copy_constructible_v<T>
+    {
+        art_map map;
+        bool ok = true;
+        other.for_each([&](const Key& key, const T& value) {
+            ok = map.try_emplace(key, value).has_value();
+            return ok;
+        });
+        if (!ok)
+            return unexpected(errc::out_of_memory);
+        return map;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    T* find(const Key& key) noexcept {
+        const auto encoded = traits::encode(key);
+        const bytes k = encoded.view();
+        ref r = root_;
+        std::size_t depth = 0;
+        while (r) {
+            if (r.is_leaf())
+                return detail::art::equal(r.as_leaf()->key_bytes(), k) ? &value_of(r.as_leaf()) : nullptr;
+            inner* n = r.as_inner();
+            if (n->prefix_len != 0) {
+                if (k.size - depth < n->prefix_len)
+                    return nullptr;
+                const std::size_t stored = std::min(n->prefix_len, detail::art::max_prefix);
+                if (std::memcmp(n->prefix, k.data + depth, stored) != 0)
+                    return nullptr;
+                depth += n->prefix_len;
+            }
+            if (depth == k.size) {
+                r = n->terminal;
+                continue;
+            }
+            const ref* child = detail::art::find_child(n, k.data[depth]);
+            if (child == nullptr)
+                return nullptr;
+            r = *child;
+            ++depth;
+        }
+        return nullptr;
+    }
+    const T* find(const Key& key) const noexcept { return const_cast<art_map*>(this)->find(key); }
+    bool contains(const Key& key) const noexcept { return find(key) != nullptr; }
+
+    // Inserts key with a value constructed from args unless the key is present. Returns the
+    // value and whether it was inserted.
+    template <class... Args>
+    expected<std::pair<T*, bool>, errc> try_emplace(const Key& key, Args&&... args) noexcept {
+        using namespace detail::art;
+        const auto encoded = traits::encode(key);
+        const bytes k = encoded.view();
+        ref* slot = &root_;
+        std::size_t depth = 0;
+        for (;;) {
+            if (!*slot) {
+                leaf* l = make_leaf(k, std::forward<Args>(args)...);
+                if (l == nullptr)
+                    return unexpected(errc::out_of_memory);
+                *slot = ref::of(l);
+                return inserted(l);
+            }
+
+            if (slot->is_leaf()) {
+                leaf* existing = slot->as_leaf();
+                const bytes e = existing->key_bytes();
+                if (equal(e, k))
+                    return std::pair{&value_of(existing), false};
+                // Both keys go below a new node4 holding their common bytes as its prefix.
+                std::size_t common = depth;
+                while (common < k.size && common < e.size && k.data[common] == e.data[common])
+                    ++common;
+                node4* n = make_node<node4>();
+                if (n == nullptr)
+                    return unexpected(errc::out_of_memory);
+                leaf* l = make_leaf(k, std::forward<Args>(args)...);
+                if (l == nullptr) {
+                    free_node(n);
+                    return unexpected(errc::out_of_memory);
+                }
+                set_prefix(n, k.data + depth, common - depth);
+                ref node = ref::of(n);
+                attach(node, ref::of(existing), e, common);
+                attach(node, ref::of(l), k, common);
+                *slot = node;
+                return inserted(l);
+            }
+
+            inner* n = slot->as_inner();
+            if (n->prefix_len != 0) {
+                const std::size_t p = prefix_mismatch(n, k, depth);
+                if (p < n->prefix_len) {
+                    // Split the compressed path at p: a new node4 keeps the shared part, and the old
+                    // node hangs below it by the first differing byte.
+                    node4* parent = make_node<node4>();
+                    if (parent == nullptr)
+                        return unexpected(errc::out_of_memory);
+                    leaf* l = make_leaf(k, std::forward<Args>(args)...);
+                    if (l == nullptr) {
+                        free_node(parent);
+                        return unexpected(errc::out_of_memory);
+                    }
+                    set_prefix(parent, k.data + depth, p);
+                    unsigned char edge;
+                    if (n->prefix_len <= max_prefix) {
+                        edge = n->prefix[p];
+                        std::memmove(n->prefix, n->prefix + p + 1, n->prefix_len - p - 1);
+                    } else {
+                        const bytes m = min_leaf(*slot)->key_bytes();
+                        edge = m.data[depth + p];
+                        const std::size_t rest = n->prefix_len - p - 1;
+                        std::memcpy(n->prefix, m.data + depth + p + 1, std::min<std::size_t>(rest, max_prefix));
+                    }
+                    n->prefix_len -= static_cast<std::uint32_t>(p + 1);
+                    ref node = ref::of(parent);
+                    add_child(node, edge, *slot);
+                    attach(node, ref::of(l), k, depth + p);
+                    *slot = node;
+                    return inserted(l);
+                }
+                depth += n->prefix_len;
+            }
+
+            if (depth == k.size) {
+                if (n->terminal)
+                    return std::pair{&value_of(n->terminal.as_leaf()), false};
+                leaf* l = make_leaf(k, std::forward<Args>(args)...);
+                if (l == nullptr)
+                    return unexpected(errc::out_of_memory);
+                n->terminal = ref::of(l);
+                return inserted(l);
+            }
+
+            ref* child = find_child(n, k.data[depth]);
+            if (child == nullptr) {
+                leaf* l = make_leaf(k, std::forward<Args>(args)...);
+                if (l == nullptr)
+                    return unexpected(errc::out_of_memory);
+                if (!add_child(*slot, k.data[depth], ref::of(l))) {
+                    destroy_leaf(l);
+                    return unexpected(errc::out_of_memory);
+                }
+                return inserted(l);
+            }
+            slot = child;
+            ++depth;
+        }
+    }
+
+    // Inserts key or assigns to its value. Returns whether the key was inserted.
+    template <class V>
+    expected<bool, errc> try_insert_or_assign(const Key& key, V&& value) noexcept {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result)
+            return unexpected(result.error());
+        if (!result->second)
+            *result->first = std::forward<V>(value);
+        return result->second;
+    }
+
+    // Removes key; returns whether it was present.
+    bool erase(const Key& key) noexcept {
+        using namespace detail::art;
+        const auto encoded = traits::encode(key);
+        const bytes k = encoded.view();
+        if (!root_)
+            return false;
+        if (root_.is_leaf()) {
+            if (!equal(root_.as_leaf()->key_bytes(), k))
+                return false;
+            destroy_leaf(root_.as_leaf());
+            root_ = ref();
+            --size_;
+            return true;
+        }
+        ref* slot = &root_;
+        std::size_t depth = 0;
+        for (;;) {
+            inner* n = slot->as_inner();
+            if (n->prefix_len != 0) {
+                if (prefix_mismatch(n, k, depth) != n->prefix_len)
+                    return false;
+                depth += n->prefix_len;
+            }
+            if (depth == k.size) {
+                if (!n->terminal || !equal(n->terminal.as_leaf()->key_bytes(), k))
+                    return false;
+                destroy_leaf(n->terminal.as_leaf());
+                n->terminal = ref();
+                collapse(*slot);
+                --size_;
+                return true;
+            }
+            ref* child = find_child(n, k.data[depth]);
+            if (child == nullptr)
+                return false;
+            if (child->is_leaf()) {
+                if (!equal(child->as_leaf()->key_bytes(), k))
+                    return false;
+                destroy_leaf(child->as_leaf());
+                remove_child(*slot, k.data[depth]);
+                collapse(*slot);
+                --size_;
+                return true;
+            }
+            slot = child;
+            ++depth;
+        }
+    }
+
+    void clear() noexcept {
+        if (root_)
+            destroy(root_);
+        root_ = ref();
+        size_ = 0;
+    }
+
+    // Visits every entry in key order.
+    template <class F>
+    void for_each(F&& f) {
+        if (root_)
+            visit_all(root_, f);
+    }
+    template <class F>
+    void for_each(F&& f) const {
+        const_cast<art_map*>(this)->for_each(as_const_visitor(f));
+    }
+
+    // Visits the entries with lo <= key < hi in key order.
+    template <class F>
+    void scan_range(const Key& lo, const Key& hi, F&& f) {
+        const auto lo_encoded = traits::encode(lo);
+        const auto hi_encoded = traits::encode(hi);
+        if (root_)
+            visit_range(root_, 0, lo_encoded.view(), true, hi_encoded.view(), true, f);
+    }
+    template <class F>
+    void scan_range(const Key& lo, const Key& hi, F&& f) const {
+        const_cast<art_map*>(this)->scan_range(lo, hi, as_const_visitor(f));
+    }
+
+    // Visits the entries whose key starts with prefix in key order.
+    template <class F>
+    void scan_prefix(std::string_view prefix, F&& f)
+        requires std::same_as<Key, std::string_view>
+    {
+        using namespace detail::art;
+        const bytes p = traits::encode(prefix).view();
+        ref r = root_;
+        std::size_t depth = 0;
+        while (r) {
+            const bytes path = detail::art::min_leaf(r)->key_bytes();
+            const std::size_t end = r.is_leaf() ? path.size : depth + r.as_inner()->prefix_len;
+            // Keys below r agree with path on [0, end); compare the part the prefix constrains.
+            const std::size_t checked = std::min(end, p.size);
+            if (checked > depth && std::memcmp(path.data + depth, p.data + depth, checked - depth) != 0)
+                return;
+            if (end >= p.size) {
+                visit_all(r, f);
+                return;
+            }
+            if (r.is_leaf())
+                return;
+            const ref* child = find_child(r.as_inner(), p.data[end]);
+            if (child == nullptr)
+                return;
+            r = *child;
+            depth = end + 1;
+        }
+    }
+    template <class F>
+    void scan_prefix(std::string_view prefix, F&& f) const
+        requires std::same_as<Key, std::string_view>
+    {
+        const_cast<art_map*>(this)->scan_prefix(prefix, as_const_visitor(f));
+    }
+
+private:
+    static constexpr std::size_t leaf_alignment = std::max(alignof(leaf), alignof(T));
+
+    static std::size_t value_offset(std::size_t key_size) noexcept {
+        return (sizeof(leaf) + key_size + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    static T& value_of(leaf* l) noexcept {
+        return *std::launder(reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(l) + value_offset(l->key_size)));
+    }
+
+    template <class... Args>
+    static leaf* make_leaf(bytes k, Args&&... args) noexcept {
+        void* p = allocate_bytes(value_offset(k.size) + sizeof(T), leaf_alignment);
+        if (p == nullptr)
+            return nullptr;
+        leaf* l = std::construct_at(static_cast<leaf*>(p), leaf{k.size});
+        if (k.size != 0)
+            std::memcpy(l->key(), k.data, k.size);
+        std::construct_at(&value_of(l), std::forward<Args>(args)...);
+        return l;
+    }
+
+    static void destroy_leaf(leaf* l) noexcept {
+        std::destroy_at(&value_of(l));
+        deallocate_bytes(l, leaf_alignment);
+    }
+
+    std::pair<T*, bool> inserted(leaf* l) noexcept {
+        ++size_;
+        return {&value_of(l), true};
+    }
+
+    // Hangs child (whose key is k) below the fresh node in slot, at key position depth.
+    static void attach(ref& slot, ref child, bytes k, std::size_t depth) noexcept {
+        if (depth == k.size)
+            slot.as_inner()->terminal = child;
+        else
+            detail::art::add_child(slot, k.data[depth], child);
+    }
+
+    static void destroy(ref r) noexcept {
+        if (r.is_leaf()) {
+            destroy_leaf(r.as_leaf());
+            return;
+        }
+        inner* n = r.as_inner();
+        if (n->terminal)
+            destroy_leaf(n->terminal.as_leaf());
+        detail::art::for_each_child(n, [](unsigned char, ref child) {
+            destroy(child);
+            return true;
+        });
+        detail::art::free_node(n);
+    }
+
+    template <class F>
+    static auto as_const_visitor(F& f) noexcept {
+        return [&f](const Key& key, T& value) { return visit_one(f, key, std::as_const(value)); };
+    }
+
+    template <class F, class V>
+    static bool visit_one(F& f, const Key& key, V& value) {
+        if constexpr (std::is_same_v<std::invoke_result_t<F&, const Key&, V&>, bool>) {
+            return f(key, value);
+        } else {
+            f(key, value);
+            return true;
+        }
+    }
+
+    template <class F>
+    static bool visit_leaf(leaf* l, F& f) {
+        return visit_one(f, traits::decode(l->key_bytes()), value_of(l));
+    }
+
+    template <class F>
+    static bool visit_all(ref r, F& f) {
+        if (r.is_leaf())
+            return visit_leaf(r.as_leaf(), f);
+        const inner* n = r.as_inner();
+        if (n->terminal && !visit_leaf(n->terminal.as_leaf(), f))
+            return false;
+        return detail::art::for_each_child(n, [&f](unsigned char, ref child) { return visit_all(child, f); });
+    }
+
+    // In-order walk restricted to [lo, hi). A bound stays active while the path so far equals
+    // the bound's leading bytes; once the path moves past it, the subtree lies entirely on one
+    // side and needs no more comparisons.
+    template <class F>
+    static bool visit_range(ref r, std::size_t depth, bytes lo, bool lo_on, bytes hi, bool hi_on, F& f) {
+        using detail::art::compare;
+        if (r.is_leaf()) {
+            const bytes key = r.as_leaf()->key_bytes();
+            if ((lo_on && compare(key, lo) < 0) || (hi_on && compare(key, hi) >= 0))
+                return true;
+            return visit_leaf(r.as_leaf(), f);
+        }
+        const inner* n = r.as_inner();
+        const std::size_t end = depth + n->prefix_len;
+        if (lo_on || hi_on) {
+            const bytes path = detail::art::min_leaf(r)->key_bytes();
+            if (lo_on) {
+                const std::size_t stop = std::min(end, lo.size);
+                std::size_t i = depth;
+                while (i < stop && path.data[i] == lo.data[i])
+                    ++i;
+                if (i < stop) {
+                    if (path.data[i] < lo.data[i])
+                        return true;
+                    lo_on = false;
+                } else if (lo.size <= end) {
+                    lo_on = false;
+                }
+            }
+            if (hi_on) {
+                const std::size_t stop = std::min(end, hi.size);
+                std::size_t i = depth;
+                while (i < stop && path.data[i] == hi.data[i])
+                    ++i;
+                if (i < stop) {
+                    if (path.data[i] > hi.data[i])
+                        return true;
+                    hi_on = false;
+                } else if (hi.size <= end) {
+                    return true;
+                }
+            }
+        }
+        // The terminal key equals the path, which is below lo while lo is still active.
+        if (n->terminal && !lo_on && !visit_leaf(n->terminal.as_leaf(), f))
+            return false;
+        return detail::art::for_each_child(n, [&](unsigned char b, ref child) {
+            if (lo_on && b < lo.data[end])
+                return true;
+            if (hi_on && b > hi.data[end])
+                return false;
+            return visit_range(child, end + 1, lo, lo_on && b == lo.data[end], hi, hi_on && b == hi.data[end], f);
+        });
+    }
+
+    ref root_;
+    size_type size_ = 0;
+};
+
+} // namespace extl
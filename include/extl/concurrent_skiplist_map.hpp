@@ -0,0 +1,495 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/hash.hpp"
+#include "extl/epoch.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+namespace detail::skiplist {
+
+inline constexpr std::size_t max_height = 16;
+
+// A tower link: pointer to the next node, with bit 0 set once the owning node is being erased
+// at that level.
+using link = std::atomic<std::uintptr_t>;
+inline constexpr std::uintptr_t mark_bit = 1;
+
+// ---------------------------------------------------------------------------------------
+// Arena
+// Concurrent bump allocator. Threads carve allocations out of the current block with one
+// fetch_add; the thread that overflows a block installs the next one with a CAS. Memory is only
+// returned when the arena is destroyed.
+// ---------------------------------------------------------------------------------------
+class arena {
+public:
+    static constexpr std::size_t alignment = cache_line_size;
+
+    explicit arena(std::size_t block_size) noexcept : block_size_(round_up(block_size)) {}
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    ~arena() {
+        free_chain(current_.load(std::memory_order_relaxed));
+        free_chain(large_.load(std::memory_order_relaxed));
+    }
+
+    // Returns alignment-aligned storage, or nullptr if a new block could not be allocated.
+    void* allocate(std::size_t bytes) noexcept {
+        bytes = round_up(bytes);
+        if (bytes > block_size_ / 4) {
+            // Oversized requests get their own block so they do not waste the shared one.
+            block* b = make_block(bytes);
+            if (b == nullptr)
+                return nullptr;
+            b->next = large_.load(std::memory_order_relaxed);
+            while (!large_.compare_exchange_weak(b->next, b, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            return b->data();
+        }
+        for (;;) {
+            block* b = current_.load(std::memory_order_acquire);
+            if (b != nullptr) {
+                const std::size_t offset = b->used.fetch_add(bytes, std::memory_order_relaxed);
+                if (offset + bytes <= b->capacity)
+                    return b->data() + offset;
+            }
+            block* fresh = make_block(block_size_);
+            if (fresh == nullptr)
+                return nullptr;
+            fresh->next = b;
+            fresh->used.store(bytes, std::memory_order_relaxed);
+            if (current_.compare_exchange_strong(b, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+                return fresh->data();
+            // Another thread installed a block first; use that one.
+            deallocate_bytes(fresh, alignment);
+            bytes_.fetch_sub(header_size + block_size_, std::memory_order_relaxed);
+        }
+    }
+
+    // Bytes obtained from the system, including block headers.
+    std::size_t bytes_reserved() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    struct block {
+        block* next;
+        std::size_t capacity;
+        std::atomic<std::size_t> used;
+
+        std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this) + header_size; }
+    };
+
+    static constexpr std::size_t header_size = (sizeof(block) + alignment - 1) / alignment * alignment;
+
+    static constexpr std::size_t round_up(std::size_t n) noexcept { return (n + alignment - 1) / alignment * alignment; }
+
+    block* make_block(std::size_t capacity) noexcept {
+        void* p = allocate_bytes(header_size + capacity, alignment);
+        if (p == nullptr)
+            return nullptr;
+        bytes_.fetch_add(header_size + capacity, std::memory_order_relaxed);
+        auto* b = ::new (p) block{nullptr, capacity, {0}};
+        return b;
+    }
+
+    static void free_chain(block* b) noexcept {
+        while (b != nullptr) {
+            block* next = b->next;
+            deallocate_bytes(b, alignment);
+            b = next;
+        }
+    }
+
+    std::size_t block_size_;
+    std::atomic<block*> current_{nullptr};
+    std::atomic<block*> large_{nullptr};
+    std::atomic<std::size_t> bytes_{0};
+};
+
+// Tower height with P(height > h) = 4^-h, from a per-thread xorshift generator.
+inline unsigned random_height() noexcept {
+    thread_local std::uint32_t state = 0;
+    if (state == 0)
+        state = static_cast<std::uint32_t>(mix64(reinterpret_cast<std::uintptr_t>(&state))) | 1;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return 1 + static_cast<unsigned>(std::countr_zero(state | (1u << (2 * (max_height - 1))))) / 2;
+}
+
+// Node header; the tower of `height` links follows it in the same allocation.
+template <class Key, class T>
+struct node : epoch_node {
+    template <class... Args>
+    node(unsigned h, const Key& k, Args&&... args) : key(k), value(std::forward<Args>(args)...), height(h) {}
+
+    static constexpr std::size_t links_offset = (sizeof(node) + alignof(link) - 1) / alignof(link) * alignof(link);
+
+    static std::size_t bytes(unsigned height) noexcept { return links_offset + height * sizeof(link); }
+
+    // Also valid for the storage of a destroyed node, whose tower outlives the entry.
+    static link* links(void* storage) noexcept {
+        return reinterpret_cast<link*>(static_cast<std::byte*>(storage) + links_offset);
+    }
+    link* links() noexcept { return links(this); }
+
+    Key key;
+    T value;
+    unsigned height;
+    // The inserter and the eraser each hold a reference; the node is retired when both are done.
+    std::atomic<std::uint32_t> owners{2};
+};
+
+} // namespace detail::skiplist
+
+// ---------------------------------------------------------------------------------------
+// concurrent_skiplist_map
+// Ordered map that any number of threads may read and write concurrently, built as a lock-free
+// skip list (Fraser; Herlihy & Shavit). Searches never write shared memory; inserts link a node
+// bottom-up with CAS; erases mark the node's tower and unlink it, helped by every writer that
+// passes over it. Keys are unique and entries are immutable once inserted, which suits memtables:
+// an update is an erase followed by an insert, or a new key carrying a sequence number.
+//
+// Nodes are carved from a per-map arena. Every operation pins the epoch (see epoch.hpp), and an
+// erased node waits in the map's epoch_limbo until no operation that might still see it is in
+// progress. Reclaimed nodes have their key and value destroyed and go to a per-height free list
+// for reuse, so the arena does not grow under churn.
+//
+// Callbacks passed to visit(), scan() and for_each() run while the operation is pinned, so
+// references to keys and values must not be kept past the callback.
+// ---------------------------------------------------------------------------------------
+template <class Key, class T, class Compare = std::less<Key>>
+class concurrent_skiplist_map {
+    using node = detail::skiplist::node<Key, T>;
+    using link = detail::skiplist::link;
+    static constexpr std::size_t max_height = detail::skiplist::max_height;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+
+    static constexpr std::size_t default_block_size = std::size_t{1} << 16;
+
+    explicit concurrent_skiplist_map(std::size_t arena_block_size = default_block_size,
+                                     const Compare& comp = Compare()) noexcept
+        : comp_(comp), arena_(arena_block_size) {}
+
+    concurrent_skiplist_map(const concurrent_skiplist_map&) = delete;
+    concurrent_skiplist_map& operator=(const concurrent_skiplist_map&) = delete;
+
+    ~concurrent_skiplist_map() {
+        std::uintptr_t bits = head_[0].load(std::memory_order_relaxed);
+        while (node* n = pointer(bits)) {
+            bits = n->links()[0].load(std::memory_order_relaxed);
+            std::destroy_at(n);
+        }
+        limbo_.drain([](epoch_node* n) noexcept { std::destroy_at(static_cast<node*>(n)); });
+    }
+
+    // Number of entries. Exact when no writer is running, otherwise a snapshot.
+    size_type size() const noexcept { return size_.load(std::memory_order_relaxed); }
+    bool empty() const noexcept { return size() == 0; }
+
+    // Memory the arena has reserved, for deciding when a memtable is full.
+    std::size_t arena_bytes() const noexcept { return arena_.bytes_reserved(); }
+
+    // Inserts key with a value constructed from args unless the key is present. Returns whether
+    // the entry was inserted.
+    template <class... Args>
+    expected<bool, errc> try_emplace(const Key& key, Args&&... args) noexcept {
+        expected<bool, errc> result;
+        {
+            auto guard = epoch::pin();
+            result = insert(key, std::forward<Args>(args)...);
+        }
+        reclaim_if_due();
+        return result;
+    }
+
+    // Removes key; returns whether this call removed it.
+    bool erase(const Key& key) noexcept {
+        bool erased;
+        {
+            auto guard = epoch::pin();
+            erased = remove(key);
+        }
+        reclaim_if_due();
+        return erased;
+    }
+
+    bool contains(const Key& key) const noexcept {
+        auto guard = epoch::pin();
+        node* n = lower_bound(key);
+        return n != nullptr && !comp_(key, n->key);
+    }
+
+    // Calls f(value) if key is present; returns whether it was.
+    template <class F>
+    bool visit(const Key& key, F&& f) const {
+        auto guard = epoch::pin();
+        node* n = lower_bound(key);
+        if (n == nullptr || comp_(key, n->key))
+            return false;
+        f(std::as_const(n->value));
+        return true;
+    }
+
+    // Calls f(key, value) for the entries with keys not less than from, in order, until f
+    // returns false. Entries inserted or erased during the scan may or may not be seen.
+    template <class F>
+    void scan(const Key& from, F&& f) const {
+        auto guard = epoch::pin();
+        walk(lower_bound(from), f);
+    }
+
+    template <class F>
+    void for_each(F&& f) const {
+        auto guard = epoch::pin();
+        walk(next_live(head_[0].load(std::memory_order_acquire)), f);
+    }
+
+private:
+    // ------------------------------------------------------------------------------------
+    // Reclamation
+    // ------------------------------------------------------------------------------------
+    static constexpr std::size_t reclaim_batch = 64;
+
+    void release(node* n) noexcept {
+        if (n->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            limbo_.push(n);
+    }
+
+    // Walks the limbo list once it holds reclaim_batch nodes or twice what the last walk left
+    // behind, and only if the epoch has moved since that walk: nothing new can have expired before
+    // then. A reader that stalls reclamation thus costs amortized O(1) per operation, not a walk.
+    void reclaim_if_due() noexcept {
+        if (limbo_.size() < reclaim_threshold_.load(std::memory_order_relaxed))
+            return;
+        epoch::try_advance();
+        const std::uint64_t e = epoch::current();
+        std::uint64_t walked = reclaim_epoch_.load(std::memory_order_relaxed);
+        if (walked == e || !reclaim_epoch_.compare_exchange_strong(walked, e, std::memory_order_relaxed))
+            return;
+        limbo_.collect([this](epoch_node* n) noexcept { recycle(static_cast<node*>(n)); });
+        reclaim_threshold_.store(std::max(reclaim_batch, 2 * limbo_.size()), std::memory_order_relaxed);
+    }
+
+    // Destroys the entry and parks the node on the free list for its height, threaded through
+    // its level-0 link. Pops happen only while pinned, and a popped node cannot return to the
+    // list before a grace period has passed, so the list is free of ABA.
+    void recycle(node* n) noexcept {
+        const unsigned height = n->height;
+        std::destroy_at(n);
+        link& head = free_[height - 1];
+        std::uintptr_t top = head.load(std::memory_order_relaxed);
+        do {
+            node::links(n)[0].store(top, std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(top, bits(n), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void* acquire_storage(unsigned height) noexcept {
+        link& head = free_[height - 1];
+        std::uintptr_t top = head.load(std::memory_order_acquire);
+        while (top != 0) {
+            void* storage = pointer(top);
+            const std::uintptr_t next = node::links(storage)[0].load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(top, next, std::memory_order_acquire, std::memory_order_acquire))
+                return storage;
+        }
+        void* storage = arena_.allocate(node::bytes(height));
+        if (storage != nullptr) {
+            for (unsigned i = 0; i < height; ++i)
+                std::construct_at(node::links(storage) + i, 0);
+        }
+        return storage;
+    }
+
+    // ------------------------------------------------------------------------------------
+    // Skip list
+    // ------------------------------------------------------------------------------------
+    static node* pointer(std::uintptr_t bits) noexcept { return reinterpret_cast<node*>(bits & ~detail::skiplist::mark_bit); }
+    static std::uintptr_t bits(node* n) noexcept { return reinterpret_cast<std::uintptr_t>(n); }
+
+    // Fills preds/succs with the neighbours of key's position at every level, unlinking marked
+    // nodes on the way. With Through set, the search continues past nodes equal to key, so it
+    // unlinks an erased node even when a newer node with the same key precedes it.
+    template <bool Through>
+    bool find(const Key& key, link** preds, node** succs) noexcept {
+    retry:
+        link* pred = head_;
+        for (std::size_t level = max_height; level-- > 0;) {
+            std::uintptr_t curr = pred[level].load(std::memory_order_acquire);
+            for (;;) {
+                if ((curr & detail::skiplist::mark_bit) != 0)
+                    goto retry; // pred is being erased.
+                node* n = pointer(curr);
+                if (n == nullptr)
+                    break;
+                const std::uintptr_t succ = n->links()[level].load(std::memory_order_acquire);
+                if ((succ & detail::skiplist::mark_bit) != 0) {
+                    const std::uintptr_t unmarked = succ & ~detail::skiplist::mark_bit;
+                    if (!pred[level].compare_exchange_strong(curr, unmarked, std::memory_order_acq_rel,
+                                                             std::memory_order_acquire))
+                        goto retry;
+                    curr = unmarked;
+                    continue;
+                }
+                if (Through ? comp_(key, n->key) : !comp_(n->key, key))
+                    break;
+                pred = n->links();
+                curr = succ;
+            }
+            preds[level] = pred;
+            succs[level] = pointer(curr);
+        }
+        return succs[0] != nullptr && !comp_(key, succs[0]->key);
+    }
+
+    // First live node at or after the node bits refers to, following level-0 links.
+    static node* next_live(std::uintptr_t bits) noexcept {
+        node* n = pointer(bits);
+        while (n != nullptr) {
+            const std::uintptr_t next = n->links()[0].load(std::memory_order_acquire);
+            if ((next & detail::skiplist::mark_bit) == 0)
+                return n;
+            n = pointer(next);
+        }
+        return nullptr;
+    }
+
+    // First live node with a key not less than key. Read-only: marked nodes are stepped over,
+    // not unlinked.
+    node* lower_bound(const Key& key) const noexcept {
+        const link* pred = head_;
+        node* n = nullptr;
+        for (std::size_t level = max_height; level-- > 0;) {
+            n = pointer(pred[level].load(std::memory_order_acquire));
+            while (n != nullptr && comp_(n->key, key)) {
+                pred = n->links();
+                n = pointer(pred[level].load(std::memory_order_acquire));
+            }
+        }
+        return n != nullptr ? next_live(bits(n)) : nullptr;
+    }
+
+    template <class F>
+    static void walk(node* n, F& f) {
+        for (; n != nullptr; n = next_live(n->links()[0].load(std::memory_order_acquire))) {
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, const Key&, const T&>, bool>) {
+                if (!f(std::as_const(n->key), std::as_const(n->value)))
+                    return;
+            } else {
+                f(std::as_const(n->key), std::as_const(n->value));
+            }
+        }
+    }
+
+    template <class... Args>
+    expected<bool, errc> insert(const Key& key, Args&&... args) noexcept {
+        link* preds[max_height];
+        node* succs[max_height];
+        const unsigned height = detail::skiplist::random_height();
+        node* fresh = nullptr;
+        for (;;) {
+            if (find<false>(key, preds, succs)) {
+                // Never published, but it may have come off a free list that others are popping,
+                // so it goes back through the limbo list rather than straight onto the free list.
+                if (fresh != nullptr)
+                    limbo_.push(fresh);
+                return false;
+            }
+            if (fresh == nullptr) {
+                void* storage = acquire_storage(height);
+                if (storage == nullptr)
+                    return unexpected(errc::out_of_memory);
+                fresh = std::construct_at(static_cast<node*>(storage), height, key, std::forward<Args>(args)...);
+            }
+            link* links = fresh->links();
+            for (unsigned i = 0; i < height; ++i)
+                links[i].store(bits(succs[i]), std::memory_order_relaxed);
+            std::uintptr_t expected = bits(succs[0]);
+            if (preds[0][0].compare_exchange_strong(expected, bits(fresh), std::memory_order_release,
+                                                    std::memory_order_relaxed))
+                break;
+        }
+        size_.fetch_add(1, std::memory_order_relaxed);
+
+        // The entry is in the map once linked at level 0; the upper levels only speed up searches
+        // and are abandoned if an eraser marks the node meanwhile.
+        link* links = fresh->links();
+        for (unsigned level = 1; level < height; ++level) {
+            for (;;) {
+                std::uintptr_t next = links[level].load(std::memory_order_acquire);
+                if ((next & detail::skiplist::mark_bit) != 0)
+                    goto linked;
+                if (pointer(next) != succs[level] &&
+                    !links[level].compare_exchange_strong(next, bits(succs[level]), std::memory_order_acq_rel,
+                                                          std::memory_order_acquire))
+                    goto linked;
+                std::uintptr_t expected = bits(succs[level]);
+                if (preds[level][level].compare_exchange_strong(expected, bits(fresh), std::memory_order_release,
+                                                                std::memory_order_relaxed))
+                    break;
+                if (!find<false>(key, preds, succs) || succs[0] != fresh)
+                    goto linked;
+            }
+        }
+    linked:
+        // If an eraser got in while the tower was being linked, its cleanup pass may have run
+        // before the last link; repeat it.
+        if ((links[0].load(std::memory_order_acquire) & detail::skiplist::mark_bit) != 0)
+            find<true>(key, preds, succs);
+        release(fresh);
+        return true;
+    }
+
+    bool remove(const Key& key) noexcept {
+        link* preds[max_height];
+        node* succs[max_height];
+        if (!find<false>(key, preds, succs))
+            return false;
+        node* victim = succs[0];
+        link* links = victim->links();
+        for (unsigned level = victim->height; level-- > 1;)
+            links[level].fetch_or(detail::skiplist::mark_bit, std::memory_order_acq_rel);
+        // Marking level 0 is the linearization point; of several concurrent erasers one wins.
+        std::uintptr_t next = links[0].load(std::memory_order_acquire);
+        do {
+            if ((next & detail::skiplist::mark_bit) != 0)
+                return false;
+        } while (!links[0].compare_exchange_weak(next, next | detail::skiplist::mark_bit, std::memory_order_acq_rel,
+                                                 std::memory_order_acquire));
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        find<true>(key, preds, succs);
+        release(victim);
+        return true;
+    }
+
+    [[no_unique_address]] Compare comp_{};
+    link head_[max_height] = {};
+    std::atomic<size_type> size_{0};
+    detail::skiplist::arena arena_;
+    link free_[max_height] = {};
+    epoch_limbo limbo_;
+    std::atomic<std::size_t> reclaim_threshold_{reclaim_batch};
+    std::atomic<std::uint64_t> reclaim_epoch_{~std::uint64_t{0}};
+};
+
+} // namespace extl
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+
+// ---------------------------------------------------------------------------------------
+// Compiler helpers
+// ---------------------------------------------------------------------------------------
+#if defined(_MSC_VER) && !defined(__clang__)
+#define EXTL_FORCE_INLINE __forceinline
+#define EXTL_NO_INLINE __declspec(noinline)
+#define EXTL_LIKELY(x) (x)
+#define EXTL_UNLIKELY(x) (x)
+#else
+#define EXTL_FORCE_INLINE inline __attribute__((always_inline))
+#define EXTL_NO_INLINE __attribute__((noinline))
+#define EXTL_LIKELY(x) __builtin_expect(!!(x), 1)
+#define EXTL_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#endif
+
+// ---------------------------------------------------------------------------------------
+// Assertions
+// ExTL never throws; violated preconditions are caught by EXTL_ASSERT in debug builds only.
+// ---------------------------------------------------------------------------------------
+#ifndef EXTL_ASSERT
+#include <cassert>
+#define EXTL_ASSERT(expr) assert(expr)
+#endif
+
+// ---------------------------------------------------------------------------------------
+// Instruction set detection
+// Kernels are selected at compile time from the target flags (-mavx2, -march=..., /arch:...),
+// and every SIMD path has a portable scalar fallback.
+// ---------------------------------------------------------------------------------------
+#if defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+#define EXTL_HAS_AVX512 1
+#else
+#define EXTL_HAS_AVX512 0
+#endif
+
+#if defined(__AVX2__)
+#define EXTL_HAS_AVX2 1
+#else
+#define EXTL_HAS_AVX2 0
+#endif
+
+#if defined(__BMI2__)
+#define EXTL_HAS_BMI2 1
+#else
+#define EXTL_HAS_BMI2 0
+#endif
+
+// Part of the x86-64 baseline, so only 32-bit x86 builds without -msse2 lack it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EXTL_HAS_SSE2 1
+#else
+#define EXTL_HAS_SSE2 0
+#endif
+
+#if EXTL_HAS_AVX2 || EXTL_HAS_AVX512 || EXTL_HAS_BMI2 || EXTL_HAS_SSE2
+#include <immintrin.h>
+#endif
+
+namespace extl {
+
+// Size of a cache line on every target ExTL cares about. Used for padding shared state.
+inline constexpr std::size_t cache_line_size = 64;
+
+} // namespace extl
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/hash.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// cuckoo_filter
+// Membership filter that supports deletion (Fan et al.). Each key stores a fingerprint in one of
+// two buckets of four slots; the second bucket is derived from the first and the fingerprint
+// alone, so fingerprints can be moved between their buckets without the key, which is how
+// insertion makes room once both buckets are full. A probe touches at most two buckets, each
+// compared against the fingerprint in one word-wide operation for 8- and 16-bit fingerprints.
+//
+// Only erase keys that were inserted: erasing a never-inserted key can remove the fingerprint
+// of a different key that shares it. The same key may be inserted several times (up to eight
+// copies) and must then be erased as often.
+// ---------------------------------------------------------------------------------------
+template <class Key, class Hash = std::hash<Key>, class Fingerprint = std::uint16_t>
+class cuckoo_filter {
+    static_assert(std::is_unsigned_v<Fingerprint> && sizeof(Fingerprint) <= 4);
+
+public:
+    using key_type = Key;
+    using hasher = Hash;
+    using fingerprint_type = Fingerprint;
+    using size_type = std::size_t;
+
+    static constexpr size_type bucket_size = 4;
+
+    cuckoo_filter() noexcept = default;
+
+    cuckoo_filter(const cuckoo_filter&) = delete;
+    cuckoo_filter& operator=(const cuckoo_filter&) = delete;
+
+    cuckoo_filter(cuckoo_filter&& other) noexcept { steal(other); }
+
+    cuckoo_filter& operator=(cuckoo_filter&& other) noexcept {
+        if (this != &other) {
+            deallocate(slots_, cache_line_size);
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~cuckoo_filter() { deallocate(slots_, cache_line_size); }
+
+    // Creates an empty filter with room for n keys at a false positive rate of at most fpr.
+    // Fails with invalid_argument unless 0 < fpr < 1 and Fingerprint is wide enough: the rate is
+    // about 2 * bucket_size / 2^bits, so 8-bit fingerprints reach 3% and 16-bit ones 0.013%.
+    static expected<cuckoo_filter, errc> create(size_type n, double fpr, const Hash& hash = Hash()) noexcept {
+        if (!(fpr > 0.0 && fpr < 1.0))
+            return unexpected(errc::invalid_argument);
+        if (std::ceil(std::log2(2.0 * bucket_size / fpr)) > std::numeric_limits<Fingerprint>::digits)
+            return unexpected(errc::invalid_argument);
+        // Four-slot buckets fill to about 95% before insertions start failing.
+        const size_type buckets = (n / 19) * 5 + (n % 19 * 5 + 18) / 19 + 1;
+        if (buckets > (size_type{1} << 31))
+            return unexpected(errc::length_error);
+        return create_buckets(std::bit_ceil(buckets), hash);
+    }
+
+    static expected<cuckoo_filter, errc> copy(const cuckoo_filter& other) noexcept {
+        auto filter = create_buckets(other.bucket_count(), other.hash_);
+        if (!filter)
+            return filter;
+        if (other.slots_ != nullptr)
+            std::memcpy(filter->slots_, other.slots_, other.size_in_bytes());
+        filter->size_ = other.size_;
+        filter->victim_ = other.victim_;
+        filter->rng_ = other.rng_;
+        return filter;
+    }
+
+    // Adds key. Fails with length_error once the filter is full; the insertion that fills it
+    // still succeeds, by parking one displaced fingerprint in a single-entry overflow slot.
+    expected<void, errc> insert(const Key& key) noexcept {
+        if (victim_.used || slots_ == nullptr)
+            return unexpected(errc::length_error);
+        const std::uint64_t h = hash_of(key);
+        place(bucket_of(h), fingerprint_of(h));
+        ++size_;
+        return {};
+    }
+
+    // False for keys that are not in the filter, except with about the configured probability.
+    bool contains(const Key& key) const noexcept {
+        if (slots_ == nullptr)
+            return false;
+        const std::uint64_t h = hash_of(key);
+        const Fingerprint f = fingerprint_of(h);
+        const std::size_t i1 = bucket_of(h);
+        const std::size_t i2 = alternate(i1, f);
+        if (bucket_contains(i1, f) || bucket_contains(i2, f))
+            return true;
+        return victim_.used && victim_.fingerprint == f && (victim_.bucket == i1 || victim_.bucket == i2);
+    }
+
+    // Removes one copy of key; returns whether a matching fingerprint was found.
+    bool erase(const Key& key) noexcept {
+        if (slots_ == nullptr)
+            return false;
+        const std::uint64_t h = hash_of(key);
+        const Fingerprint f = fingerprint_of(h);
+        const std::size_t i1 = bucket_of(h);
+        const std::size_t i2 = alternate(i1, f);
+        if (victim_.used && victim_.fingerprint == f && (victim_.bucket == i1 || victim_.bucket == i2)) {
+            victim_.used = false;
+            --size_;
+            return true;
+        }
+        if (!remove_from(i1, f) && !remove_from(i2, f))
+            return false;
+        --size_;
+        if (victim_.used) {
+            // A slot was freed; give the parked fingerprint another chance.
+            victim_.used = false;
+            place(victim_.bucket, victim_.fingerprint);
+        }
+        return true;
+    }
+
+    void clear() noexcept {
+        if (slots_ != nullptr)
+            std::fill_n(slots_, slot_count(), Fingerprint{0});
+        size_ = 0;
+        victim_ = {};
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type bucket_count() const noexcept { return mask_ + (slots_ != nullptr); }
+    size_type slot_count() const noexcept { return bucket_count() * bucket_size; }
+    size_type size_in_bytes() const noexcept { return slot_count() * sizeof(Fingerprint); }
+    double load_factor() const noexcept {
+        return slots_ == nullptr ? 0.0 : static_cast<double>(size_) / static_cast<double>(slot_count());
+    }
+
+private:
+    // Displacements tried before an insertion gives up and parks a fingerprint.
+    static constexpr int max_kicks = 500;
+
+    struct victim_slot {
+        std::size_t bucket = 0;
+        Fingerprint fingerprint = 0;
+        bool used = false;
+    };
+
+    static expected<cuckoo_filter, errc> create_buckets(size_type buckets, const Hash& hash) noexcept {
+        cuckoo_filter filter;
+        filter.hash_ = hash;
+        if (buckets != 0) {
+            filter.slots_ = allocate<Fingerprint>(buckets * bucket_size, cache_line_size);
+            if (filter.slots_ == nullptr)
+                return unexpected(errc::out_of_memory);
+            filter.mask_ = buckets - 1;
+            filter.clear();
+        }
+        return filter;
+    }
+
+    void steal(cuckoo_filter& other) noexcept {
+        slots_ = std::exchange(other.slots_, nullptr);
+        mask_ = std::exchange(other.mask_, 0);
+        size_ = std::exchange(other.size_, 0);
+        victim_ = std::exchange(other.victim_, {});
+        rng_ = other.rng_;
+        hash_ = std::move(other.hash_);
+    }
+
+    std::uint64_t hash_of(const Key& key) const noexcept {
+        return detail::mix64(static_cast<std::uint64_t>(hash_(key)));
+    }
+
+    // Zero marks an empty slot, so it is never a fingerprint.
+    static Fingerprint fingerprint_of(std::uint64_t h) noexcept {
+        const auto f = static_cast<Fingerprint>(h >> 32);
+        return f == 0 ? Fingerprint{1} : f;
+    }
+
+    std::size_t bucket_of(std::uint64_t h) const noexcept { return static_cast<std::size_t>(h) & mask_; }
+
+    // The other bucket of a fingerprint stored in bucket i; alternate(alternate(i, f), f) == i.
+    std::size_t alternate(std::size_t i, Fingerprint f) const noexcept {
+        return (i ^ static_cast<std::size_t>(detail::mix64(f))) & mask_;
+    }
+
+    bool bucket_contains(std::size_t i, Fingerprint f) const noexcept {
+        const Fingerprint* b = slots_ + i * bucket_size;
+        if constexpr (sizeof(Fingerprint) <= 2) {
+            // Zero-lane test on the bucket xor the broadcast fingerprint.
+            using word = std::conditional_t<sizeof(Fingerprint) == 1, std::uint32_t, std::uint64_t>;
+            constexpr word ones = ~word{0} / std::numeric_limits<Fingerprint>::max();
+            constexpr word high = ones << (std::numeric_limits<Fingerprint>::digits - 1);
+            word w;
+            std::memcpy(&w, b, sizeof w);
+            const word x = w ^ (ones * f);
+            return ((x - ones) & ~x & high) != 0;
+        } else {
+            return b[0] == f || b[1] == f || b[2] == f || b[3] == f;
+        }
+    }
+
+    bool try_store(std::size_t i, Fingerprint f) noexcept {
+        Fingerprint* b = slots_ + i * bucket_size;
+        for (std::size_t s = 0; s < bucket_size; ++s) {
+            if (b[s] == 0) {
+                b[s] = f;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool remove_from(std::size_t i, Fingerprint f) noexcept {
+        Fingerprint* b = slots_ + i * bucket_size;
+        for (std::size_t s = 0; s < bucket_size; ++s) {
+            if (b[s] == f) {
+                b[s] = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Stores f in bucket i or its alternate, evicting fingerprints along a random walk if both
+    // are full. The last evicted fingerprint is parked in victim_ if the walk runs out.
+    void place(std::size_t i, Fingerprint f) noexcept {
+        if (try_store(i, f))
+            return;
+        i = alternate(i, f);
+        for (int kick = 0; kick < max_kicks; ++kick) {
+            if (try_store(i, f))
+                return;
+            rng_ ^= rng_ << 13;
+            rng_ ^= rng_ >> 7;
+            rng_ ^= rng_ << 17;
+            std::swap(f, slots_[i * bucket_size + (rng_ & (bucket_size - 1))]);
+            i = alternate(i, f);
+        }
+        victim_ = {i, f, true};
+    }
+
+    Fingerprint* slots_ = nullptr;
+    std::size_t mask_ = 0; // bucket_count() - 1
+    std::size_t size_ = 0;
+    victim_slot victim_{};
+    std::uint64_t rng_ = 0x2545f4914f6cdd1dull;
+    [[no_unique_address]] Hash hash_{};
+};
+
+} // namespace extl
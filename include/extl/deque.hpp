@@ -0,0 +1,336 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+template <class T, std::size_t BlockBytes>
+class deque;
+
+// ---------------------------------------------------------------------------------------
+// deque_iterator
+// Random-access iterator addressing elements by logical index.
+// ---------------------------------------------------------------------------------------
+template <class T, std::size_t BlockBytes, bool Const>
+class deque_iterator {
+    using container = std::conditional_t<Const, const deque<T, BlockBytes>, deque<T, BlockBytes>>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    deque_iterator() noexcept = default;
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    deque_iterator(const deque_iterator<T, BlockBytes, OtherConst>& other) noexcept
+        : deque_(other.deque_), index_(other.index_) {}
+
+    reference operator*() const noexcept { return (*deque_)[index_]; }
+    pointer operator->() const noexcept { return std::addressof((*deque_)[index_]); }
+    reference operator[](difference_type n) const noexcept { return (*deque_)[index_ + static_cast<std::size_t>(n)]; }
+
+    deque_iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+    deque_iterator operator++(int) noexcept { return deque_iterator(deque_, index_++); }
+    deque_iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+    deque_iterator operator--(int) noexcept { return deque_iterator(deque_, index_--); }
+
+    deque_iterator& operator+=(difference_type n) noexcept {
+        index_ += static_cast<std::size_t>(n);
+        return *this;
+    }
+    deque_iterator& operator-=(difference_type n) noexcept {
+        index_ -= static_cast<std::size_t>(n);
+        return *this;
+    }
+    friend deque_iterator operator+(deque_iterator it, difference_type n) noexcept { return it += n; }
+    friend deque_iterator operator+(difference_type n, deque_iterator it) noexcept { return it += n; }
+    friend deque_iterator operator-(deque_iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(const deque_iterator& a, const deque_iterator& b) noexcept {
+        return static_cast<difference_type>(a.index_ - b.index_);
+    }
+
+    friend bool operator==(const deque_iterator& a, const deque_iterator& b) noexcept { return a.index_ == b.index_; }
+    friend std::strong_ordering operator<=>(const deque_iterator& a, const deque_iterator& b) noexcept {
+        return a.index_ <=> b.index_;
+    }
+
+private:
+    friend class deque<T, BlockBytes>;
+    template <class, std::size_t, bool>
+    friend class deque_iterator;
+
+    deque_iterator(container* d, std::size_t index) noexcept : deque_(d), index_(index) {}
+
+    container* deque_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+// ---------------------------------------------------------------------------------------
+// deque
+// Double-ended queue made of fixed-size blocks of BlockBytes bytes (at least one element),
+// tracked by a circular map of block pointers. Pushing at either end touches only the map slot
+// next to the current first or last block, so the map is reallocated only when it is full, and
+// one spare block is kept to absorb push/pop oscillation at a block boundary. Growth is fallible:
+// try_push_front/back return expected and leave the deque unchanged on failure.
+// ---------------------------------------------------------------------------------------
+template <class T, std::size_t BlockBytes = 4096>
+class deque {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = deque_iterator<T, BlockBytes, false>;
+    using const_iterator = deque_iterator<T, BlockBytes, true>;
+
+    // Elements per block.
+    static constexpr size_type block_size = BlockBytes / sizeof(T) > 0 ? BlockBytes / sizeof(T) : 1;
+
+    deque() noexcept = default;
+
+    deque(const deque&) = delete;
+    deque& operator=(const deque&) = delete;
+
+    deque(deque&& other) noexcept { steal(other); }
+
+    deque& operator=(deque&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~deque() { release(); }
+
+    static expected<deque, errc> copy(const deque& other) noexcept
+        requires std::is_copy_constructible_v<T>
+    {
+        deque result;
+        for (const T& value : other) {
+            if (auto pushed = result.try_push_back(value); !pushed)
+                return unexpected(pushed.error());
+        }
+        return result;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    T& operator[](size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        const size_type p = start_ + i;
+        return block_at(p / block_size)[p % block_size];
+    }
+    const T& operator[](size_type i) const noexcept { return const_cast<deque&>(*this)[i]; }
+
+    T& front() noexcept { return (*this)[0]; }
+    const T& front() const noexcept { return (*this)[0]; }
+    T& back() noexcept { return (*this)[size_ - 1]; }
+    const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    expected<void, errc> try_push_back(const T& value) noexcept { return try_emplace_back(value); }
+    expected<void, errc> try_push_back(T&& value) noexcept { return try_emplace_back(std::move(value)); }
+    expected<void, errc> try_push_front(const T& value) noexcept { return try_emplace_front(value); }
+    expected<void, errc> try_push_front(T&& value) noexcept { return try_emplace_front(std::move(value)); }
+
+    template <class... Args>
+    expected<void, errc> try_emplace_back(Args&&... args) noexcept {
+        const size_type p = start_ + size_;
+        if (p == block_count_ * block_size) {
+            if (auto result = add_block_back(); !result)
+                return result;
+        }
+        std::construct_at(block_at(p / block_size) + p % block_size, std::forward<Args>(args)...);
+        ++size_;
+        return {};
+    }
+
+    template <class... Args>
+    expected<void, errc> try_emplace_front(Args&&... args) noexcept {
+        if (start_ == 0) {
+            if (size_ == 0 && block_count_ == 1) {
+                start_ = block_size; // Reuse the empty block instead of adding one in front of it.
+            } else if (auto result = add_block_front(); !result) {
+                return result;
+            }
+        }
+        std::construct_at(block_at(0) + (start_ - 1), std::forward<Args>(args)...);
+        --start_;
+        ++size_;
+        return {};
+    }
+
+    void pop_back() noexcept {
+        EXTL_ASSERT(!empty());
+        --size_;
+        const size_type p = start_ + size_;
+        std::destroy_at(block_at(p / block_size) + p % block_size);
+        if (block_count_ > 1 && p == (block_count_ - 1) * block_size)
+            remove_block_back();
+    }
+
+    void pop_front() noexcept {
+        EXTL_ASSERT(!empty());
+        std::destroy_at(block_at(0) + start_);
+        ++start_;
+        --size_;
+        if (start_ == block_size && block_count_ > 1) {
+            remove_block_front();
+            start_ = 0;
+        } else if (size_ == 0) {
+            start_ = 0;
+        }
+    }
+
+    // Calls f(std::span<T>) for each contiguous run of elements, front to back.
+    template <class F>
+    void for_each_span(F&& f) {
+        size_type p = start_;
+        size_type remaining = size_;
+        while (remaining != 0) {
+            const size_type offset = p % block_size;
+            const size_type n = block_size - offset < remaining ? block_size - offset : remaining;
+            f(std::span<T>(block_at(p / block_size) + offset, n));
+            p += n;
+            remaining -= n;
+        }
+    }
+
+    void clear() noexcept {
+        while (!empty())
+            pop_back();
+        start_ = 0;
+    }
+
+private:
+    T* block_at(size_type i) const noexcept { return map_[(map_head_ + i) & (map_capacity_ - 1)]; }
+
+    T* take_block() noexcept {
+        if (spare_ != nullptr)
+            return std::exchange(spare_, nullptr);
+        return allocate<T>(block_size);
+    }
+
+    void give_block(T* block) noexcept {
+        if (spare_ == nullptr)
+            spare_ = block;
+        else
+            deallocate(block);
+    }
+
+    // Ensures the map has room for one more block pointer.
+    expected<void, errc> reserve_map_slot() noexcept {
+        if (block_count_ < map_capacity_)
+            return {};
+        const size_type capacity = map_capacity_ == 0 ? 8 : map_capacity_ * 2;
+        T** map = allocate<T*>(capacity);
+        if (map == nullptr)
+            return unexpected(errc::out_of_memory);
+        for (size_type i = 0; i < block_count_; ++i)
+            map[i] = block_at(i);
+        deallocate(map_);
+        map_ = map;
+        map_capacity_ = capacity;
+        map_head_ = 0;
+        return {};
+    }
+
+    expected<void, errc> add_block_back() noexcept {
+        if (auto result = reserve_map_slot(); !result)
+            return result;
+        T* block = take_block();
+        if (block == nullptr)
+            return unexpected(errc::out_of_memory);
+        map_[(map_head_ + block_count_) & (map_capacity_ - 1)] = block;
+        ++block_count_;
+        return {};
+    }
+
+    expected<void, errc> add_block_front() noexcept {
+        if (auto result = reserve_map_slot(); !result)
+            return result;
+        T* block = take_block();
+        if (block == nullptr)
+            return unexpected(errc::out_of_memory);
+        map_head_ = (map_head_ - 1) & (map_capacity_ - 1);
+        map_[map_head_] = block;
+        ++block_count_;
+        start_ += block_size;
+        return {};
+    }
+
+    void remove_block_back() noexcept {
+        --block_count_;
+        give_block(block_at(block_count_));
+    }
+
+    void remove_block_front() noexcept {
+        give_block(block_at(0));
+        map_head_ = (map_head_ + 1) & (map_capacity_ - 1);
+        --block_count_;
+    }
+
+    void steal(deque& other) noexcept {
+        map_ = std::exchange(other.map_, nullptr);
+        map_capacity_ = std::exchange(other.map_capacity_, 0);
+        map_head_ = std::exchange(other.map_head_, 0);
+        block_count_ = std::exchange(other.block_count_, 0);
+        start_ = std::exchange(other.start_, 0);
+        size_ = std::exchange(other.size_, 0);
+        spare_ = std::exchange(other.spare_, nullptr);
+    }
+
+    void release() noexcept {
+        clear();
+        for (size_type i = 0; i < block_count_; ++i)
+            deallocate(block_at(i));
+        deallocate(spare_);
+        deallocate(map_);
+        map_ = nullptr;
+        map_capacity_ = 0;
+        map_head_ = 0;
+        block_count_ = 0;
+        spare_ = nullptr;
+    }
+
+    T** map_ = nullptr;
+    size_type map_capacity_ = 0; // Zero or a power of two.
+    size_type map_head_ = 0;     // Map slot of the first block.
+    size_type block_count_ = 0;  // Blocks in use, starting at map_head_.
+    size_type start_ = 0;        // Offset of the first element in the first block.
+    size_type size_ = 0;
+    T* spare_ = nullptr;
+};
+
+} // namespace extl
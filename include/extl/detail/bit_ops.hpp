@@ -0,0 +1,158 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "extl/config.hpp"
+
+namespace extl::detail {
+
+// ---------------------------------------------------------------------------------------
+// Word-array kernels
+// Bulk operations over arrays of 64-bit words, shared by the bitset containers. The loops run a
+// full vector (512 or 256 bits) per iteration where available and finish with scalar words.
+// ---------------------------------------------------------------------------------------
+
+enum class bit_op { and_, or_, xor_, and_not };
+
+template <bit_op Op>
+EXTL_FORCE_INLINE std::uint64_t apply_bit_op(std::uint64_t a, std::uint64_t b) noexcept {
+    if constexpr (Op == bit_op::and_)
+        return a & b;
+    else if constexpr (Op == bit_op::or_)
+        return a | b;
+    else if constexpr (Op == bit_op::xor_)
+        return a ^ b;
+    else
+        return a & ~b;
+}
+
+// dst[i] = a[i] Op b[i] for i < n. dst may alias a or b.
+template <bit_op Op>
+inline void bitwise(std::uint64_t* dst, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) noexcept {
+    std::size_t i = 0;
+#if EXTL_HAS_AVX512
+    for (const std::size_t end = n & ~std::size_t{7}; i < end; i += 8) {
+        const __m512i x = _mm512_loadu_si512(a + i);
+        const __m512i y = _mm512_loadu_si512(b + i);
+        __m512i r;
+        if constexpr (Op == bit_op::and_)
+            r = _mm512_and_si512(x, y);
+        else if constexpr (Op == bit_op::or_)
+            r = _mm512_or_si512(x, y);
+        else if constexpr (Op == bit_op::xor_)
+            r = _mm512_xor_si512(x, y);
+        else  // masked form: GCC 12 warns about the undefined source of _mm512_andnot_si512
+            r = _mm512_mask_andnot_epi64(x, __mmask8(0xFF), y, x);
+        _mm512_storeu_si512(dst + i, r);
+    }
+#elif EXTL_HAS_AVX2
+    for (const std::size_t end = n & ~std::size_t{3}; i < end; i += 4) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i r;
+        if constexpr (Op == bit_op::and_)
+            r = _mm256_and_si256(x, y);
+        else if constexpr (Op == bit_op::or_)
+            r = _mm256_or_si256(x, y);
+        else if constexpr (Op == bit_op::xor_)
+            r = _mm256_xor_si256(x, y);
+        else
+            r = _mm256_andnot_si256(y, x);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), r);
+    }
+#endif
+    for (; i < n; ++i)
+        dst[i] = apply_bit_op<Op>(a[i], b[i]);
+}
+
+#if EXTL_HAS_AVX2
+
+// Set bits in one 256-bit vector, as four 64-bit lane sums (nibble lookup with vpshufb).
+EXTL_FORCE_INLINE __m256i popcount_lanes(__m256i v) noexcept {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, //
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_and_si256(v, low_nibbles);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+    const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+EXTL_FORCE_INLINE std::uint64_t horizontal_sum(__m256i v) noexcept {
+    const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(s)) + static_cast<std::uint64_t>(_mm_extract_epi64(s, 1));
+}
+
+#endif
+
+// Number of set bits in p[0, n). The vector path beats one popcnt per word once n reaches a few
+// dozen words; short arrays take the scalar loop.
+inline std::uint64_t popcount(const std::uint64_t* p, std::size_t n) noexcept {
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+#if EXTL_HAS_AVX2
+    if (n >= 32) {
+        __m256i acc = _mm256_setzero_si256();
+        for (const std::size_t end = n & ~std::size_t{3}; i < end; i += 4)
+            acc = _mm256_add_epi64(acc, popcount_lanes(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))));
+        total = horizontal_sum(acc);
+    }
+#endif
+    for (; i < n; ++i)
+        total += static_cast<std::uint64_t>(std::popcount(p[i]));
+    return total;
+}
+
+// Set bits in a[i] Op b[i] over i < n, without materializing the result.
+template <bit_op Op>
+inline std::uint64_t popcount(const std::uint64_t* a, const std::uint64_t* b, std::size_t n) noexcept {
+    std::uint64_t total = 0;
+    std::size_t i = 0;
+#if EXTL_HAS_AVX2
+    if (n >= 32) {
+        __m256i acc = _mm256_setzero_si256();
+        for (const std::size_t end = n & ~std::size_t{3}; i < end; i += 4) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            __m256i r;
+            if constexpr (Op == bit_op::and_)
+                r = _mm256_and_si256(x, y);
+            else if constexpr (Op == bit_op::or_)
+                r = _mm256_or_si256(x, y);
+            else if constexpr (Op == bit_op::xor_)
+                r = _mm256_xor_si256(x, y);
+            else
+                r = _mm256_andnot_si256(y, x);
+            acc = _mm256_add_epi64(acc, popcount_lanes(r));
+        }
+        total = horizontal_sum(acc);
+    }
+#endif
+    for (; i < n; ++i)
+        total += static_cast<std::uint64_t>(std::popcount(apply_bit_op<Op>(a[i], b[i])));
+    return total;
+}
+
+// Position of the k-th (0-based) set bit of w. Precondition: k < popcount(w).
+EXTL_FORCE_INLINE unsigned select_in_word(std::uint64_t w, unsigned k) noexcept {
+#if EXTL_HAS_BMI2
+    return static_cast<unsigned>(std::countr_zero(_pdep_u64(std::uint64_t{1} << k, w)));
+#else
+    unsigned base = 0;
+    for (;;) {
+        const unsigned c = static_cast<unsigned>(std::popcount(w & 0xff));
+        if (k < c)
+            break;
+        k -= c;
+        w >>= 8;
+        base += 8;
+    }
+    for (; k != 0; --k)
+        w &= w - 1;
+    return base + static_cast<unsigned>(std::countr_zero(w));
+#endif
+}
+
+} // namespace extl::detail
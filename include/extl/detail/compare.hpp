@@ -0,0 +1,20 @@
+#pragma once
+
+#include <concepts>
+#include <functional>
+
+namespace extl::detail {
+
+// True when Compare is one of the standard "a < b" function objects for T.
+template <class Compare, class T>
+inline constexpr bool is_less_compare_v =
+    std::same_as<Compare, std::ranges::less> || std::same_as<Compare, std::less<>> ||
+    std::same_as<Compare, std::less<T>>;
+
+// True when Compare is one of the standard "a > b" function objects for T.
+template <class Compare, class T>
+inline constexpr bool is_greater_compare_v =
+    std::same_as<Compare, std::ranges::greater> || std::same_as<Compare, std::greater<>> ||
+    std::same_as<Compare, std::greater<T>>;
+
+} // namespace extl::detail
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "extl/config.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 35)) && __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define EXTL_HAS_RSEQ 1
+#endif
+#endif
+
+#ifndef EXTL_HAS_RSEQ
+#define EXTL_HAS_RSEQ 0
+#endif
+
+namespace extl::detail {
+
+// ---------------------------------------------------------------------------------------
+// CPU identification for per-CPU sharding
+// ---------------------------------------------------------------------------------------
+
+// A small dense id per thread, for when the CPU cannot be queried.
+inline std::uint32_t thread_ordinal() noexcept {
+    static constinit std::atomic<std::uint32_t> next{0};
+    thread_local const std::uint32_t ordinal = next.fetch_add(1, std::memory_order_relaxed);
+    return ordinal;
+}
+
+// The CPU the calling thread is running on. The thread may migrate right after, so callers use it
+// only to pick a likely-uncontended shard, never for correctness. With glibc 2.35+ this is one
+// load from the thread's rseq area, which the kernel keeps current; otherwise sched_getcpu(), and
+// off Linux a per-thread ordinal.
+inline std::uint32_t current_cpu() noexcept {
+#if EXTL_HAS_RSEQ
+    if (EXTL_LIKELY(__rseq_size != 0)) {
+        const auto* area = reinterpret_cast<const struct rseq*>(static_cast<const char*>(__builtin_thread_pointer()) +
+                                                                __rseq_offset);
+        return __atomic_load_n(&area->cpu_id, __ATOMIC_RELAXED);
+    }
+#endif
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (EXTL_LIKELY(cpu >= 0))
+        return static_cast<std::uint32_t>(cpu);
+#endif
+    return thread_ordinal();
+}
+
+// ---------------------------------------------------------------------------------------
+// Cycle counter
+// ---------------------------------------------------------------------------------------
+
+// A fast, monotonically increasing tick count for timestamps: the TSC on x86 and the virtual
+// counter on AArch64, both readable from user space without a system call. Elsewhere it falls
+// back to steady_clock nanoseconds. The tick rate is unspecified; callers calibrate it against a
+// real clock.
+EXTL_FORCE_INLINE std::uint64_t read_cycle_counter() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+} // namespace extl::detail
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "extl/config.hpp"
+
+namespace extl::detail {
+
+// ---------------------------------------------------------------------------------------
+// Hash helpers
+// std::hash is the identity for integers on common standard libraries, so the filters run every
+// user hash through a finalizer before slicing it into indexes and fingerprints.
+// ---------------------------------------------------------------------------------------
+
+// MurmurHash3's 64-bit finalizer: every input bit affects every output bit.
+EXTL_FORCE_INLINE std::uint64_t mix64(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Maps a uniform 32-bit value onto [0, n) with a multiply instead of a division.
+EXTL_FORCE_INLINE std::uint32_t reduce(std::uint32_t x, std::uint32_t n) noexcept {
+    return static_cast<std::uint32_t>((std::uint64_t{x} * n) >> 32);
+}
+
+} // namespace extl::detail
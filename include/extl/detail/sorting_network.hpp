@@ -0,0 +1,419 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "extl/config.hpp"
+
+// Bitonic sorting networks over a fixed number of SIMD registers.
+//
+// A network sorts N = R * W elements held in R registers of W lanes. Compare-exchange steps whose
+// partners live in different registers are plain vertical min/max; steps whose partners share a
+// register swap lanes with a permute and pick min or max per lane with a compile-time blend mask.
+// Every loop is expanded at compile time, so the whole network is straight-line, branch-free code.
+
+namespace extl::detail {
+
+// Value used to pad a partially filled network; it sorts after every real element.
+template <class T>
+inline constexpr T sort_pad_value =
+    std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+
+// ---------------------------------------------------------------------------------------
+// Register traits
+// Each traits type provides: reg, width, load/store (full and partial), min, max,
+// swap<J> (exchange lane l with lane l ^ J) and blend<M> (lane l from hi if bit l of M is set).
+// min(a, b) and max(a, b) follow the x86 rule: each returns b unless a compares strictly less
+// (greater), so with unordered operands min(a, b) and max(b, a) still return one of each.
+// ---------------------------------------------------------------------------------------
+
+#if EXTL_HAS_AVX512
+
+// min, max and swap use the masked intrinsics with an all-ones mask and an explicit source. The
+// unmasked forms pass _mm512_undefined_*() through, which GCC 12 reports as -Wuninitialized once
+// the network is inlined; the masked forms compile to the same unmasked instructions.
+template <class T>
+struct avx512_traits;
+
+template <>
+struct avx512_traits<std::int32_t> {
+    using value_type = std::int32_t;
+    using reg = __m512i;
+    static constexpr std::size_t width = 16;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm512_loadu_si512(p); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm512_storeu_si512(p, v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        return _mm512_mask_loadu_epi32(_mm512_set1_epi32(sort_pad_value<value_type>), lanes(n), p);
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm512_mask_storeu_epi32(p, lanes(n), v);
+    }
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm512_mask_min_epi32(a, __mmask16(0xFFFF), a, b); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm512_mask_max_epi32(a, __mmask16(0xFFFF), a, b); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) {
+        const __m512i idx = _mm512_xor_si512(
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(J));
+        return _mm512_mask_permutexvar_epi32(v, __mmask16(0xFFFF), idx, v);
+    }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm512_mask_blend_epi32(__mmask16(M), lo, hi); }
+
+    static EXTL_FORCE_INLINE __mmask16 lanes(std::size_t n) { return __mmask16((1u << n) - 1u); }
+};
+
+template <>
+struct avx512_traits<float> {
+    using value_type = float;
+    using reg = __m512;
+    static constexpr std::size_t width = 16;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm512_loadu_ps(p); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm512_storeu_ps(p, v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        return _mm512_mask_loadu_ps(_mm512_set1_ps(sort_pad_value<value_type>), lanes(n), p);
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm512_mask_storeu_ps(p, lanes(n), v);
+    }
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm512_mask_min_ps(a, __mmask16(0xFFFF), a, b); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm512_mask_max_ps(a, __mmask16(0xFFFF), a, b); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) {
+        const __m512i idx = _mm512_xor_si512(
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(J));
+        return _mm512_mask_permutexvar_ps(v, __mmask16(0xFFFF), idx, v);
+    }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm512_mask_blend_ps(__mmask16(M), lo, hi); }
+
+    static EXTL_FORCE_INLINE __mmask16 lanes(std::size_t n) { return __mmask16((1u << n) - 1u); }
+};
+
+template <>
+struct avx512_traits<std::int64_t> {
+    using value_type = std::int64_t;
+    using reg = __m512i;
+    static constexpr std::size_t width = 8;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm512_loadu_si512(p); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm512_storeu_si512(p, v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        return _mm512_mask_loadu_epi64(_mm512_set1_epi64(sort_pad_value<value_type>), lanes(n), p);
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm512_mask_storeu_epi64(p, lanes(n), v);
+    }
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm512_mask_min_epi64(a, __mmask8(0xFF), a, b); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm512_mask_max_epi64(a, __mmask8(0xFF), a, b); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) {
+        const __m512i idx = _mm512_xor_si512(_mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7), _mm512_set1_epi64(J));
+        return _mm512_mask_permutexvar_epi64(v, __mmask8(0xFF), idx, v);
+    }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm512_mask_blend_epi64(__mmask8(M), lo, hi); }
+
+    static EXTL_FORCE_INLINE __mmask8 lanes(std::size_t n) { return __mmask8((1u << n) - 1u); }
+};
+
+template <>
+struct avx512_traits<double> {
+    using value_type = double;
+    using reg = __m512d;
+    static constexpr std::size_t width = 8;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm512_loadu_pd(p); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm512_storeu_pd(p, v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        return _mm512_mask_loadu_pd(_mm512_set1_pd(sort_pad_value<value_type>), lanes(n), p);
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm512_mask_storeu_pd(p, lanes(n), v);
+    }
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm512_mask_min_pd(a, __mmask8(0xFF), a, b); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm512_mask_max_pd(a, __mmask8(0xFF), a, b); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) {
+        const __m512i idx = _mm512_xor_si512(_mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7), _mm512_set1_epi64(J));
+        return _mm512_mask_permutexvar_pd(v, __mmask8(0xFF), idx, v);
+    }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm512_mask_blend_pd(__mmask8(M), lo, hi); }
+
+    static EXTL_FORCE_INLINE __mmask8 lanes(std::size_t n) { return __mmask8((1u << n) - 1u); }
+};
+
+template <class T>
+using simd_sort_traits = avx512_traits<T>;
+
+#elif EXTL_HAS_AVX2
+
+// Lane mask with the first n 32-bit lanes set, as used by the AVX2 masked loads and stores.
+EXTL_FORCE_INLINE __m256i avx2_lanes32(std::size_t n) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(n)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+EXTL_FORCE_INLINE __m256i avx2_lanes64(std::size_t n) {
+    return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(n)), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+// permute4x64 immediate exchanging lane l with lane l ^ J.
+template <std::size_t J>
+inline constexpr int avx2_swap64_imm = int((0 ^ J) | ((1 ^ J) << 2) | ((2 ^ J) << 4) | ((3 ^ J) << 6));
+
+// Widens a 4-lane blend mask into the equivalent 8-lane (32-bit) mask.
+template <unsigned M>
+inline constexpr int avx2_widen_mask =
+    int(((M & 1u) ? 0x03u : 0u) | ((M & 2u) ? 0x0Cu : 0u) | ((M & 4u) ? 0x30u : 0u) | ((M & 8u) ? 0xC0u : 0u));
+
+template <class T>
+struct avx2_traits;
+
+template <>
+struct avx2_traits<std::int32_t> {
+    using value_type = std::int32_t;
+    using reg = __m256i;
+    static constexpr std::size_t width = 8;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        const __m256i mask = avx2_lanes32(n);
+        return _mm256_blendv_epi8(_mm256_set1_epi32(sort_pad_value<value_type>), _mm256_maskload_epi32(p, mask), mask);
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm256_maskstore_epi32(p, avx2_lanes32(n), v);
+    }
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) {
+        const __m256i idx = _mm256_xor_si256(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(J));
+        return _mm256_permutevar8x32_epi32(v, idx);
+    }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm256_blend_epi32(lo, hi, int(M)); }
+};
+
+template <>
+struct avx2_traits<float> {
+    using value_type = float;
+    using reg = __m256;
+    static constexpr std::size_t width = 8;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm256_loadu_ps(p); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm256_storeu_ps(p, v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        const __m256i mask = avx2_lanes32(n);
+        return _mm256_blendv_ps(_mm256_set1_ps(sort_pad_value<value_type>), _mm256_maskload_ps(p, mask),
+                                _mm256_castsi256_ps(mask));
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm256_maskstore_ps(p, avx2_lanes32(n), v);
+    }
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) {
+        const __m256i idx = _mm256_xor_si256(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(J));
+        return _mm256_permutevar8x32_ps(v, idx);
+    }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm256_blend_ps(lo, hi, int(M)); }
+};
+
+template <>
+struct avx2_traits<std::int64_t> {
+    using value_type = std::int64_t;
+    using reg = __m256i;
+    static constexpr std::size_t width = 4;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        const __m256i mask = avx2_lanes64(n);
+        return _mm256_blendv_epi8(_mm256_set1_epi64x(sort_pad_value<value_type>),
+                                  _mm256_maskload_epi64(reinterpret_cast<const long long*>(p), mask), mask);
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm256_maskstore_epi64(reinterpret_cast<long long*>(p), avx2_lanes64(n), v);
+    }
+    // AVX2 has no 64-bit integer min/max; emulate with a compare and a byte blend.
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) { return _mm256_permute4x64_epi64(v, avx2_swap64_imm<J>); }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm256_blend_epi32(lo, hi, avx2_widen_mask<M>); }
+};
+
+template <>
+struct avx2_traits<double> {
+    using value_type = double;
+    using reg = __m256d;
+    static constexpr std::size_t width = 4;
+
+    static EXTL_FORCE_INLINE reg load(const value_type* p) { return _mm256_loadu_pd(p); }
+    static EXTL_FORCE_INLINE void store(value_type* p, reg v) { _mm256_storeu_pd(p, v); }
+    static EXTL_FORCE_INLINE reg load_partial(const value_type* p, std::size_t n) {
+        const __m256i mask = avx2_lanes64(n);
+        return _mm256_blendv_pd(_mm256_set1_pd(sort_pad_value<value_type>), _mm256_maskload_pd(p, mask),
+                                _mm256_castsi256_pd(mask));
+    }
+    static EXTL_FORCE_INLINE void store_partial(value_type* p, reg v, std::size_t n) {
+        _mm256_maskstore_pd(p, avx2_lanes64(n), v);
+    }
+    static EXTL_FORCE_INLINE reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    static EXTL_FORCE_INLINE reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    template <std::size_t J>
+    static EXTL_FORCE_INLINE reg swap(reg v) { return _mm256_permute4x64_pd(v, avx2_swap64_imm<J>); }
+    template <unsigned M>
+    static EXTL_FORCE_INLINE reg blend(reg lo, reg hi) { return _mm256_blend_pd(lo, hi, int(M)); }
+};
+
+template <class T>
+using simd_sort_traits = avx2_traits<T>;
+
+#endif
+
+// ---------------------------------------------------------------------------------------
+// Register-resident bitonic network
+// ---------------------------------------------------------------------------------------
+template <class V, std::size_t R>
+struct bitonic_network {
+    using value_type = typename V::value_type;
+    using reg = typename V::reg;
+    static constexpr std::size_t width = V::width;
+    static constexpr std::size_t size = R * width;
+
+    static_assert((R & (R - 1)) == 0, "register count must be a power of two");
+
+    // Sorts data[0, n) for 0 < n <= size.
+    static EXTL_FORCE_INLINE void sort(value_type* data, std::size_t n) {
+        reg r[R];
+        for_each_reg([&]<std::size_t A>() {
+            if constexpr (A == 0) {
+                r[A] = n >= width ? V::load(data) : V::load_partial(data, n);
+            } else {
+                const std::size_t base = A * width;
+                if (n >= base + width)
+                    r[A] = V::load(data + base);
+                else if (n > base)
+                    r[A] = V::load_partial(data + base, n - base);
+                else
+                    r[A] = V::load_partial(data, 0);
+            }
+        });
+
+        merge<2>(r);
+
+        for_each_reg([&]<std::size_t A>() {
+            const std::size_t base = A * width;
+            if (n >= base + width)
+                V::store(data + base, r[A]);
+            else if (n > base)
+                V::store_partial(data + base, r[A], n - base);
+        });
+    }
+
+private:
+    template <class F>
+    static EXTL_FORCE_INLINE void for_each_reg(F&& f) {
+        [&]<std::size_t... A>(std::index_sequence<A...>) {
+            (f.template operator()<A>(), ...);
+        }(std::make_index_sequence<R>{});
+    }
+
+    // Blend mask for register A at step (K, J < width): lane l keeps the larger value when it is the
+    // upper element of an ascending pair or the lower element of a descending pair.
+    template <std::size_t K, std::size_t J, std::size_t A>
+    static constexpr unsigned lane_mask() {
+        unsigned mask = 0;
+        for (std::size_t l = 0; l < width; ++l) {
+            const bool upper = (l & J) != 0;
+            const bool descending = ((A * width + l) & K) != 0;
+            if (upper != descending)
+                mask |= 1u << l;
+        }
+        return mask;
+    }
+
+    template <std::size_t K, std::size_t J>
+    static EXTL_FORCE_INLINE void step(reg* r) {
+        if constexpr (J >= width) {
+            constexpr std::size_t d = J / width;
+            for_each_reg([&]<std::size_t A>() {
+                if constexpr ((A & d) == 0) {
+                    // Operands of max are swapped so a NaN never duplicates one input and drops the other.
+                    const reg lo = V::min(r[A], r[A | d]);
+                    const reg hi = V::max(r[A | d], r[A]);
+                    if constexpr (((A * width) & K) == 0) {
+                        r[A] = lo;
+                        r[A | d] = hi;
+                    } else {
+                        r[A] = hi;
+                        r[A | d] = lo;
+                    }
+                }
+            });
+        } else {
+            for_each_reg([&]<std::size_t A>() {
+                const reg other = V::template swap<J>(r[A]);
+                r[A] = V::template blend<lane_mask<K, J, A>()>(V::min(r[A], other), V::max(r[A], other));
+            });
+        }
+    }
+
+    template <std::size_t K, std::size_t J>
+    static EXTL_FORCE_INLINE void stages(reg* r) {
+        step<K, J>(r);
+        if constexpr (J > 1)
+            stages<K, J / 2>(r);
+    }
+
+    template <std::size_t K>
+    static EXTL_FORCE_INLINE void merge(reg* r) {
+        stages<K, K / 2>(r);
+        if constexpr (K < size)
+            merge<K * 2>(r);
+    }
+};
+
+// ---------------------------------------------------------------------------------------
+// Scalar bitonic network
+// Used when no SIMD kernel is available. Compare-exchanges are written as min/max selects so the
+// compiler emits conditional moves instead of data-dependent branches.
+// ---------------------------------------------------------------------------------------
+template <class T>
+inline void scalar_bitonic_sort(T* data, std::size_t n, std::size_t size) {
+    T buffer[128];
+    for (std::size_t i = 0; i < n; ++i)
+        buffer[i] = data[i];
+    for (std::size_t i = n; i < size; ++i)
+        buffer[i] = sort_pad_value<T>;
+
+    for (std::size_t k = 2; k <= size; k *= 2) {
+        for (std::size_t j = k / 2; j > 0; j /= 2) {
+            for (std::size_t i = 0; i < size; ++i) {
+                const std::size_t l = i ^ j;
+                if (l > i) {
+                    const T a = buffer[i];
+                    const T b = buffer[l];
+                    const T lo = b < a ? b : a;
+                    const T hi = b < a ? a : b;
+                    const bool descending = (i & k) != 0;
+                    buffer[i] = descending ? hi : lo;
+                    buffer[l] = descending ? lo : hi;
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < n; ++i)
+        data[i] = buffer[i];
+}
+
+} // namespace extl::detail
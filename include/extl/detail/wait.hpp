@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#include "extl/config.hpp"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace extl::detail {
+
+// ---------------------------------------------------------------------------------------
+// Spinning and blocking helpers for the locks
+// ---------------------------------------------------------------------------------------
+
+// Tells the core we are spin-waiting: saves power and, on SMT cores, yields issue slots to the
+// sibling thread.
+EXTL_FORCE_INLINE void cpu_relax() noexcept {
+#if EXTL_HAS_SSE2
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Exponential backoff for spin-wait loops: each round doubles the pause so that contenders
+// stop hammering the lock's cache line. Past the cap the waiter yields its CPU instead, since by
+// then the holder has most likely been preempted and needs the core to finish.
+class backoff {
+public:
+    void pause() noexcept {
+        if (spins_ > max_spins) {
+            std::this_thread::yield();
+            return;
+        }
+        for (std::uint32_t i = 0; i < spins_; ++i)
+            cpu_relax();
+        spins_ *= 2;
+    }
+
+private:
+    static constexpr std::uint32_t max_spins = 128;
+
+    std::uint32_t spins_ = 1;
+};
+
+// Blocks while word == expected, or returns spuriously. Uses the futex directly on Linux and
+// C++20 atomic waiting elsewhere.
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    word.wait(expected, std::memory_order_relaxed);
+#endif
+}
+
+inline void futex_wake_one(std::atomic<std::uint32_t>& word) noexcept {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    word.notify_one();
+#endif
+}
+
+inline void futex_wake_all(std::atomic<std::uint32_t>& word) noexcept {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    word.notify_all();
+#endif
+}
+
+} // namespace extl::detail
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/bit_ops.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// dynamic_bitset
+// Run-time sized bitset over a cache-line aligned array of 64-bit words. Bits past size() in the
+// last word are always zero, so count() and the bulk operations work on whole words. The
+// in-place &=, |=, ^= and and_not() run 256 or 512 bits per instruction when AVX2 or AVX-512 is
+// enabled; count_and() and friends compute the population of a combination without storing it.
+// ---------------------------------------------------------------------------------------
+class dynamic_bitset {
+public:
+    using word_type = std::uint64_t;
+    using size_type = std::size_t;
+
+    static constexpr size_type bits_per_word = 64;
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    dynamic_bitset() noexcept = default;
+
+    dynamic_bitset(const dynamic_bitset&) = delete;
+    dynamic_bitset& operator=(const dynamic_bitset&) = delete;
+
+    dynamic_bitset(dynamic_bitset&& other) noexcept
+        : words_(std::exchange(other.words_, nullptr)), size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {}
+
+    dynamic_bitset& operator=(dynamic_bitset&& other) noexcept {
+        if (this != &other) {
+            deallocate(words_, alignment);
+            words_ = std::exchange(other.words_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~dynamic_bitset() { deallocate(words_, alignment); }
+
+    // Creates a bitset of n bits, all equal to value.
+    static expected<dynamic_bitset, errc> create(size_type n, bool value = false) noexcept {
+        dynamic_bitset bits;
+        if (auto result = bits.try_resize(n, value); !result)
+            return unexpected(result.error());
+        return bits;
+    }
+
+    static expected<dynamic_bitset, errc> copy(const dynamic_bitset& other) noexcept {
+        dynamic_bitset bits;
+        if (auto result = bits.reallocate(other.word_count()); !result)
+            return unexpected(result.error());
+        std::memcpy(bits.words_, other.words_, other.word_count() * sizeof(word_type));
+        bits.size_ = other.size_;
+        return bits;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type word_count() const noexcept { return words_for(size_); }
+
+    // The underlying words, least significant bit first. Writers must keep the bits past size()
+    // in the last word zero.
+    std::span<word_type> words() noexcept { return {words_, word_count()}; }
+    std::span<const word_type> words() const noexcept { return {words_, word_count()}; }
+
+    bool test(size_type i) const noexcept {
+        EXTL_ASSERT(i < size_);
+        return (words_[i / bits_per_word] >> (i % bits_per_word)) & 1;
+    }
+    bool operator[](size_type i) const noexcept { return test(i); }
+
+    void set(size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        words_[i / bits_per_word] |= bit(i);
+    }
+    void set(size_type i, bool value) noexcept {
+        EXTL_ASSERT(i < size_);
+        word_type& w = words_[i / bits_per_word];
+        w = (w & ~bit(i)) | (word_type(value) << (i % bits_per_word));
+    }
+    void reset(size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        words_[i / bits_per_word] &= ~bit(i);
+    }
+    void flip(size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        words_[i / bits_per_word] ^= bit(i);
+    }
+
+    void set() noexcept {
+        std::fill_n(words_, word_count(), ~word_type(0));
+        clear_tail();
+    }
+    void reset() noexcept { std::fill_n(words_, word_count(), word_type(0)); }
+    void flip() noexcept {
+        for (size_type i = 0, n = word_count(); i < n; ++i)
+            words_[i] = ~words_[i];
+        clear_tail();
+    }
+
+    size_type count() const noexcept { return static_cast<size_type>(detail::popcount(words_, word_count())); }
+    bool any() const noexcept { return find_first() != npos; }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == size_; }
+
+    // Index of the first set bit, or npos.
+    size_type find_first() const noexcept { return scan_from(0); }
+
+    // Index of the first set bit after pos, or npos.
+    size_type find_next(size_type pos) const noexcept {
+        if (pos >= size_ || ++pos == size_)
+            return npos;
+        const size_type w = pos / bits_per_word;
+        const word_type rest = words_[w] >> (pos % bits_per_word);
+        if (rest != 0)
+            return pos + static_cast<size_type>(std::countr_zero(rest));
+        return scan_from(w + 1);
+    }
+
+    // Calls f(index) for every set bit in increasing order.
+    template <class F>
+    void for_each_set(F&& f) const {
+        for (size_type w = 0, n = word_count(); w < n; ++w) {
+            for (word_type bits = words_[w]; bits != 0; bits &= bits - 1)
+                f(w * bits_per_word + static_cast<size_type>(std::countr_zero(bits)));
+        }
+    }
+
+    // In-place bulk operations. Precondition: other.size() == size().
+    dynamic_bitset& operator&=(const dynamic_bitset& other) noexcept { return apply<detail::bit_op::and_>(other); }
+    dynamic_bitset& operator|=(const dynamic_bitset& other) noexcept { return apply<detail::bit_op::or_>(other); }
+    dynamic_bitset& operator^=(const dynamic_bitset& other) noexcept { return apply<detail::bit_op::xor_>(other); }
+    // Clears every bit that is set in other.
+    dynamic_bitset& and_not(const dynamic_bitset& other) noexcept { return apply<detail::bit_op::and_not>(other); }
+
+    // Population of a & b, a | b, a ^ b and a & ~b. Precondition: a.size() == b.size().
+    static size_type count_and(const dynamic_bitset& a, const dynamic_bitset& b) noexcept {
+        return count_of<detail::bit_op::and_>(a, b);
+    }
+    static size_type count_or(const dynamic_bitset& a, const dynamic_bitset& b) noexcept {
+        return count_of<detail::bit_op::or_>(a, b);
+    }
+    static size_type count_xor(const dynamic_bitset& a, const dynamic_bitset& b) noexcept {
+        return count_of<detail::bit_op::xor_>(a, b);
+    }
+    static size_type count_and_not(const dynamic_bitset& a, const dynamic_bitset& b) noexcept {
+        return count_of<detail::bit_op::and_not>(a, b);
+    }
+
+    friend bool operator==(const dynamic_bitset& a, const dynamic_bitset& b) noexcept {
+        return a.size_ == b.size_ && std::equal(a.words_, a.words_ + a.word_count(), b.words_);
+    }
+
+    // Resizes to n bits; new bits are set to value.
+    expected<void, errc> try_resize(size_type n, bool value = false) noexcept {
+        const size_type words = words_for(n);
+        if (words > capacity_) {
+            if (n > max_size())
+                return unexpected(errc::length_error);
+            if (auto result = reallocate(std::min(detail::grow_capacity(capacity_, words), max_size() / bits_per_word));
+                !result)
+                return result;
+        }
+        if (n > size_) {
+            const size_type old_words = word_count();
+            if (words > old_words)
+                std::fill(words_ + old_words, words_ + words, value ? ~word_type(0) : word_type(0));
+            if (value && size_ % bits_per_word != 0)
+                words_[size_ / bits_per_word] |= ~word_type(0) << (size_ % bits_per_word);
+        }
+        size_ = n;
+        clear_tail();
+        return {};
+    }
+
+    expected<void, errc> try_push_back(bool value) noexcept {
+        if (auto result = try_resize(size_ + 1); !result)
+            return result;
+        if (value)
+            set(size_ - 1);
+        return {};
+    }
+
+    void clear() noexcept { size_ = 0; }
+
+    static constexpr size_type max_size() noexcept { return npos / 2 - (npos / 2) % bits_per_word; }
+
+private:
+    static constexpr std::size_t alignment = cache_line_size;
+
+    static size_type words_for(size_type bits) noexcept { return (bits + bits_per_word - 1) / bits_per_word; }
+    static word_type bit(size_type i) noexcept { return word_type(1) << (i % bits_per_word); }
+
+    void clear_tail() noexcept {
+        if (size_ % bits_per_word != 0)
+            words_[size_ / bits_per_word] &= ~(~word_type(0) << (size_ % bits_per_word));
+    }
+
+    size_type scan_from(size_type w) const noexcept {
+        for (size_type n = word_count(); w < n; ++w) {
+            if (words_[w] != 0)
+                return w * bits_per_word + static_cast<size_type>(std::countr_zero(words_[w]));
+        }
+        return npos;
+    }
+
+    template <detail::bit_op Op>
+    dynamic_bitset& apply(const dynamic_bitset& other) noexcept {
+        EXTL_ASSERT(other.size_ == size_);
+        detail::bitwise<Op>(words_, words_, other.words_, word_count());
+        return *this;
+    }
+
+    template <detail::bit_op Op>
+    static size_type count_of(const dynamic_bitset& a, const dynamic_bitset& b) noexcept {
+        EXTL_ASSERT(a.size_ == b.size_);
+        return static_cast<size_type>(detail::popcount<Op>(a.words_, b.words_, a.word_count()));
+    }
+
+    expected<void, errc> reallocate(size_type capacity) noexcept {
+        word_type* words = allocate<word_type>(capacity, alignment);
+        if (words == nullptr)
+            return unexpected(errc::out_of_memory);
+        if (words_ != nullptr)
+            std::memcpy(words, words_, word_count() * sizeof(word_type));
+        deallocate(words_, alignment);
+        words_ = words;
+        capacity_ = capacity;
+        return {};
+    }
+
+    word_type* words_ = nullptr;
+    size_type size_ = 0;     // In bits.
+    size_type capacity_ = 0; // In words.
+};
+
+// ---------------------------------------------------------------------------------------
+// rank_select_index
+// Succinct rank/select directory over a dynamic_bitset: one 64-bit running count per 512-bit
+// block (12.5% extra space). rank1 adds at most eight word popcounts to a block count; select1
+// binary-searches the block counts, scans at most eight words and finishes with PDEP when BMI2
+// is available. The index refers to the bitset's words and must be rebuilt after the bitset is
+// modified or resized.
+// ---------------------------------------------------------------------------------------
+class rank_select_index {
+public:
+    using size_type = std::size_t;
+    using word_type = dynamic_bitset::word_type;
+
+    static constexpr size_type npos = dynamic_bitset::npos;
+
+    rank_select_index() noexcept = default;
+
+    rank_select_index(const rank_select_index&) = delete;
+    rank_select_index& operator=(const rank_select_index&) = delete;
+
+    rank_select_index(rank_select_index&& other) noexcept
+        : words_(std::exchange(other.words_, nullptr)), size_(std::exchange(other.size_, 0)),
+          blocks_(std::exchange(other.blocks_, nullptr)), block_count_(std::exchange(other.block_count_, 0)) {}
+
+    rank_select_index& operator=(rank_select_index&& other) noexcept {
+        if (this != &other) {
+            deallocate(blocks_);
+            words_ = std::exchange(other.words_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            blocks_ = std::exchange(other.blocks_, nullptr);
+            block_count_ = std::exchange(other.block_count_, 0);
+        }
+        return *this;
+    }
+
+    ~rank_select_index() { deallocate(blocks_); }
+
+    static expected<rank_select_index, errc> create(const dynamic_bitset& bits) noexcept {
+        const std::span<const word_type> words = bits.words();
+        const size_type block_count = (words.size() + block_words - 1) / block_words;
+        rank_select_index index;
+        index.blocks_ = allocate<std::uint64_t>(block_count + 1);
+        if (index.blocks_ == nullptr)
+            return unexpected(errc::out_of_memory);
+        index.words_ = words.data();
+        index.size_ = bits.size();
+        index.block_count_ = block_count;
+        std::uint64_t running = 0;
+        for (size_type b = 0; b < block_count; ++b) {
+            index.blocks_[b] = running;
+            const size_type first = b * block_words;
+            running += detail::popcount(words.data() + first, std::min(block_words, words.size() - first));
+        }
+        index.blocks_[block_count] = running;
+        return index;
+    }
+
+    size_type size() const noexcept { return size_; }
+    size_type count() const noexcept { return block_count_ == 0 ? 0 : static_cast<size_type>(blocks_[block_count_]); }
+
+    // Number of set bits in [0, i). Precondition: i <= size().
+    size_type rank1(size_type i) const noexcept {
+        EXTL_ASSERT(i <= size_);
+        const size_type w = i / 64;
+        const size_type b = w / block_words;
+        if (b == block_count_)
+            return count();
+        std::uint64_t r = blocks_[b];
+        for (size_type k = b * block_words; k < w; ++k)
+            r += static_cast<std::uint64_t>(std::popcount(words_[k]));
+        if (i % 64 != 0)
+            r += static_cast<std::uint64_t>(std::popcount(words_[w] & ~(~word_type(0) << (i % 64))));
+        return static_cast<size_type>(r);
+    }
+
+    // Number of clear bits in [0, i).
+    size_type rank0(size_type i) const noexcept { return i - rank1(i); }
+
+    // Index of the k-th (0-based) set bit, or npos if there are not that many.
+    size_type select1(size_type k) const noexcept {
+        if (k >= count())
+            return npos;
+        // Last block whose running count is <= k.
+        const std::uint64_t* it = std::upper_bound(blocks_, blocks_ + block_count_, static_cast<std::uint64_t>(k));
+        const size_type b = static_cast<size_type>(it - blocks_) - 1;
+        std::uint64_t remaining = k - blocks_[b];
+        for (size_type w = b * block_words;; ++w) {
+            const auto c = static_cast<std::uint64_t>(std::popcount(words_[w]));
+            if (remaining < c)
+                return w * 64 + detail::select_in_word(words_[w], static_cast<unsigned>(remaining));
+            remaining -= c;
+        }
+    }
+
+private:
+    static constexpr size_type block_words = 8;
+
+    const word_type* words_ = nullptr;
+    size_type size_ = 0;
+    std::uint64_t* blocks_ = nullptr; // Set bits before each block, plus the total.
+    size_type block_count_ = 0;
+};
+
+} // namespace extl
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#include "extl/config.hpp"
+
+namespace extl {
+
+class epoch;
+class epoch_limbo;
+
+// ---------------------------------------------------------------------------------------
+// epoch_node
+// Intrusive hook for objects retired through epoch-based reclamation. Embed it (or derive from
+// it) in the node type; retiring never allocates because the limbo lists are threaded through
+// the hooks.
+// ---------------------------------------------------------------------------------------
+class epoch_node {
+public:
+    using reclaim_fn = void (*)(epoch_node*) noexcept;
+
+    epoch_node() noexcept = default;
+    epoch_node(const epoch_node&) noexcept {}
+    epoch_node& operator=(const epoch_node&) noexcept { return *this; }
+
+    // Epoch the node was retired in. Only meaningful while it is waiting for reclamation.
+    std::uint64_t retired_epoch() const noexcept { return epoch_; }
+
+private:
+    friend class epoch;
+    friend class epoch_limbo;
+
+    epoch_node* next_ = nullptr;
+    reclaim_fn reclaim_ = nullptr;
+    std::uint64_t epoch_ = 0;
+};
+
+namespace detail::epoch {
+
+inline constexpr std::size_t max_threads = 256;
+
+// Retired nodes of one epoch, owned by a single thread.
+struct bag {
+    epoch_node* head = nullptr;
+    std::uint64_t epoch = 0;
+    std::size_t count = 0;
+};
+
+// Per-thread record. The announcement word has a cache line to itself because every epoch
+// advance reads it; the rest is only touched by the owning thread.
+struct alignas(cache_line_size) record {
+    // 0 when not pinned, otherwise (epoch << 1) | 1.
+    std::atomic<std::uint64_t> state{0};
+    std::atomic<bool> claimed{false};
+
+    alignas(cache_line_size) std::uint32_t depth = 0;
+    std::size_t pending = 0;
+    bag bags[3];
+};
+
+struct state {
+    std::atomic<std::uint64_t> global{0};
+    // Records at and after this index have never been claimed, so scans stop here.
+    std::atomic<std::size_t> high_water{0};
+    // Nodes left behind by exited threads, each tagged with its retirement epoch.
+    std::atomic<epoch_node*> orphans{nullptr};
+    record records[max_threads];
+};
+
+// Constant-initialized and never destroyed, so it outlives every thread-exit handler.
+inline constinit state instance;
+
+} // namespace detail::epoch
+
+// ---------------------------------------------------------------------------------------
+// epoch
+// Process-wide epoch-based memory reclamation (Fraser), shared by every lock-free structure.
+//
+// A thread pins the current epoch for the duration of an operation on a shared structure. A
+// node unlinked from the structure is retired rather than freed: it goes to the retiring thread's
+// limbo list for the epoch it was retired in, with the callback that will free it. The global
+// epoch advances only once every pinned thread has announced the current one, so by the time it
+// has advanced twice past a node's retirement no operation that could have seen the node is
+// still running, and the node is reclaimed.
+//
+// Pinning costs a store and a fence on a thread-private cache line; retiring is a push onto a
+// thread-private list. Reclamation is batched: a thread tries to advance the epoch and frees its
+// expired limbo lists after collect_batch retirements. A thread that exits hands its pending nodes
+// to a shared orphan list that any later collect() frees.
+//
+// Each thread that pins claims one of max_threads records on first use and releases it on exit;
+// beyond that many live threads, pin() waits for a record to free up. A pinned thread stalls
+// reclamation for everyone, so guards should not be held across blocking calls.
+// ---------------------------------------------------------------------------------------
+class epoch {
+public:
+    using reclaim_fn = epoch_node::reclaim_fn;
+
+    static constexpr std::size_t max_threads = detail::epoch::max_threads;
+    static constexpr std::size_t collect_batch = 64;
+
+    // RAII pin. Guards nest; only the outermost one announces and withdraws the epoch.
+    class guard {
+    public:
+        guard(guard&& other) noexcept : record_(std::exchange(other.record_, nullptr)) {}
+        guard& operator=(guard&&) = delete;
+
+        ~guard() {
+            if (record_ != nullptr)
+                unpin(*record_);
+        }
+
+        // Hands node to reclamation: reclaim(node) runs once no pinned thread can still reach it.
+        // The node must already be unreachable for operations that start from now on.
+        void retire(epoch_node* node, reclaim_fn reclaim) noexcept {
+            EXTL_ASSERT(record_ != nullptr);
+            node->reclaim_ = reclaim;
+            node->epoch_ = retirement_epoch();
+            detail::epoch::bag& bag = record_->bags[node->epoch_ % 3];
+            if (bag.epoch != node->epoch_) {
+                // The bag last held nodes from three or more epochs ago, which have expired.
+                reclaim_bag(*record_, bag);
+                bag.epoch = node->epoch_;
+            }
+            node->next_ = bag.head;
+            bag.head = node;
+            ++bag.count;
+            ++record_->pending;
+        }
+
+    private:
+        friend class epoch;
+
+        explicit guard(detail::epoch::record& r) noexcept : record_(&r) {}
+
+        detail::epoch::record* record_;
+    };
+
+    [[nodiscard]] static guard pin() noexcept {
+        detail::epoch::record& r = local();
+        if (r.depth++ == 0) {
+            const std::uint64_t e = state().global.load(std::memory_order_relaxed);
+            r.state.store((e << 1) | 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        return guard(r);
+    }
+
+    // Whether the calling thread holds a guard.
+    static bool is_pinned() noexcept { return local().depth != 0; }
+
+    // The global epoch.
+    static std::uint64_t current() noexcept { return state().global.load(std::memory_order_acquire); }
+
+    // Advances the global epoch if every pinned thread has announced the current one. Returns
+    // false if a thread pinned at an older epoch held it back.
+    static bool try_advance() noexcept {
+        auto& s = state();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint64_t e = s.global.load(std::memory_order_relaxed);
+        const std::size_t n = s.high_water.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint64_t announced = s.records[i].state.load(std::memory_order_acquire);
+            if ((announced & 1) != 0 && (announced >> 1) != e)
+                return false;
+        }
+        // Failing means another thread advanced it first.
+        s.global.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Tries to advance the epoch, then frees this thread's expired limbo lists and any expired
+    // orphans. Must not be called while pinned.
+    static void collect() noexcept {
+        detail::epoch::record& r = local();
+        EXTL_ASSERT(r.depth == 0);
+        try_advance();
+        const std::uint64_t e = current();
+        for (auto& bag : r.bags) {
+            if (bag.count != 0 && bag.epoch + 2 <= e)
+                reclaim_bag(r, bag);
+        }
+        collect_orphans(e);
+    }
+
+    // Waits until every operation pinned before the call has finished, then collects. Afterwards
+    // everything this thread retired before the call has been reclaimed. Must not be called while
+    // pinned, and blocks for as long as another thread stays pinned.
+    static void synchronize() noexcept {
+        EXTL_ASSERT(local().depth == 0);
+        const std::uint64_t target = current() + 2;
+        while (current() < target) {
+            if (!try_advance())
+                std::this_thread::yield();
+        }
+        collect();
+    }
+
+private:
+    friend class epoch_limbo;
+
+    static detail::epoch::state& state() noexcept { return detail::epoch::instance; }
+
+    // Epoch to tag a retirement with: read after the caller's unlink, so every thread that
+    // could have seen the node is pinned at this epoch or earlier.
+    static std::uint64_t retirement_epoch() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return state().global.load(std::memory_order_relaxed);
+    }
+
+    static void unpin(detail::epoch::record& r) noexcept {
+        if (--r.depth != 0)
+            return;
+        r.state.store(0, std::memory_order_release);
+        if (r.pending >= collect_batch)
+            collect();
+    }
+
+    static void reclaim_bag(detail::epoch::record& r, detail::epoch::bag& bag) noexcept {
+        epoch_node* n = std::exchange(bag.head, nullptr);
+        r.pending -= bag.count;
+        bag.count = 0;
+        reclaim_chain(n);
+    }
+
+    static void reclaim_chain(epoch_node* n) noexcept {
+        while (n != nullptr) {
+            epoch_node* next = n->next_;
+            n->reclaim_(n);
+            n = next;
+        }
+    }
+
+    // Pushes the chain first..last onto a shared list.
+    static void push_chain(std::atomic<epoch_node*>& list, epoch_node* first, epoch_node* last) noexcept {
+        last->next_ = list.load(std::memory_order_relaxed);
+        while (!list.compare_exchange_weak(last->next_, first, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Takes the whole shared list, reclaims the nodes that expired by epoch e and puts the rest
+    // back. Concurrent callers split the list between them. Returns the number reclaimed.
+    template <class F>
+    static std::size_t collect_list(std::atomic<epoch_node*>& list, std::uint64_t e, F& reclaim) noexcept {
+        if (list.load(std::memory_order_relaxed) == nullptr)
+            return 0;
+        epoch_node* n = list.exchange(nullptr, std::memory_order_acquire);
+        epoch_node* keep_first = nullptr;
+        epoch_node* keep_last = nullptr;
+        std::size_t reclaimed = 0;
+        while (n != nullptr) {
+            epoch_node* next = n->next_;
+            if (n->epoch_ + 2 <= e) {
+                reclaim(n);
+                ++reclaimed;
+            } else {
+                n->next_ = keep_first;
+                keep_first = n;
+                if (keep_last == nullptr)
+                    keep_last = n;
+            }
+            n = next;
+        }
+        if (keep_first != nullptr)
+            push_chain(list, keep_first, keep_last);
+        return reclaimed;
+    }
+
+    static void collect_orphans(std::uint64_t e) noexcept {
+        auto reclaim = [](epoch_node* n) noexcept { n->reclaim_(n); };
+        collect_list(state().orphans, e, reclaim);
+    }
+
+    // Claims a free record for the calling thread, waiting if all of them are taken.
+    static detail::epoch::record& claim() noexcept {
+        auto& s = state();
+        for (;;) {
+            for (std::size_t i = 0; i < max_threads; ++i) {
+                detail::epoch::record& r = s.records[i];
+                bool expected = false;
+                if (!r.claimed.load(std::memory_order_relaxed) &&
+                    r.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    std::size_t high = s.high_water.load(std::memory_order_relaxed);
+                    while (high <= i &&
+                           !s.high_water.compare_exchange_weak(high, i + 1, std::memory_order_release,
+                                                               std::memory_order_relaxed)) {
+                    }
+                    return r;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // On thread exit: pending nodes become orphans and the record is freed for reuse.
+    static void release(detail::epoch::record& r) noexcept {
+        EXTL_ASSERT(r.depth == 0);
+        for (auto& bag : r.bags) {
+            epoch_node* first = std::exchange(bag.head, nullptr);
+            if (first != nullptr) {
+                epoch_node* last = first;
+                while (last->next_ != nullptr)
+                    last = last->next_;
+                push_chain(state().orphans, first, last);
+            }
+            bag.count = 0;
+            bag.epoch = 0;
+        }
+        r.pending = 0;
+        r.claimed.store(false, std::memory_order_release);
+    }
+
+    struct thread_record {
+        detail::epoch::record* record = nullptr;
+        ~thread_record() {
+            if (record != nullptr)
+                release(*record);
+        }
+    };
+
+    static detail::epoch::record& local() noexcept {
+        thread_local thread_record handle;
+        if (EXTL_UNLIKELY(handle.record == nullptr))
+            handle.record = &claim();
+        return *handle.record;
+    }
+};
+
+// ---------------------------------------------------------------------------------------
+// epoch_limbo
+// Shared limbo list for a structure that reclaims its own nodes, for example into a free list or
+// an arena it owns. Unlike guard::retire(), whose per-thread lists may outlive the structure, a
+// structure can drain its epoch_limbo in its destructor once no operation is running on it.
+// ---------------------------------------------------------------------------------------
+class epoch_limbo {
+public:
+    epoch_limbo() noexcept = default;
+    epoch_limbo(const epoch_limbo&) = delete;
+    epoch_limbo& operator=(const epoch_limbo&) = delete;
+
+    ~epoch_limbo() { EXTL_ASSERT(head_.load(std::memory_order_relaxed) == nullptr); }
+
+    // Number of nodes waiting. Approximate while other threads push or collect.
+    std::size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+    // Retires node; the same rules as guard::retire() apply. Call while pinned.
+    void push(epoch_node* node) noexcept {
+        node->epoch_ = epoch::retirement_epoch();
+        epoch::push_chain(head_, node, node);
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Tries to advance the epoch, then calls reclaim(node) for every node whose grace period has
+    // passed. Concurrent collects split the list between them. Returns the number reclaimed.
+    template <class F>
+    std::size_t collect(F&& reclaim) noexcept {
+        epoch::try_advance();
+        const std::size_t reclaimed = epoch::collect_list(head_, epoch::current(), reclaim);
+        size_.fetch_sub(reclaimed, std::memory_order_relaxed);
+        return reclaimed;
+    }
+
+    // Calls reclaim(node) for every node regardless of epoch. Only when no thread can still
+    // reach them, typically from the owner's destructor.
+    template <class F>
+    void drain(F&& reclaim) noexcept {
+        epoch_node* n = head_.exchange(nullptr, std::memory_order_acquire);
+        while (n != nullptr) {
+            epoch_node* next = n->next_;
+            reclaim(n);
+            n = next;
+        }
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<epoch_node*> head_{nullptr};
+    std::atomic<std::size_t> size_{0};
+};
+
+} // namespace extl
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace extl {
+
+// Error codes reported through expected<T, errc> by ExTL containers and utilities.
+enum class errc {
+    out_of_memory = 1, // An allocation failed.
+    length_error,      // A requested size exceeds the container's maximum size.
+    invalid_argument,  // An argument is outside the accepted domain.
+    stale_handle,      // A handle refers to an element that has been erased.
+    corrupt_data,      // Serialized input is truncated or malformed.
+    busy,              // A bounded retry gave up before a concurrent writer finished.
+};
+
+constexpr const char* to_string(errc e) noexcept {
+    switch (e) {
+    case errc::out_of_memory:
+        return "out of memory";
+    case errc::length_error:
+        return "length error";
+    case errc::invalid_argument:
+        return "invalid argument";
+    case errc::stale_handle:
+        return "stale handle";
+    case errc::corrupt_data:
+        return "corrupt data";
+    case errc::busy:
+        return "busy";
+    }
+    return "unknown error";
+}
+
+} // namespace extl
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// unexpected
+// Wraps an error value so it can be returned from a function returning expected<T, E>.
+// ---------------------------------------------------------------------------------------
+template <class E>
+class unexpected {
+public:
+    template <class Err = E>
+        requires std::constructible_from<E, Err> && (!std::same_as<std::remove_cvref_t<Err>, unexpected>)
+    constexpr explicit unexpected(Err&& e) noexcept : error_(std::forward<Err>(e)) {}
+
+    constexpr E& error() & noexcept { return error_; }
+    constexpr const E& error() const& noexcept { return error_; }
+    constexpr E&& error() && noexcept { return std::move(error_); }
+
+    friend constexpr bool operator==(const unexpected& a, const unexpected& b) { return a.error_ == b.error_; }
+
+private:
+    E error_;
+};
+
+template <class E>
+unexpected(E) -> unexpected<E>;
+
+// ---------------------------------------------------------------------------------------
+// expected
+// Holds either a value of type T or an error of type E. Accessing the wrong alternative is a
+// precondition violation checked by EXTL_ASSERT; there is no exception to throw.
+// ---------------------------------------------------------------------------------------
+template <class T, class E>
+class expected {
+public:
+    using value_type = T;
+    using error_type = E;
+
+    constexpr expected() noexcept
+        requires std::default_initializable<T>
+        : value_(), has_value_(true) {}
+
+    template <class U = T>
+        requires std::constructible_from<T, U> && (!std::same_as<std::remove_cvref_t<U>, expected>) &&
+                 (!std::same_as<std::remove_cvref_t<U>, unexpected<E>>)
+    constexpr expected(U&& value) noexcept : value_(std::forward<U>(value)), has_value_(true) {}
+
+    template <class G>
+    constexpr expected(const unexpected<G>& e) noexcept : error_(e.error()), has_value_(false) {}
+    template <class G>
+    constexpr expected(unexpected<G>&& e) noexcept : error_(std::move(e).error()), has_value_(false) {}
+
+    constexpr expected(const expected& other) noexcept
+        requires std::copy_constructible<T> && std::copy_constructible<E>
+        : has_value_(other.has_value_) {
+        if (has_value_)
+            std::construct_at(std::addressof(value_), other.value_);
+        else
+            std::construct_at(std::addressof(error_), other.error_);
+    }
+
+    constexpr expected(expected&& other) noexcept : has_value_(other.has_value_) {
+        if (has_value_)
+            std::construct_at(std::addressof(value_), std::move(other.value_));
+        else
+            std::construct_at(std::addressof(error_), std::move(other.error_));
+    }
+
+    constexpr expected& operator=(const expected& other) noexcept
+        requires std::copy_constructible<T> && std::copy_constructible<E>
+    {
+        if (this != &other) {
+            destroy();
+            std::construct_at(this, other);
+        }
+        return *this;
+    }
+
+    constexpr expected& operator=(expected&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            std::construct_at(this, std::move(other));
+        }
+        return *this;
+    }
+
+    constexpr ~expected() { destroy(); }
+
+    constexpr bool has_value() const noexcept { return has_value_; }
+    constexpr explicit operator bool() const noexcept { return has_value_; }
+
+    constexpr T& value() & noexcept {
+        EXTL_ASSERT(has_value_);
+        return value_;
+    }
+    constexpr const T& value() const& noexcept {
+        EXTL_ASSERT(has_value_);
+        return value_;
+    }
+    constexpr T&& value() && noexcept {
+        EXTL_ASSERT(has_value_);
+        return std::move(value_);
+    }
+
+    constexpr E& error() & noexcept {
+        EXTL_ASSERT(!has_value_);
+        return error_;
+    }
+    constexpr const E& error() const& noexcept {
+        EXTL_ASSERT(!has_value_);
+        return error_;
+    }
+    constexpr E&& error() && noexcept {
+        EXTL_ASSERT(!has_value_);
+        return std::move(error_);
+    }
+
+    constexpr T& operator*() & noexcept { return value(); }
+    constexpr const T& operator*() const& noexcept { return value(); }
+    constexpr T&& operator*() && noexcept { return std::move(*this).value(); }
+    constexpr T* operator->() noexcept { return std::addressof(value()); }
+    constexpr const T* operator->() const noexcept { return std::addressof(value()); }
+
+    template <class U>
+    constexpr T value_or(U&& fallback) const& noexcept {
+        return has_value_ ? value_ : static_cast<T>(std::forward<U>(fallback));
+    }
+    template <class U>
+    constexpr T value_or(U&& fallback) && noexcept {
+        return has_value_ ? std::move(value_) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+private:
+    constexpr void destroy() noexcept {
+        if (has_value_)
+            std::destroy_at(std::addressof(value_));
+        else
+            std::destroy_at(std::addressof(error_));
+    }
+
+    union {
+        T value_;
+        E error_;
+    };
+    bool has_value_;
+};
+
+// ---------------------------------------------------------------------------------------
+// expected<void, E>
+// Result of an operation that either succeeds without a value or fails with an error.
+// ---------------------------------------------------------------------------------------
+template <class E>
+class expected<void, E> {
+public:
+    using value_type = void;
+    using error_type = E;
+
+    constexpr expected() noexcept : has_value_(true) {}
+
+    template <class G>
+    constexpr expected(const unexpected<G>& e) noexcept : error_(e.error()), has_value_(false) {}
+    template <class G>
+    constexpr expected(unexpected<G>&& e) noexcept : error_(std::move(e).error()), has_value_(false) {}
+
+    constexpr expected(const expected& other) noexcept
+        requires std::copy_constructible<E>
+        : has_value_(other.has_value_) {
+        if (!has_value_)
+            std::construct_at(std::addressof(error_), other.error_);
+    }
+
+    constexpr expected(expected&& other) noexcept : has_value_(other.has_value_) {
+        if (!has_value_)
+            std::construct_at(std::addressof(error_), std::move(other.error_));
+    }
+
+    constexpr expected& operator=(const expected& other) noexcept
+        requires std::copy_constructible<E>
+    {
+        if (this != &other) {
+            destroy();
+            std::construct_at(this, other);
+        }
+        return *this;
+    }
+
+    constexpr expected& operator=(expected&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            std::construct_at(this, std::move(other));
+        }
+        return *this;
+    }
+
+    constexpr ~expected() { destroy(); }
+
+    constexpr bool has_value() const noexcept { return has_value_; }
+    constexpr explicit operator bool() const noexcept { return has_value_; }
+
+    constexpr void value() const noexcept { EXTL_ASSERT(has_value_); }
+
+    constexpr E& error() & noexcept {
+        EXTL_ASSERT(!has_value_);
+        return error_;
+    }
+    constexpr const E& error() const& noexcept {
+        EXTL_ASSERT(!has_value_);
+        return error_;
+    }
+    constexpr E&& error() && noexcept {
+        EXTL_ASSERT(!has_value_);
+        return std::move(error_);
+    }
+
+private:
+    constexpr void destroy() noexcept {
+        if (!has_value_)
+            std::destroy_at(std::addressof(error_));
+    }
+
+    union {
+        E error_;
+    };
+    bool has_value_;
+};
+
+} // namespace extl
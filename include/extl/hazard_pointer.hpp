@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+
+namespace extl {
+
+class hazard_pointer;
+
+namespace detail::hazard {
+
+inline constexpr std::size_t max_slots = 1024;
+// Slots a thread keeps for itself after its hazard pointers are destroyed.
+inline constexpr std::size_t cached_slots = 8;
+inline constexpr std::size_t min_scan_threshold = 64;
+
+// Intrusive retirement hook; hazard_pointer_obj_base derives from it.
+struct node {
+    using reclaim_fn = void (*)(node*) noexcept;
+
+    node* next = nullptr;
+    reclaim_fn reclaim = nullptr;
+    // Address a reader would protect, which differs from `this` under multiple inheritance.
+    const void* object = nullptr;
+};
+
+// One hazard pointer. Each sits on its own cache line: the owner stores to it on every protect,
+// and scans from other threads read all of them.
+struct alignas(cache_line_size) slot {
+    std::atomic<const void*> protected_ptr{nullptr};
+    std::atomic<bool> claimed{false};
+};
+
+struct state {
+    // Slots at and after this index have never been claimed, so scans stop here.
+    std::atomic<std::size_t> high_water{0};
+    // Retired objects left behind by exited threads.
+    std::atomic<node*> orphans{nullptr};
+    slot slots[max_slots];
+};
+
+inline constinit state instance;
+
+inline void push_chain(node* first, node* last) noexcept {
+    last->next = instance.orphans.load(std::memory_order_relaxed);
+    while (!instance.orphans.compare_exchange_weak(last->next, first, std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+    }
+}
+
+inline slot* claim_slot() noexcept {
+    for (std::size_t i = 0; i < max_slots; ++i) {
+        slot& s = instance.slots[i];
+        bool expected = false;
+        if (!s.claimed.load(std::memory_order_relaxed) &&
+            s.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            std::size_t high = instance.high_water.load(std::memory_order_relaxed);
+            while (high <= i && !instance.high_water.compare_exchange_weak(high, i + 1, std::memory_order_release,
+                                                                           std::memory_order_relaxed)) {
+            }
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+// Per-thread state: a cache of claimed slots and the list of objects this thread retired.
+struct thread_state {
+    slot* cache[cached_slots];
+    std::size_t cached = 0;
+    node* retired = nullptr;
+    std::size_t retired_count = 0;
+
+    ~thread_state();
+};
+
+inline thread_state& local() noexcept {
+    thread_local thread_state state;
+    return state;
+}
+
+// Scans the hazard pointers and reclaims every object on this thread's list, plus any orphans,
+// that no slot protects. Sorting the snapshot makes the scan O((H + R) log H) for H slots and
+// R retired objects; it runs once R reaches 2H, so at least H objects are freed per scan,
+// reclamation costs O(log H) per object, and at most about 2H objects per thread are waiting.
+inline void scan(thread_state& t) noexcept {
+    // Detach the lists before taking the snapshot. An orphan was unlinked by another thread, and
+    // only a snapshot taken after adopting it is guaranteed to see every reader that could still
+    // hold it. Detaching also lets a reclaim callback retire further objects.
+    node* pending = std::exchange(t.retired, nullptr);
+    t.retired_count = 0;
+    node* orphans = instance.orphans.exchange(nullptr, std::memory_order_acquire);
+
+    const void* hazards[max_slots];
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::size_t n = instance.high_water.load(std::memory_order_acquire);
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const void* p = instance.slots[i].protected_ptr.load(std::memory_order_acquire);
+        if (p != nullptr)
+            hazards[count++] = p;
+    }
+    std::sort(hazards, hazards + count, std::less<const void*>());
+
+    for (node* list : {pending, orphans}) {
+        while (list != nullptr) {
+            node* r = list;
+            list = r->next;
+            if (std::binary_search(hazards, hazards + count, r->object, std::less<const void*>())) {
+                r->next = t.retired;
+                t.retired = r;
+                ++t.retired_count;
+            } else {
+                r->reclaim(r);
+            }
+        }
+    }
+}
+
+// On thread exit the cached slots are released, and whatever is still protected becomes an
+// orphan that the next scan on any thread picks up.
+inline thread_state::~thread_state() {
+    for (std::size_t i = 0; i < cached; ++i)
+        cache[i]->claimed.store(false, std::memory_order_release);
+    if (retired != nullptr)
+        scan(*this);
+    if (retired != nullptr) {
+        node* last = retired;
+        while (last->next != nullptr)
+            last = last->next;
+        push_chain(retired, last);
+    }
+}
+
+inline std::size_t scan_threshold() noexcept {
+    return std::max(min_scan_threshold, 2 * instance.high_water.load(std::memory_order_relaxed));
+}
+
+inline void retire(node* n) noexcept {
+    thread_state& t = local();
+    n->next = t.retired;
+    t.retired = n;
+    if (++t.retired_count >= scan_threshold())
+        scan(t);
+}
+
+} // namespace detail::hazard
+
+// ---------------------------------------------------------------------------------------
+// Hazard pointers
+// Safe memory reclamation for lock-free structures after P2530 (std::hazard_pointer). A reader
+// publishes the address of the object it is about to use in a hazard pointer; a retired object is
+// freed only once no hazard pointer holds its address.
+//
+// Unlike epoch reclamation, a stalled reader only keeps alive the objects it protects, so the
+// amount of unreclaimed memory stays bounded: each thread scans once its retired list reaches
+// twice the number of hazard pointers in use, which also amortizes the scan to O(log H) per
+// object. Retiring never allocates: the list is threaded through hazard_pointer_obj_base.
+//
+// There is one process-wide domain with max_hazard_pointers slots. Threads keep a few slots
+// cached, so making and destroying a hazard_pointer is usually free of shared writes.
+// ---------------------------------------------------------------------------------------
+inline constexpr std::size_t max_hazard_pointers = detail::hazard::max_slots;
+
+// Base class for objects protected by hazard pointers.
+template <class T, class D = std::default_delete<T>>
+class hazard_pointer_obj_base : private detail::hazard::node {
+public:
+    // Hands the object to reclamation: d(object) runs once no hazard pointer protects it. The
+    // object must already be unreachable for readers that start protecting from now on.
+    void retire(D d = D()) noexcept {
+        deleter_ = std::move(d);
+        reclaim = &reclaim_object;
+        object = static_cast<const T*>(this);
+        detail::hazard::retire(this);
+    }
+
+protected:
+    hazard_pointer_obj_base() noexcept = default;
+    hazard_pointer_obj_base(const hazard_pointer_obj_base&) noexcept {}
+    hazard_pointer_obj_base& operator=(const hazard_pointer_obj_base&) noexcept { return *this; }
+    ~hazard_pointer_obj_base() = default;
+
+private:
+    static void reclaim_object(detail::hazard::node* n) noexcept {
+        auto* self = static_cast<hazard_pointer_obj_base*>(n);
+        D d = std::move(self->deleter_);
+        d(static_cast<T*>(self));
+    }
+
+    [[no_unique_address]] D deleter_{};
+};
+
+class hazard_pointer {
+public:
+    // An empty hazard pointer; use make_hazard_pointer() to get one that can protect.
+    hazard_pointer() noexcept = default;
+
+    hazard_pointer(const hazard_pointer&) = delete;
+    hazard_pointer& operator=(const hazard_pointer&) = delete;
+
+    hazard_pointer(hazard_pointer&& other) noexcept : slot_(std::exchange(other.slot_, nullptr)) {}
+    hazard_pointer& operator=(hazard_pointer&& other) noexcept {
+        if (this != &other) {
+            release();
+            slot_ = std::exchange(other.slot_, nullptr);
+        }
+        return *this;
+    }
+
+    ~hazard_pointer() { release(); }
+
+    bool empty() const noexcept { return slot_ == nullptr; }
+
+    // Protects the object src points to and returns it; the result stays valid until the
+    // protection is reset, even if the object is retired meanwhile.
+    template <class T>
+    T* protect(const std::atomic<T*>& src) noexcept {
+        T* p = src.load(std::memory_order_relaxed);
+        while (!try_protect(p, src)) {
+        }
+        return p;
+    }
+
+    // Protects ptr if src still holds it. Otherwise clears the protection, sets ptr to the
+    // current value of src and returns false.
+    template <class T>
+    bool try_protect(T*& ptr, const std::atomic<T*>& src) noexcept {
+        EXTL_ASSERT(!empty());
+        T* p = ptr;
+        // Release, so that a scan that reads this value also sees this thread's earlier use of
+        // whatever the slot protected before: a plain store would not carry that ordering.
+        slot_->protected_ptr.store(p, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptr = src.load(std::memory_order_acquire);
+        if (ptr == p)
+            return true;
+        slot_->protected_ptr.store(nullptr, std::memory_order_release);
+        return false;
+    }
+
+    // Protects ptr, which the caller knows to be safe to access (for example because another
+    // hazard pointer already protects it).
+    template <class T>
+    void reset_protection(const T* ptr) noexcept {
+        EXTL_ASSERT(!empty());
+        slot_->protected_ptr.store(ptr, std::memory_order_release);
+    }
+    void reset_protection(std::nullptr_t = nullptr) noexcept {
+        EXTL_ASSERT(!empty());
+        slot_->protected_ptr.store(nullptr, std::memory_order_release);
+    }
+
+    void swap(hazard_pointer& other) noexcept { std::swap(slot_, other.slot_); }
+
+private:
+    friend expected<hazard_pointer, errc> make_hazard_pointer() noexcept;
+
+    explicit hazard_pointer(detail::hazard::slot* s) noexcept : slot_(s) {}
+
+    void release() noexcept {
+        if (slot_ == nullptr)
+            return;
+        slot_->protected_ptr.store(nullptr, std::memory_order_release);
+        auto& t = detail::hazard::local();
+        if (t.cached < detail::hazard::cached_slots)
+            t.cache[t.cached++] = slot_;
+        else
+            slot_->claimed.store(false, std::memory_order_release);
+        slot_ = nullptr;
+    }
+
+    detail::hazard::slot* slot_ = nullptr;
+};
+
+// Returns a hazard pointer that can protect, or length_error once all max_hazard_pointers
+// slots are in use.
+inline expected<hazard_pointer, errc> make_hazard_pointer() noexcept {
+    auto& t = detail::hazard::local();
+    if (t.cached != 0)
+        return hazard_pointer(t.cache[--t.cached]);
+    detail::hazard::slot* s = detail::hazard::claim_slot();
+    if (s == nullptr)
+        return unexpected(errc::length_error);
+    return hazard_pointer(s);
+}
+
+// Scans now and reclaims every object this thread retired, and every orphan of an exited
+// thread, that no hazard pointer protects.
+inline void hazard_pointer_clean_up() noexcept { detail::hazard::scan(detail::hazard::local()); }
+
+} // namespace extl
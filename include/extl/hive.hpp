@@ -0,0 +1,471 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+template <class T>
+class hive;
+
+namespace detail {
+
+// Links between the erased runs of a hive block, stored in the first slot of each run.
+struct hive_free_link {
+    std::uint16_t prev;
+    std::uint16_t next;
+};
+
+template <class T>
+struct hive_slot {
+    static constexpr std::size_t size = sizeof(T) > sizeof(hive_free_link) ? sizeof(T) : sizeof(hive_free_link);
+    static constexpr std::size_t align = alignof(T) > alignof(hive_free_link) ? alignof(T) : alignof(hive_free_link);
+
+    alignas(align) std::byte bytes[size];
+
+    T* value() noexcept { return std::launder(reinterpret_cast<T*>(bytes)); }
+    hive_free_link* link() noexcept { return std::launder(reinterpret_cast<hive_free_link*>(bytes)); }
+};
+
+// A block of hive storage: header, element slots and a jump-counting skipfield, allocated as one
+// chunk. skip[i] is 0 for a live slot; for a run of erased slots the first and last entry hold
+// the run's length and interior entries are nonzero. skip has one extra zero entry past the end
+// so iteration stops at `size` without a bounds check.
+template <class T>
+struct hive_block {
+    using slot = hive_slot<T>;
+
+    static constexpr std::uint16_t npos = 0xFFFF;
+
+    hive_block* next;
+    hive_block* prev;
+    hive_block* next_erased; // Intrusive list of blocks that have erased runs to reuse.
+    hive_block* prev_erased;
+    slot* slots;
+    std::uint16_t* skip;
+    std::uint16_t capacity;
+    std::uint16_t size; // Slots ever used; slots at and after `size` have never held an element.
+    std::uint16_t live;
+    std::uint16_t free_head; // First slot of the first erased run, or npos.
+
+    static constexpr std::size_t slots_offset() noexcept {
+        return (sizeof(hive_block) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+    }
+    static constexpr std::size_t alignment() noexcept {
+        return alignof(slot) > alignof(hive_block) ? alignof(slot) : alignof(hive_block);
+    }
+    static std::size_t bytes(std::uint16_t capacity) noexcept {
+        return slots_offset() + capacity * sizeof(slot) + (capacity + 1u) * sizeof(std::uint16_t);
+    }
+
+    static hive_block* create(std::uint16_t capacity) noexcept {
+        void* memory = allocate_bytes(bytes(capacity), alignment());
+        if (memory == nullptr)
+            return nullptr;
+        auto* b = ::new (memory) hive_block{};
+        b->slots = reinterpret_cast<slot*>(static_cast<std::byte*>(memory) + slots_offset());
+        b->skip = reinterpret_cast<std::uint16_t*>(b->slots + capacity);
+        std::uninitialized_fill_n(b->skip, capacity + 1u, std::uint16_t(0));
+        b->capacity = capacity;
+        b->free_head = npos;
+        return b;
+    }
+
+    static void destroy(hive_block* b) noexcept {
+        b->~hive_block();
+        deallocate_bytes(b, alignment());
+    }
+
+    T* value(std::size_t i) noexcept { return slots[i].value(); }
+};
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------
+// hive_iterator
+// Bidirectional iterator that skips erased slots with the jump-counting skipfield: each step is
+// O(1) regardless of how many consecutive elements were erased.
+// ---------------------------------------------------------------------------------------
+template <class T, bool Const>
+class hive_iterator {
+    using block = detail::hive_block<std::remove_const_t<T>>;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using iterator_concept = std::bidirectional_iterator_tag;
+    using value_type = std::remove_const_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+    hive_iterator() noexcept = default;
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    hive_iterator(const hive_iterator<T, OtherConst>& other) noexcept : block_(other.block_), index_(other.index_) {}
+
+    reference operator*() const noexcept { return *block_->value(index_); }
+    pointer operator->() const noexcept { return block_->value(index_); }
+
+    hive_iterator& operator++() noexcept {
+        ++index_;
+        index_ += block_->skip[index_];
+        if (index_ == block_->size && block_->next != nullptr) {
+            block_ = block_->next;
+            index_ = block_->skip[0];
+        }
+        return *this;
+    }
+
+    hive_iterator operator++(int) noexcept {
+        hive_iterator copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    hive_iterator& operator--() noexcept {
+        while (true) {
+            if (index_ == 0) {
+                block_ = block_->prev;
+                index_ = block_->size;
+            }
+            --index_;
+            if (block_->skip[index_] == 0)
+                return *this;
+            // index_ is the last slot of an erased run; jump to the slot just before the run.
+            index_ -= block_->skip[index_] - 1u;
+        }
+    }
+
+    hive_iterator operator--(int) noexcept {
+        hive_iterator copy = *this;
+        --*this;
+        return copy;
+    }
+
+    friend bool operator==(const hive_iterator& a, const hive_iterator& b) noexcept {
+        return a.block_ == b.block_ && a.index_ == b.index_;
+    }
+
+private:
+    friend class hive<value_type>;
+    template <class, bool>
+    friend class hive_iterator;
+
+    hive_iterator(block* b, std::size_t index) noexcept : block_(b), index_(index) {}
+
+    block* block_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+// ---------------------------------------------------------------------------------------
+// hive
+// An unordered container with stable element addresses, following the P2596 model (std::hive).
+// Elements live in a chain of blocks whose capacities grow geometrically up to
+// max_block_capacity. Erasing marks the slot in the block's skipfield and threads it onto a
+// free list of erased runs, so erase is O(1) and a later insert reuses the slot. A block that
+// becomes empty is kept as a spare for the next block the hive needs, one at most, so inserts and
+// erases that alternate across a block boundary do not allocate and free each time. Pointers and
+// iterators to an element stay valid until it is erased. Iteration walks the blocks in order and
+// jumps over erased runs in one step.
+// ---------------------------------------------------------------------------------------
+template <class T>
+class hive {
+    using block = detail::hive_block<T>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = hive_iterator<T, false>;
+    using const_iterator = hive_iterator<T, true>;
+
+    static constexpr std::uint16_t min_block_capacity = 8;
+    static constexpr std::uint16_t max_block_capacity = 8192;
+
+    hive() noexcept = default;
+
+    hive(const hive&) = delete;
+    hive& operator=(const hive&) = delete;
+
+    hive(hive&& other) noexcept { steal(other); }
+
+    hive& operator=(hive&& other) noexcept {
+        if (this != &other) {
+            clear();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~hive() { clear(); }
+
+    static expected<hive, errc> copy(const hive& other) noexcept
+        requires std::is_copy_constructible_v<T>
+    {
+        hive result;
+        for (const T& value : other) {
+            if (auto inserted = result.try_insert(value); !inserted)
+                return unexpected(inserted.error());
+        }
+        return result;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    // Total number of slots in all blocks, including the spare.
+    size_type capacity() const noexcept { return capacity_; }
+
+    // Releases the spare block, if any.
+    void trim_capacity() noexcept {
+        if (spare_ != nullptr) {
+            capacity_ -= spare_->capacity;
+            block::destroy(std::exchange(spare_, nullptr));
+        }
+    }
+
+    iterator begin() noexcept { return first_ != nullptr ? iterator(first_, first_->skip[0]) : iterator(); }
+    iterator end() noexcept { return last_ != nullptr ? iterator(last_, last_->size) : iterator(); }
+    const_iterator begin() const noexcept { return const_cast<hive*>(this)->begin(); }
+    const_iterator end() const noexcept { return const_cast<hive*>(this)->end(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    expected<iterator, errc> try_insert(const T& value) noexcept { return try_emplace(value); }
+    expected<iterator, errc> try_insert(T&& value) noexcept { return try_emplace(std::move(value)); }
+
+    template <class... Args>
+    expected<iterator, errc> try_emplace(Args&&... args) noexcept {
+        block* b;
+        std::size_t index;
+        if (erased_ != nullptr) {
+            b = erased_;
+            index = reuse_erased_slot(b);
+        } else if (last_ != nullptr && last_->size < last_->capacity) {
+            b = last_;
+            index = b->size++;
+        } else {
+            b = add_block();
+            if (b == nullptr)
+                return unexpected(errc::out_of_memory);
+            index = b->size++;
+        }
+        std::construct_at(b->value(index), std::forward<Args>(args)...);
+        ++b->live;
+        ++size_;
+        return iterator(b, index);
+    }
+
+    // Erases the element at pos and returns an iterator to the element after it.
+    iterator erase(const_iterator pos) noexcept {
+        block* b = pos.block_;
+        const auto i = static_cast<std::uint16_t>(pos.index_);
+        EXTL_ASSERT(b->skip[i] == 0 && i < b->size);
+
+        std::destroy_at(b->value(i));
+        --size_;
+        if (--b->live == 0) {
+            block* next = b->next;
+            remove_block(b);
+            return next != nullptr ? iterator(next, next->skip[0]) : end();
+        }
+
+        const std::uint16_t run_end = mark_erased(b, i);
+        iterator next(b, run_end + 1u);
+        if (next.index_ == b->size && b->next != nullptr)
+            next = iterator(b->next, b->next->skip[0]);
+        return next;
+    }
+
+    iterator erase(iterator pos) noexcept { return erase(const_iterator(pos)); }
+
+    // Destroys every element and releases all blocks, the spare included.
+    void clear() noexcept {
+        block* b = first_;
+        while (b != nullptr) {
+            block* next = b->next;
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (std::size_t i = b->skip[0]; i < b->size;) {
+                    std::destroy_at(b->value(i));
+                    ++i;
+                    i += b->skip[i];
+                }
+            }
+            block::destroy(b);
+            b = next;
+        }
+        if (spare_ != nullptr)
+            block::destroy(spare_);
+        first_ = last_ = erased_ = spare_ = nullptr;
+        size_ = capacity_ = 0;
+    }
+
+private:
+    block* add_block() noexcept {
+        block* b = std::exchange(spare_, nullptr);
+        if (b == nullptr) {
+            std::size_t capacity = last_ != nullptr ? last_->capacity * 2u : min_block_capacity;
+            capacity = std::clamp<std::size_t>(std::max(capacity, size_ / 2), min_block_capacity, max_block_capacity);
+            b = block::create(static_cast<std::uint16_t>(capacity));
+            if (b == nullptr)
+                return nullptr;
+            capacity_ += b->capacity;
+        }
+        b->next = nullptr;
+        b->prev = last_;
+        if (last_ != nullptr)
+            last_->next = b;
+        else
+            first_ = b;
+        last_ = b;
+        return b;
+    }
+
+    // Unlinks an empty block and keeps it as the spare, resetting its skipfield. With a spare
+    // already there, the smaller of the two is freed.
+    void remove_block(block* b) noexcept {
+        if (b->free_head != block::npos)
+            unlink_erased(b);
+        (b->prev != nullptr ? b->prev->next : first_) = b->next;
+        (b->next != nullptr ? b->next->prev : last_) = b->prev;
+        if (spare_ != nullptr && spare_->capacity >= b->capacity) {
+            capacity_ -= b->capacity;
+            block::destroy(b);
+            return;
+        }
+        std::fill_n(b->skip, b->size, std::uint16_t(0));
+        b->size = 0;
+        b->free_head = block::npos;
+        trim_capacity();
+        spare_ = b;
+    }
+
+    void link_erased(block* b) noexcept {
+        b->prev_erased = nullptr;
+        b->next_erased = erased_;
+        if (erased_ != nullptr)
+            erased_->prev_erased = b;
+        erased_ = b;
+    }
+
+    void unlink_erased(block* b) noexcept {
+        (b->prev_erased != nullptr ? b->prev_erased->next_erased : erased_) = b->next_erased;
+        if (b->next_erased != nullptr)
+            b->next_erased->prev_erased = b->prev_erased;
+    }
+
+    // Free-list maintenance; runs are keyed by their first slot.
+    static void push_run(block* b, std::uint16_t start) noexcept {
+        std::construct_at(b->slots[start].link(), detail::hive_free_link{block::npos, b->free_head});
+        if (b->free_head != block::npos)
+            b->slots[b->free_head].link()->prev = start;
+        b->free_head = start;
+    }
+
+    static void remove_run(block* b, std::uint16_t start) noexcept {
+        const detail::hive_free_link link = *b->slots[start].link();
+        if (link.prev != block::npos)
+            b->slots[link.prev].link()->next = link.next;
+        else
+            b->free_head = link.next;
+        if (link.next != block::npos)
+            b->slots[link.next].link()->prev = link.prev;
+    }
+
+    static void move_run(block* b, std::uint16_t from, std::uint16_t to) noexcept {
+        const detail::hive_free_link link = *b->slots[from].link();
+        std::construct_at(b->slots[to].link(), link);
+        if (link.prev != block::npos)
+            b->slots[link.prev].link()->next = to;
+        else
+            b->free_head = to;
+        if (link.next != block::npos)
+            b->slots[link.next].link()->prev = to;
+    }
+
+    // Marks slot i of b erased, merging with neighbouring runs. Returns the last slot of the run.
+    std::uint16_t mark_erased(block* b, std::uint16_t i) noexcept {
+        std::uint16_t* skip = b->skip;
+        const bool left = i > 0 && skip[i - 1] != 0;
+        const bool right = i + 1u < b->size && skip[i + 1] != 0;
+        const bool had_runs = b->free_head != block::npos;
+
+        std::uint16_t run_end = i;
+        if (!left && !right) {
+            skip[i] = 1;
+            push_run(b, i);
+        } else if (left && !right) {
+            const std::uint16_t length = skip[i - 1] + 1u;
+            skip[i - length + 1] = length;
+            skip[i] = length;
+        } else if (!left && right) {
+            const std::uint16_t length = skip[i + 1] + 1u;
+            run_end = static_cast<std::uint16_t>(i + length - 1);
+            skip[i] = length;
+            skip[run_end] = length;
+            move_run(b, static_cast<std::uint16_t>(i + 1), i);
+        } else {
+            const std::uint16_t left_length = skip[i - 1];
+            const std::uint16_t right_length = skip[i + 1];
+            const auto start = static_cast<std::uint16_t>(i - left_length);
+            const auto length = static_cast<std::uint16_t>(left_length + 1u + right_length);
+            run_end = static_cast<std::uint16_t>(i + right_length);
+            remove_run(b, static_cast<std::uint16_t>(i + 1));
+            skip[start] = length;
+            skip[run_end] = length;
+            skip[i] = 1; // Interior entries only need to be nonzero.
+        }
+
+        if (!had_runs)
+            link_erased(b);
+        return run_end;
+    }
+
+    // Takes the first slot of b's first erased run for a new element and returns its index.
+    std::size_t reuse_erased_slot(block* b) noexcept {
+        std::uint16_t* skip = b->skip;
+        const std::uint16_t start = b->free_head;
+        const std::uint16_t length = skip[start];
+        if (length == 1) {
+            remove_run(b, start);
+        } else {
+            const auto next = static_cast<std::uint16_t>(start + 1);
+            move_run(b, start, next);
+            skip[next] = static_cast<std::uint16_t>(length - 1);
+            skip[start + length - 1] = static_cast<std::uint16_t>(length - 1);
+        }
+        skip[start] = 0;
+        if (b->free_head == block::npos)
+            unlink_erased(b);
+        return start;
+    }
+
+    void steal(hive& other) noexcept {
+        first_ = std::exchange(other.first_, nullptr);
+        last_ = std::exchange(other.last_, nullptr);
+        erased_ = std::exchange(other.erased_, nullptr);
+        spare_ = std::exchange(other.spare_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+    }
+
+    block* first_ = nullptr;
+    block* last_ = nullptr;
+    block* erased_ = nullptr;
+    block* spare_ = nullptr;
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+};
+
+} // namespace extl
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/intrusive/hook_traits.hpp"
+#include "extl/memory.hpp"
+
+namespace extl::intrusive {
+
+// ---------------------------------------------------------------------------------------
+// hash_hook
+// Member hook for intrusive::hash_table. Chains are hlists: each hook points at the link that
+// points at it (a bucket head or the previous hook's next_), so unlinking needs neither the bucket
+// nor a walk. The full hash is cached to skip most key comparisons and to make rehashing cheap.
+// ---------------------------------------------------------------------------------------
+class hash_hook {
+public:
+    hash_hook() noexcept = default;
+    hash_hook(const hash_hook&) noexcept {}
+    hash_hook& operator=(const hash_hook&) noexcept { return *this; }
+    ~hash_hook() { EXTL_ASSERT(!is_linked()); }
+
+    bool is_linked() const noexcept { return pprev_ != nullptr; }
+
+private:
+    template <class U, hash_hook U::*, class, class, class>
+    friend class hash_table;
+    template <class U, hash_hook U::*, class, class, class, bool>
+    friend class hash_table_iterator;
+
+    void link_at(hash_hook** pprev) noexcept {
+        next_ = *pprev;
+        if (next_ != nullptr)
+            next_->pprev_ = &next_;
+        *pprev = this;
+        pprev_ = pprev;
+    }
+
+    void unlink() noexcept {
+        *pprev_ = next_;
+        if (next_ != nullptr)
+            next_->pprev_ = pprev_;
+        next_ = nullptr;
+        pprev_ = nullptr;
+    }
+
+    hash_hook* next_ = nullptr;
+    hash_hook** pprev_ = nullptr;
+    std::size_t hash_ = 0;
+};
+
+template <class T, hash_hook T::*Hook, class KeyOf, class Hash, class KeyEqual>
+class hash_table;
+
+template <class T, hash_hook T::*Hook, class KeyOf, class Hash, class KeyEqual, bool Const>
+class hash_table_iterator {
+    using traits = detail::hook_traits<T, hash_hook, Hook>;
+    using table = hash_table<T, Hook, KeyOf, Hash, KeyEqual>;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    hash_table_iterator() noexcept = default;
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    hash_table_iterator(const hash_table_iterator<T, Hook, KeyOf, Hash, KeyEqual, OtherConst>& other) noexcept
+        : table_(other.table_), node_(other.node_) {}
+
+    reference operator*() const noexcept { return *traits::to_value(node_); }
+    pointer operator->() const noexcept { return traits::to_value(node_); }
+
+    hash_table_iterator& operator++() noexcept {
+        node_ = node_->next_ != nullptr ? node_->next_ : table_->first_after(table_->bucket_of(node_->hash_));
+        return *this;
+    }
+    hash_table_iterator operator++(int) noexcept {
+        hash_table_iterator copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    friend bool operator==(const hash_table_iterator& a, const hash_table_iterator& b) noexcept {
+        return a.node_ == b.node_;
+    }
+
+private:
+    friend class hash_table<T, Hook, KeyOf, Hash, KeyEqual>;
+    template <class U, hash_hook U::*, class, class, class, bool>
+    friend class hash_table_iterator;
+
+    hash_table_iterator(const table* t, hash_hook* node) noexcept : table_(t), node_(node) {}
+
+    const table* table_ = nullptr;
+    hash_hook* node_ = nullptr; // Null for end().
+};
+
+// ---------------------------------------------------------------------------------------
+// hash_table
+// Chained hash table threaded through a hash_hook member of T; KeyOf extracts the key from an
+// element. Inserting and erasing never allocate. The bucket array is the only allocation and is
+// made only by create() and try_rehash(), so the table never resizes behind the caller's back:
+// watch load_factor() and rehash at a point where failure can be handled. Lookups are
+// heterogeneous when Hash and KeyEqual accept other key types. Buckets are a power of two and the
+// hash is spread with a Fibonacci multiply, so weak hashes such as std::hash<int> still scatter.
+// ---------------------------------------------------------------------------------------
+template <class T, hash_hook T::*Hook, class KeyOf,
+          class Hash = std::hash<std::remove_cvref_t<std::invoke_result_t<KeyOf, const T&>>>,
+          class KeyEqual = std::equal_to<>>
+class hash_table {
+    using traits = detail::hook_traits<T, hash_hook, Hook>;
+
+public:
+    using value_type = T;
+    using key_type = std::remove_cvref_t<std::invoke_result_t<KeyOf, const T&>>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using iterator = hash_table_iterator<T, Hook, KeyOf, Hash, KeyEqual, false>;
+    using const_iterator = hash_table_iterator<T, Hook, KeyOf, Hash, KeyEqual, true>;
+
+    hash_table() noexcept = default;
+
+    hash_table(const hash_table&) = delete;
+    hash_table& operator=(const hash_table&) = delete;
+
+    hash_table(hash_table&& other) noexcept { steal(other); }
+
+    hash_table& operator=(hash_table&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~hash_table() { release(); }
+
+    // Creates an empty table with bucket_count rounded up to a power of two (at least 1).
+    static expected<hash_table, errc> create(size_type bucket_count, const Hash& hash = Hash(),
+                                             const KeyEqual& equal = KeyEqual()) noexcept {
+        hash_table table;
+        table.hash_ = hash;
+        table.equal_ = equal;
+        if (auto result = table.try_rehash(bucket_count); !result)
+            return unexpected(result.error());
+        return table;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type bucket_count() const noexcept { return bucket_count_; }
+    float load_factor() const noexcept {
+        return bucket_count_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(bucket_count_);
+    }
+
+    iterator begin() noexcept { return iterator(this, first_after(npos)); }
+    iterator end() noexcept { return iterator(this, nullptr); }
+    const_iterator begin() const noexcept { return const_iterator(this, first_after(npos)); }
+    const_iterator end() const noexcept { return const_iterator(this, nullptr); }
+
+    // Links value unless an element with an equal key is present; returns the element with that
+    // key and whether value was linked. Precondition: bucket_count() > 0.
+    std::pair<iterator, bool> insert_unique(T& value) noexcept {
+        const key_type& key = KeyOf()(std::as_const(value));
+        const size_type h = hash_(key);
+        if (hash_hook* node = find_node(key, h); node != nullptr)
+            return {iterator(this, node), false};
+        return {iterator(this, link(traits::to_hook(value), h, nullptr)), true};
+    }
+
+    // Links value next to any elements with an equal key. Precondition: bucket_count() > 0.
+    iterator insert_equal(T& value) noexcept {
+        const key_type& key = KeyOf()(std::as_const(value));
+        const size_type h = hash_(key);
+        return iterator(this, link(traits::to_hook(value), h, find_node(key, h)));
+    }
+
+    // Unlinks value, which must be in this table, in O(1).
+    void erase(T& value) noexcept {
+        hash_hook* node = traits::to_hook(value);
+        EXTL_ASSERT(node->is_linked());
+        node->unlink();
+        --size_;
+    }
+
+    // Unlinks every element whose key equals key and returns how many there were.
+    template <class K>
+    size_type erase_key(const K& key) noexcept {
+        const size_type h = hash_(key);
+        size_type count = 0;
+        for (hash_hook* node = find_node(key, h); node != nullptr && matches(node, key, h);) {
+            hash_hook* next = node->next_;
+            node->unlink();
+            --size_;
+            ++count;
+            node = next;
+        }
+        return count;
+    }
+
+    template <class K>
+    iterator find(const K& key) noexcept {
+        return iterator(this, find_node(key, hash_(key)));
+    }
+    template <class K>
+    const_iterator find(const K& key) const noexcept {
+        return const_iterator(this, find_node(key, hash_(key)));
+    }
+
+    template <class K>
+    bool contains(const K& key) const noexcept {
+        return find_node(key, hash_(key)) != nullptr;
+    }
+
+    // Number of elements whose key equals key; they are adjacent in iteration order.
+    template <class K>
+    size_type count(const K& key) const noexcept {
+        const size_type h = hash_(key);
+        size_type n = 0;
+        for (hash_hook* node = find_node(key, h); node != nullptr && matches(node, key, h); node = node->next_)
+            ++n;
+        return n;
+    }
+
+    // Iterator to an element known to be in this table.
+    iterator iterator_to(T& value) noexcept { return iterator(this, traits::to_hook(value)); }
+    const_iterator iterator_to(const T& value) const noexcept {
+        return const_iterator(this, const_cast<hash_hook*>(traits::to_hook(value)));
+    }
+
+    // Replaces the bucket array with one of bucket_count rounded up to a power of two (at least
+    // 1) and relinks every element using its cached hash. On failure the table is unchanged.
+    expected<void, errc> try_rehash(size_type bucket_count) noexcept {
+        if (bucket_count > max_bucket_count())
+            return unexpected(errc::length_error);
+        bucket_count = std::bit_ceil(bucket_count == 0 ? size_type(1) : bucket_count);
+        hash_hook** buckets = allocate<hash_hook*>(bucket_count);
+        if (buckets == nullptr)
+            return unexpected(errc::out_of_memory);
+        for (size_type i = 0; i < bucket_count; ++i)
+            buckets[i] = nullptr;
+
+        hash_hook** old_buckets = buckets_;
+        const size_type old_count = bucket_count_;
+        buckets_ = buckets;
+        bucket_count_ = bucket_count;
+        shift_ = std::numeric_limits<size_type>::digits - std::countr_zero(bucket_count);
+        for (size_type i = 0; i < old_count; ++i) {
+            // Relinking in chain order reverses runs of equal keys but keeps them adjacent.
+            for (hash_hook* node = old_buckets[i]; node != nullptr;) {
+                hash_hook* next = node->next_;
+                node->link_at(&buckets_[bucket_of(node->hash_)]);
+                node = next;
+            }
+        }
+        deallocate(old_buckets);
+        return {};
+    }
+
+    // Unlinks every element.
+    void clear() noexcept {
+        for (size_type i = 0; i < bucket_count_; ++i) {
+            for (hash_hook* node = buckets_[i]; node != nullptr;) {
+                hash_hook* next = node->next_;
+                node->next_ = nullptr;
+                node->pprev_ = nullptr;
+                node = next;
+            }
+            buckets_[i] = nullptr;
+        }
+        size_ = 0;
+    }
+
+private:
+    friend iterator;
+    friend const_iterator;
+
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    static constexpr size_type max_bucket_count() noexcept {
+        return std::bit_floor(std::numeric_limits<size_type>::max() / sizeof(hash_hook*));
+    }
+
+    size_type bucket_of(size_type h) const noexcept {
+        if (shift_ >= static_cast<unsigned>(std::numeric_limits<size_type>::digits))
+            return 0;
+        return static_cast<size_type>(h * static_cast<size_type>(0x9E3779B97F4A7C15ull)) >> shift_;
+    }
+
+    // First node in a bucket after `bucket` (or from bucket 0 when bucket is npos).
+    hash_hook* first_after(size_type bucket) const noexcept {
+        for (size_type i = bucket + 1; i < bucket_count_; ++i) {
+            if (buckets_[i] != nullptr)
+                return buckets_[i];
+        }
+        return nullptr;
+    }
+
+    template <class K>
+    bool matches(const hash_hook* node, const K& key, size_type h) const noexcept {
+        return node->hash_ == h && equal_(key, KeyOf()(*traits::to_value(node)));
+    }
+
+    template <class K>
+    hash_hook* find_node(const K& key, size_type h) const noexcept {
+        if (bucket_count_ == 0)
+            return nullptr;
+        for (hash_hook* node = buckets_[bucket_of(h)]; node != nullptr; node = node->next_) {
+            if (matches(node, key, h))
+                return node;
+        }
+        return nullptr;
+    }
+
+    // Links node at the head of its bucket, or right after `after` when given.
+    hash_hook* link(hash_hook* node, size_type h, hash_hook* after) noexcept {
+        EXTL_ASSERT(bucket_count_ > 0);
+        EXTL_ASSERT(!node->is_linked());
+        node->hash_ = h;
+        node->link_at(after != nullptr ? &after->next_ : &buckets_[bucket_of(h)]);
+        ++size_;
+        return node;
+    }
+
+    void steal(hash_table& other) noexcept {
+        buckets_ = std::exchange(other.buckets_, nullptr);
+        bucket_count_ = std::exchange(other.bucket_count_, 0);
+        shift_ = std::exchange(other.shift_, std::numeric_limits<size_type>::digits);
+        size_ = std::exchange(other.size_, 0);
+        hash_ = other.hash_;
+        equal_ = other.equal_;
+    }
+
+    void release() noexcept {
+        clear();
+        deallocate(buckets_);
+        buckets_ = nullptr;
+        bucket_count_ = 0;
+        shift_ = std::numeric_limits<size_type>::digits;
+    }
+
+    hash_hook** buckets_ = nullptr;
+    size_type bucket_count_ = 0; // Zero or a power of two.
+    unsigned shift_ = std::numeric_limits<size_type>::digits;
+    size_type size_ = 0;
+    [[no_unique_address]] Hash hash_{};
+    [[no_unique_address]] KeyEqual equal_{};
+};
+
+} // namespace extl::intrusive
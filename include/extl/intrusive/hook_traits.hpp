@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace extl::intrusive::detail {
+
+// Byte offset of the member hook `Hook` inside T. Only the address of the member is formed, never
+// read, so optimizers fold this to a constant.
+template <class T, class H, H T::*Hook>
+inline std::size_t hook_offset() noexcept {
+    alignas(T) unsigned char storage[sizeof(T)];
+    const T* object = reinterpret_cast<const T*>(storage);
+    return static_cast<std::size_t>(reinterpret_cast<const unsigned char*>(&(object->*Hook)) - storage);
+}
+
+// Maps between an element and its member hook.
+template <class T, class H, H T::*Hook>
+struct hook_traits {
+    static H* to_hook(T& value) noexcept { return &(value.*Hook); }
+    static const H* to_hook(const T& value) noexcept { return &(value.*Hook); }
+
+    static T* to_value(H* hook) noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(hook) - hook_offset<T, H, Hook>());
+    }
+    static const T* to_value(const H* hook) noexcept {
+        return reinterpret_cast<const T*>(reinterpret_cast<const unsigned char*>(hook) - hook_offset<T, H, Hook>());
+    }
+};
+
+} // namespace extl::intrusive::detail
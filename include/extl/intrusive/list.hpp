@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "extl/config.hpp"
+#include "extl/intrusive/hook_traits.hpp"
+
+namespace extl::intrusive {
+
+// ---------------------------------------------------------------------------------------
+// list_hook
+// Member hook for intrusive::list. An object can sit in several lists at once through several
+// hooks. A linked hook must not be copied or moved; unlink it first.
+// ---------------------------------------------------------------------------------------
+class list_hook {
+public:
+    list_hook() noexcept = default;
+    list_hook(const list_hook&) noexcept {}
+    list_hook& operator=(const list_hook&) noexcept { return *this; }
+    ~list_hook() { EXTL_ASSERT(!is_linked()); }
+
+    bool is_linked() const noexcept { return next_ != nullptr; }
+
+    // Removes the hook from whatever list holds it without going through the list. The list's
+    // size() is then stale, so prefer list::erase unless the list is not at hand.
+    void unlink() noexcept {
+        prev_->next_ = next_;
+        next_->prev_ = prev_;
+        next_ = nullptr;
+        prev_ = nullptr;
+    }
+
+private:
+    template <class U, list_hook U::*>
+    friend class list;
+    template <class U, list_hook U::*, bool>
+    friend class list_iterator;
+
+    list_hook* next_ = nullptr;
+    list_hook* prev_ = nullptr;
+};
+
+template <class T, list_hook T::*Hook, bool Const>
+class list_iterator {
+    using traits = detail::hook_traits<T, list_hook, Hook>;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using iterator_concept = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    list_iterator() noexcept = default;
+    explicit list_iterator(list_hook* node) noexcept : node_(node) {}
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    list_iterator(const list_iterator<T, Hook, OtherConst>& other) noexcept : node_(other.node_) {}
+
+    reference operator*() const noexcept { return *traits::to_value(node_); }
+    pointer operator->() const noexcept { return traits::to_value(node_); }
+
+    list_iterator& operator++() noexcept {
+        node_ = node_->next_;
+        return *this;
+    }
+    list_iterator operator++(int) noexcept {
+        list_iterator copy = *this;
+        node_ = node_->next_;
+        return copy;
+    }
+    list_iterator& operator--() noexcept {
+        node_ = node_->prev_;
+        return *this;
+    }
+    list_iterator operator--(int) noexcept {
+        list_iterator copy = *this;
+        node_ = node_->prev_;
+        return copy;
+    }
+
+    friend bool operator==(const list_iterator& a, const list_iterator& b) noexcept { return a.node_ == b.node_; }
+
+private:
+    template <class U, list_hook U::*>
+    friend class list;
+    template <class U, list_hook U::*, bool>
+    friend class list_iterator;
+
+    list_hook* node_ = nullptr;
+};
+
+// ---------------------------------------------------------------------------------------
+// list
+// Circular doubly linked list threaded through a list_hook member of T. The list never owns or
+// allocates: inserting links the caller's object, erasing unlinks it. All operations except
+// clear() are O(1). The list must be empty (or cleared) before its elements are destroyed.
+// ---------------------------------------------------------------------------------------
+template <class T, list_hook T::*Hook>
+class list {
+    using traits = detail::hook_traits<T, list_hook, Hook>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = list_iterator<T, Hook, false>;
+    using const_iterator = list_iterator<T, Hook, true>;
+
+    list() noexcept { reset(); }
+
+    list(const list&) = delete;
+    list& operator=(const list&) = delete;
+
+    list(list&& other) noexcept {
+        reset();
+        splice_back(other);
+    }
+
+    list& operator=(list&& other) noexcept {
+        if (this != &other) {
+            clear();
+            splice_back(other);
+        }
+        return *this;
+    }
+
+    ~list() {
+        clear();
+        root_.next_ = nullptr;
+        root_.prev_ = nullptr;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    iterator begin() noexcept { return iterator(root_.next_); }
+    iterator end() noexcept { return iterator(&root_); }
+    const_iterator begin() const noexcept { return const_iterator(root_.next_); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<list_hook*>(&root_)); }
+
+    T& front() noexcept { return *begin(); }
+    const T& front() const noexcept { return *begin(); }
+    T& back() noexcept { return *iterator(root_.prev_); }
+    const T& back() const noexcept { return *const_iterator(root_.prev_); }
+
+    void push_front(T& value) noexcept { insert(begin(), value); }
+    void push_back(T& value) noexcept { insert(end(), value); }
+
+    // Links value before pos.
+    iterator insert(const_iterator pos, T& value) noexcept {
+        list_hook* node = traits::to_hook(value);
+        EXTL_ASSERT(!node->is_linked());
+        list_hook* next = pos.node_;
+        node->next_ = next;
+        node->prev_ = next->prev_;
+        next->prev_->next_ = node;
+        next->prev_ = node;
+        ++size_;
+        return iterator(node);
+    }
+
+    void pop_front() noexcept { erase(front()); }
+    void pop_back() noexcept { erase(back()); }
+
+    // Unlinks value, which must be in this list, and returns the element after it.
+    iterator erase(T& value) noexcept {
+        list_hook* node = traits::to_hook(value);
+        EXTL_ASSERT(node->is_linked());
+        list_hook* next = node->next_;
+        node->unlink();
+        --size_;
+        return iterator(next);
+    }
+
+    iterator erase(const_iterator pos) noexcept { return erase(const_cast<T&>(*pos)); }
+
+    // Iterator to an element known to be in this list.
+    iterator iterator_to(T& value) noexcept { return iterator(traits::to_hook(value)); }
+    const_iterator iterator_to(const T& value) const noexcept {
+        return const_iterator(const_cast<list_hook*>(traits::to_hook(value)));
+    }
+
+    // Moves every element of other to the end of this list in O(1).
+    void splice_back(list& other) noexcept {
+        if (other.empty() || &other == this)
+            return;
+        list_hook* first = other.root_.next_;
+        list_hook* last = other.root_.prev_;
+        first->prev_ = root_.prev_;
+        root_.prev_->next_ = first;
+        last->next_ = &root_;
+        root_.prev_ = last;
+        size_ += other.size_;
+        other.reset();
+    }
+
+    // Unlinks every element.
+    void clear() noexcept {
+        list_hook* node = root_.next_;
+        while (node != &root_) {
+            list_hook* next = node->next_;
+            node->next_ = nullptr;
+            node->prev_ = nullptr;
+            node = next;
+        }
+        reset();
+    }
+
+private:
+    void reset() noexcept {
+        root_.next_ = &root_;
+        root_.prev_ = &root_;
+        size_ = 0;
+    }
+
+    list_hook root_;
+    size_type size_ = 0;
+};
+
+} // namespace extl::intrusive
@@ -0,0 +1,559 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/intrusive/hook_traits.hpp"
+
+namespace extl::intrusive {
+
+// ---------------------------------------------------------------------------------------
+// rbtree_hook
+// Member hook for intrusive::rbtree: three links and a color, with no sentinel nodes, so the
+// root's parent and missing children are null.
+// ---------------------------------------------------------------------------------------
+class rbtree_hook {
+public:
+    rbtree_hook() noexcept = default;
+    rbtree_hook(const rbtree_hook&) noexcept {}
+    rbtree_hook& operator=(const rbtree_hook&) noexcept { return *this; }
+    ~rbtree_hook() { EXTL_ASSERT(!is_linked()); }
+
+    bool is_linked() const noexcept { return color_ != color::unlinked; }
+
+private:
+    template <class U, rbtree_hook U::*, class>
+    friend class rbtree;
+    template <class U, rbtree_hook U::*, class, bool>
+    friend class rbtree_iterator;
+
+    enum class color : unsigned char { unlinked, red, black };
+
+    static rbtree_hook* minimum(rbtree_hook* node) noexcept {
+        while (node->left_ != nullptr)
+            node = node->left_;
+        return node;
+    }
+
+    static rbtree_hook* maximum(rbtree_hook* node) noexcept {
+        while (node->right_ != nullptr)
+            node = node->right_;
+        return node;
+    }
+
+    // In-order successor, or null after the last node.
+    static rbtree_hook* next(rbtree_hook* node) noexcept {
+        if (node->right_ != nullptr)
+            return minimum(node->right_);
+        rbtree_hook* parent = node->parent_;
+        while (parent != nullptr && node == parent->right_) {
+            node = parent;
+            parent = parent->parent_;
+        }
+        return parent;
+    }
+
+    // In-order predecessor, or null before the first node.
+    static rbtree_hook* prev(rbtree_hook* node) noexcept {
+        if (node->left_ != nullptr)
+            return maximum(node->left_);
+        rbtree_hook* parent = node->parent_;
+        while (parent != nullptr && node == parent->left_) {
+            node = parent;
+            parent = parent->parent_;
+        }
+        return parent;
+    }
+
+    rbtree_hook* parent_ = nullptr;
+    rbtree_hook* left_ = nullptr;
+    rbtree_hook* right_ = nullptr;
+    color color_ = color::unlinked;
+};
+
+template <class T, rbtree_hook T::*Hook, class Compare, bool Const>
+class rbtree_iterator {
+    using traits = detail::hook_traits<T, rbtree_hook, Hook>;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using iterator_concept = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    rbtree_iterator() noexcept = default;
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    rbtree_iterator(const rbtree_iterator<T, Hook, Compare, OtherConst>& other) noexcept
+        : node_(other.node_), root_(other.root_) {}
+
+    reference operator*() const noexcept { return *traits::to_value(node_); }
+    pointer operator->() const noexcept { return traits::to_value(node_); }
+
+    rbtree_iterator& operator++() noexcept {
+        node_ = rbtree_hook::next(node_);
+        return *this;
+    }
+    rbtree_iterator operator++(int) noexcept {
+        rbtree_iterator copy = *this;
+        ++*this;
+        return copy;
+    }
+    rbtree_iterator& operator--() noexcept {
+        node_ = node_ == nullptr ? rbtree_hook::maximum(*root_) : rbtree_hook::prev(node_);
+        return *this;
+    }
+    rbtree_iterator operator--(int) noexcept {
+        rbtree_iterator copy = *this;
+        --*this;
+        return copy;
+    }
+
+    friend bool operator==(const rbtree_iterator& a, const rbtree_iterator& b) noexcept {
+        return a.node_ == b.node_;
+    }
+
+private:
+    template <class U, rbtree_hook U::*, class>
+    friend class rbtree;
+    template <class U, rbtree_hook U::*, class, bool>
+    friend class rbtree_iterator;
+
+    rbtree_iterator(rbtree_hook* node, rbtree_hook* const* root) noexcept : node_(node), root_(root) {}
+
+    rbtree_hook* node_ = nullptr;         // Null for end().
+    rbtree_hook* const* root_ = nullptr; // The tree's root slot, so end() can be decremented.
+};
+
+// ---------------------------------------------------------------------------------------
+// rbtree
+// Red-black tree ordered by Compare, threaded through an rbtree_hook member of T. Insertion links
+// the caller's object and never allocates; erase(T&) unlinks in O(log n) without a search. Lookups
+// accept any key that Compare can order against T in both argument orders, so a tree of
+// connections can be searched by id with a transparent comparator. Iterators are invalidated only
+// by erasing the element they point to; end() is invalidated by moving the tree.
+// ---------------------------------------------------------------------------------------
+template <class T, rbtree_hook T::*Hook, class Compare = std::less<>>
+class rbtree {
+    using traits = detail::hook_traits<T, rbtree_hook, Hook>;
+    using color = rbtree_hook::color;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using iterator = rbtree_iterator<T, Hook, Compare, false>;
+    using const_iterator = rbtree_iterator<T, Hook, Compare, true>;
+
+    rbtree() noexcept = default;
+    explicit rbtree(const Compare& comp) noexcept : comp_(comp) {}
+
+    rbtree(const rbtree&) = delete;
+    rbtree& operator=(const rbtree&) = delete;
+
+    rbtree(rbtree&& other) noexcept
+        : root_(std::exchange(other.root_, nullptr)), size_(std::exchange(other.size_, 0)), comp_(other.comp_) {}
+
+    rbtree& operator=(rbtree&& other) noexcept {
+        if (this != &other) {
+            clear();
+            root_ = std::exchange(other.root_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            comp_ = other.comp_;
+        }
+        return *this;
+    }
+
+    ~rbtree() { clear(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    iterator begin() noexcept { return make_iterator(root_ ? rbtree_hook::minimum(root_) : nullptr); }
+    iterator end() noexcept { return make_iterator(nullptr); }
+    const_iterator begin() const noexcept { return const_cast<rbtree&>(*this).begin(); }
+    const_iterator end() const noexcept { return const_cast<rbtree&>(*this).end(); }
+
+    T& front() noexcept { return *begin(); }
+    const T& front() const noexcept { return *begin(); }
+    T& back() noexcept { return *traits::to_value(rbtree_hook::maximum(root_)); }
+    const T& back() const noexcept { return *traits::to_value(rbtree_hook::maximum(root_)); }
+
+    // Links value unless an equivalent element is present; returns the element with that key and
+    // whether value was linked.
+    std::pair<iterator, bool> insert_unique(T& value) noexcept {
+        rbtree_hook* parent = nullptr;
+        rbtree_hook* candidate = nullptr; // Last node not greater than value.
+        bool left = true;
+        for (rbtree_hook* node = root_; node != nullptr;) {
+            parent = node;
+            left = comp_(value, *traits::to_value(node));
+            if (left) {
+                node = node->left_;
+            } else {
+                candidate = node;
+                node = node->right_;
+            }
+        }
+        if (candidate != nullptr && !comp_(*traits::to_value(candidate), value))
+            return {make_iterator(candidate), false};
+        return {make_iterator(link(traits::to_hook(value), parent, left)), true};
+    }
+
+    // Links value after any equivalent elements.
+    iterator insert_equal(T& value) noexcept {
+        rbtree_hook* parent = nullptr;
+        bool left = true;
+        for (rbtree_hook* node = root_; node != nullptr;) {
+            parent = node;
+            left = comp_(value, *traits::to_value(node));
+            node = left ? node->left_ : node->right_;
+        }
+        return make_iterator(link(traits::to_hook(value), parent, left));
+    }
+
+    // Unlinks value, which must be in this tree, and returns the element after it.
+    iterator erase(T& value) noexcept {
+        rbtree_hook* node = traits::to_hook(value);
+        EXTL_ASSERT(node->is_linked());
+        rbtree_hook* next = rbtree_hook::next(node);
+        unlink(node);
+        return make_iterator(next);
+    }
+
+    iterator erase(const_iterator pos) noexcept { return erase(const_cast<T&>(*pos)); }
+
+    // Unlinks every element equivalent to key and returns how many there were.
+    template <class K>
+    size_type erase_key(const K& key) noexcept {
+        size_type count = 0;
+        for (iterator it = lower_bound(key); it != end() && !comp_(key, *it); ++count)
+            it = erase(*it);
+        return count;
+    }
+
+    template <class K>
+    iterator find(const K& key) noexcept {
+        iterator it = lower_bound(key);
+        return it != end() && !comp_(key, *it) ? it : end();
+    }
+    template <class K>
+    const_iterator find(const K& key) const noexcept {
+        return const_cast<rbtree&>(*this).find(key);
+    }
+
+    template <class K>
+    bool contains(const K& key) const noexcept {
+        return find(key) != end();
+    }
+
+    // First element not less than key.
+    template <class K>
+    iterator lower_bound(const K& key) noexcept {
+        rbtree_hook* result = nullptr;
+        for (rbtree_hook* node = root_; node != nullptr;) {
+            if (comp_(*traits::to_value(node), key)) {
+                node = node->right_;
+            } else {
+                result = node;
+                node = node->left_;
+            }
+        }
+        return make_iterator(result);
+    }
+    template <class K>
+    const_iterator lower_bound(const K& key) const noexcept {
+        return const_cast<rbtree&>(*this).lower_bound(key);
+    }
+
+    // First element greater than key.
+    template <class K>
+    iterator upper_bound(const K& key) noexcept {
+        rbtree_hook* result = nullptr;
+        for (rbtree_hook* node = root_; node != nullptr;) {
+            if (comp_(key, *traits::to_value(node))) {
+                result = node;
+                node = node->left_;
+            } else {
+                node = node->right_;
+            }
+        }
+        return make_iterator(result);
+    }
+    template <class K>
+    const_iterator upper_bound(const K& key) const noexcept {
+        return const_cast<rbtree&>(*this).upper_bound(key);
+    }
+
+    // Iterator to an element known to be in this tree.
+    iterator iterator_to(T& value) noexcept { return make_iterator(traits::to_hook(value)); }
+    const_iterator iterator_to(const T& value) const noexcept {
+        return const_cast<rbtree&>(*this).iterator_to(const_cast<T&>(value));
+    }
+
+    // Unlinks every element in O(n) without rebalancing.
+    void clear() noexcept {
+        rbtree_hook* node = root_;
+        while (node != nullptr) {
+            if (node->left_ != nullptr) {
+                node = node->left_;
+            } else if (node->right_ != nullptr) {
+                node = node->right_;
+            } else {
+                rbtree_hook* parent = node->parent_;
+                if (parent != nullptr)
+                    (parent->left_ == node ? parent->left_ : parent->right_) = nullptr;
+                reset(node);
+                node = parent;
+            }
+        }
+        root_ = nullptr;
+        size_ = 0;
+    }
+
+    // Walks the whole tree and checks the red-black invariants: the root is black, no red node
+    // has a red child, and every path down to a missing child passes the same number of black
+    // nodes. Also checks parent links, element order and size(). O(n); for tests and debugging.
+    bool check_invariants() const noexcept {
+        if (root_ == nullptr)
+            return size_ == 0;
+        if (root_->parent_ != nullptr || is_red(root_))
+            return false;
+        size_type count = 0;
+        return black_height(root_, count) != invalid_height && count == size_;
+    }
+
+private:
+    static constexpr std::size_t invalid_height = ~std::size_t{0};
+
+    iterator make_iterator(rbtree_hook* node) noexcept { return iterator(node, &root_); }
+
+    // Black nodes on each path from node down to a missing child, or invalid_height if the
+    // subtree breaks an invariant. count accumulates the nodes visited.
+    std::size_t black_height(const rbtree_hook* node, size_type& count) const noexcept {
+        if (node == nullptr)
+            return 0;
+        ++count;
+        if (node->color_ == color::unlinked)
+            return invalid_height;
+        const T& value = *traits::to_value(node);
+        const rbtree_hook* left = node->left_;
+        const rbtree_hook* right = node->right_;
+        if (left != nullptr &&
+            (left->parent_ != node || (is_red(node) && is_red(left)) || comp_(value, *traits::to_value(left))))
+            return invalid_height;
+        if (right != nullptr &&
+            (right->parent_ != node || (is_red(node) && is_red(right)) || comp_(*traits::to_value(right), value)))
+            return invalid_height;
+        const std::size_t left_height = black_height(left, count);
+        const std::size_t right_height = black_height(right, count);
+        if (left_height == invalid_height || left_height != right_height)
+            return invalid_height;
+        return left_height + (is_red(node) ? 0 : 1);
+    }
+
+    static bool is_red(const rbtree_hook* node) noexcept { return node != nullptr && node->color_ == color::red; }
+
+    static void reset(rbtree_hook* node) noexcept {
+        node->parent_ = nullptr;
+        node->left_ = nullptr;
+        node->right_ = nullptr;
+        node->color_ = color::unlinked;
+    }
+
+    rbtree_hook* link(rbtree_hook* node, rbtree_hook* parent, bool left) noexcept {
+        EXTL_ASSERT(!node->is_linked());
+        node->parent_ = parent;
+        node->left_ = nullptr;
+        node->right_ = nullptr;
+        node->color_ = color::red;
+        if (parent == nullptr)
+            root_ = node;
+        else
+            (left ? parent->left_ : parent->right_) = node;
+        ++size_;
+        insert_fixup(node);
+        return node;
+    }
+
+    // Replaces the subtree rooted at u with the one rooted at v.
+    void transplant(rbtree_hook* u, rbtree_hook* v) noexcept {
+        if (u->parent_ == nullptr)
+            root_ = v;
+        else if (u == u->parent_->left_)
+            u->parent_->left_ = v;
+        else
+            u->parent_->right_ = v;
+        if (v != nullptr)
+            v->parent_ = u->parent_;
+    }
+
+    void rotate_left(rbtree_hook* x) noexcept {
+        rbtree_hook* y = x->right_;
+        x->right_ = y->left_;
+        if (y->left_ != nullptr)
+            y->left_->parent_ = x;
+        transplant(x, y);
+        y->left_ = x;
+        x->parent_ = y;
+    }
+
+    void rotate_right(rbtree_hook* x) noexcept {
+        rbtree_hook* y = x->left_;
+        x->left_ = y->right_;
+        if (y->right_ != nullptr)
+            y->right_->parent_ = x;
+        transplant(x, y);
+        y->right_ = x;
+        x->parent_ = y;
+    }
+
+    void insert_fixup(rbtree_hook* z) noexcept {
+        while (is_red(z->parent_)) {
+            rbtree_hook* p = z->parent_;
+            rbtree_hook* g = p->parent_; // Exists: a red node is never the root.
+            if (p == g->left_) {
+                rbtree_hook* uncle = g->right_;
+                if (is_red(uncle)) {
+                    p->color_ = color::black;
+                    uncle->color_ = color::black;
+                    g->color_ = color::red;
+                    z = g;
+                    continue;
+                }
+                if (z == p->right_) {
+                    rotate_left(p);
+                    p = z;
+                }
+                p->color_ = color::black;
+                g->color_ = color::red;
+                rotate_right(g);
+                break;
+            } else {
+                rbtree_hook* uncle = g->left_;
+                if (is_red(uncle)) {
+                    p->color_ = color::black;
+                    uncle->color_ = color::black;
+                    g->color_ = color::red;
+                    z = g;
+                    continue;
+                }
+                if (z == p->left_) {
+                    rotate_right(p);
+                    p = z;
+                }
+                p->color_ = color::black;
+                g->color_ = color::red;
+                rotate_left(g);
+                break;
+            }
+        }
+        root_->color_ = color::black;
+    }
+
+    void unlink(rbtree_hook* z) noexcept {
+        rbtree_hook* x;
+        rbtree_hook* x_parent;
+        color removed = z->color_;
+        if (z->left_ == nullptr) {
+            x = z->right_;
+            x_parent = z->parent_;
+            transplant(z, x);
+        } else if (z->right_ == nullptr) {
+            x = z->left_;
+            x_parent = z->parent_;
+            transplant(z, x);
+        } else {
+            rbtree_hook* y = rbtree_hook::minimum(z->right_);
+            removed = y->color_;
+            x = y->right_;
+            if (y->parent_ == z) {
+                x_parent = y;
+            } else {
+                x_parent = y->parent_;
+                transplant(y, x);
+                y->right_ = z->right_;
+                y->right_->parent_ = y;
+            }
+            transplant(z, y);
+            y->left_ = z->left_;
+            y->left_->parent_ = y;
+            y->color_ = z->color_;
+        }
+        reset(z);
+        --size_;
+        if (removed == color::black)
+            erase_fixup(x, x_parent);
+    }
+
+    // x carries an extra black; it may be null, hence the separate parent.
+    void erase_fixup(rbtree_hook* x, rbtree_hook* parent) noexcept {
+        while (x != root_ && !is_red(x)) {
+            if (x == parent->left_) {
+                rbtree_hook* w = parent->right_;
+                if (is_red(w)) {
+                    w->color_ = color::black;
+                    parent->color_ = color::red;
+                    rotate_left(parent);
+                    w = parent->right_;
+                }
+                if (!is_red(w->left_) && !is_red(w->right_)) {
+                    w->color_ = color::red;
+                    x = parent;
+                    parent = x->parent_;
+                    continue;
+                }
+                if (!is_red(w->right_)) {
+                    w->left_->color_ = color::black;
+                    w->color_ = color::red;
+                    rotate_right(w);
+                    w = parent->right_;
+                }
+                w->color_ = parent->color_;
+                parent->color_ = color::black;
+                w->right_->color_ = color::black;
+                rotate_left(parent);
+            } else {
+                rbtree_hook* w = parent->left_;
+                if (is_red(w)) {
+                    w->color_ = color::black;
+                    parent->color_ = color::red;
+                    rotate_right(parent);
+                    w = parent->left_;
+                }
+                if (!is_red(w->left_) && !is_red(w->right_)) {
+                    w->color_ = color::red;
+                    x = parent;
+                    parent = x->parent_;
+                    continue;
+                }
+                if (!is_red(w->left_)) {
+                    w->right_->color_ = color::black;
+                    w->color_ = color::red;
+                    rotate_left(w);
+                    w = parent->left_;
+                }
+                w->color_ = parent->color_;
+                parent->color_ = color::black;
+                w->left_->color_ = color::black;
+                rotate_right(parent);
+            }
+            x = root_;
+        }
+        if (x != nullptr)
+            x->color_ = color::black;
+    }
+
+    rbtree_hook* root_ = nullptr;
+    size_type size_ = 0;
+    [[no_unique_address]] Compare comp_{};
+};
+
+} // namespace extl::intrusive
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "extl/config.hpp"
+#include "extl/intrusive/hook_traits.hpp"
+
+namespace extl::intrusive {
+
+// ---------------------------------------------------------------------------------------
+// slist_hook
+// Member hook for intrusive::slist: a single pointer per element.
+// ---------------------------------------------------------------------------------------
+class slist_hook {
+public:
+    slist_hook() noexcept = default;
+    slist_hook(const slist_hook&) noexcept {}
+    slist_hook& operator=(const slist_hook&) noexcept { return *this; }
+    ~slist_hook() { EXTL_ASSERT(!is_linked()); }
+
+    bool is_linked() const noexcept { return next_ != nullptr; }
+
+private:
+    template <class U, slist_hook U::*>
+    friend class slist;
+    template <class U, slist_hook U::*, bool>
+    friend class slist_iterator;
+
+    slist_hook* next_ = nullptr;
+};
+
+template <class T, slist_hook T::*Hook, bool Const>
+class slist_iterator {
+    using traits = detail::hook_traits<T, slist_hook, Hook>;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    slist_iterator() noexcept = default;
+    explicit slist_iterator(slist_hook* node) noexcept : node_(node) {}
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    slist_iterator(const slist_iterator<T, Hook, OtherConst>& other) noexcept : node_(other.node_) {}
+
+    reference operator*() const noexcept { return *traits::to_value(node_); }
+    pointer operator->() const noexcept { return traits::to_value(node_); }
+
+    slist_iterator& operator++() noexcept {
+        node_ = node_->next_;
+        return *this;
+    }
+    slist_iterator operator++(int) noexcept {
+        slist_iterator copy = *this;
+        node_ = node_->next_;
+        return copy;
+    }
+
+    friend bool operator==(const slist_iterator& a, const slist_iterator& b) noexcept { return a.node_ == b.node_; }
+
+private:
+    template <class U, slist_hook U::*>
+    friend class slist;
+    template <class U, slist_hook U::*, bool>
+    friend class slist_iterator;
+
+    slist_hook* node_ = nullptr;
+};
+
+// ---------------------------------------------------------------------------------------
+// slist
+// Circular singly linked list threaded through an slist_hook member of T, with a tail pointer
+// so it also works as an O(1) FIFO. Like intrusive::list it never owns or allocates.
+// Erasure goes through the predecessor (erase_after); there is no O(1) erase by value.
+// ---------------------------------------------------------------------------------------
+template <class T, slist_hook T::*Hook>
+class slist {
+    using traits = detail::hook_traits<T, slist_hook, Hook>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = slist_iterator<T, Hook, false>;
+    using const_iterator = slist_iterator<T, Hook, true>;
+
+    slist() noexcept { reset(); }
+
+    slist(const slist&) = delete;
+    slist& operator=(const slist&) = delete;
+
+    slist(slist&& other) noexcept {
+        reset();
+        splice_back(other);
+    }
+
+    slist& operator=(slist&& other) noexcept {
+        if (this != &other) {
+            clear();
+            splice_back(other);
+        }
+        return *this;
+    }
+
+    ~slist() {
+        clear();
+        root_.next_ = nullptr;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    iterator before_begin() noexcept { return iterator(&root_); }
+    iterator begin() noexcept { return iterator(root_.next_); }
+    iterator end() noexcept { return iterator(&root_); }
+    const_iterator before_begin() const noexcept { return const_iterator(const_cast<slist_hook*>(&root_)); }
+    const_iterator begin() const noexcept { return const_iterator(root_.next_); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<slist_hook*>(&root_)); }
+
+    T& front() noexcept { return *begin(); }
+    const T& front() const noexcept { return *begin(); }
+    T& back() noexcept { return *iterator(tail_); }
+    const T& back() const noexcept { return *const_iterator(tail_); }
+
+    void push_front(T& value) noexcept { insert_after(before_begin(), value); }
+    void push_back(T& value) noexcept { insert_after(iterator(tail_), value); }
+    void pop_front() noexcept { erase_after(before_begin()); }
+
+    // Links value after pos (which may be before_begin()).
+    iterator insert_after(const_iterator pos, T& value) noexcept {
+        slist_hook* node = traits::to_hook(value);
+        EXTL_ASSERT(!node->is_linked());
+        slist_hook* prev = pos.node_;
+        node->next_ = prev->next_;
+        prev->next_ = node;
+        if (prev == tail_)
+            tail_ = node;
+        ++size_;
+        return iterator(node);
+    }
+
+    // Unlinks the element after pos and returns the element after the erased one.
+    iterator erase_after(const_iterator pos) noexcept {
+        slist_hook* prev = pos.node_;
+        slist_hook* node = prev->next_;
+        EXTL_ASSERT(node != &root_);
+        prev->next_ = node->next_;
+        if (node == tail_)
+            tail_ = prev;
+        node->next_ = nullptr;
+        --size_;
+        return iterator(prev->next_);
+    }
+
+    // Moves every element of other to the end of this list in O(1).
+    void splice_back(slist& other) noexcept {
+        if (other.empty() || &other == this)
+            return;
+        tail_->next_ = other.root_.next_;
+        other.tail_->next_ = &root_;
+        tail_ = other.tail_;
+        size_ += other.size_;
+        other.reset();
+    }
+
+    // Unlinks every element.
+    void clear() noexcept {
+        slist_hook* node = root_.next_;
+        while (node != &root_) {
+            slist_hook* next = node->next_;
+            node->next_ = nullptr;
+            node = next;
+        }
+        reset();
+    }
+
+private:
+    void reset() noexcept {
+        root_.next_ = &root_;
+        tail_ = &root_;
+        size_ = 0;
+    }
+
+    slist_hook root_;
+    slist_hook* tail_ = &root_;
+    size_type size_ = 0;
+};
+
+} // namespace extl::intrusive
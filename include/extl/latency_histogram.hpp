@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+namespace detail::hdr {
+
+// Log-linear bucketing. Values below 2^bits each get a bucket of their own; above that, every
+// power-of-two range [2^k, 2^(k+1)) is split into 2^(bits-1) equal buckets, so a bucket is never
+// wider than 2^-(bits-1) times the values it holds.
+inline std::size_t index_of(std::uint64_t value, unsigned bits) noexcept {
+    const unsigned width = static_cast<unsigned>(std::bit_width(value));
+    if (width <= bits)
+        return static_cast<std::size_t>(value);
+    const unsigned shift = width - bits;
+    return (std::size_t{shift} << (bits - 1)) + static_cast<std::size_t>(value >> shift);
+}
+
+inline std::uint64_t lowest_in(std::size_t index, unsigned bits) noexcept {
+    if (index < (std::size_t{1} << bits))
+        return index;
+    const unsigned shift = static_cast<unsigned>(index >> (bits - 1)) - 1;
+    const std::uint64_t top = index - (std::size_t{shift} << (bits - 1));
+    return top << shift;
+}
+
+inline std::uint64_t highest_in(std::size_t index, unsigned bits) noexcept {
+    if (index < (std::size_t{1} << bits))
+        return index;
+    const unsigned shift = static_cast<unsigned>(index >> (bits - 1)) - 1;
+    const std::uint64_t top = index - (std::size_t{shift} << (bits - 1));
+    return ((top + 1) << shift) - 1;
+}
+
+// Sub-bucket bits that keep the relative error within 10^-digits.
+constexpr unsigned bits_for_digits(unsigned digits) noexcept {
+    std::uint64_t needed = 1;
+    for (unsigned i = 0; i < digits; ++i)
+        needed *= 10;
+    return static_cast<unsigned>(std::bit_width(needed - 1)) + 1;
+}
+
+inline constexpr unsigned char magic[4] = {'X', 'H', 'D', 'R'};
+
+inline std::size_t put_varint(unsigned char* out, std::uint64_t v) noexcept {
+    std::size_t n = 0;
+    while (v >= 0x80) {
+        if (out != nullptr)
+            out[n] = static_cast<unsigned char>(v | 0x80);
+        v >>= 7;
+        ++n;
+    }
+    if (out != nullptr)
+        out[n] = static_cast<unsigned char>(v);
+    return n + 1;
+}
+
+inline bool get_varint(const unsigned char*& p, const unsigned char* end, std::uint64_t& v) noexcept {
+    v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (p == end)
+            return false;
+        const std::uint64_t byte = *p++;
+        if (shift == 63 && byte > 1)
+            return false;
+        v |= (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+} // namespace detail::hdr
+
+// ---------------------------------------------------------------------------------------
+// latency_histogram
+// An HDR-style histogram of uint64 samples (typically nanoseconds) with bounded relative error:
+// every recorded value is kept to `significant_digits` decimal digits of precision over the
+// whole range [0, highest_value], using log-linear buckets. With 3 digits and an hour in
+// nanoseconds as the highest value, that is about 33k buckets (260 KiB).
+//
+// record() never allocates or locks: it is a relaxed atomic increment of one bucket plus the
+// running count, sum and extremes, so any number of threads may record concurrently. Queries
+// and serialization may run alongside recording and then see a nearly consistent state; they are
+// exact once recording stops. At very high record rates from many threads, give each thread its
+// own histogram and merge them.
+//
+// Values above highest_value are recorded as highest_value.
+// ---------------------------------------------------------------------------------------
+class latency_histogram {
+public:
+    static constexpr unsigned max_significant_digits = 5;
+
+    latency_histogram(const latency_histogram&) = delete;
+    latency_histogram& operator=(const latency_histogram&) = delete;
+
+    latency_histogram(latency_histogram&& other) noexcept
+        : counts_(std::exchange(other.counts_, nullptr)), bucket_count_(std::exchange(other.bucket_count_, 0)),
+          highest_(other.highest_), digits_(other.digits_), bits_(other.bits_),
+          total_(other.total_.load(std::memory_order_relaxed)), sum_(other.sum_.load(std::memory_order_relaxed)),
+          min_(other.min_.load(std::memory_order_relaxed)), max_(other.max_.load(std::memory_order_relaxed)) {}
+
+    latency_histogram& operator=(latency_histogram&& other) noexcept {
+        if (this != &other) {
+            release();
+            counts_ = std::exchange(other.counts_, nullptr);
+            bucket_count_ = std::exchange(other.bucket_count_, 0);
+            highest_ = other.highest_;
+            digits_ = other.digits_;
+            bits_ = other.bits_;
+            total_.store(other.total_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            sum_.store(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            min_.store(other.min_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            max_.store(other.max_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    ~latency_histogram() { release(); }
+
+    // Fails with invalid_argument unless 1 <= significant_digits <= 5 and highest_value >= 2.
+    static expected<latency_histogram, errc> create(std::uint64_t highest_value,
+                                                    unsigned significant_digits = 3) noexcept {
+        if (significant_digits < 1 || significant_digits > max_significant_digits || highest_value < 2)
+            return unexpected(errc::invalid_argument);
+        const unsigned bits = detail::hdr::bits_for_digits(significant_digits);
+        const std::size_t buckets = detail::hdr::index_of(highest_value, bits) + 1;
+        auto* counts = allocate<std::atomic<std::uint64_t>>(buckets);
+        if (counts == nullptr)
+            return unexpected(errc::out_of_memory);
+        for (std::size_t i = 0; i < buckets; ++i)
+            std::construct_at(counts + i, 0);
+        return latency_histogram(counts, buckets, highest_value, significant_digits, bits);
+    }
+
+    static expected<latency_histogram, errc> copy(const latency_histogram& other) noexcept {
+        auto copied = create(other.highest_, other.digits_);
+        if (copied)
+            copied->merge(other);
+        return copied;
+    }
+
+    void record(std::uint64_t value, std::uint64_t count = 1) noexcept {
+        value = std::min(value, highest_);
+        counts_[detail::hdr::index_of(value, bits_)].fetch_add(count, std::memory_order_relaxed);
+        total_.fetch_add(count, std::memory_order_relaxed);
+        sum_.fetch_add(value * count, std::memory_order_relaxed);
+        std::uint64_t low = min_.load(std::memory_order_relaxed);
+        while (value < low && !min_.compare_exchange_weak(low, value, std::memory_order_relaxed)) {
+        }
+        std::uint64_t high = max_.load(std::memory_order_relaxed);
+        while (value > high && !max_.compare_exchange_weak(high, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::uint64_t count() const noexcept { return total_.load(std::memory_order_relaxed); }
+    // Both 0 while empty.
+    std::uint64_t min() const noexcept { return count() == 0 ? 0 : min_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const noexcept { return max_.load(std::memory_order_relaxed); }
+    double mean() const noexcept {
+        const std::uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / static_cast<double>(n);
+    }
+
+    std::uint64_t highest_value() const noexcept { return highest_; }
+    unsigned significant_digits() const noexcept { return digits_; }
+    std::size_t bucket_count() const noexcept { return bucket_count_; }
+
+    // The range of values that are recorded as indistinguishable from `value`.
+    std::uint64_t lowest_equivalent(std::uint64_t value) const noexcept {
+        return detail::hdr::lowest_in(detail::hdr::index_of(std::min(value, highest_), bits_), bits_);
+    }
+    std::uint64_t highest_equivalent(std::uint64_t value) const noexcept {
+        return detail::hdr::highest_in(detail::hdr::index_of(std::min(value, highest_), bits_), bits_);
+    }
+
+    // The smallest recorded value v such that `percentile` percent of the samples are <= v, reported
+    // as the highest value equivalent to it (but never above max()). 0 when empty.
+    std::uint64_t value_at_percentile(double percentile) const noexcept {
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < bucket_count_; ++i)
+            total += counts_[i].load(std::memory_order_relaxed);
+        if (total == 0)
+            return 0;
+        if (!(percentile > 0.0))
+            return min();
+        // Rounded to the nearest sample so that 99.9% of 10000 is 9990, not 9991 through
+        // floating-point noise.
+        const double fraction = std::min(percentile, 100.0) / 100.0;
+        const auto target = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(fraction * static_cast<double>(total) + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count_; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= target)
+                return std::min(detail::hdr::highest_in(i, bits_), max());
+        }
+        return max();
+    }
+
+    // Calls f(lowest, highest, count) for every non-empty bucket, in increasing order.
+    template <class F>
+    void for_each_bucket(F&& f) const {
+        for (std::size_t i = 0; i < bucket_count_; ++i) {
+            if (const std::uint64_t n = counts_[i].load(std::memory_order_relaxed); n != 0)
+                f(detail::hdr::lowest_in(i, bits_), detail::hdr::highest_in(i, bits_), n);
+        }
+    }
+
+    // Adds other's samples. The histograms may differ in range and precision: each of other's
+    // buckets is re-recorded at its lowest value, clamped to this histogram's highest value, and
+    // other's extremes are clamped into the buckets theirs were re-recorded in.
+    void merge(const latency_histogram& other) noexcept {
+        if (other.count() == 0)
+            return;
+        const auto target = [&](std::size_t i) {
+            return detail::hdr::index_of(std::min(detail::hdr::lowest_in(i, other.bits_), highest_), bits_);
+        };
+        for (std::size_t i = 0; i < other.bucket_count_; ++i) {
+            if (const std::uint64_t n = other.counts_[i].load(std::memory_order_relaxed); n != 0)
+                counts_[target(i)].fetch_add(n, std::memory_order_relaxed);
+        }
+        total_.fetch_add(other.count(), std::memory_order_relaxed);
+        sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // other's extreme v was re-recorded at or below itself, in bucket target(index of v); it can
+        // only lie above that bucket, never below.
+        const auto clamp_extreme = [&](std::uint64_t v) {
+            const std::size_t bucket = target(detail::hdr::index_of(v, other.bits_));
+            return std::min({v, highest_, detail::hdr::highest_in(bucket, bits_)});
+        };
+        const std::uint64_t low = clamp_extreme(other.min());
+        std::uint64_t current = min_.load(std::memory_order_relaxed);
+        while (low < current && !min_.compare_exchange_weak(current, low, std::memory_order_relaxed)) {
+        }
+        const std::uint64_t high = clamp_extreme(other.max());
+        current = max_.load(std::memory_order_relaxed);
+        while (high > current && !max_.compare_exchange_weak(current, high, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Clears the histogram. Records racing with the reset may be partly kept.
+    void reset() noexcept {
+        for (std::size_t i = 0; i < bucket_count_; ++i)
+            counts_[i].store(0, std::memory_order_relaxed);
+        total_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    // ---------------------------------------------------------------------------------------
+    // Serialization
+    // A 4-byte magic followed by LEB128 varints: significant digits, highest value, min, max, sum,
+    // then the bucket counts up to the last non-empty one and a 0 terminator. A non-zero count c
+    // is written as 2c and a run of k empty buckets as 2k + 1, so sparse histograms take a few
+    // bytes per occupied bucket. Byte order independent.
+    // ---------------------------------------------------------------------------------------
+
+    // Size of serialize()'s output while the histogram is not being recorded into.
+    std::size_t serialized_size() const noexcept { return encode(nullptr, std::numeric_limits<std::size_t>::max()); }
+
+    // Writes the histogram and returns the bytes used. Fails with length_error if out is too small,
+    // which can happen despite serialized_size() if records arrive in between.
+    expected<std::size_t, errc> serialize(std::span<std::byte> out) const noexcept {
+        const std::size_t used = encode(reinterpret_cast<unsigned char*>(out.data()), out.size());
+        if (used > out.size())
+            return unexpected(errc::length_error);
+        return used;
+    }
+
+    // Reads serialize()'s output; fails with corrupt_data on truncated or malformed input. Output
+    // taken while records were running may carry extremes that lag the buckets; they are clamped
+    // into the first and last occupied buckets.
+    static expected<latency_histogram, errc> deserialize(std::span<const std::byte> bytes) noexcept {
+        const auto* p = reinterpret_cast<const unsigned char*>(bytes.data());
+        const auto* end = p + bytes.size();
+        if (bytes.size() < sizeof(detail::hdr::magic) ||
+            std::memcmp(p, detail::hdr::magic, sizeof(detail::hdr::magic)) != 0)
+            return unexpected(errc::corrupt_data);
+        p += sizeof(detail::hdr::magic);
+        std::uint64_t digits, highest, low, high, sum;
+        if (!detail::hdr::get_varint(p, end, digits) || !detail::hdr::get_varint(p, end, highest) ||
+            !detail::hdr::get_varint(p, end, low) || !detail::hdr::get_varint(p, end, high) ||
+            !detail::hdr::get_varint(p, end, sum))
+            return unexpected(errc::corrupt_data);
+        if (digits < 1 || digits > max_significant_digits || highest < 2)
+            return unexpected(errc::corrupt_data);
+        auto created = create(highest, static_cast<unsigned>(digits));
+        if (!created)
+            return unexpected(created.error());
+        latency_histogram& h = *created;
+
+        std::uint64_t total = 0;
+        std::size_t index = 0;
+        std::size_t first = 0;
+        std::size_t last = 0;
+        for (;;) {
+            std::uint64_t token;
+            if (!detail::hdr::get_varint(p, end, token))
+                return unexpected(errc::corrupt_data);
+            if (token == 0)
+                break;
+            const std::uint64_t n = token >> 1;
+            if ((token & 1) != 0) {
+                if (n == 0 || n > h.bucket_count_ - index)
+                    return unexpected(errc::corrupt_data);
+                index += static_cast<std::size_t>(n);
+            } else {
+                if (n == 0 || index == h.bucket_count_ || total + n < total)
+                    return unexpected(errc::corrupt_data);
+                if (total == 0)
+                    first = index;
+                last = index;
+                h.counts_[index++].store(n, std::memory_order_relaxed);
+                total += n;
+            }
+        }
+        if (p != end)
+            return unexpected(errc::corrupt_data);
+        h.total_.store(total, std::memory_order_relaxed);
+        h.sum_.store(sum, std::memory_order_relaxed);
+        if (total != 0) {
+            const std::uint64_t first_low = detail::hdr::lowest_in(first, h.bits_);
+            const std::uint64_t first_high = detail::hdr::highest_in(first, h.bits_);
+            const std::uint64_t last_low = detail::hdr::lowest_in(last, h.bits_);
+            const std::uint64_t last_high = std::min(detail::hdr::highest_in(last, h.bits_), highest);
+            h.min_.store(std::clamp(low, first_low, first_high), std::memory_order_relaxed);
+            h.max_.store(std::clamp(high, last_low, last_high), std::memory_order_relaxed);
+        }
+        return created;
+    }
+
+private:
+    latency_histogram(std::atomic<std::uint64_t>* counts, std::size_t buckets, std::uint64_t highest, unsigned digits,
+                      unsigned bits) noexcept
+        : counts_(counts), bucket_count_(buckets), highest_(highest), digits_(digits), bits_(bits) {}
+
+    void release() noexcept {
+        if (counts_ == nullptr)
+            return;
+        std::destroy_n(counts_, bucket_count_);
+        deallocate(counts_);
+        counts_ = nullptr;
+    }
+
+    // Writes into out while it has room and returns the full encoded size; out may be null to
+    // only measure.
+    std::size_t encode(unsigned char* out, std::size_t capacity) const noexcept {
+        std::size_t used = 0;
+        auto put = [&](std::uint64_t v) {
+            const std::size_t n = detail::hdr::put_varint(nullptr, v);
+            if (out != nullptr && used + n <= capacity)
+                detail::hdr::put_varint(out + used, v);
+            used += n;
+        };
+        if (out != nullptr && capacity >= sizeof(detail::hdr::magic))
+            std::memcpy(out, detail::hdr::magic, sizeof(detail::hdr::magic));
+        used += sizeof(detail::hdr::magic);
+        put(digits_);
+        put(highest_);
+        put(min());
+        put(max());
+        put(sum_.load(std::memory_order_relaxed));
+        std::uint64_t empty_run = 0;
+        for (std::size_t i = 0; i < bucket_count_; ++i) {
+            const std::uint64_t n = counts_[i].load(std::memory_order_relaxed);
+            if (n == 0) {
+                ++empty_run;
+                continue;
+            }
+            if (empty_run != 0)
+                put((empty_run << 1) | 1);
+            empty_run = 0;
+            put(n << 1);
+        }
+        put(0);
+        return used;
+    }
+
+    std::atomic<std::uint64_t>* counts_ = nullptr;
+    std::size_t bucket_count_ = 0;
+    std::uint64_t highest_ = 0;
+    unsigned digits_ = 0;
+    unsigned bits_ = 0;
+    std::atomic<std::uint64_t> total_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> min_{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+} // namespace extl
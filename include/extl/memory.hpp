@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// Non-throwing allocation
+// All ExTL containers allocate through these functions. A failed allocation returns nullptr and
+// is turned into errc::out_of_memory by the caller.
+// ---------------------------------------------------------------------------------------
+
+[[nodiscard]] inline void* allocate_bytes(std::size_t bytes, std::size_t alignment) noexcept {
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return ::operator new(bytes, std::nothrow);
+    return ::operator new(bytes, std::align_val_t(alignment), std::nothrow);
+}
+
+inline void deallocate_bytes(void* p, std::size_t alignment) noexcept {
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(p);
+    else
+        ::operator delete(p, std::align_val_t(alignment));
+}
+
+// Allocates uninitialized storage for n objects of type T, or returns nullptr if the allocation
+// fails or n * sizeof(T) overflows.
+template <class T>
+[[nodiscard]] inline T* allocate(std::size_t n, std::size_t alignment = alignof(T)) noexcept {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        return nullptr;
+    return static_cast<T*>(allocate_bytes(n * sizeof(T), alignment));
+}
+
+template <class T>
+inline void deallocate(T* p, std::size_t alignment = alignof(T)) noexcept {
+    if (p != nullptr)
+        deallocate_bytes(p, alignment);
+}
+
+namespace detail {
+
+// Capacity to grow to when `required` elements must fit: at least double the current capacity.
+inline std::size_t grow_capacity(std::size_t current, std::size_t required, std::size_t minimum = 8) noexcept {
+    std::size_t next = current < std::numeric_limits<std::size_t>::max() / 2 ? current * 2 : required;
+    if (next < minimum)
+        next = minimum;
+    return next < required ? required : next;
+}
+
+// Moves n objects from src into uninitialized storage at dst and destroys the originals.
+template <class T>
+inline void relocate(T* src, std::size_t n, T* dst) noexcept {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (n != 0)
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            std::construct_at(dst + i, std::move(src[i]));
+            std::destroy_at(src + i);
+        }
+    }
+}
+
+} // namespace detail
+
+} // namespace extl
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "extl/config.hpp"
+#include "extl/detail/wait.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// adaptive_mutex
+// A sleeping mutex that spins briefly before it blocks. The word is 0 when unlocked, 1 when
+// locked and 2 when locked with possible sleepers (Drepper, "Futexes Are Tricky"), so an
+// uncontended lock and unlock are one atomic each and never enter the kernel.
+//
+// How long to spin adapts per mutex, as with glibc's PTHREAD_MUTEX_ADAPTIVE_NP: a running
+// average of the spins that recent acquisitions needed, so a lock with short critical sections
+// spins long enough to avoid sleeping, and one held for long stops wasting cycles. Not fair:
+// a spinning thread can take the lock ahead of a sleeper that was just woken.
+// ---------------------------------------------------------------------------------------
+class adaptive_mutex {
+public:
+    adaptive_mutex() noexcept = default;
+    adaptive_mutex(const adaptive_mutex&) = delete;
+    adaptive_mutex& operator=(const adaptive_mutex&) = delete;
+
+    void lock() noexcept {
+        std::uint32_t expected = unlocked;
+        if (EXTL_LIKELY(state_.compare_exchange_strong(expected, locked, std::memory_order_acquire,
+                                                       std::memory_order_relaxed)))
+            return;
+        lock_slow();
+    }
+
+    bool try_lock() noexcept {
+        std::uint32_t expected = unlocked;
+        return state_.compare_exchange_strong(expected, locked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        if (state_.exchange(unlocked, std::memory_order_release) == contended)
+            detail::futex_wake_one(state_);
+    }
+
+private:
+    static constexpr std::uint32_t unlocked = 0;
+    static constexpr std::uint32_t locked = 1;
+    static constexpr std::uint32_t contended = 2;
+    static constexpr std::int32_t min_spins = 10;
+    static constexpr std::int32_t max_spins = 100;
+
+    EXTL_NO_INLINE void lock_slow() noexcept {
+        // The estimate is a heuristic: racing updates may lose one, which does no harm.
+        const std::int32_t estimate = spin_estimate_.load(std::memory_order_relaxed);
+        const std::int32_t limit = std::min(max_spins, estimate * 2 + min_spins);
+        for (std::int32_t spins = 0; spins < limit; ++spins) {
+            std::uint32_t s = state_.load(std::memory_order_relaxed);
+            if (s == unlocked &&
+                state_.compare_exchange_weak(s, locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+                spin_estimate_.store(estimate + (spins - estimate) / 8, std::memory_order_relaxed);
+                return;
+            }
+            detail::cpu_relax();
+        }
+        spin_estimate_.store(estimate + (limit - estimate) / 8, std::memory_order_relaxed);
+
+        // Mark the lock contended so that its holder wakes us, then sleep until we get it.
+        // Whoever takes it here keeps it marked, because other sleepers may remain.
+        while (state_.exchange(contended, std::memory_order_acquire) != unlocked)
+            detail::futex_wait(state_, contended);
+    }
+
+    std::atomic<std::uint32_t> state_{unlocked};
+    std::atomic<std::int32_t> spin_estimate_{0};
+};
+
+// ---------------------------------------------------------------------------------------
+// rw_lock
+// A writer-preferring reader-writer lock. Once a writer is waiting, new readers wait too, so a
+// steady stream of readers cannot starve writers; readers that already hold the lock finish
+// first. Pending writers take turns before the readers get back in.
+//
+// One 32-bit word holds the reader count, the number of waiting writers and the writer bit;
+// readers and writers each take and release the lock with one atomic when uncontended. Writers
+// sleep on that word. Readers sleep on a separate generation counter that only writer unlocks
+// bump, so the last reader leaving wakes a writer and nobody else.
+//
+// At most 2^20 - 1 concurrent readers and 2^11 - 1 waiting writers.
+// ---------------------------------------------------------------------------------------
+class rw_lock {
+public:
+    rw_lock() noexcept = default;
+    rw_lock(const rw_lock&) = delete;
+    rw_lock& operator=(const rw_lock&) = delete;
+
+    void lock() noexcept {
+        std::uint32_t expected = 0;
+        if (EXTL_LIKELY(state_.compare_exchange_strong(expected, writer_bit, std::memory_order_acquire,
+                                                       std::memory_order_relaxed)))
+            return;
+        lock_slow();
+    }
+
+    bool try_lock() noexcept {
+        std::uint32_t expected = 0;
+        return state_.compare_exchange_strong(expected, writer_bit, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        const std::uint32_t prev = state_.fetch_and(~writer_bit, std::memory_order_seq_cst);
+        if ((prev & waiting_mask) != 0) {
+            // Hand over to the next writer; readers keep waiting.
+            detail::futex_wake_one(state_);
+            return;
+        }
+        gate_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleeping_readers_.load(std::memory_order_seq_cst) != 0)
+            detail::futex_wake_all(gate_);
+    }
+
+    void lock_shared() noexcept {
+        std::uint32_t s = state_.load(std::memory_order_relaxed);
+        if (EXTL_LIKELY((s & writer_mask) == 0) &&
+            state_.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return;
+        lock_shared_slow();
+    }
+
+    bool try_lock_shared() noexcept {
+        std::uint32_t s = state_.load(std::memory_order_relaxed);
+        while ((s & writer_mask) == 0) {
+            EXTL_ASSERT((s & reader_mask) != reader_mask);
+            if (state_.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    void unlock_shared() noexcept {
+        const std::uint32_t prev = state_.fetch_sub(1, std::memory_order_release);
+        EXTL_ASSERT((prev & reader_mask) != 0);
+        // Only writers sleep on state_, so waking one reaches a writer.
+        if ((prev & reader_mask) == 1 && (prev & waiting_mask) != 0)
+            detail::futex_wake_one(state_);
+    }
+
+private:
+    static constexpr std::uint32_t reader_mask = (1u << 20) - 1;
+    static constexpr std::uint32_t waiting_one = 1u << 20;
+    static constexpr std::uint32_t waiting_mask = ((1u << 11) - 1) << 20;
+    static constexpr std::uint32_t writer_bit = 1u << 31;
+    static constexpr std::uint32_t writer_mask = writer_bit | waiting_mask;
+    static constexpr std::uint32_t max_spins = 100;
+
+    EXTL_NO_INLINE void lock_slow() noexcept {
+        // Announce ourselves first: from here on, no new reader gets in.
+        state_.fetch_add(waiting_one, std::memory_order_relaxed);
+        for (std::uint32_t spins = 0;; ++spins) {
+            std::uint32_t s = state_.load(std::memory_order_relaxed);
+            if ((s & (writer_bit | reader_mask)) == 0) {
+                if (state_.compare_exchange_weak(s, s - waiting_one + writer_bit, std::memory_order_acquire,
+                                                 std::memory_order_relaxed))
+                    return;
+                continue;
+            }
+            if (spins < max_spins)
+                detail::cpu_relax();
+            else
+                detail::futex_wait(state_, s);
+        }
+    }
+
+    EXTL_NO_INLINE void lock_shared_slow() noexcept {
+        for (std::uint32_t spins = 0;; ++spins) {
+            std::uint32_t s = state_.load(std::memory_order_relaxed);
+            if ((s & writer_mask) == 0) {
+                EXTL_ASSERT((s & reader_mask) != reader_mask);
+                if (state_.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+                continue;
+            }
+            if (spins < max_spins) {
+                detail::cpu_relax();
+                continue;
+            }
+            // Register before sampling the generation, and sample it before re-checking the
+            // state: a writer that clears its bits after our check bumps the generation and
+            // sees us registered, so the wait below either returns at once or is woken.
+            sleeping_readers_.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint32_t generation = gate_.load(std::memory_order_seq_cst);
+            if ((state_.load(std::memory_order_seq_cst) & writer_mask) != 0)
+                detail::futex_wait(gate_, generation);
+            sleeping_readers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint32_t> state_{0};
+    std::atomic<std::uint32_t> gate_{0};
+    std::atomic<std::uint32_t> sleeping_readers_{0};
+};
+
+} // namespace extl
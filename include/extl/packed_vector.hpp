@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+// Bits argument of packed_vector selecting a width chosen at run time.
+inline constexpr unsigned dynamic_width = 0;
+
+namespace detail {
+
+// ---------------------------------------------------------------------------------------
+// Bit unpacking
+// Values of `width` bits (1 to 32) are stored back to back, least significant bit first, in an
+// array of 64-bit words followed by packed_padding_words of slack. The slack lets every access
+// use one unaligned 64-bit load (and the vector kernels one full-width load) without bounds
+// checks. Eight values of w bits occupy exactly w bytes, so groups of 8 (AVX2) or 16 (AVX-512)
+// values start on a byte boundary; the kernel loads the group, moves the 32-bit word holding
+// each value's first bit (and the next one) into the value's lane, and shifts it into place.
+// ---------------------------------------------------------------------------------------
+
+inline constexpr std::size_t packed_padding_words = 8;
+
+EXTL_FORCE_INLINE std::uint32_t packed_mask(unsigned width) noexcept {
+    return static_cast<std::uint32_t>((std::uint64_t{1} << width) - 1);
+}
+
+EXTL_FORCE_INLINE std::uint32_t unpack_one(const std::uint64_t* words, unsigned width, std::size_t i) noexcept {
+    const std::size_t bit = i * width;
+    std::uint64_t v;
+    std::memcpy(&v, reinterpret_cast<const unsigned char*>(words) + bit / 8, sizeof v);
+    return static_cast<std::uint32_t>(v >> (bit % 8)) & packed_mask(width);
+}
+
+// out[k] = value first + k for k < count.
+inline void unpack(const std::uint64_t* words, unsigned width, std::size_t first, std::size_t count,
+                   std::uint32_t* out) noexcept {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(words);
+    std::size_t i = first;
+    const std::size_t end = first + count;
+#if EXTL_HAS_AVX512
+    for (; i % 16 != 0 && i < end; ++i)
+        *out++ = unpack_one(words, width, i);
+    if (end - i >= 16) {
+        alignas(64) std::uint32_t lo_index[16], hi_index[16], shift[16], back_shift[16];
+        for (unsigned j = 0; j < 16; ++j) {
+            lo_index[j] = j * width / 32;
+            hi_index[j] = lo_index[j] + 1;
+            shift[j] = j * width % 32;
+            back_shift[j] = 32 - shift[j];
+        }
+        const __m512i lo_idx = _mm512_load_si512(lo_index);
+        const __m512i hi_idx = _mm512_load_si512(hi_index);
+        const __m512i right = _mm512_load_si512(shift);
+        const __m512i left = _mm512_load_si512(back_shift);
+        const __m512i mask = _mm512_set1_epi32(static_cast<int>(packed_mask(width)));
+        // Full-mask forms of permutexvar/srlv/sllv: the unmasked ones pass an undefined source that GCC 12
+        // reports as -Wmaybe-uninitialized.
+        const __mmask16 all = 0xFFFF;
+        for (; end - i >= 16; i += 16, out += 16) {
+            const __m512i v = _mm512_loadu_si512(bytes + i * width / 8);
+            const __m512i lo = _mm512_mask_srlv_epi32(v, all, _mm512_mask_permutexvar_epi32(v, all, lo_idx, v), right);
+            const __m512i hi = _mm512_mask_sllv_epi32(v, all, _mm512_mask_permutexvar_epi32(v, all, hi_idx, v), left);
+            _mm512_storeu_si512(out, _mm512_and_si512(_mm512_or_si512(lo, hi), mask));
+        }
+    }
+#elif EXTL_HAS_AVX2
+    for (; i % 8 != 0 && i < end; ++i)
+        *out++ = unpack_one(words, width, i);
+    if (end - i >= 8) {
+        alignas(32) std::uint32_t lo_index[8], hi_index[8], shift[8], back_shift[8];
+        for (unsigned j = 0; j < 8; ++j) {
+            lo_index[j] = j * width / 32;
+            hi_index[j] = lo_index[j] + 1;
+            shift[j] = j * width % 32;
+            back_shift[j] = 32 - shift[j];
+        }
+        const __m256i lo_idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(lo_index));
+        const __m256i hi_idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(hi_index));
+        const __m256i right = _mm256_load_si256(reinterpret_cast<const __m256i*>(shift));
+        const __m256i left = _mm256_load_si256(reinterpret_cast<const __m256i*>(back_shift));
+        const __m256i mask = _mm256_set1_epi32(static_cast<int>(packed_mask(width)));
+        for (; end - i >= 8; i += 8, out += 8) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i * width / 8));
+            const __m256i lo = _mm256_srlv_epi32(_mm256_permutevar8x32_epi32(v, lo_idx), right);
+            const __m256i hi = _mm256_sllv_epi32(_mm256_permutevar8x32_epi32(v, hi_idx), left);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_and_si256(_mm256_or_si256(lo, hi), mask));
+        }
+    }
+#endif
+    for (; i < end; ++i)
+        *out++ = unpack_one(words, width, i);
+    (void)bytes;
+}
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------
+// packed_vector
+// Vector of unsigned integers stored in exactly Bits bits each (1 to 32), or in a width fixed at
+// create() time for packed_vector<dynamic_width>. Elements are read and written by value; there
+// are no references into the storage. unpack() decodes a range into a uint32_t array 8 or 16
+// values per instruction group with AVX2 or AVX-512, which is the fast way to scan a column.
+// ---------------------------------------------------------------------------------------
+template <unsigned Bits = dynamic_width>
+class packed_vector {
+    static_assert(Bits <= 32, "packed_vector holds values of at most 32 bits");
+
+public:
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    packed_vector() noexcept = default;
+
+    packed_vector(const packed_vector&) = delete;
+    packed_vector& operator=(const packed_vector&) = delete;
+
+    packed_vector(packed_vector&& other) noexcept
+        : words_(std::exchange(other.words_, nullptr)), size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)), width_(other.width_) {}
+
+    packed_vector& operator=(packed_vector&& other) noexcept {
+        if (this != &other) {
+            deallocate(words_, alignment);
+            words_ = std::exchange(other.words_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            width_ = other.width_;
+        }
+        return *this;
+    }
+
+    ~packed_vector() { deallocate(words_, alignment); }
+
+    // Creates a vector of n zeros.
+    static expected<packed_vector, errc> create(size_type n) noexcept
+        requires(Bits != dynamic_width)
+    {
+        packed_vector v;
+        if (auto result = v.try_resize(n); !result)
+            return unexpected(result.error());
+        return v;
+    }
+
+    // Creates a vector of n zeros, each width bits wide. Fails with invalid_argument unless
+    // 1 <= width <= 32.
+    static expected<packed_vector, errc> create(size_type n, unsigned width) noexcept
+        requires(Bits == dynamic_width)
+    {
+        if (width == 0 || width > 32)
+            return unexpected(errc::invalid_argument);
+        packed_vector v;
+        v.width_ = width;
+        if (auto result = v.try_resize(n); !result)
+            return unexpected(result.error());
+        return v;
+    }
+
+    static expected<packed_vector, errc> copy(const packed_vector& other) noexcept {
+        packed_vector v;
+        v.width_ = other.width_;
+        if (other.words_ != nullptr) {
+            if (auto result = v.reallocate(other.size_); !result)
+                return unexpected(result.error());
+            std::memcpy(v.words_, other.words_, other.size_in_bytes());
+            v.size_ = other.size_;
+        }
+        return v;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    unsigned width() const noexcept {
+        if constexpr (Bits != dynamic_width)
+            return Bits;
+        else
+            return width_;
+    }
+    value_type max_value() const noexcept { return detail::packed_mask(width()); }
+    size_type size_in_bytes() const noexcept { return words_for(size_) * sizeof(std::uint64_t); }
+
+    // The packed words; the first size() * width() bits hold the values.
+    std::span<const std::uint64_t> words() const noexcept { return {words_, words_for(size_)}; }
+
+    value_type get(size_type i) const noexcept {
+        EXTL_ASSERT(i < size_);
+        return detail::unpack_one(words_, width(), i);
+    }
+    value_type operator[](size_type i) const noexcept { return get(i); }
+
+    // Precondition: v <= max_value().
+    void set(size_type i, value_type v) noexcept {
+        EXTL_ASSERT(i < size_);
+        EXTL_ASSERT(v <= max_value());
+        const size_type bit = i * width();
+        const size_type w = bit / 64;
+        const unsigned offset = bit % 64;
+        const std::uint64_t mask = max_value();
+        words_[w] = (words_[w] & ~(mask << offset)) | (std::uint64_t{v} << offset);
+        if (offset + width() > 64) {
+            const unsigned spill = 64 - offset;
+            words_[w + 1] = (words_[w + 1] & ~(mask >> spill)) | (std::uint64_t{v} >> spill);
+        }
+    }
+
+    // Decodes values [first, first + count) into out.
+    void unpack(size_type first, size_type count, value_type* out) const noexcept {
+        EXTL_ASSERT(first <= size_ && count <= size_ - first);
+        detail::unpack(words_, width(), first, count, out);
+    }
+
+    expected<void, errc> try_push_back(value_type v) noexcept {
+        if (size_ == capacity_) {
+            if (size_ == max_size())
+                return unexpected(errc::length_error);
+            if (auto result = reallocate(std::min(detail::grow_capacity(capacity_, size_ + 1), max_size())); !result)
+                return result;
+        }
+        ++size_;
+        set(size_ - 1, v);
+        return {};
+    }
+
+    // Resizes to n values; new values are zero.
+    expected<void, errc> try_resize(size_type n) noexcept {
+        if (n > capacity_ || words_ == nullptr) {
+            if (n > max_size())
+                return unexpected(errc::length_error);
+            if (auto result = reallocate(std::max(n, capacity_)); !result)
+                return result;
+        }
+        if (n > size_) {
+            // Clear the bits past the old end; the old last word may be partially used.
+            const size_type bit = size_ * width();
+            if (bit % 64 != 0)
+                words_[bit / 64] &= ~(~std::uint64_t{0} << (bit % 64));
+            const size_type first_word = (bit + 63) / 64;
+            std::fill(words_ + first_word, words_ + words_for(n), std::uint64_t{0});
+        }
+        size_ = n;
+        return {};
+    }
+
+    void clear() noexcept { size_ = 0; }
+
+    static constexpr size_type max_size() noexcept { return std::numeric_limits<size_type>::max() / 64; }
+
+private:
+    static constexpr std::size_t alignment = cache_line_size;
+
+    size_type words_for(size_type n) const noexcept { return (n * width() + 63) / 64; }
+
+    // Allocates room for capacity values plus the padding the decoders read past the end. Out of
+    // line like the other containers' growth paths.
+    EXTL_NO_INLINE expected<void, errc> reallocate(size_type capacity) noexcept {
+        EXTL_ASSERT(width() != 0); // A default-constructed dynamic-width vector cannot grow.
+        const size_type used = words_for(size_);
+        const size_type total = words_for(capacity) + detail::packed_padding_words;
+        std::uint64_t* words = allocate<std::uint64_t>(total, alignment);
+        if (words == nullptr)
+            return unexpected(errc::out_of_memory);
+        if (words_ != nullptr)
+            std::memcpy(words, words_, used * sizeof(std::uint64_t));
+        std::fill(words + used, words + total, std::uint64_t{0});
+        deallocate(words_, alignment);
+        words_ = words;
+        capacity_ = capacity;
+        return {};
+    }
+
+    std::uint64_t* words_ = nullptr;
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+    unsigned width_ = Bits; // Read through width(), which is a constant for a fixed Bits.
+};
+
+using dynamic_packed_vector = packed_vector<dynamic_width>;
+
+// ---------------------------------------------------------------------------------------
+// frame_of_reference_vector
+// Immutable column of 32-bit values stored as offsets from their minimum, each in the fewest bits
+// that fit the largest offset. A column of timestamps within one hour costs 12 bits per value
+// instead of 32; decode() unpacks with the packed_vector kernels and adds the base back.
+// ---------------------------------------------------------------------------------------
+class frame_of_reference_vector {
+public:
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    frame_of_reference_vector() noexcept = default;
+
+    static expected<frame_of_reference_vector, errc> create(std::span<const value_type> values) noexcept {
+        frame_of_reference_vector result;
+        value_type max = 0;
+        if (!values.empty()) {
+            const auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+            result.base_ = *lo;
+            max = *hi;
+        }
+        const unsigned width = std::max(1u, static_cast<unsigned>(std::bit_width(max - result.base_)));
+        auto packed = dynamic_packed_vector::create(values.size(), width);
+        if (!packed)
+            return unexpected(packed.error());
+        for (size_type i = 0; i < values.size(); ++i)
+            packed->set(i, values[i] - result.base_);
+        result.offsets_ = std::move(*packed);
+        return result;
+    }
+
+    static expected<frame_of_reference_vector, errc> copy(const frame_of_reference_vector& other) noexcept {
+        auto packed = dynamic_packed_vector::copy(other.offsets_);
+        if (!packed)
+            return unexpected(packed.error());
+        frame_of_reference_vector result;
+        result.base_ = other.base_;
+        result.offsets_ = std::move(*packed);
+        return result;
+    }
+
+    bool empty() const noexcept { return offsets_.empty(); }
+    size_type size() const noexcept { return offsets_.size(); }
+    value_type base() const noexcept { return base_; }
+    unsigned width() const noexcept { return offsets_.width(); }
+    size_type size_in_bytes() const noexcept { return offsets_.size_in_bytes(); }
+
+    value_type get(size_type i) const noexcept { return base_ + offsets_.get(i); }
+    value_type operator[](size_type i) const noexcept { return get(i); }
+
+    // Decodes values [first, first + count) into out.
+    void decode(size_type first, size_type count, value_type* out) const noexcept {
+        offsets_.unpack(first, count, out);
+        for (size_type k = 0; k < count; ++k)
+            out[k] += base_;
+    }
+
+private:
+    value_type base_ = 0;
+    dynamic_packed_vector offsets_;
+};
+
+} // namespace extl
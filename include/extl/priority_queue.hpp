@@ -0,0 +1,500 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// priority_queue
+// A D-ary heap over contiguous storage. With the default arity of 4 the children of a node sit
+// next to each other, so a sift-down step reads one or two cache lines and the tree is half as
+// deep as a binary heap. Like std::priority_queue, top() is the largest element under Compare.
+// ---------------------------------------------------------------------------------------
+template <class T, std::size_t D = 4, class Compare = std::less<T>>
+class priority_queue {
+    static_assert(D >= 2, "a heap needs an arity of at least 2");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    static constexpr size_type arity = D;
+
+    priority_queue() noexcept = default;
+    explicit priority_queue(const Compare& comp) noexcept : comp_(comp) {}
+
+    priority_queue(const priority_queue&) = delete;
+    priority_queue& operator=(const priority_queue&) = delete;
+
+    priority_queue(priority_queue&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)), comp_(std::move(other.comp_)) {}
+
+    priority_queue& operator=(priority_queue&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            comp_ = std::move(other.comp_);
+        }
+        return *this;
+    }
+
+    ~priority_queue() { release(); }
+
+    // Creates an empty queue with room for at least `capacity` elements.
+    static expected<priority_queue, errc> create(size_type capacity, const Compare& comp = Compare()) noexcept {
+        priority_queue queue(comp);
+        if (auto result = queue.try_reserve(capacity); !result)
+            return unexpected(result.error());
+        return queue;
+    }
+
+    static expected<priority_queue, errc> copy(const priority_queue& other) noexcept
+        requires std::is_copy_constructible_v<T>
+    {
+        auto queue = create(other.size_, other.comp_);
+        if (!queue)
+            return queue;
+        for (size_type i = 0; i < other.size_; ++i)
+            std::construct_at(queue->data_ + i, other.data_[i]);
+        queue->size_ = other.size_;
+        return queue;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    static constexpr size_type max_size() noexcept { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+    const T& top() const noexcept {
+        EXTL_ASSERT(!empty());
+        return data_[0];
+    }
+
+    expected<void, errc> try_push(const T& value) noexcept { return try_emplace(value); }
+    expected<void, errc> try_push(T&& value) noexcept { return try_emplace(std::move(value)); }
+
+    // args may refer to an element of this queue, such as top().
+    template <class... Args>
+    expected<void, errc> try_emplace(Args&&... args) noexcept {
+        if (size_ == capacity_) {
+            const size_type capacity = detail::grow_capacity(capacity_, size_ + 1);
+            auto data = allocate_storage(capacity);
+            if (!data)
+                return unexpected(data.error());
+            std::construct_at(*data + size_, std::forward<Args>(args)...);
+            adopt_storage(*data, capacity);
+        } else {
+            std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        sift_up(size_ - 1);
+        return {};
+    }
+
+    void pop() noexcept {
+        EXTL_ASSERT(!empty());
+        --size_;
+        if (size_ == 0) {
+            std::destroy_at(data_);
+            return;
+        }
+        T value = std::move(data_[size_]);
+        std::destroy_at(data_ + size_);
+        sift_down(0, std::move(value));
+    }
+
+    // Removes and returns the top element.
+    T take_top() noexcept {
+        EXTL_ASSERT(!empty());
+        T value = std::move(data_[0]);
+        pop();
+        return value;
+    }
+
+    expected<void, errc> try_reserve(size_type capacity) noexcept {
+        if (capacity <= capacity_)
+            return {};
+        auto data = allocate_storage(capacity);
+        if (!data)
+            return unexpected(data.error());
+        adopt_storage(*data, capacity);
+        return {};
+    }
+
+    void clear() noexcept {
+        std::destroy_n(data_, size_);
+        size_ = 0;
+    }
+
+    const Compare& value_comp() const noexcept { return comp_; }
+
+private:
+    static constexpr std::size_t alignment = alignof(T) > cache_line_size ? alignof(T) : cache_line_size;
+
+    // Growth happens in two steps so try_emplace can construct the new element in between, while
+    // the old storage is still alive.
+    static expected<T*, errc> allocate_storage(size_type capacity) noexcept {
+        if (capacity > max_size())
+            return unexpected(errc::length_error);
+        T* data = allocate<T>(capacity, alignment);
+        if (data == nullptr)
+            return unexpected(errc::out_of_memory);
+        return data;
+    }
+
+    // Moves the elements to data and frees the old storage.
+    void adopt_storage(T* data, size_type capacity) noexcept {
+        detail::relocate(data_, size_, data);
+        deallocate(data_, alignment);
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void sift_up(size_type hole) noexcept {
+        T value = std::move(data_[hole]);
+        while (hole > 0) {
+            const size_type parent = (hole - 1) / D;
+            if (!comp_(data_[parent], value))
+                break;
+            data_[hole] = std::move(data_[parent]);
+            hole = parent;
+        }
+        data_[hole] = std::move(value);
+    }
+
+    // Fills the hole at `hole` with `value`, moving larger children up.
+    void sift_down(size_type hole, T value) noexcept {
+        while (true) {
+            const size_type first = D * hole + 1;
+            if (first >= size_)
+                break;
+            const size_type last = first + D < size_ ? first + D : size_;
+            size_type best = first;
+            for (size_type child = first + 1; child < last; ++child) {
+                if (comp_(data_[best], data_[child]))
+                    best = child;
+            }
+            if (!comp_(value, data_[best]))
+                break;
+            data_[hole] = std::move(data_[best]);
+            hole = best;
+        }
+        data_[hole] = std::move(value);
+    }
+
+    void release() noexcept {
+        std::destroy_n(data_, size_);
+        deallocate(data_, alignment);
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+    T* data_ = nullptr;
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+    [[no_unique_address]] Compare comp_{};
+};
+
+// ---------------------------------------------------------------------------------------
+// indexed_priority_queue
+// A D-ary heap whose elements can be found again through stable handles, which enables
+// promote, update and erase in O(log_D n). A handle stays valid until its element is
+// popped or erased; afterwards its slot may be reused by a later push.
+// ---------------------------------------------------------------------------------------
+template <class T, std::size_t D = 4, class Compare = std::less<T>>
+class indexed_priority_queue {
+    static_assert(D >= 2, "a heap needs an arity of at least 2");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    static constexpr size_type arity = D;
+
+    struct handle {
+        std::uint32_t index;
+
+        friend constexpr bool operator==(handle, handle) noexcept = default;
+    };
+
+    indexed_priority_queue() noexcept = default;
+    explicit indexed_priority_queue(const Compare& comp) noexcept : comp_(comp) {}
+
+    indexed_priority_queue(const indexed_priority_queue&) = delete;
+    indexed_priority_queue& operator=(const indexed_priority_queue&) = delete;
+
+    indexed_priority_queue(indexed_priority_queue&& other) noexcept { steal(other); }
+
+    indexed_priority_queue& operator=(indexed_priority_queue&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~indexed_priority_queue() { release(); }
+
+    static expected<indexed_priority_queue, errc> create(size_type capacity,
+                                                         const Compare& comp = Compare()) noexcept {
+        indexed_priority_queue queue(comp);
+        if (auto result = queue.try_reserve(capacity); !result)
+            return unexpected(result.error());
+        return queue;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    static constexpr size_type max_size() noexcept { return free_bit - 1; }
+
+    const T& top() const noexcept {
+        EXTL_ASSERT(!empty());
+        return nodes_[0].value;
+    }
+
+    handle top_handle() const noexcept {
+        EXTL_ASSERT(!empty());
+        return handle{nodes_[0].slot};
+    }
+
+    bool contains(handle h) const noexcept { return h.index < slot_count_ && (positions_[h.index] & free_bit) == 0; }
+
+    const T& operator[](handle h) const noexcept {
+        EXTL_ASSERT(contains(h));
+        return nodes_[positions_[h.index]].value;
+    }
+
+    expected<handle, errc> try_push(const T& value) noexcept { return try_emplace(value); }
+    expected<handle, errc> try_push(T&& value) noexcept { return try_emplace(std::move(value)); }
+
+    // args may refer to an element of this queue, such as top().
+    template <class... Args>
+    expected<handle, errc> try_emplace(Args&&... args) noexcept {
+        if (size_ == capacity_) {
+            const size_type capacity = detail::grow_capacity(capacity_, size_ + 1);
+            auto grown = allocate_storage(capacity);
+            if (!grown)
+                return unexpected(grown.error());
+            std::construct_at(grown->nodes + size_, node{T(std::forward<Args>(args)...), npos});
+            adopt_storage(*grown, capacity);
+        } else {
+            std::construct_at(nodes_ + size_, node{T(std::forward<Args>(args)...), npos});
+        }
+        return link_last();
+    }
+
+    void pop() noexcept {
+        EXTL_ASSERT(!empty());
+        erase_at(0);
+    }
+
+    void erase(handle h) noexcept {
+        EXTL_ASSERT(contains(h));
+        erase_at(positions_[h.index]);
+    }
+
+    // Replaces the element's value with one that ranks at least as high under Compare, so the
+    // element only moves toward top(): a larger value with std::less, a smaller one with
+    // std::greater, where this is the classic decrease-key.
+    void promote(handle h, T value) noexcept {
+        EXTL_ASSERT(contains(h));
+        const size_type hole = positions_[h.index];
+        EXTL_ASSERT(!comp_(value, nodes_[hole].value));
+        nodes_[hole].value = std::move(value);
+        sift_up(hole, take(hole));
+    }
+
+    // Replaces the element's value and moves it up or down as needed.
+    void update(handle h, T value) noexcept {
+        EXTL_ASSERT(contains(h));
+        const size_type hole = positions_[h.index];
+        nodes_[hole].value = std::move(value);
+        reposition(hole, take(hole));
+    }
+
+    expected<void, errc> try_reserve(size_type capacity) noexcept {
+        if (capacity <= capacity_)
+            return {};
+        auto grown = allocate_storage(capacity);
+        if (!grown)
+            return unexpected(grown.error());
+        adopt_storage(*grown, capacity);
+        return {};
+    }
+
+    void clear() noexcept {
+        std::destroy_n(nodes_, size_);
+        size_ = 0;
+        slot_count_ = 0;
+        free_head_ = npos;
+    }
+
+    const Compare& value_comp() const noexcept { return comp_; }
+
+private:
+    // positions_[slot] is the heap index of a live slot, or free_bit | next free slot.
+    static constexpr std::uint32_t free_bit = std::uint32_t(1) << 31;
+    static constexpr std::uint32_t npos = free_bit - 1;
+
+    struct node {
+        T value;
+        std::uint32_t slot;
+    };
+
+    struct storage {
+        node* nodes;
+        std::uint32_t* positions;
+    };
+
+    // Growth happens in two steps so try_emplace can construct the new element in between, while
+    // the old storage is still alive.
+    static expected<storage, errc> allocate_storage(size_type capacity) noexcept {
+        if (capacity > max_size())
+            return unexpected(errc::length_error);
+        node* nodes = allocate<node>(capacity);
+        std::uint32_t* positions = allocate<std::uint32_t>(capacity);
+        if (nodes == nullptr || positions == nullptr) {
+            deallocate(nodes);
+            deallocate(positions);
+            return unexpected(errc::out_of_memory);
+        }
+        return storage{nodes, positions};
+    }
+
+    // Moves the nodes and slot positions to s and frees the old storage.
+    void adopt_storage(storage s, size_type capacity) noexcept {
+        detail::relocate(nodes_, size_, s.nodes);
+        detail::relocate(positions_, slot_count_, s.positions);
+        deallocate(nodes_);
+        deallocate(positions_);
+        nodes_ = s.nodes;
+        positions_ = s.positions;
+        capacity_ = capacity;
+    }
+
+    // Gives the node just constructed at nodes_[size_] a slot, reusing a free one if possible,
+    // and sifts it into place.
+    handle link_last() noexcept {
+        std::uint32_t slot;
+        if (free_head_ != npos) {
+            slot = free_head_;
+            free_head_ = positions_[slot] & ~free_bit;
+        } else {
+            slot = slot_count_++;
+        }
+        nodes_[size_].slot = slot;
+        positions_[slot] = static_cast<std::uint32_t>(size_);
+        ++size_;
+        sift_up(size_ - 1, take(size_ - 1));
+        return handle{slot};
+    }
+
+    node take(size_type i) noexcept { return std::move(nodes_[i]); }
+
+    void place(size_type i, node&& n) noexcept {
+        positions_[n.slot] = static_cast<std::uint32_t>(i);
+        nodes_[i] = std::move(n);
+    }
+
+    void sift_up(size_type hole, node n) noexcept {
+        while (hole > 0) {
+            const size_type parent = (hole - 1) / D;
+            if (!comp_(nodes_[parent].value, n.value))
+                break;
+            place(hole, take(parent));
+            hole = parent;
+        }
+        place(hole, std::move(n));
+    }
+
+    void sift_down(size_type hole, node n) noexcept {
+        while (true) {
+            const size_type first = D * hole + 1;
+            if (first >= size_)
+                break;
+            const size_type last = first + D < size_ ? first + D : size_;
+            size_type best = first;
+            for (size_type child = first + 1; child < last; ++child) {
+                if (comp_(nodes_[best].value, nodes_[child].value))
+                    best = child;
+            }
+            if (!comp_(n.value, nodes_[best].value))
+                break;
+            place(hole, take(best));
+            hole = best;
+        }
+        place(hole, std::move(n));
+    }
+
+    void reposition(size_type hole, node n) noexcept {
+        if (hole > 0 && comp_(nodes_[(hole - 1) / D].value, n.value))
+            sift_up(hole, std::move(n));
+        else
+            sift_down(hole, std::move(n));
+    }
+
+    void erase_at(size_type i) noexcept {
+        const std::uint32_t slot = nodes_[i].slot;
+        positions_[slot] = free_bit | free_head_;
+        free_head_ = slot;
+
+        --size_;
+        if (i == size_) {
+            std::destroy_at(nodes_ + i);
+            return;
+        }
+        node last = take(size_);
+        std::destroy_at(nodes_ + size_);
+        reposition(i, std::move(last));
+    }
+
+    void steal(indexed_priority_queue& other) noexcept {
+        nodes_ = std::exchange(other.nodes_, nullptr);
+        positions_ = std::exchange(other.positions_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+        slot_count_ = std::exchange(other.slot_count_, 0);
+        free_head_ = std::exchange(other.free_head_, npos);
+        comp_ = std::move(other.comp_);
+    }
+
+    void release() noexcept {
+        std::destroy_n(nodes_, size_);
+        deallocate(nodes_);
+        deallocate(positions_);
+        nodes_ = nullptr;
+        positions_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        slot_count_ = 0;
+        free_head_ = npos;
+    }
+
+    node* nodes_ = nullptr;
+    std::uint32_t* positions_ = nullptr;
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+    std::uint32_t slot_count_ = 0;
+    std::uint32_t free_head_ = npos;
+    [[no_unique_address]] Compare comp_{};
+};
+
+} // namespace extl
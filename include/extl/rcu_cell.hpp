@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/epoch.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+namespace detail::rcu {
+
+// ExTL containers copy through a fallible static T::copy(); everything else through its copy
+// constructor.
+template <class T>
+concept fallible_copy = requires(const T& t) {
+    { T::copy(t) } -> std::same_as<expected<T, errc>>;
+};
+
+template <class T>
+struct version : epoch_node {
+    template <class... Args>
+    explicit version(Args&&... args) noexcept : value(std::forward<Args>(args)...) {}
+
+    T value;
+};
+
+template <class T, class... Args>
+inline version<T>* make_version(Args&&... args) noexcept {
+    version<T>* v = allocate<version<T>>(1);
+    if (v != nullptr)
+        std::construct_at(v, std::forward<Args>(args)...);
+    return v;
+}
+
+template <class T>
+inline void destroy_version(version<T>* v) noexcept {
+    std::destroy_at(v);
+    deallocate(v);
+}
+
+template <class T>
+inline expected<version<T>*, errc> copy_version(const T& value) noexcept {
+    if constexpr (fallible_copy<T>) {
+        auto copied = T::copy(value);
+        if (!copied)
+            return unexpected(copied.error());
+        version<T>* v = make_version<T>(std::move(*copied));
+        if (v == nullptr)
+            return unexpected(errc::out_of_memory);
+        return v;
+    } else {
+        version<T>* v = make_version<T>(value);
+        if (v == nullptr)
+            return unexpected(errc::out_of_memory);
+        return v;
+    }
+}
+
+} // namespace detail::rcu
+
+// ---------------------------------------------------------------------------------------
+// rcu_cell
+// A shared value for read-mostly data such as routing or configuration tables. Readers take a
+// snapshot: one epoch pin and one acquire load, with no write to shared memory and no retry, so
+// reads scale with the number of cores. Writers copy the current version, modify the copy and
+// publish it with a CAS; the old version is retired through extl::epoch and freed once the
+// last snapshot that could see it is gone. Since updates are rare and already copy the whole
+// value, each one also advances the epoch and frees the versions that have expired, so only the
+// last two or three stay around; an update made while the caller holds a snapshot skips this.
+//
+// update(fn) is optimistic: if another writer publishes first, the copy is discarded and fn
+// runs again on the newer version, so fn must be safe to repeat. A snapshot pins the epoch for
+// its whole lifetime and holds up reclamation everywhere, so keep snapshots short.
+// ---------------------------------------------------------------------------------------
+template <class T>
+class rcu_cell {
+    using version = detail::rcu::version<T>;
+
+public:
+    using value_type = T;
+
+    // A consistent view of one version. Stays valid while the snapshot lives, even if newer
+    // versions are published meanwhile.
+    class snapshot {
+    public:
+        snapshot(snapshot&&) noexcept = default;
+        snapshot& operator=(snapshot&&) = delete;
+
+        const T& operator*() const noexcept { return *value_; }
+        const T* operator->() const noexcept { return value_; }
+        const T* get() const noexcept { return value_; }
+
+    private:
+        friend class rcu_cell;
+
+        snapshot(epoch::guard&& guard, const T* value) noexcept : guard_(std::move(guard)), value_(value) {}
+
+        epoch::guard guard_;
+        const T* value_;
+    };
+
+    template <class... Args>
+    static expected<rcu_cell, errc> create(Args&&... args) noexcept {
+        version* v = detail::rcu::make_version<T>(std::forward<Args>(args)...);
+        if (v == nullptr)
+            return unexpected(errc::out_of_memory);
+        return rcu_cell(v);
+    }
+
+    rcu_cell(const rcu_cell&) = delete;
+    rcu_cell& operator=(const rcu_cell&) = delete;
+
+    // Moving is not thread-safe: nobody may be using either cell.
+    rcu_cell(rcu_cell&& other) noexcept
+        : current_(other.current_.exchange(nullptr, std::memory_order_relaxed)) {}
+    rcu_cell& operator=(rcu_cell&& other) noexcept {
+        if (this != &other)
+            reset(other.current_.exchange(nullptr, std::memory_order_relaxed));
+        return *this;
+    }
+
+    // Must not run concurrently with any other use. Older versions still waiting for their grace
+    // period are freed by the epoch independently of the cell.
+    ~rcu_cell() { reset(nullptr); }
+
+    snapshot read() const noexcept {
+        auto guard = epoch::pin();
+        const version* v = current_.load(std::memory_order_acquire);
+        EXTL_ASSERT(v != nullptr);
+        return snapshot(std::move(guard), &v->value);
+    }
+
+    // Publishes a copy of the current value modified by fn(T&). If fn returns expected<void, errc>,
+    // an error abandons the update and is returned. Fails with the copy's error when copying fails.
+    template <class F>
+    expected<void, errc> update(F&& fn) noexcept {
+        auto result = publish_update(fn);
+        if (result)
+            collect();
+        return result;
+    }
+
+    // Publishes a new value built from args, replacing the current one.
+    template <class... Args>
+    expected<void, errc> store(Args&&... args) noexcept {
+        version* next = detail::rcu::make_version<T>(std::forward<Args>(args)...);
+        if (next == nullptr)
+            return unexpected(errc::out_of_memory);
+        {
+            auto guard = epoch::pin();
+            version* previous = current_.exchange(next, std::memory_order_acq_rel);
+            guard.retire(previous, &reclaim);
+        }
+        collect();
+        return {};
+    }
+
+private:
+    explicit rcu_cell(version* v) noexcept : current_(v) {}
+
+    template <class F>
+    expected<void, errc> publish_update(F& fn) noexcept {
+        auto guard = epoch::pin();
+        version* current = current_.load(std::memory_order_acquire);
+        for (;;) {
+            auto copied = detail::rcu::copy_version(current->value);
+            if (!copied)
+                return unexpected(copied.error());
+            version* next = *copied;
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, T&>, expected<void, errc>>) {
+                auto applied = fn(next->value);
+                if (!applied) {
+                    detail::rcu::destroy_version(next);
+                    return applied;
+                }
+            } else {
+                fn(next->value);
+            }
+            if (current_.compare_exchange_strong(current, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                guard.retire(current, &reclaim);
+                return {};
+            }
+            // Lost to a concurrent writer; the copy was never published.
+            detail::rcu::destroy_version(next);
+        }
+    }
+
+    // Without this, retired versions wait for epoch::collect_batch retirements on this thread.
+    static void collect() noexcept {
+        if (!epoch::is_pinned())
+            epoch::collect();
+    }
+
+    static void reclaim(epoch_node* n) noexcept { detail::rcu::destroy_version(static_cast<version*>(n)); }
+
+    void reset(version* v) noexcept {
+        if (version* old = current_.exchange(v, std::memory_order_relaxed))
+            detail::rcu::destroy_version(old);
+    }
+
+    std::atomic<version*> current_;
+};
+
+} // namespace extl
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+template <class T>
+class ring_buffer;
+
+// ---------------------------------------------------------------------------------------
+// ring_buffer_iterator
+// Random-access iterator addressing elements by logical index from the front.
+// ---------------------------------------------------------------------------------------
+template <class T, bool Const>
+class ring_buffer_iterator {
+    using container = std::conditional_t<Const, const ring_buffer<T>, ring_buffer<T>>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    ring_buffer_iterator() noexcept = default;
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    ring_buffer_iterator(const ring_buffer_iterator<T, OtherConst>& other) noexcept
+        : ring_(other.ring_), index_(other.index_) {}
+
+    reference operator*() const noexcept { return (*ring_)[index_]; }
+    pointer operator->() const noexcept { return std::addressof((*ring_)[index_]); }
+    reference operator[](difference_type n) const noexcept { return (*ring_)[index_ + static_cast<std::size_t>(n)]; }
+
+    ring_buffer_iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+    ring_buffer_iterator operator++(int) noexcept { return ring_buffer_iterator(ring_, index_++); }
+    ring_buffer_iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+    ring_buffer_iterator operator--(int) noexcept { return ring_buffer_iterator(ring_, index_--); }
+
+    ring_buffer_iterator& operator+=(difference_type n) noexcept {
+        index_ += static_cast<std::size_t>(n);
+        return *this;
+    }
+    ring_buffer_iterator& operator-=(difference_type n) noexcept {
+        index_ -= static_cast<std::size_t>(n);
+        return *this;
+    }
+    friend ring_buffer_iterator operator+(ring_buffer_iterator it, difference_type n) noexcept { return it += n; }
+    friend ring_buffer_iterator operator+(difference_type n, ring_buffer_iterator it) noexcept { return it += n; }
+    friend ring_buffer_iterator operator-(ring_buffer_iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(const ring_buffer_iterator& a, const ring_buffer_iterator& b) noexcept {
+        return static_cast<difference_type>(a.index_ - b.index_);
+    }
+
+    friend bool operator==(const ring_buffer_iterator& a, const ring_buffer_iterator& b) noexcept {
+        return a.index_ == b.index_;
+    }
+    friend std::strong_ordering operator<=>(const ring_buffer_iterator& a, const ring_buffer_iterator& b) noexcept {
+        return a.index_ <=> b.index_;
+    }
+
+private:
+    friend class ring_buffer<T>;
+    template <class, bool>
+    friend class ring_buffer_iterator;
+
+    ring_buffer_iterator(container* r, std::size_t index) noexcept : ring_(r), index_(index) {}
+
+    container* ring_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+// ---------------------------------------------------------------------------------------
+// ring_buffer
+// Circular FIFO over one power-of-two allocation, so wrapping is a mask instead of a branch or
+// a division. The contents are always at most two contiguous runs; as_spans() exposes them for
+// vectorized processing or scatter/gather I/O (one iovec per span). Pushing into a full buffer
+// either grows it (try_push_back, fallible) or replaces the oldest element
+// (push_back_overwrite, never allocates), which suits fixed-size sliding windows.
+// ---------------------------------------------------------------------------------------
+template <class T>
+class ring_buffer {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = ring_buffer_iterator<T, false>;
+    using const_iterator = ring_buffer_iterator<T, true>;
+
+    ring_buffer() noexcept = default;
+
+    ring_buffer(const ring_buffer&) = delete;
+    ring_buffer& operator=(const ring_buffer&) = delete;
+
+    ring_buffer(ring_buffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), capacity_(std::exchange(other.capacity_, 0)),
+          head_(std::exchange(other.head_, 0)), size_(std::exchange(other.size_, 0)) {}
+
+    ring_buffer& operator=(ring_buffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            head_ = std::exchange(other.head_, 0);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~ring_buffer() { release(); }
+
+    // Creates an empty buffer whose capacity is `capacity` rounded up to a power of two.
+    static expected<ring_buffer, errc> create(size_type capacity) noexcept {
+        ring_buffer ring;
+        if (auto result = ring.try_reserve(capacity); !result)
+            return unexpected(result.error());
+        return ring;
+    }
+
+    static expected<ring_buffer, errc> copy(const ring_buffer& other) noexcept
+        requires std::is_copy_constructible_v<T>
+    {
+        auto ring = create(other.capacity_);
+        if (!ring)
+            return ring;
+        for (size_type i = 0; i < other.size_; ++i)
+            std::construct_at(ring->data_ + i, other[i]);
+        ring->size_ = other.size_;
+        return ring;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    bool full() const noexcept { return size_ == capacity_; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    static constexpr size_type max_size() noexcept {
+        return std::bit_floor(std::numeric_limits<size_type>::max() / sizeof(T));
+    }
+
+    T& operator[](size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        return data_[(head_ + i) & mask()];
+    }
+    const T& operator[](size_type i) const noexcept {
+        EXTL_ASSERT(i < size_);
+        return data_[(head_ + i) & mask()];
+    }
+
+    T& front() noexcept { return (*this)[0]; }
+    const T& front() const noexcept { return (*this)[0]; }
+    T& back() noexcept { return (*this)[size_ - 1]; }
+    const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // The contents as two contiguous runs, oldest first. The second span is empty unless the
+    // contents wrap around the end of the allocation.
+    std::pair<std::span<T>, std::span<T>> as_spans() noexcept {
+        const size_type first = capacity_ - head_ < size_ ? capacity_ - head_ : size_;
+        return {std::span<T>(data_ + head_, first), std::span<T>(data_, size_ - first)};
+    }
+    std::pair<std::span<const T>, std::span<const T>> as_spans() const noexcept {
+        auto [a, b] = const_cast<ring_buffer&>(*this).as_spans();
+        return {a, b};
+    }
+
+    expected<void, errc> try_push_back(const T& value) noexcept { return try_emplace_back(value); }
+    expected<void, errc> try_push_back(T&& value) noexcept { return try_emplace_back(std::move(value)); }
+
+    // args may refer to an element of this buffer.
+    template <class... Args>
+    expected<void, errc> try_emplace_back(Args&&... args) noexcept {
+        if (size_ == capacity_) {
+            const size_type capacity = detail::grow_capacity(capacity_, capacity_ + 1);
+            auto data = allocate_storage(capacity);
+            if (!data)
+                return unexpected(data.error());
+            std::construct_at(*data + size_, std::forward<Args>(args)...);
+            adopt_storage(*data, capacity);
+            ++size_;
+            return {};
+        }
+        std::construct_at(data_ + ((head_ + size_) & mask()), std::forward<Args>(args)...);
+        ++size_;
+        return {};
+    }
+
+    // Appends all of values, growing once if needed. values may be a view of this buffer.
+    expected<void, errc> try_append(std::span<const T> values) noexcept
+        requires std::is_copy_constructible_v<T>
+    {
+        if (values.size() > capacity_ - size_) {
+            if (values.size() > max_size() - size_)
+                return unexpected(errc::length_error);
+            // Copy into the new storage while the old one, which values may point into, is alive.
+            const size_type capacity = std::bit_ceil(size_ + values.size());
+            auto data = allocate_storage(capacity);
+            if (!data)
+                return unexpected(data.error());
+            std::uninitialized_copy(values.begin(), values.end(), *data + size_);
+            adopt_storage(*data, capacity);
+            size_ += values.size();
+            return {};
+        }
+        for (const T& value : values)
+            std::construct_at(data_ + ((head_ + size_++) & mask()), value);
+        return {};
+    }
+
+    // Appends value, replacing the oldest element when the buffer is full.
+    // Precondition: capacity() > 0.
+    template <class U = T>
+    void push_back_overwrite(U&& value) noexcept {
+        EXTL_ASSERT(capacity_ > 0);
+        if (size_ == capacity_) {
+            data_[head_] = std::forward<U>(value);
+            head_ = (head_ + 1) & mask();
+            return;
+        }
+        std::construct_at(data_ + ((head_ + size_) & mask()), std::forward<U>(value));
+        ++size_;
+    }
+
+    void pop_front() noexcept {
+        EXTL_ASSERT(!empty());
+        std::destroy_at(data_ + head_);
+        head_ = (head_ + 1) & mask();
+        --size_;
+    }
+
+    // Removes the n oldest elements, e.g. after a partial write of as_spans().
+    void pop_front(size_type n) noexcept {
+        EXTL_ASSERT(n <= size_);
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            head_ = (head_ + n) & mask();
+            size_ -= n;
+        } else {
+            while (n-- != 0)
+                pop_front();
+        }
+    }
+
+    void pop_back() noexcept {
+        EXTL_ASSERT(!empty());
+        --size_;
+        std::destroy_at(data_ + ((head_ + size_) & mask()));
+    }
+
+    // Grows the capacity to at least `capacity`, rounded up to a power of two. The contents are
+    // moved so they start at the beginning of the new allocation.
+    expected<void, errc> try_reserve(size_type capacity) noexcept {
+        if (capacity <= capacity_)
+            return {};
+        if (capacity > max_size())
+            return unexpected(errc::length_error);
+        capacity = std::bit_ceil(capacity);
+        auto data = allocate_storage(capacity);
+        if (!data)
+            return unexpected(data.error());
+        adopt_storage(*data, capacity);
+        return {};
+    }
+
+    void clear() noexcept {
+        pop_front(size_);
+        head_ = 0;
+    }
+
+private:
+    size_type mask() const noexcept { return capacity_ - 1; }
+
+    // Growth happens in two steps so callers can construct new elements in between, while the
+    // old storage is still alive. capacity must be a power of two.
+    static expected<T*, errc> allocate_storage(size_type capacity) noexcept {
+        if (capacity > max_size())
+            return unexpected(errc::length_error);
+        T* data = allocate<T>(capacity);
+        if (data == nullptr)
+            return unexpected(errc::out_of_memory);
+        return data;
+    }
+
+    // Moves the contents to the start of data and frees the old storage.
+    void adopt_storage(T* data, size_type capacity) noexcept {
+        auto [a, b] = as_spans();
+        detail::relocate(a.data(), a.size(), data);
+        detail::relocate(b.data(), b.size(), data + a.size());
+        deallocate(data_);
+        data_ = data;
+        capacity_ = capacity;
+        head_ = 0;
+    }
+
+    void release() noexcept {
+        clear();
+        deallocate(data_);
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+
+    T* data_ = nullptr;
+    size_type capacity_ = 0; // Zero or a power of two.
+    size_type head_ = 0;     // Index of the oldest element.
+    size_type size_ = 0;
+};
+
+} // namespace extl
@@ -0,0 +1,1256 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/bit_ops.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+namespace detail::roaring {
+
+static_assert(std::endian::native == std::endian::little,
+              "roaring containers share their in-memory layout with the little-endian serialized format");
+
+// ---------------------------------------------------------------------------------------
+// Containers
+// A 32-bit value is split into a 16-bit key, which selects a container, and a 16-bit low part
+// stored in it. Each container holds one chunk of 65536 values in one of three forms:
+//   array   sorted uint16 values, at most 4096 (2 bytes per value)
+//   bitmap  1024 words, one bit per value (8 KiB)
+//   run     sorted (first, length - 1) uint16 pairs (4 bytes per run)
+// Owned containers use exactly the byte layout of the portable serialized format, so the
+// algorithms below run unchanged over a roaring_bitmap or a frozen view of mapped memory.
+// ---------------------------------------------------------------------------------------
+
+enum class container_type : std::uint8_t { array, bitmap, run };
+
+inline constexpr std::uint32_t array_max = 4096;
+inline constexpr std::size_t bitmap_words = 1024;
+inline constexpr std::size_t bitmap_bytes = bitmap_words * sizeof(std::uint64_t);
+inline constexpr std::uint32_t chunk_size = 65536;
+
+inline std::uint16_t load16(const unsigned char* p) noexcept {
+    std::uint16_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+inline std::uint32_t load32(const unsigned char* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+inline std::uint64_t load64(const unsigned char* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+inline void store16(unsigned char* p, std::uint16_t v) noexcept { std::memcpy(p, &v, sizeof v); }
+inline void store32(unsigned char* p, std::uint32_t v) noexcept { std::memcpy(p, &v, sizeof v); }
+
+// Sets bits [first, last] of a chunk bitmap.
+inline void set_range(std::uint64_t* words, std::uint32_t first, std::uint32_t last) noexcept {
+    const std::uint32_t fw = first / 64;
+    const std::uint32_t lw = last / 64;
+    const std::uint64_t first_mask = ~std::uint64_t{0} << (first % 64);
+    const std::uint64_t last_mask = ~std::uint64_t{0} >> (63 - last % 64);
+    if (fw == lw) {
+        words[fw] |= first_mask & last_mask;
+        return;
+    }
+    words[fw] |= first_mask;
+    for (std::uint32_t w = fw + 1; w < lw; ++w)
+        words[w] = ~std::uint64_t{0};
+    words[lw] |= last_mask;
+}
+
+// Index of the first set (Set) or clear (!Set) bit at or after i, or chunk_size.
+template <bool Set>
+inline std::uint32_t next_bit(const std::uint64_t* words, std::uint32_t i) noexcept {
+    if (i >= chunk_size)
+        return chunk_size;
+    std::size_t w = i / 64;
+    std::uint64_t bits = (Set ? words[w] : ~words[w]) & (~std::uint64_t{0} << (i % 64));
+    while (bits == 0) {
+        if (++w == bitmap_words)
+            return chunk_size;
+        bits = Set ? words[w] : ~words[w];
+    }
+    return static_cast<std::uint32_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+}
+
+// Number of maximal runs of set bits: every set bit whose predecessor is clear starts one.
+inline std::uint32_t count_runs(const std::uint64_t* words) noexcept {
+    std::uint32_t runs = 0;
+    std::uint64_t carry = 0;
+    for (std::size_t w = 0; w < bitmap_words; ++w) {
+        runs += static_cast<std::uint32_t>(std::popcount(words[w] & ~((words[w] << 1) | carry)));
+        carry = words[w] >> 63;
+    }
+    return runs;
+}
+
+// Smallest form for a container with the given cardinality and number of runs.
+inline container_type best_type(std::uint32_t cardinality, std::uint32_t runs) noexcept {
+    const std::size_t run_bytes = 2 + 4 * std::size_t(runs);
+    const std::size_t other_bytes = cardinality <= array_max ? 2 * std::size_t(cardinality) : bitmap_bytes;
+    if (run_bytes < other_bytes)
+        return container_type::run;
+    return cardinality <= array_max ? container_type::array : container_type::bitmap;
+}
+
+// Read-only view of one container's data, which may be unaligned.
+struct container_view {
+    container_type type = container_type::array;
+    std::uint32_t cardinality = 0;
+    std::uint32_t size = 0; // Values (array) or runs (run); unused for bitmaps.
+    const unsigned char* data = nullptr;
+
+    std::uint16_t value(std::uint32_t i) const noexcept { return load16(data + 2 * std::size_t(i)); }
+    std::uint64_t word(std::size_t i) const noexcept { return load64(data + 8 * i); }
+    std::uint32_t run_first(std::uint32_t i) const noexcept { return load16(data + 4 * std::size_t(i)); }
+    std::uint32_t run_last(std::uint32_t i) const noexcept {
+        return run_first(i) + load16(data + 4 * std::size_t(i) + 2);
+    }
+
+    std::size_t bytes() const noexcept {
+        switch (type) {
+        case container_type::array:
+            return 2 * std::size_t(size);
+        case container_type::bitmap:
+            return bitmap_bytes;
+        case container_type::run:
+            return 4 * std::size_t(size);
+        }
+        return 0;
+    }
+
+    // Whether the contents match the invariants the kernels rely on: array values strictly
+    // increasing, runs sorted, disjoint and inside the chunk, and the cardinality equal to the
+    // number of values held. Used to vet untrusted serialized input.
+    bool well_formed() const noexcept {
+        switch (type) {
+        case container_type::array:
+            if (size != cardinality)
+                return false;
+            for (std::uint32_t i = 1; i < size; ++i) {
+                if (value(i) <= value(i - 1))
+                    return false;
+            }
+            return true;
+        case container_type::bitmap: {
+            std::uint32_t n = 0;
+            for (std::size_t w = 0; w < bitmap_words; ++w)
+                n += static_cast<std::uint32_t>(std::popcount(word(w)));
+            return n == cardinality;
+        }
+        case container_type::run: {
+            std::uint32_t n = 0;
+            for (std::uint32_t i = 0; i < size; ++i) {
+                if (run_last(i) >= chunk_size || (i != 0 && run_first(i) <= run_last(i - 1)))
+                    return false;
+                n += run_last(i) - run_first(i) + 1;
+            }
+            return n == cardinality;
+        }
+        }
+        return false;
+    }
+
+    bool contains(std::uint16_t x) const noexcept {
+        switch (type) {
+        case container_type::array: {
+            std::uint32_t lo = 0;
+            std::uint32_t hi = size;
+            while (lo < hi) {
+                const std::uint32_t mid = lo + (hi - lo) / 2;
+                const std::uint16_t v = value(mid);
+                if (v == x)
+                    return true;
+                if (v < x)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return false;
+        }
+        case container_type::bitmap:
+            return (word(x / 64) >> (x % 64)) & 1;
+        case container_type::run: {
+            // lo = number of runs starting at or before x.
+            std::uint32_t lo = 0;
+            std::uint32_t hi = size;
+            while (lo < hi) {
+                const std::uint32_t mid = lo + (hi - lo) / 2;
+                if (run_first(mid) <= x)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return lo != 0 && x <= run_last(lo - 1);
+        }
+        }
+        return false;
+    }
+
+    // Sets the container's values in a zeroed or partially filled chunk bitmap.
+    void or_into(std::uint64_t* words) const noexcept {
+        switch (type) {
+        case container_type::array:
+            for (std::uint32_t i = 0; i < size; ++i) {
+                const std::uint16_t v = value(i);
+                words[v / 64] |= std::uint64_t{1} << (v % 64);
+            }
+            break;
+        case container_type::bitmap:
+            for (std::size_t w = 0; w < bitmap_words; ++w)
+                words[w] |= word(w);
+            break;
+        case container_type::run:
+            for (std::uint32_t i = 0; i < size; ++i)
+                set_range(words, run_first(i), run_last(i));
+            break;
+        }
+    }
+
+    std::uint32_t count_runs() const noexcept {
+        switch (type) {
+        case container_type::array: {
+            std::uint32_t runs = size != 0;
+            for (std::uint32_t i = 1; i < size; ++i)
+                runs += value(i) != value(i - 1) + 1;
+            return runs;
+        }
+        case container_type::bitmap: {
+            std::uint32_t runs = 0;
+            std::uint64_t carry = 0;
+            for (std::size_t w = 0; w < bitmap_words; ++w) {
+                const std::uint64_t bits = word(w);
+                runs += static_cast<std::uint32_t>(std::popcount(bits & ~((bits << 1) | carry)));
+                carry = bits >> 63;
+            }
+            return runs;
+        }
+        case container_type::run:
+            return size;
+        }
+        return 0;
+    }
+
+    // Set bits of a bitmap container within [first, last].
+    std::uint32_t count_range(std::uint32_t first, std::uint32_t last) const noexcept {
+        const std::uint32_t fw = first / 64;
+        const std::uint32_t lw = last / 64;
+        const std::uint64_t first_mask = ~std::uint64_t{0} << (first % 64);
+        const std::uint64_t last_mask = ~std::uint64_t{0} >> (63 - last % 64);
+        if (fw == lw)
+            return static_cast<std::uint32_t>(std::popcount(word(fw) & first_mask & last_mask));
+        std::uint32_t n = static_cast<std::uint32_t>(std::popcount(word(fw) & first_mask) +
+                                                     std::popcount(word(lw) & last_mask));
+        for (std::uint32_t w = fw + 1; w < lw; ++w)
+            n += static_cast<std::uint32_t>(std::popcount(word(w)));
+        return n;
+    }
+
+    // Calls f(high | v) for every value v, in increasing order.
+    template <class F>
+    void for_each(std::uint32_t high, F& f) const {
+        switch (type) {
+        case container_type::array:
+            for (std::uint32_t i = 0; i < size; ++i)
+                f(high | value(i));
+            break;
+        case container_type::bitmap:
+            for (std::size_t w = 0; w < bitmap_words; ++w) {
+                for (std::uint64_t bits = word(w); bits != 0; bits &= bits - 1)
+                    f(high | static_cast<std::uint32_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(bits))));
+            }
+            break;
+        case container_type::run:
+            for (std::uint32_t i = 0; i < size; ++i) {
+                for (std::uint32_t v = run_first(i), last = run_last(i); v <= last; ++v)
+                    f(high | v);
+            }
+            break;
+        }
+    }
+};
+
+// Number of values in both containers.
+inline std::uint32_t and_cardinality(const container_view& a, const container_view& b) noexcept {
+    if (a.type == container_type::array || b.type == container_type::array) {
+        const container_view& small = a.type == container_type::array ? a : b;
+        const container_view& other = a.type == container_type::array ? b : a;
+        std::uint32_t n = 0;
+        for (std::uint32_t i = 0; i < small.size; ++i)
+            n += other.contains(small.value(i));
+        return n;
+    }
+    if (a.type == container_type::run && b.type == container_type::run) {
+        std::uint32_t n = 0;
+        for (std::uint32_t i = 0, j = 0; i < a.size && j < b.size;) {
+            const std::uint32_t first = std::max(a.run_first(i), b.run_first(j));
+            const std::uint32_t last = std::min(a.run_last(i), b.run_last(j));
+            if (first <= last)
+                n += last - first + 1;
+            if (a.run_last(i) < b.run_last(j))
+                ++i;
+            else
+                ++j;
+        }
+        return n;
+    }
+    if (a.type == container_type::run || b.type == container_type::run) {
+        const container_view& runs = a.type == container_type::run ? a : b;
+        const container_view& bitmap = a.type == container_type::run ? b : a;
+        std::uint32_t n = 0;
+        for (std::uint32_t i = 0; i < runs.size; ++i)
+            n += bitmap.count_range(runs.run_first(i), runs.run_last(i));
+        return n;
+    }
+    std::uint32_t n = 0;
+    for (std::size_t w = 0; w < bitmap_words; ++w)
+        n += static_cast<std::uint32_t>(std::popcount(a.word(w) & b.word(w)));
+    return n;
+}
+
+// Anything that exposes its containers in key order: roaring_bitmap and frozen_roaring_bitmap.
+template <class S>
+concept source = requires(const S& s, std::size_t i) {
+    { s.container_count() } -> std::convertible_to<std::size_t>;
+    { s.key_at(i) } -> std::convertible_to<std::uint16_t>;
+    { s.container_at(i) } -> std::same_as<container_view>;
+};
+
+template <source S>
+inline std::size_t lower_bound_key(const S& s, std::uint16_t key) noexcept {
+    std::size_t lo = 0;
+    std::size_t hi = s.container_count();
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (s.key_at(mid) < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+template <source S>
+inline bool contains(const S& s, std::uint32_t x) noexcept {
+    const auto key = static_cast<std::uint16_t>(x >> 16);
+    const std::size_t i = lower_bound_key(s, key);
+    return i != s.container_count() && s.key_at(i) == key && s.container_at(i).contains(static_cast<std::uint16_t>(x));
+}
+
+template <source S>
+inline std::uint64_t cardinality(const S& s) noexcept {
+    std::uint64_t n = 0;
+    for (std::size_t i = 0; i < s.container_count(); ++i)
+        n += s.container_at(i).cardinality;
+    return n;
+}
+
+template <source S, class F>
+inline void for_each(const S& s, F& f) {
+    for (std::size_t i = 0; i < s.container_count(); ++i)
+        s.container_at(i).for_each(std::uint32_t(s.key_at(i)) << 16, f);
+}
+
+// Scratch space for the set operations: two chunk bitmaps and one full array, allocated once
+// per operation rather than per container.
+class workspace {
+public:
+    workspace() noexcept
+        : block_(static_cast<unsigned char*>(allocate_bytes(2 * bitmap_bytes + 2 * array_max, cache_line_size))) {}
+    workspace(const workspace&) = delete;
+    workspace& operator=(const workspace&) = delete;
+    ~workspace() {
+        if (block_ != nullptr)
+            deallocate_bytes(block_, cache_line_size);
+    }
+
+    explicit operator bool() const noexcept { return block_ != nullptr; }
+    std::uint64_t* first() noexcept { return reinterpret_cast<std::uint64_t*>(block_); }
+    std::uint64_t* second() noexcept { return reinterpret_cast<std::uint64_t*>(block_ + bitmap_bytes); }
+    std::uint16_t* values() noexcept { return reinterpret_cast<std::uint16_t*>(block_ + 2 * bitmap_bytes); }
+
+private:
+    unsigned char* block_;
+};
+
+inline void load_words(const container_view& c, std::uint64_t* words) noexcept {
+    std::fill_n(words, bitmap_words, std::uint64_t{0});
+    c.or_into(words);
+}
+
+} // namespace detail::roaring
+
+// ---------------------------------------------------------------------------------------
+// frozen_roaring_bitmap
+// Read-only, zero-copy view of a bitmap in the portable Roaring serialized format (the format
+// shared by the CRoaring and Java implementations), e.g. over a memory-mapped file. view()
+// checks the header, that every container lies inside the buffer and that its contents are
+// well formed, in one pass over the buffer. The buffer must outlive the view; no alignment is
+// required.
+// ---------------------------------------------------------------------------------------
+class frozen_roaring_bitmap {
+    using container_view = detail::roaring::container_view;
+    using container_type = detail::roaring::container_type;
+
+public:
+    using value_type = std::uint32_t;
+    using size_type = std::uint64_t;
+
+    frozen_roaring_bitmap() noexcept = default;
+
+    static expected<frozen_roaring_bitmap, errc> view(std::span<const std::byte> bytes) noexcept {
+        using namespace detail::roaring;
+        const auto* base = reinterpret_cast<const unsigned char*>(bytes.data());
+        const std::size_t length = bytes.size();
+        frozen_roaring_bitmap result;
+        result.base_ = base;
+
+        if (length < 4)
+            return unexpected(errc::corrupt_data);
+        const std::uint32_t cookie = load32(base);
+        std::size_t pos;
+        if ((cookie & 0xffff) == run_cookie) {
+            result.count_ = (cookie >> 16) + 1;
+            result.run_flags_ = base + 4;
+            pos = 4 + (std::size_t(result.count_) + 7) / 8;
+        } else if (cookie == no_run_cookie) {
+            if (length < 8)
+                return unexpected(errc::corrupt_data);
+            result.count_ = load32(base + 4);
+            if (result.count_ > chunk_size)
+                return unexpected(errc::corrupt_data);
+            pos = 8;
+        } else {
+            return unexpected(errc::corrupt_data);
+        }
+
+        const std::size_t n = result.count_;
+        const bool has_offsets = result.run_flags_ == nullptr || n >= no_offset_threshold;
+        if (length < pos + 4 * n + (has_offsets ? 4 * n : 0))
+            return unexpected(errc::corrupt_data);
+        result.header_ = base + pos;
+        pos += 4 * n;
+        if (has_offsets) {
+            result.offsets_ = base + pos;
+            pos += 4 * n;
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i != 0 && result.key_at(i) <= result.key_at(i - 1))
+                return unexpected(errc::corrupt_data);
+            std::size_t offset = has_offsets ? load32(result.offsets_ + 4 * i) : pos;
+            if (!has_offsets)
+                result.small_offsets_[i] = static_cast<std::uint32_t>(offset);
+            if (result.is_run(i)) {
+                if (offset + 2 > length)
+                    return unexpected(errc::corrupt_data);
+                offset += 2 + 4 * std::size_t(load16(base + offset));
+            } else {
+                const std::uint32_t card = result.header_cardinality(i);
+                offset += card <= array_max ? 2 * std::size_t(card) : bitmap_bytes;
+            }
+            if (offset > length || !result.container_at(i).well_formed())
+                return unexpected(errc::corrupt_data);
+            pos = std::max(pos, offset);
+        }
+        result.bytes_ = pos;
+        return result;
+    }
+
+    bool empty() const noexcept { return count_ == 0; }
+    size_type cardinality() const noexcept { return detail::roaring::cardinality(*this); }
+    bool contains(value_type x) const noexcept { return detail::roaring::contains(*this, x); }
+
+    // Calls f(value) for every value in increasing order.
+    template <class F>
+    void for_each(F&& f) const {
+        detail::roaring::for_each(*this, f);
+    }
+
+    // Bytes of the buffer covered by the serialized bitmap.
+    std::size_t serialized_size() const noexcept { return bytes_; }
+
+    std::size_t container_count() const noexcept { return count_; }
+    std::uint16_t key_at(std::size_t i) const noexcept { return detail::roaring::load16(header_ + 4 * i); }
+
+    container_view container_at(std::size_t i) const noexcept {
+        using namespace detail::roaring;
+        const std::size_t offset = offsets_ != nullptr ? load32(offsets_ + 4 * i) : small_offsets_[i];
+        const std::uint32_t card = header_cardinality(i);
+        if (is_run(i))
+            return {container_type::run, card, load16(base_ + offset), base_ + offset + 2};
+        if (card <= array_max)
+            return {container_type::array, card, card, base_ + offset};
+        return {container_type::bitmap, card, 0, base_ + offset};
+    }
+
+private:
+    friend class roaring_bitmap;
+
+    static constexpr std::uint32_t no_run_cookie = 12346;
+    static constexpr std::uint32_t run_cookie = 12347;
+    static constexpr std::size_t no_offset_threshold = 4; // Run-format bitmaps with fewer containers omit offsets.
+
+    bool is_run(std::size_t i) const noexcept { return run_flags_ != nullptr && ((run_flags_[i / 8] >> (i % 8)) & 1); }
+    std::uint32_t header_cardinality(std::size_t i) const noexcept {
+        return std::uint32_t(detail::roaring::load16(header_ + 4 * i + 2)) + 1;
+    }
+
+    const unsigned char* base_ = nullptr;
+    const unsigned char* run_flags_ = nullptr; // One bit per container, or null without runs.
+    const unsigned char* header_ = nullptr;    // (key, cardinality - 1) pairs.
+    const unsigned char* offsets_ = nullptr;   // Container offsets, or null when small_offsets_ is used.
+    std::array<std::uint32_t, no_offset_threshold> small_offsets_{};
+    std::size_t count_ = 0;
+    std::size_t bytes_ = 0;
+};
+
+// ---------------------------------------------------------------------------------------
+// roaring_bitmap
+// Compressed set of 32-bit integers (Roaring): values are grouped by their high 16 bits into
+// chunks, and each chunk uses whichever of a sorted array, a 64 Kibit bitmap or a run list is
+// smallest. Sparse sets cost about two bytes per value, dense ones one bit, and long ranges a
+// few bytes. Set operations work chunk by chunk and pick a kernel per container pair:
+// array/array merges, array/other probes, bitmap/bitmap word loops, run/run interval sweeps.
+//
+// intersect() and unite() accept any mix of roaring_bitmap and frozen_roaring_bitmap, so
+// queries can combine an in-memory bitmap with one mapped from disk without deserializing it.
+// serialize() writes the portable Roaring format.
+// ---------------------------------------------------------------------------------------
+class roaring_bitmap {
+    using container_view = detail::roaring::container_view;
+    using container_type = detail::roaring::container_type;
+
+public:
+    using value_type = std::uint32_t;
+    using size_type = std::uint64_t;
+
+    roaring_bitmap() noexcept = default;
+
+    roaring_bitmap(const roaring_bitmap&) = delete;
+    roaring_bitmap& operator=(const roaring_bitmap&) = delete;
+
+    roaring_bitmap(roaring_bitmap&& other) noexcept
+        : entries_(std::exchange(other.entries_, nullptr)), count_(std::exchange(other.count_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {}
+
+    roaring_bitmap& operator=(roaring_bitmap&& other) noexcept {
+        if (this != &other) {
+            release();
+            entries_ = std::exchange(other.entries_, nullptr);
+            count_ = std::exchange(other.count_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~roaring_bitmap() { release(); }
+
+    static expected<roaring_bitmap, errc> copy(const roaring_bitmap& other) noexcept { return copy_of(other); }
+    static expected<roaring_bitmap, errc> copy(const frozen_roaring_bitmap& other) noexcept { return copy_of(other); }
+
+    // Reads a bitmap in the portable format into owned memory.
+    static expected<roaring_bitmap, errc> deserialize(std::span<const std::byte> bytes) noexcept {
+        auto view = frozen_roaring_bitmap::view(bytes);
+        if (!view)
+            return unexpected(view.error());
+        return copy_of(*view);
+    }
+
+    bool empty() const noexcept { return count_ == 0; }
+    size_type cardinality() const noexcept { return detail::roaring::cardinality(*this); }
+    bool contains(value_type x) const noexcept { return detail::roaring::contains(*this, x); }
+
+    // Calls f(value) for every value in increasing order.
+    template <class F>
+    void for_each(F&& f) const {
+        detail::roaring::for_each(*this, f);
+    }
+
+    std::size_t container_count() const noexcept { return count_; }
+    std::uint16_t key_at(std::size_t i) const noexcept { return entries_[i].key; }
+    container_view container_at(std::size_t i) const noexcept { return entries_[i].view(); }
+
+    // Adds x; returns whether it was absent.
+    expected<bool, errc> try_add(value_type x) noexcept {
+        const auto key = static_cast<std::uint16_t>(x >> 16);
+        const std::size_t i = detail::roaring::lower_bound_key(*this, key);
+        if (i == count_ || entries_[i].key != key) {
+            unsigned char* data = allocate_data(2 * initial_capacity);
+            if (data == nullptr)
+                return unexpected(errc::out_of_memory);
+            if (auto inserted = insert_entry(i, {key, container_type::array, 0, 0, initial_capacity, data}); !inserted) {
+                free_data(data);
+                return unexpected(inserted.error());
+            }
+        }
+        return add_to(entries_[i], static_cast<std::uint16_t>(x));
+    }
+
+    // Adds every value in [first, last]. A range covering a whole chunk becomes a single run. On
+    // failure the chunks before the failing one have been added.
+    expected<void, errc> try_add_range(value_type first, value_type last) noexcept {
+        EXTL_ASSERT(first <= last);
+        std::uint64_t* words = nullptr;
+        expected<void, errc> result;
+        for (std::uint32_t key = first >> 16;; ++key) {
+            const std::uint32_t lo = key == first >> 16 ? first & 0xffff : 0;
+            const std::uint32_t hi = key == last >> 16 ? last & 0xffff : 0xffff;
+            const std::size_t i = detail::roaring::lower_bound_key(*this, static_cast<std::uint16_t>(key));
+            if (i == count_ || entries_[i].key != key) {
+                unsigned char* data = allocate_data(4);
+                if (data == nullptr) {
+                    result = unexpected(errc::out_of_memory);
+                    break;
+                }
+                detail::roaring::store16(data, static_cast<std::uint16_t>(lo));
+                detail::roaring::store16(data + 2, static_cast<std::uint16_t>(hi - lo));
+                result = insert_entry(i, {static_cast<std::uint16_t>(key), container_type::run, hi - lo + 1, 1, 1, data});
+                if (!result) {
+                    free_data(data);
+                    break;
+                }
+            } else {
+                if (words == nullptr) {
+                    words = allocate<std::uint64_t>(detail::roaring::bitmap_words);
+                    if (words == nullptr) {
+                        result = unexpected(errc::out_of_memory);
+                        break;
+                    }
+                }
+                detail::roaring::load_words(entries_[i].view(), words);
+                detail::roaring::set_range(words, lo, hi);
+                const auto card = static_cast<std::uint32_t>(detail::popcount(words, detail::roaring::bitmap_words));
+                result = rebuild(entries_[i], words, card);
+                if (!result)
+                    break;
+            }
+            if (key == last >> 16)
+                break;
+        }
+        deallocate(words);
+        return result;
+    }
+
+    // Removes x; returns whether it was present. Fails only when splitting a run needs memory.
+    expected<bool, errc> try_remove(value_type x) noexcept {
+        const auto key = static_cast<std::uint16_t>(x >> 16);
+        const auto low = static_cast<std::uint16_t>(x);
+        const std::size_t i = detail::roaring::lower_bound_key(*this, key);
+        if (i == count_ || entries_[i].key != key)
+            return false;
+        entry& e = entries_[i];
+        switch (e.type) {
+        case container_type::array: {
+            auto* values = reinterpret_cast<std::uint16_t*>(e.data);
+            auto* pos = std::lower_bound(values, values + e.size, low);
+            if (pos == values + e.size || *pos != low)
+                return false;
+            std::memmove(pos, pos + 1, (values + e.size - pos - 1) * sizeof(std::uint16_t));
+            --e.size;
+            break;
+        }
+        case container_type::bitmap: {
+            std::uint64_t& w = reinterpret_cast<std::uint64_t*>(e.data)[low / 64];
+            const std::uint64_t bit = std::uint64_t{1} << (low % 64);
+            if ((w & bit) == 0)
+                return false;
+            w &= ~bit;
+            break;
+        }
+        case container_type::run: {
+            const container_view v = e.view();
+            const std::uint32_t r = runs_at_or_before(v, low);
+            if (r == 0 || low > v.run_last(r - 1))
+                return false;
+            auto* runs = reinterpret_cast<std::uint16_t*>(e.data) + 2 * (r - 1);
+            const std::uint32_t first = runs[0];
+            const std::uint32_t last = first + runs[1];
+            if (first == last) {
+                erase_run(e, r - 1);
+            } else if (low == first) {
+                ++runs[0];
+                --runs[1];
+            } else if (low == last) {
+                --runs[1];
+            } else {
+                if (auto grown = insert_run(e, r, low + 1, last); !grown)
+                    return unexpected(grown.error());
+                reinterpret_cast<std::uint16_t*>(e.data)[2 * (r - 1) + 1] = static_cast<std::uint16_t>(low - 1 - first);
+            }
+            break;
+        }
+        }
+        if (--e.cardinality == 0) {
+            erase_entry(i);
+        } else if (e.type == container_type::bitmap && e.cardinality <= detail::roaring::array_max) {
+            (void)convert(e, container_type::array); // Best effort: the bitmap stays valid on failure.
+        }
+        return true;
+    }
+
+    // Converts every container to its smallest form, turning long runs of values into run
+    // containers. Worth calling once a bitmap is built and before serializing it.
+    expected<void, errc> try_optimize() noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            entry& e = entries_[i];
+            const container_view v = e.view();
+            const container_type best = detail::roaring::best_type(e.cardinality, v.count_runs());
+            if (best != e.type) {
+                if (auto result = convert(e, best); !result)
+                    return result;
+            }
+        }
+        return {};
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i < count_; ++i)
+            free_data(entries_[i].data);
+        count_ = 0;
+    }
+
+    // Size of serialize()'s output in bytes.
+    std::size_t serialized_size() const noexcept {
+        const bool runs = has_runs();
+        std::size_t bytes = runs ? 4 + (count_ + 7) / 8 : 8;
+        bytes += 4 * count_;
+        if (!runs || count_ >= frozen_roaring_bitmap::no_offset_threshold)
+            bytes += 4 * count_;
+        for (std::size_t i = 0; i < count_; ++i)
+            bytes += serialized_bytes(entries_[i]);
+        return bytes;
+    }
+
+    // Writes the bitmap in the portable Roaring format and returns the bytes written.
+    // Precondition: out.size() >= serialized_size().
+    std::size_t serialize(std::span<std::byte> out) const noexcept {
+        using namespace detail::roaring;
+        EXTL_ASSERT(out.size() >= serialized_size());
+        auto* p = reinterpret_cast<unsigned char*>(out.data());
+        const bool runs = has_runs();
+        std::size_t pos;
+        if (runs) {
+            store32(p, frozen_roaring_bitmap::run_cookie | static_cast<std::uint32_t>((count_ - 1) << 16));
+            pos = 4;
+            const std::size_t flag_bytes = (count_ + 7) / 8;
+            std::memset(p + pos, 0, flag_bytes);
+            for (std::size_t i = 0; i < count_; ++i) {
+                if (entries_[i].type == container_type::run)
+                    p[pos + i / 8] |= static_cast<unsigned char>(1u << (i % 8));
+            }
+            pos += flag_bytes;
+        } else {
+            store32(p, frozen_roaring_bitmap::no_run_cookie);
+            store32(p + 4, static_cast<std::uint32_t>(count_));
+            pos = 8;
+        }
+        for (std::size_t i = 0; i < count_; ++i) {
+            store16(p + pos, entries_[i].key);
+            store16(p + pos + 2, static_cast<std::uint16_t>(entries_[i].cardinality - 1));
+            pos += 4;
+        }
+        std::size_t data_pos = pos;
+        if (!runs || count_ >= frozen_roaring_bitmap::no_offset_threshold) {
+            data_pos += 4 * count_;
+            for (std::size_t i = 0; i < count_; ++i) {
+                store32(p + pos + 4 * i, static_cast<std::uint32_t>(data_pos));
+                data_pos += serialized_bytes(entries_[i]);
+            }
+            data_pos = pos + 4 * count_;
+        }
+        for (std::size_t i = 0; i < count_; ++i) {
+            const entry& e = entries_[i];
+            if (e.type == container_type::run) {
+                store16(p + data_pos, static_cast<std::uint16_t>(e.size));
+                data_pos += 2;
+            }
+            const std::size_t bytes = e.view().bytes();
+            std::memcpy(p + data_pos, e.data, bytes);
+            data_pos += bytes;
+        }
+        return data_pos;
+    }
+
+    // Values present in both a and b.
+    template <detail::roaring::source A, detail::roaring::source B>
+    static expected<roaring_bitmap, errc> intersect(const A& a, const B& b) noexcept {
+        detail::roaring::workspace ws;
+        if (!ws)
+            return unexpected(errc::out_of_memory);
+        roaring_bitmap result;
+        for (std::size_t i = 0, j = 0; i < a.container_count() && j < b.container_count();) {
+            const std::uint16_t ka = a.key_at(i);
+            const std::uint16_t kb = b.key_at(j);
+            if (ka < kb) {
+                ++i;
+            } else if (kb < ka) {
+                ++j;
+            } else {
+                if (auto r = result.append_and(ka, a.container_at(i), b.container_at(j), ws); !r)
+                    return unexpected(r.error());
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    // Values present in a or b.
+    template <detail::roaring::source A, detail::roaring::source B>
+    static expected<roaring_bitmap, errc> unite(const A& a, const B& b) noexcept {
+        detail::roaring::workspace ws;
+        if (!ws)
+            return unexpected(errc::out_of_memory);
+        roaring_bitmap result;
+        const std::size_t na = a.container_count();
+        const std::size_t nb = b.container_count();
+        for (std::size_t i = 0, j = 0; i < na || j < nb;) {
+            expected<void, errc> r;
+            if (j == nb || (i < na && a.key_at(i) < b.key_at(j))) {
+                r = result.append_copy(a.key_at(i), a.container_at(i));
+                ++i;
+            } else if (i == na || b.key_at(j) < a.key_at(i)) {
+                r = result.append_copy(b.key_at(j), b.container_at(j));
+                ++j;
+            } else {
+                r = result.append_or(a.key_at(i), a.container_at(i), b.container_at(j), ws);
+                ++i;
+                ++j;
+            }
+            if (!r)
+                return unexpected(r.error());
+        }
+        return result;
+    }
+
+    // Size of the intersection, computed without building it.
+    template <detail::roaring::source A, detail::roaring::source B>
+    static size_type intersect_cardinality(const A& a, const B& b) noexcept {
+        size_type n = 0;
+        for (std::size_t i = 0, j = 0; i < a.container_count() && j < b.container_count();) {
+            const std::uint16_t ka = a.key_at(i);
+            const std::uint16_t kb = b.key_at(j);
+            if (ka < kb) {
+                ++i;
+            } else if (kb < ka) {
+                ++j;
+            } else {
+                n += detail::roaring::and_cardinality(a.container_at(i), b.container_at(j));
+                ++i;
+                ++j;
+            }
+        }
+        return n;
+    }
+
+private:
+    struct entry {
+        std::uint16_t key;
+        container_type type;
+        std::uint32_t cardinality;
+        std::uint32_t size;     // Values (array) or runs (run).
+        std::uint32_t capacity; // Allocated values or runs; unused for bitmaps.
+        unsigned char* data;
+
+        container_view view() const noexcept { return {type, cardinality, size, data}; }
+    };
+
+    static constexpr std::uint32_t initial_capacity = 4;
+    static constexpr std::size_t data_alignment = alignof(std::uint64_t);
+
+    static unsigned char* allocate_data(std::size_t bytes) noexcept {
+        return static_cast<unsigned char*>(allocate_bytes(bytes == 0 ? 1 : bytes, data_alignment));
+    }
+    static void free_data(unsigned char* data) noexcept {
+        if (data != nullptr)
+            deallocate_bytes(data, data_alignment);
+    }
+
+    static std::size_t serialized_bytes(const entry& e) noexcept {
+        return e.view().bytes() + (e.type == container_type::run ? 2 : 0);
+    }
+
+    // Number of runs starting at or before x.
+    static std::uint32_t runs_at_or_before(const container_view& v, std::uint32_t x) noexcept {
+        std::uint32_t lo = 0;
+        std::uint32_t hi = v.size;
+        while (lo < hi) {
+            const std::uint32_t mid = lo + (hi - lo) / 2;
+            if (v.run_first(mid) <= x)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    bool has_runs() const noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (entries_[i].type == container_type::run)
+                return true;
+        }
+        return false;
+    }
+
+    template <class S>
+    static expected<roaring_bitmap, errc> copy_of(const S& other) noexcept {
+        roaring_bitmap result;
+        for (std::size_t i = 0; i < other.container_count(); ++i) {
+            if (auto r = result.append_copy(other.key_at(i), other.container_at(i)); !r)
+                return unexpected(r.error());
+        }
+        return result;
+    }
+
+    expected<void, errc> insert_entry(std::size_t i, const entry& e) noexcept {
+        if (count_ == capacity_) {
+            const std::size_t capacity = detail::grow_capacity(capacity_, count_ + 1);
+            entry* entries = allocate<entry>(capacity);
+            if (entries == nullptr)
+                return unexpected(errc::out_of_memory);
+            if (count_ != 0)
+                std::memcpy(static_cast<void*>(entries), entries_, count_ * sizeof(entry));
+            deallocate(entries_);
+            entries_ = entries;
+            capacity_ = capacity;
+        }
+        std::memmove(static_cast<void*>(entries_ + i + 1), entries_ + i, (count_ - i) * sizeof(entry));
+        entries_[i] = e;
+        ++count_;
+        return {};
+    }
+
+    void erase_entry(std::size_t i) noexcept {
+        free_data(entries_[i].data);
+        std::memmove(static_cast<void*>(entries_ + i), entries_ + i + 1, (count_ - i - 1) * sizeof(entry));
+        --count_;
+    }
+
+    // Appends a container with the next key in order.
+    expected<void, errc> push_entry(const entry& e) noexcept {
+        if (auto r = insert_entry(count_, e); !r) {
+            free_data(e.data);
+            return r;
+        }
+        return {};
+    }
+
+    // Grows an array or run container to hold `capacity` values or runs.
+    static expected<void, errc> reserve(entry& e, std::uint32_t capacity) noexcept {
+        const std::size_t unit = e.type == container_type::run ? 4 : 2;
+        unsigned char* data = allocate_data(unit * capacity);
+        if (data == nullptr)
+            return unexpected(errc::out_of_memory);
+        std::memcpy(data, e.data, unit * e.size);
+        free_data(e.data);
+        e.data = data;
+        e.capacity = capacity;
+        return {};
+    }
+
+    static std::uint32_t grown(const entry& e, std::uint32_t limit) noexcept {
+        return static_cast<std::uint32_t>(std::min<std::size_t>(limit, detail::grow_capacity(e.capacity, e.size + 1, 4)));
+    }
+
+    // Inserts run [first, last] before run r.
+    static expected<void, errc> insert_run(entry& e, std::uint32_t r, std::uint32_t first, std::uint32_t last) noexcept {
+        if (e.size == e.capacity) {
+            if (auto result = reserve(e, grown(e, detail::roaring::chunk_size / 2)); !result)
+                return result;
+        }
+        auto* runs = reinterpret_cast<std::uint16_t*>(e.data);
+        std::memmove(runs + 2 * (r + 1), runs + 2 * r, 4 * std::size_t(e.size - r));
+        runs[2 * r] = static_cast<std::uint16_t>(first);
+        runs[2 * r + 1] = static_cast<std::uint16_t>(last - first);
+        ++e.size;
+        return {};
+    }
+
+    static void erase_run(entry& e, std::uint32_t r) noexcept {
+        auto* runs = reinterpret_cast<std::uint16_t*>(e.data);
+        std::memmove(runs + 2 * r, runs + 2 * (r + 1), 4 * std::size_t(e.size - r - 1));
+        --e.size;
+    }
+
+    expected<bool, errc> add_to(entry& e, std::uint16_t low) noexcept {
+        switch (e.type) {
+        case container_type::array: {
+            auto* values = reinterpret_cast<std::uint16_t*>(e.data);
+            auto* pos = std::lower_bound(values, values + e.size, low);
+            if (pos != values + e.size && *pos == low)
+                return false;
+            if (e.size == detail::roaring::array_max) {
+                if (auto r = convert(e, container_type::bitmap); !r)
+                    return unexpected(r.error());
+                return add_to(e, low);
+            }
+            if (e.size == e.capacity) {
+                const auto index = pos - values;
+                if (auto r = reserve(e, grown(e, detail::roaring::array_max)); !r)
+                    return unexpected(r.error());
+                values = reinterpret_cast<std::uint16_t*>(e.data);
+                pos = values + index;
+            }
+            std::memmove(pos + 1, pos, (values + e.size - pos) * sizeof(std::uint16_t));
+            *pos = low;
+            ++e.size;
+            break;
+        }
+        case container_type::bitmap: {
+            std::uint64_t& w = reinterpret_cast<std::uint64_t*>(e.data)[low / 64];
+            const std::uint64_t bit = std::uint64_t{1} << (low % 64);
+            if (w & bit)
+                return false;
+            w |= bit;
+            break;
+        }
+        case container_type::run: {
+            const container_view v = e.view();
+            const std::uint32_t r = runs_at_or_before(v, low);
+            auto* runs = reinterpret_cast<std::uint16_t*>(e.data);
+            if (r != 0 && low <= v.run_last(r - 1))
+                return false;
+            if (r != 0 && low == v.run_last(r - 1) + 1) {
+                ++runs[2 * (r - 1) + 1];
+                if (r < e.size && runs[2 * r] == low + 1) {
+                    runs[2 * (r - 1) + 1] = static_cast<std::uint16_t>(runs[2 * (r - 1) + 1] + runs[2 * r + 1] + 1);
+                    erase_run(e, r);
+                }
+            } else if (r < e.size && runs[2 * r] == low + 1) {
+                --runs[2 * r];
+                ++runs[2 * r + 1];
+            } else if (auto inserted = insert_run(e, r, low, low); !inserted) {
+                return unexpected(inserted.error());
+            }
+            break;
+        }
+        }
+        ++e.cardinality;
+        return true;
+    }
+
+    // Replaces e's storage with a container of type `to` holding the same values.
+    static expected<void, errc> convert(entry& e, container_type to) noexcept {
+        const container_view v = e.view();
+        entry next = e;
+        next.type = to;
+        switch (to) {
+        case container_type::array: {
+            next.data = allocate_data(2 * std::size_t(e.cardinality));
+            if (next.data == nullptr)
+                return unexpected(errc::out_of_memory);
+            auto* out = reinterpret_cast<std::uint16_t*>(next.data);
+            auto append = [&out](std::uint32_t x) { *out++ = static_cast<std::uint16_t>(x); };
+            v.for_each(0, append);
+            next.size = next.capacity = e.cardinality;
+            break;
+        }
+        case container_type::bitmap:
+            next.data = allocate_data(detail::roaring::bitmap_bytes);
+            if (next.data == nullptr)
+                return unexpected(errc::out_of_memory);
+            detail::roaring::load_words(v, reinterpret_cast<std::uint64_t*>(next.data));
+            next.size = next.capacity = 0;
+            break;
+        case container_type::run: {
+            const std::uint32_t runs = v.count_runs();
+            next.data = allocate_data(4 * std::size_t(runs));
+            if (next.data == nullptr)
+                return unexpected(errc::out_of_memory);
+            auto* out = reinterpret_cast<std::uint16_t*>(next.data);
+            std::uint32_t n = 0;
+            auto append = [&](std::uint32_t x) {
+                if (n != 0 && x == std::uint32_t(out[2 * (n - 1)]) + out[2 * (n - 1) + 1] + 1) {
+                    ++out[2 * (n - 1) + 1];
+                } else {
+                    out[2 * n] = static_cast<std::uint16_t>(x);
+                    out[2 * n + 1] = 0;
+                    ++n;
+                }
+            };
+            v.for_each(0, append);
+            next.size = next.capacity = runs;
+            break;
+        }
+        }
+        free_data(e.data);
+        e = next;
+        return {};
+    }
+
+    // Replaces e's storage with the smallest container holding the set bits of words.
+    static expected<void, errc> rebuild(entry& e, const std::uint64_t* words, std::uint32_t cardinality) noexcept {
+        using namespace detail::roaring;
+        const std::uint32_t runs = count_runs(words);
+        entry next = e;
+        next.type = best_type(cardinality, runs);
+        next.cardinality = cardinality;
+        switch (next.type) {
+        case container_type::array: {
+            next.data = allocate_data(2 * std::size_t(cardinality));
+            if (next.data == nullptr)
+                return unexpected(errc::out_of_memory);
+            auto* out = reinterpret_cast<std::uint16_t*>(next.data);
+            for (std::size_t w = 0; w < bitmap_words; ++w) {
+                for (std::uint64_t bits = words[w]; bits != 0; bits &= bits - 1)
+                    *out++ = static_cast<std::uint16_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(bits)));
+            }
+            next.size = next.capacity = cardinality;
+            break;
+        }
+        case container_type::bitmap:
+            next.data = allocate_data(bitmap_bytes);
+            if (next.data == nullptr)
+                return unexpected(errc::out_of_memory);
+            std::memcpy(next.data, words, bitmap_bytes);
+            next.size = next.capacity = 0;
+            break;
+        case container_type::run: {
+            next.data = allocate_data(4 * std::size_t(runs));
+            if (next.data == nullptr)
+                return unexpected(errc::out_of_memory);
+            auto* out = reinterpret_cast<std::uint16_t*>(next.data);
+            for (std::uint32_t start = next_bit<true>(words, 0); start < chunk_size;) {
+                const std::uint32_t end = next_bit<false>(words, start);
+                *out++ = static_cast<std::uint16_t>(start);
+                *out++ = static_cast<std::uint16_t>(end - 1 - start);
+                start = next_bit<true>(words, end);
+            }
+            next.size = next.capacity = runs;
+            break;
+        }
+        }
+        free_data(e.data);
+        e = next;
+        return {};
+    }
+
+    expected<void, errc> append_copy(std::uint16_t key, const container_view& v) noexcept {
+        unsigned char* data = allocate_data(v.bytes());
+        if (data == nullptr)
+            return unexpected(errc::out_of_memory);
+        std::memcpy(data, v.data, v.bytes());
+        const std::uint32_t capacity = v.type == container_type::bitmap ? 0 : v.size;
+        return push_entry({key, v.type, v.cardinality, v.size, capacity, data});
+    }
+
+    expected<void, errc> append_array(std::uint16_t key, const std::uint16_t* values, std::uint32_t n) noexcept {
+        if (n == 0)
+            return {};
+        unsigned char* data = allocate_data(2 * std::size_t(n));
+        if (data == nullptr)
+            return unexpected(errc::out_of_memory);
+        std::memcpy(data, values, 2 * std::size_t(n));
+        return push_entry({key, container_type::array, n, n, n, data});
+    }
+
+    expected<void, errc> append_words(std::uint16_t key, const std::uint64_t* words) noexcept {
+        const auto card = static_cast<std::uint32_t>(detail::popcount(words, detail::roaring::bitmap_words));
+        if (card == 0)
+            return {};
+        entry e{key, container_type::array, 0, 0, 0, nullptr};
+        if (auto r = rebuild(e, words, card); !r)
+            return r;
+        return push_entry(e);
+    }
+
+    expected<void, errc> append_and(std::uint16_t key, const container_view& a, const container_view& b,
+                                    detail::roaring::workspace& ws) noexcept {
+        using namespace detail::roaring;
+        if (a.type == container_type::array || b.type == container_type::array) {
+            std::uint16_t* out = ws.values();
+            std::uint32_t n = 0;
+            const container_view& small = a.type != container_type::array || (b.type == container_type::array && b.size < a.size) ? b : a;
+            const container_view& other = &small == &a ? b : a;
+            if (other.type == container_type::array && small.size * 16 > other.size) {
+                // Comparable sizes: linear merge.
+                for (std::uint32_t i = 0, j = 0; i < small.size && j < other.size;) {
+                    const std::uint16_t x = small.value(i);
+                    const std::uint16_t y = other.value(j);
+                    if (x < y) {
+                        ++i;
+                    } else if (y < x) {
+                        ++j;
+                    } else {
+                        out[n++] = x;
+                        ++i;
+                        ++j;
+                    }
+                }
+            } else {
+                // Skewed sizes or a bitmap/run partner: probe the larger side.
+                for (std::uint32_t i = 0; i < small.size; ++i) {
+                    const std::uint16_t x = small.value(i);
+                    if (other.contains(x))
+                        out[n++] = x;
+                }
+            }
+            return append_array(key, out, n);
+        }
+        std::uint64_t* x = ws.first();
+        std::uint64_t* y = ws.second();
+        load_words(a, x);
+        load_words(b, y);
+        detail::bitwise<detail::bit_op::and_>(x, x, y, bitmap_words);
+        return append_words(key, x);
+    }
+
+    expected<void, errc> append_or(std::uint16_t key, const container_view& a, const container_view& b,
+                                   detail::roaring::workspace& ws) noexcept {
+        using namespace detail::roaring;
+        if (a.type == container_type::array && b.type == container_type::array && a.size + b.size <= array_max) {
+            std::uint16_t* out = ws.values();
+            std::uint32_t n = 0;
+            std::uint32_t i = 0;
+            std::uint32_t j = 0;
+            while (i < a.size && j < b.size) {
+                const std::uint16_t x = a.value(i);
+                const std::uint16_t y = b.value(j);
+                out[n++] = x < y ? x : y;
+                i += x <= y;
+                j += y <= x;
+            }
+            for (; i < a.size; ++i)
+                out[n++] = a.value(i);
+            for (; j < b.size; ++j)
+                out[n++] = b.value(j);
+            return append_array(key, out, n);
+        }
+        std::uint64_t* x = ws.first();
+        load_words(a, x);
+        b.or_into(x);
+        return append_words(key, x);
+    }
+
+    void release() noexcept {
+        clear();
+        deallocate(entries_);
+        entries_ = nullptr;
+        capacity_ = 0;
+    }
+
+    entry* entries_ = nullptr; // Sorted by key.
+    std::size_t count_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+} // namespace extl
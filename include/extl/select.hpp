@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/compare.hpp"
+
+namespace extl {
+
+namespace detail {
+
+// ---------------------------------------------------------------------------------------
+// Candidate filtering
+// top_k only touches its heap for elements that beat the current threshold. For arithmetic
+// inputs the threshold test runs on a whole 64-byte block at once and yields a lane bitmask,
+// so blocks without candidates cost one compare and one branch.
+// ---------------------------------------------------------------------------------------
+
+template <class T>
+concept filterable = std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t> ||
+                     std::same_as<T, float> || std::same_as<T, double>;
+
+template <class T>
+inline constexpr std::size_t filter_block_size = 64 / sizeof(T);
+
+#if EXTL_HAS_AVX512
+
+// Bit l is set when p[l] is strictly greater (Greater) or less (!Greater) than threshold.
+template <bool Greater, class T>
+EXTL_FORCE_INLINE std::uint32_t filter_block(const T* p, T threshold) {
+    if constexpr (std::same_as<T, std::int32_t>) {
+        const __m512i v = _mm512_loadu_si512(p);
+        const __m512i t = _mm512_set1_epi32(threshold);
+        return Greater ? _mm512_cmpgt_epi32_mask(v, t) : _mm512_cmplt_epi32_mask(v, t);
+    } else if constexpr (std::same_as<T, std::int64_t>) {
+        const __m512i v = _mm512_loadu_si512(p);
+        const __m512i t = _mm512_set1_epi64(threshold);
+        return Greater ? _mm512_cmpgt_epi64_mask(v, t) : _mm512_cmplt_epi64_mask(v, t);
+    } else if constexpr (std::same_as<T, float>) {
+        return _mm512_cmp_ps_mask(_mm512_loadu_ps(p), _mm512_set1_ps(threshold), Greater ? _CMP_GT_OQ : _CMP_LT_OQ);
+    } else {
+        return _mm512_cmp_pd_mask(_mm512_loadu_pd(p), _mm512_set1_pd(threshold), Greater ? _CMP_GT_OQ : _CMP_LT_OQ);
+    }
+}
+
+#elif EXTL_HAS_AVX2
+
+template <bool Greater, class T>
+EXTL_FORCE_INLINE std::uint32_t filter_half(const T* p, T threshold) {
+    if constexpr (std::same_as<T, std::int32_t>) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i t = _mm256_set1_epi32(threshold);
+        const __m256i m = Greater ? _mm256_cmpgt_epi32(v, t) : _mm256_cmpgt_epi32(t, v);
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+    } else if constexpr (std::same_as<T, std::int64_t>) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i t = _mm256_set1_epi64x(threshold);
+        const __m256i m = Greater ? _mm256_cmpgt_epi64(v, t) : _mm256_cmpgt_epi64(t, v);
+        return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(m)));
+    } else if constexpr (std::same_as<T, float>) {
+        const __m256 m = _mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(threshold), Greater ? _CMP_GT_OQ : _CMP_LT_OQ);
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(m));
+    } else {
+        const __m256d m = _mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(threshold), Greater ? _CMP_GT_OQ : _CMP_LT_OQ);
+        return static_cast<std::uint32_t>(_mm256_movemask_pd(m));
+    }
+}
+
+template <bool Greater, class T>
+EXTL_FORCE_INLINE std::uint32_t filter_block(const T* p, T threshold) {
+    constexpr std::size_t half = filter_block_size<T> / 2;
+    return filter_half<Greater>(p, threshold) | (filter_half<Greater>(p + half, threshold) << half);
+}
+
+#else
+
+template <bool Greater, class T>
+EXTL_FORCE_INLINE std::uint32_t filter_block(const T* p, T threshold) {
+    std::uint32_t mask = 0;
+    for (std::size_t l = 0; l < filter_block_size<T>; ++l)
+        mask |= static_cast<std::uint32_t>(Greater ? p[l] > threshold : p[l] < threshold) << l;
+    return mask;
+}
+
+#endif
+
+// ---------------------------------------------------------------------------------------
+// Heap helpers
+// The layout is the standard binary heap of <algorithm>, so std::sort_heap can finish it.
+// ---------------------------------------------------------------------------------------
+
+// Replaces heap[0] with value and restores the heap property over heap[0, size).
+template <class It, class T, class Compare>
+inline void heap_replace_top(It heap, std::ptrdiff_t size, T&& value, Compare& comp) {
+    std::ptrdiff_t hole = 0;
+    while (true) {
+        std::ptrdiff_t child = 2 * hole + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && std::invoke(comp, heap[child], heap[child + 1]))
+            ++child;
+        if (!std::invoke(comp, value, heap[child]))
+            break;
+        heap[hole] = std::ranges::iter_move(heap + child);
+        hole = child;
+    }
+    heap[hole] = std::forward<T>(value);
+}
+
+template <class T, class Compare>
+inline constexpr bool use_filtered_top_k_v =
+    filterable<T> && (is_less_compare_v<Compare, T> || is_greater_compare_v<Compare, T>);
+
+// Top-k over a contiguous arithmetic array once the heap holds k elements.
+template <class T, class Out, class Compare>
+inline void top_k_filtered(const T* data, std::size_t n, std::size_t i, Out heap, std::ptrdiff_t k, Compare& comp) {
+    constexpr bool greater = is_greater_compare_v<Compare, T>;
+    constexpr std::size_t block = filter_block_size<T>;
+
+    for (; i + block <= n; i += block) {
+        std::uint32_t mask = filter_block<greater>(data + i, heap[0]);
+        while (mask != 0) {
+            // The threshold may have moved since the block was filtered; recheck each candidate.
+            const T value = data[i + static_cast<std::size_t>(std::countr_zero(mask))];
+            mask &= mask - 1;
+            if (std::invoke(comp, value, heap[0]))
+                heap_replace_top(heap, k, value, comp);
+        }
+    }
+    for (; i < n; ++i) {
+        if (std::invoke(comp, data[i], heap[0]))
+            heap_replace_top(heap, k, data[i], comp);
+    }
+}
+
+// Heap selection over [first + left, first + right]: a heap holds the smaller side of k plus k
+// itself, and every element on the other side that beats its root replaces it. O(n log m) for a
+// heap of m elements whatever the input, which makes it the fallback for Floyd–Rivest.
+template <class It, class Compare>
+inline void heap_select(It first, std::ptrdiff_t left, std::ptrdiff_t right, std::ptrdiff_t k, Compare& comp) {
+    if (k - left <= right - k) {
+        // The k - left + 1 smallest, largest at the root; popping it leaves it at k.
+        const It heap = first + left;
+        const std::ptrdiff_t size = k - left + 1;
+        std::make_heap(heap, heap + size, std::ref(comp));
+        for (std::ptrdiff_t j = k + 1; j <= right; ++j) {
+            if (std::invoke(comp, first[j], heap[0])) {
+                std::iter_value_t<It> value = std::ranges::iter_move(first + j);
+                first[j] = std::ranges::iter_move(heap);
+                heap_replace_top(heap, size, std::move(value), comp);
+            }
+        }
+        std::pop_heap(heap, heap + size, std::ref(comp));
+    } else {
+        // The right - k + 1 largest, smallest at the root, which is already at k.
+        auto reversed = [&comp](const auto& a, const auto& b) -> bool { return std::invoke(comp, b, a); };
+        const It heap = first + k;
+        const std::ptrdiff_t size = right - k + 1;
+        std::make_heap(heap, heap + size, reversed);
+        for (std::ptrdiff_t j = left; j < k; ++j) {
+            if (std::invoke(comp, heap[0], first[j])) {
+                std::iter_value_t<It> value = std::ranges::iter_move(first + j);
+                first[j] = std::ranges::iter_move(heap);
+                heap_replace_top(heap, size, std::move(value), reversed);
+            }
+        }
+    }
+}
+
+// Floyd–Rivest selection over [first + left, first + right] (inclusive bounds, as in the paper).
+// Like introselect, it gives up on partitioning after 2 log2 n rounds, which only adversarial
+// inputs reach, and finishes with heap_select.
+template <class It, class Compare>
+inline void floyd_rivest_select(It first, std::ptrdiff_t left, std::ptrdiff_t right, std::ptrdiff_t k, Compare& comp) {
+    // Below this size sampling does not pay for itself and the loop degrades to quickselect.
+    constexpr std::ptrdiff_t sample_threshold = 600;
+
+    int depth_limit = 2 * std::bit_width(static_cast<std::size_t>(right - left + 1));
+    while (right > left) {
+        if (depth_limit-- == 0) {
+            heap_select(first, left, right, k, comp);
+            return;
+        }
+        if (right - left > sample_threshold) {
+            // Recursively select from a sample so that the k-th element is very likely to land
+            // between two pivots that bracket it tightly.
+            const double n = static_cast<double>(right - left + 1);
+            const double i = static_cast<double>(k - left + 1);
+            const double z = std::log(n);
+            const double s = 0.5 * std::exp(2.0 * z / 3.0);
+            const double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1.0 : 1.0);
+            const auto new_left = std::max(left, static_cast<std::ptrdiff_t>(std::floor(static_cast<double>(k) - i * s / n + sd)));
+            const auto new_right =
+                std::min(right, static_cast<std::ptrdiff_t>(std::floor(static_cast<double>(k) + (n - i) * s / n + sd)));
+            floyd_rivest_select(first, new_left, new_right, k, comp);
+        }
+
+        const std::iter_value_t<It> pivot = first[k];
+        std::ptrdiff_t i = left;
+        std::ptrdiff_t j = right;
+        std::iter_swap(first + left, first + k);
+        if (std::invoke(comp, pivot, first[right]))
+            std::iter_swap(first + right, first + left);
+        while (i < j) {
+            std::iter_swap(first + i, first + j);
+            ++i;
+            --j;
+            while (std::invoke(comp, first[i], pivot))
+                ++i;
+            while (std::invoke(comp, pivot, first[j]))
+                --j;
+        }
+        if (!std::invoke(comp, first[left], pivot) && !std::invoke(comp, pivot, first[left])) {
+            std::iter_swap(first + left, first + j);
+        } else {
+            ++j;
+            std::iter_swap(first + j, first + right);
+        }
+        if (j <= k)
+            left = j + 1;
+        if (k <= j)
+            right = j - 1;
+    }
+}
+
+} // namespace detail
+
+// Copies the k best elements of [first, last) to [out, out + min(k, n)), best first, and returns
+// the end of the written range. comp(a, b) returns true when a ranks ahead of b; the default keeps
+// the largest values.
+//
+// The output range doubles as a bounded heap whose root is the current threshold, so each input
+// element costs one comparison unless it makes the cut. Contiguous int32, int64, float and double
+// inputs compared with a standard less/greater are screened a 64-byte block at a time with SIMD
+// compares, and only blocks holding candidates reach the heap.
+template <std::input_iterator It, std::sentinel_for<It> S, std::random_access_iterator Out,
+          class Compare = std::ranges::greater>
+    requires std::indirectly_copyable<It, Out> && std::sortable<Out, Compare>
+inline Out top_k(It first, S last, std::size_t k, Out out, Compare comp = {}) {
+    if (k == 0)
+        return out;
+
+    std::ptrdiff_t size = 0;
+    const auto limit = static_cast<std::ptrdiff_t>(k);
+    for (; size < limit && first != last; ++first, ++size)
+        out[size] = *first;
+    std::make_heap(out, out + size, std::ref(comp));
+
+    if (size == limit) {
+        using value_type = std::iter_value_t<It>;
+        // The filter compares in the input type, so the heap must hold that type too: converting
+        // its root back from a wider or different output type could round or overflow.
+        if constexpr (std::contiguous_iterator<It> && std::sized_sentinel_for<S, It> &&
+                      std::same_as<std::iter_value_t<Out>, value_type> &&
+                      detail::use_filtered_top_k_v<value_type, Compare>) {
+            const auto n = static_cast<std::size_t>(last - first);
+            detail::top_k_filtered(std::to_address(first), n, 0, out, size, comp);
+        } else {
+            for (; first != last; ++first) {
+                if (std::invoke(comp, *first, out[0]))
+                    detail::heap_replace_top(out, size, std::iter_value_t<Out>(*first), comp);
+            }
+        }
+    }
+
+    std::sort_heap(out, out + size, std::ref(comp));
+    return out + size;
+}
+
+template <std::ranges::input_range R, std::random_access_iterator Out, class Compare = std::ranges::greater>
+    requires std::indirectly_copyable<std::ranges::iterator_t<R>, Out> && std::sortable<Out, Compare>
+inline Out top_k(R&& range, std::size_t k, Out out, Compare comp = {}) {
+    return extl::top_k(std::ranges::begin(range), std::ranges::end(range), k, out, std::move(comp));
+}
+
+// Rearranges [first, last) so that *nth is the element a full sort would put there, everything
+// before it is not greater and everything after it is not less. Uses Floyd–Rivest selection,
+// which picks its pivots from a recursive sample and needs about n + min(k, n - k) comparisons
+// on average, noticeably fewer than introselect for large inputs. A depth limit with a heap
+// selection fallback bounds the worst case at O(n log n).
+template <std::random_access_iterator It, std::sentinel_for<It> S, class Compare = std::ranges::less>
+    requires std::sortable<It, Compare> && std::copyable<std::iter_value_t<It>>
+inline It nth_element(It first, It nth, S last, Compare comp = {}) {
+    It end = std::ranges::next(first, last);
+    if (nth == end)
+        return end;
+    detail::floyd_rivest_select(first, 0, (end - first) - 1, nth - first, comp);
+    return end;
+}
+
+template <std::ranges::random_access_range R, class Compare = std::ranges::less>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare> &&
+             std::copyable<std::ranges::range_value_t<R>>
+inline std::ranges::borrowed_iterator_t<R> nth_element(R&& range, std::ranges::iterator_t<R> nth, Compare comp = {}) {
+    return extl::nth_element(std::ranges::begin(range), nth, std::ranges::end(range), std::move(comp));
+}
+
+} // namespace extl
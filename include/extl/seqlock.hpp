@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/wait.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+
+namespace extl {
+
+namespace detail::seq {
+
+// One value guarded by a sequence number: odd while a write is in progress, and advanced by two
+// per completed write. The value lives in relaxed atomic words, so a read that overlaps a write
+// sees a torn copy that validation then discards, and is never a data race.
+template <class T>
+class alignas(cache_line_size) versioned {
+public:
+    explicit versioned(const T& value) noexcept { store_words(value); }
+
+    // Single writer only.
+    void write(const T& value) noexcept {
+        const std::uint64_t s = seq_.load(std::memory_order_relaxed);
+        EXTL_ASSERT((s & 1) == 0);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        // Orders the odd sequence before the data, so a reader that sees new data sees it too.
+        std::atomic_thread_fence(std::memory_order_release);
+        store_words(value);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    expected<T, errc> try_read() const noexcept {
+        const std::uint64_t before = seq_.load(std::memory_order_acquire);
+        if (EXTL_UNLIKELY((before & 1) != 0))
+            return unexpected(errc::busy);
+        std::uint64_t buffer[word_count];
+        load_words(buffer);
+        // Orders the data loads before the re-check of the sequence.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (EXTL_UNLIKELY(seq_.load(std::memory_order_relaxed) != before))
+            return unexpected(errc::busy);
+        // Only a validated copy becomes a T, so a torn one never forms an invalid object.
+        return from_words(buffer);
+    }
+
+    // The writer may read back its own last write without validation.
+    T read_owned() const noexcept {
+        std::uint64_t buffer[word_count];
+        load_words(buffer);
+        return from_words(buffer);
+    }
+
+    std::uint64_t writes() const noexcept { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+    static constexpr std::size_t word_count = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    void store_words(const T& value) noexcept {
+        std::uint64_t buffer[word_count] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (std::size_t i = 0; i < word_count; ++i)
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    void load_words(std::uint64_t* buffer) const noexcept {
+        for (std::size_t i = 0; i < word_count; ++i)
+            buffer[i] = words_[i].load(std::memory_order_relaxed);
+    }
+
+    static T from_words(const std::uint64_t* buffer) noexcept {
+        std::array<std::byte, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), buffer, sizeof(T));
+        return std::bit_cast<T>(bytes);
+    }
+
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> words_[word_count];
+};
+
+} // namespace detail::seq
+
+// ---------------------------------------------------------------------------------------
+// seqlock
+// A value written by one thread and read by many, where readers never write shared memory. A
+// read copies the value and checks that no write overlapped the copy, retrying if one did, so
+// an uncontended read costs two loads of the sequence plus the copy. Writes never wait for
+// readers.
+//
+// T must be trivially copyable; reads return copies. Stores must not run concurrently with each
+// other: there is one writer, or writers serialize through a lock of their own.
+// ---------------------------------------------------------------------------------------
+template <class T>
+class seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock copies T byte-wise");
+
+public:
+    using value_type = T;
+
+    // Attempts try_load() makes by default before reporting busy.
+    static constexpr std::size_t default_attempts = 64;
+
+    seqlock() noexcept requires std::is_default_constructible_v<T> : cell_(T{}) {}
+    explicit seqlock(const T& value) noexcept : cell_(value) {}
+
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    void store(const T& value) noexcept { cell_.write(value); }
+
+    // Writer-side read-modify-write: fn(T&) edits a copy of the current value, which is then
+    // stored. Only the writer may call this.
+    template <class F>
+    void update(F&& fn) noexcept {
+        T value = cell_.read_owned();
+        fn(value);
+        cell_.write(value);
+    }
+
+    // Returns a consistent copy, waiting for as long as writes keep overlapping the read. A
+    // reader that keeps failing yields its CPU, in case the writer was preempted mid-store.
+    T load() const noexcept {
+        detail::backoff wait;
+        for (;;) {
+            auto value = cell_.try_read();
+            if (EXTL_LIKELY(value.has_value()))
+                return *value;
+            wait.pause();
+        }
+    }
+
+    // Returns a consistent copy, or busy if `attempts` reads in a row overlapped a write.
+    expected<T, errc> try_load(std::size_t attempts = default_attempts) const noexcept {
+        EXTL_ASSERT(attempts > 0);
+        for (;;) {
+            auto value = cell_.try_read();
+            if (EXTL_LIKELY(value.has_value()) || --attempts == 0)
+                return value;
+            detail::cpu_relax();
+        }
+    }
+
+    // Number of completed stores; lets a reader check for a new value without copying it.
+    std::uint64_t version() const noexcept { return cell_.writes(); }
+
+private:
+    detail::seq::versioned<T> cell_;
+};
+
+// ---------------------------------------------------------------------------------------
+// seqlock_ring
+// A seqlock whose writer rotates through Slots copies and then publishes the index of the newest,
+// so it never writes the copy that readers are being sent to. A read is not disturbed by a store
+// in progress, only by Slots - 1 further stores completing while it copies, which with a few
+// slots means readers practically never retry, however often the writer stores or however large
+// T is. Readers get the newest value published when they start.
+//
+// Costs Slots copies of T, each on its own cache lines. Same rules as seqlock otherwise.
+// ---------------------------------------------------------------------------------------
+template <class T, std::size_t Slots = 4>
+class seqlock_ring {
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock_ring copies T byte-wise");
+    static_assert(Slots >= 2, "seqlock_ring needs a slot to write while readers use another");
+
+public:
+    using value_type = T;
+
+    seqlock_ring() noexcept requires std::is_default_constructible_v<T> : seqlock_ring(T{}) {}
+    explicit seqlock_ring(const T& value) noexcept : slots_(make_slots(value, std::make_index_sequence<Slots>())) {}
+
+    seqlock_ring(const seqlock_ring&) = delete;
+    seqlock_ring& operator=(const seqlock_ring&) = delete;
+
+    void store(const T& value) noexcept {
+        const std::uint64_t next = latest_.load(std::memory_order_relaxed) + 1;
+        slots_[next % Slots].write(value);
+        latest_.store(next, std::memory_order_release);
+    }
+
+    template <class F>
+    void update(F&& fn) noexcept {
+        T value = slots_[latest_.load(std::memory_order_relaxed) % Slots].read_owned();
+        fn(value);
+        store(value);
+    }
+
+    T load() const noexcept {
+        for (;;) {
+            const std::uint64_t index = latest_.load(std::memory_order_acquire);
+            auto value = slots_[index % Slots].try_read();
+            if (EXTL_LIKELY(value.has_value()))
+                return *value;
+            // The writer lapped the ring while we copied; start over from the newest slot.
+        }
+    }
+
+    // Number of completed stores.
+    std::uint64_t version() const noexcept { return latest_.load(std::memory_order_acquire); }
+
+private:
+    template <std::size_t... I>
+    static std::array<detail::seq::versioned<T>, Slots> make_slots(const T& value, std::index_sequence<I...>) noexcept {
+        return {((void)I, detail::seq::versioned<T>(value))...};
+    }
+
+    alignas(cache_line_size) std::atomic<std::uint64_t> latest_{0};
+    std::array<detail::seq::versioned<T>, Slots> slots_;
+};
+
+} // namespace extl
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <thread>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/cpu.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+namespace detail::shard {
+
+inline constexpr std::size_t max_shards = 4096;
+
+// One shard per hardware thread, rounded up to a power of two.
+inline std::size_t default_count() noexcept {
+    const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    return std::min(std::bit_ceil(threads), max_shards);
+}
+
+// A power-of-two array of cache-line-aligned shards, indexed by the current CPU. Threads on
+// different CPUs update different lines, so writes scale; readers aggregate over all shards.
+template <class Shard>
+class array {
+public:
+    array() noexcept = default;
+
+    array(const array&) = delete;
+    array& operator=(const array&) = delete;
+
+    array(array&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    array& operator=(array&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~array() { release(); }
+
+    // `count` is rounded up to a power of two; 0 picks default_count().
+    static expected<array, errc> create(std::size_t count) noexcept {
+        if (count == 0)
+            count = default_count();
+        if (count > max_shards)
+            return unexpected(errc::length_error);
+        count = std::bit_ceil(count);
+        Shard* data = allocate<Shard>(count);
+        if (data == nullptr)
+            return unexpected(errc::out_of_memory);
+        for (std::size_t i = 0; i < count; ++i)
+            std::construct_at(data + i);
+        array shards;
+        shards.data_ = data;
+        shards.size_ = count;
+        return shards;
+    }
+
+    Shard& local() noexcept {
+        EXTL_ASSERT(data_ != nullptr);
+        return data_[current_cpu() & (size_ - 1)];
+    }
+
+    std::span<Shard> shards() noexcept { return {data_, size_}; }
+    std::span<const Shard> shards() const noexcept { return {data_, size_}; }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    void release() noexcept {
+        if (data_ == nullptr)
+            return;
+        std::destroy_n(data_, size_);
+        deallocate(data_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    Shard* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+struct alignas(cache_line_size) counter_shard {
+    std::atomic<std::uint64_t> value{0};
+};
+
+inline constexpr std::size_t stats_buckets = 65;
+
+struct alignas(cache_line_size) stats_shard {
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> min{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max{0};
+    std::atomic<std::uint64_t> buckets[stats_buckets] = {};
+};
+
+} // namespace detail::shard
+
+// ---------------------------------------------------------------------------------------
+// sharded_counter
+// A counter for hot paths incremented from many threads. Each CPU adds to its own cache line,
+// so increments do not bounce a shared line between cores the way a single std::atomic does;
+// reading the value sums the shards and costs O(shards). The arithmetic is modulo 2^64.
+//
+// The value read while adds are running is a sum of per-shard values taken at slightly different
+// times, so it may miss adds that race with the read. Every add is eventually counted.
+// ---------------------------------------------------------------------------------------
+class sharded_counter {
+public:
+    sharded_counter(sharded_counter&&) noexcept = default;
+    sharded_counter& operator=(sharded_counter&&) noexcept = default;
+
+    // `shards` is rounded up to a power of two; 0 picks one per hardware thread. Fails with
+    // length_error above detail::shard::max_shards.
+    static expected<sharded_counter, errc> create(std::size_t shards = 0) noexcept {
+        auto created = detail::shard::array<detail::shard::counter_shard>::create(shards);
+        if (!created)
+            return unexpected(created.error());
+        return sharded_counter(std::move(*created));
+    }
+
+    void add(std::uint64_t delta = 1) noexcept { shards_.local().value.fetch_add(delta, std::memory_order_relaxed); }
+    void sub(std::uint64_t delta = 1) noexcept { shards_.local().value.fetch_sub(delta, std::memory_order_relaxed); }
+
+    std::uint64_t value() const noexcept {
+        std::uint64_t total = 0;
+        for (const auto& s : shards_.shards())
+            total += s.value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Zeroes the counter and returns what it held, for per-interval rates. No concurrent add is
+    // lost: each one lands either in the returned total or in the new count.
+    std::uint64_t reset() noexcept {
+        std::uint64_t total = 0;
+        for (auto& s : shards_.shards())
+            total += s.value.exchange(0, std::memory_order_relaxed);
+        return total;
+    }
+
+    std::size_t shard_count() const noexcept { return shards_.size(); }
+
+private:
+    explicit sharded_counter(detail::shard::array<detail::shard::counter_shard>&& shards) noexcept
+        : shards_(std::move(shards)) {}
+
+    detail::shard::array<detail::shard::counter_shard> shards_;
+};
+
+// Aggregate of the values recorded into extl::stats.
+struct stats_summary {
+    // Bucket i counts values of bit width i: bucket 0 holds zero, bucket i > 0 holds
+    // [2^(i-1), 2^i).
+    static constexpr std::size_t bucket_count = detail::shard::stats_buckets;
+
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    // Both 0 when count is 0.
+    std::uint64_t min = 0;
+    std::uint64_t max = 0;
+    std::array<std::uint64_t, bucket_count> histogram{};
+
+    double mean() const noexcept { return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count); }
+
+    static constexpr std::uint64_t bucket_lower_bound(std::size_t bucket) noexcept {
+        return bucket == 0 ? 0 : std::uint64_t{1} << (bucket - 1);
+    }
+};
+
+// ---------------------------------------------------------------------------------------
+// stats
+// Count, sum, min, max and a power-of-two histogram of uint64 samples, recorded from many threads
+// into per-CPU shards like sharded_counter. A record is a few relaxed atomics on the local
+// shard's lines; min and max are written only when they change. summary() merges the shards on
+// demand. The sum is modulo 2^64.
+//
+// A summary taken while records are running may include part of a concurrent record (its count
+// but not yet its sum, say); once recording stops it is exact.
+// ---------------------------------------------------------------------------------------
+class stats {
+public:
+    stats(stats&&) noexcept = default;
+    stats& operator=(stats&&) noexcept = default;
+
+    // Same shard rules as sharded_counter::create.
+    static expected<stats, errc> create(std::size_t shards = 0) noexcept {
+        auto created = detail::shard::array<detail::shard::stats_shard>::create(shards);
+        if (!created)
+            return unexpected(created.error());
+        return stats(std::move(*created));
+    }
+
+    void record(std::uint64_t value) noexcept {
+        auto& s = shards_.local();
+        s.count.fetch_add(1, std::memory_order_relaxed);
+        s.sum.fetch_add(value, std::memory_order_relaxed);
+        s.buckets[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t low = s.min.load(std::memory_order_relaxed);
+        while (value < low && !s.min.compare_exchange_weak(low, value, std::memory_order_relaxed)) {
+        }
+        std::uint64_t high = s.max.load(std::memory_order_relaxed);
+        while (value > high && !s.max.compare_exchange_weak(high, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    stats_summary summary() const noexcept {
+        stats_summary out;
+        std::uint64_t low = std::numeric_limits<std::uint64_t>::max();
+        for (const auto& s : shards_.shards()) {
+            out.count += s.count.load(std::memory_order_relaxed);
+            out.sum += s.sum.load(std::memory_order_relaxed);
+            low = std::min(low, s.min.load(std::memory_order_relaxed));
+            out.max = std::max(out.max, s.max.load(std::memory_order_relaxed));
+            for (std::size_t b = 0; b < stats_summary::bucket_count; ++b)
+                out.histogram[b] += s.buckets[b].load(std::memory_order_relaxed);
+        }
+        out.min = out.count == 0 ? 0 : low;
+        return out;
+    }
+
+    // Clears all shards. Records racing with the reset may be partly kept and partly cleared.
+    void reset() noexcept {
+        for (auto& s : shards_.shards()) {
+            s.count.store(0, std::memory_order_relaxed);
+            s.sum.store(0, std::memory_order_relaxed);
+            s.min.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+            s.max.store(0, std::memory_order_relaxed);
+            for (auto& b : s.buckets)
+                b.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t shard_count() const noexcept { return shards_.size(); }
+
+private:
+    explicit stats(detail::shard::array<detail::shard::stats_shard>&& shards) noexcept : shards_(std::move(shards)) {}
+
+    detail::shard::array<detail::shard::stats_shard> shards_;
+};
+
+} // namespace extl
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// slot_map
+// Values live densely in one contiguous array, so iteration is as fast as over a vector.
+// Elements are addressed by 64-bit keys made of a slot index and a generation; the slot table
+// maps a key to the value's current position in O(1). Erasing moves the last value into the
+// hole and bumps the slot's generation, so keys to erased elements are detected as stale
+// instead of aliasing whatever reuses the slot.
+//
+// Generations are odd while a slot is live, so a default-constructed key never matches. A
+// slot's generation wraps after 2^31 reuses.
+// ---------------------------------------------------------------------------------------
+template <class T>
+class slot_map {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    struct key {
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0;
+
+        friend constexpr bool operator==(key, key) noexcept = default;
+    };
+    using key_type = key;
+
+    slot_map() noexcept = default;
+
+    slot_map(const slot_map&) = delete;
+    slot_map& operator=(const slot_map&) = delete;
+
+    slot_map(slot_map&& other) noexcept { steal(other); }
+
+    slot_map& operator=(slot_map&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~slot_map() { release(); }
+
+    static expected<slot_map, errc> create(size_type capacity) noexcept {
+        slot_map map;
+        if (auto result = map.try_reserve(capacity); !result)
+            return unexpected(result.error());
+        return map;
+    }
+
+    // Copies values, keys and free slots, so keys into `other` are also valid in the copy.
+    static expected<slot_map, errc> copy(const slot_map& other) noexcept
+        requires std::is_copy_constructible_v<T>
+    {
+        auto map = create(other.capacity_);
+        if (!map)
+            return map;
+        for (size_type i = 0; i < other.size_; ++i)
+            std::construct_at(map->values_ + i, other.values_[i]);
+        std::uninitialized_copy_n(other.dense_to_slot_, other.size_, map->dense_to_slot_);
+        std::uninitialized_copy_n(other.slots_, other.slot_count_, map->slots_);
+        map->size_ = other.size_;
+        map->slot_count_ = other.slot_count_;
+        map->free_head_ = other.free_head_;
+        return map;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+    static constexpr size_type max_size() noexcept { return npos; }
+
+    // Dense storage, in no particular order.
+    T* data() noexcept { return values_; }
+    const T* data() const noexcept { return values_; }
+    std::span<T> values() noexcept { return {values_, size_}; }
+    std::span<const T> values() const noexcept { return {values_, size_}; }
+
+    iterator begin() noexcept { return values_; }
+    iterator end() noexcept { return values_ + size_; }
+    const_iterator begin() const noexcept { return values_; }
+    const_iterator end() const noexcept { return values_ + size_; }
+
+    // Key of the value stored at dense position i.
+    key key_at(size_type i) const noexcept {
+        EXTL_ASSERT(i < size_);
+        const std::uint32_t s = dense_to_slot_[i];
+        return key{s, slots_[s].generation};
+    }
+
+    bool contains(key k) const noexcept {
+        return k.index < slot_count_ && slots_[k.index].generation == k.generation && (k.generation & 1u) != 0;
+    }
+
+    T* find(key k) noexcept { return contains(k) ? values_ + slots_[k.index].position : nullptr; }
+    const T* find(key k) const noexcept { return contains(k) ? values_ + slots_[k.index].position : nullptr; }
+
+    T& operator[](key k) noexcept {
+        EXTL_ASSERT(contains(k));
+        return values_[slots_[k.index].position];
+    }
+    const T& operator[](key k) const noexcept {
+        EXTL_ASSERT(contains(k));
+        return values_[slots_[k.index].position];
+    }
+
+    expected<key, errc> try_insert(const T& value) noexcept { return try_emplace(value); }
+    expected<key, errc> try_insert(T&& value) noexcept { return try_emplace(std::move(value)); }
+
+    // args may refer to a value in this map.
+    template <class... Args>
+    expected<key, errc> try_emplace(Args&&... args) noexcept {
+        if (size_ == capacity_) {
+            const size_type capacity = detail::grow_capacity(capacity_, size_ + 1);
+            auto grown = allocate_storage(capacity);
+            if (!grown)
+                return unexpected(grown.error());
+            std::construct_at(grown->values + size_, std::forward<Args>(args)...);
+            adopt_storage(*grown, capacity);
+        } else {
+            std::construct_at(values_ + size_, std::forward<Args>(args)...);
+        }
+
+        std::uint32_t s;
+        if (free_head_ != npos) {
+            s = free_head_;
+            free_head_ = slots_[s].position;
+        } else {
+            s = slot_count_++;
+            std::construct_at(slots_ + s, slot{0, 0});
+        }
+        dense_to_slot_[size_] = s;
+        slots_[s].position = static_cast<std::uint32_t>(size_);
+        slots_[s].generation += 1; // even (free) -> odd (live)
+        ++size_;
+        return key{s, slots_[s].generation};
+    }
+
+    expected<void, errc> erase(key k) noexcept {
+        if (!contains(k))
+            return unexpected(errc::stale_handle);
+        erase_slot(k.index);
+        return {};
+    }
+
+    // Erases the element and returns its value.
+    expected<T, errc> take(key k) noexcept {
+        if (!contains(k))
+            return unexpected(errc::stale_handle);
+        T value = std::move(values_[slots_[k.index].position]);
+        erase_slot(k.index);
+        return value;
+    }
+
+    expected<void, errc> try_reserve(size_type capacity) noexcept {
+        if (capacity <= capacity_)
+            return {};
+        auto grown = allocate_storage(capacity);
+        if (!grown)
+            return unexpected(grown.error());
+        adopt_storage(*grown, capacity);
+        return {};
+    }
+
+    // Erases every element. Existing keys become stale; slots are kept for reuse.
+    void clear() noexcept {
+        for (size_type i = 0; i < size_; ++i)
+            free_slot(dense_to_slot_[i]);
+        std::destroy_n(values_, size_);
+        size_ = 0;
+    }
+
+private:
+    static constexpr std::uint32_t npos = ~std::uint32_t(0);
+
+    struct slot {
+        std::uint32_t position;   // Dense index while live, next free slot otherwise.
+        std::uint32_t generation; // Odd while live.
+    };
+
+    struct storage {
+        T* values;
+        std::uint32_t* dense_to_slot;
+        slot* slots;
+    };
+
+    // Growth happens in two steps so try_emplace can construct the new value in between, while
+    // the old storage is still alive.
+    static expected<storage, errc> allocate_storage(size_type capacity) noexcept {
+        if (capacity > max_size())
+            return unexpected(errc::length_error);
+        T* values = allocate<T>(capacity);
+        std::uint32_t* dense_to_slot = allocate<std::uint32_t>(capacity);
+        slot* slots = allocate<slot>(capacity);
+        if (values == nullptr || dense_to_slot == nullptr || slots == nullptr) {
+            deallocate(values);
+            deallocate(dense_to_slot);
+            deallocate(slots);
+            return unexpected(errc::out_of_memory);
+        }
+        return storage{values, dense_to_slot, slots};
+    }
+
+    // Moves the contents to s and frees the old storage.
+    void adopt_storage(storage s, size_type capacity) noexcept {
+        detail::relocate(values_, size_, s.values);
+        detail::relocate(dense_to_slot_, size_, s.dense_to_slot);
+        detail::relocate(slots_, slot_count_, s.slots);
+        deallocate(values_);
+        deallocate(dense_to_slot_);
+        deallocate(slots_);
+        values_ = s.values;
+        dense_to_slot_ = s.dense_to_slot;
+        slots_ = s.slots;
+        capacity_ = capacity;
+    }
+
+    void free_slot(std::uint32_t s) noexcept {
+        slots_[s].generation += 1; // odd (live) -> even (free)
+        slots_[s].position = free_head_;
+        free_head_ = s;
+    }
+
+    void erase_slot(std::uint32_t s) noexcept {
+        const std::uint32_t hole = slots_[s].position;
+        const auto last = static_cast<std::uint32_t>(size_ - 1);
+        if (hole != last) {
+            values_[hole] = std::move(values_[last]);
+            const std::uint32_t moved = dense_to_slot_[last];
+            dense_to_slot_[hole] = moved;
+            slots_[moved].position = hole;
+        }
+        std::destroy_at(values_ + last);
+        --size_;
+        free_slot(s);
+    }
+
+    void steal(slot_map& other) noexcept {
+        values_ = std::exchange(other.values_, nullptr);
+        dense_to_slot_ = std::exchange(other.dense_to_slot_, nullptr);
+        slots_ = std::exchange(other.slots_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+        slot_count_ = std::exchange(other.slot_count_, 0);
+        free_head_ = std::exchange(other.free_head_, npos);
+    }
+
+    void release() noexcept {
+        std::destroy_n(values_, size_);
+        deallocate(values_);
+        deallocate(dense_to_slot_);
+        deallocate(slots_);
+        values_ = nullptr;
+        dense_to_slot_ = nullptr;
+        slots_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        slot_count_ = 0;
+        free_head_ = npos;
+    }
+
+    T* values_ = nullptr;
+    std::uint32_t* dense_to_slot_ = nullptr;
+    slot* slots_ = nullptr;
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+    std::uint32_t slot_count_ = 0;
+    std::uint32_t free_head_ = npos;
+};
+
+} // namespace extl
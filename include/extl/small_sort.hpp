@@ -0,0 +1,101 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "extl/config.hpp"
+#include "extl/detail/sorting_network.hpp"
+
+namespace extl {
+
+// Element types with a dedicated sorting network kernel.
+template <class T>
+concept small_sortable = std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t> ||
+                         std::same_as<T, float> || std::same_as<T, double>;
+
+// Largest input small_sort accepts: 128 elements of 4 bytes or 64 elements of 8 bytes.
+template <small_sortable T>
+inline constexpr std::size_t small_sort_max = sizeof(T) == 4 ? 128 : 64;
+
+namespace detail {
+
+#if EXTL_HAS_AVX512 || EXTL_HAS_AVX2
+
+template <class T, std::size_t R>
+EXTL_NO_INLINE void simd_small_sort(T* data, std::size_t n) {
+    bitonic_network<simd_sort_traits<T>, R>::sort(data, n);
+}
+
+template <class T>
+inline void small_sort_dispatch(T* data, std::size_t n) {
+    constexpr std::size_t w = simd_sort_traits<T>::width;
+    constexpr std::size_t max_regs = small_sort_max<T> / w;
+    static_assert(max_regs <= 16, "network would exceed the dispatch table");
+
+    // Smallest power-of-two register count that holds n elements.
+    const std::size_t regs = (n + w - 1) / w;
+    if (regs <= 1)
+        simd_small_sort<T, 1>(data, n);
+    else if (regs <= 2)
+        simd_small_sort<T, 2>(data, n);
+    else if (regs <= 4)
+        simd_small_sort<T, 4>(data, n);
+    else if (regs <= 8)
+        simd_small_sort<T, 8>(data, n);
+    else if constexpr (max_regs >= 16)
+        simd_small_sort<T, 16>(data, n);
+}
+
+#else
+
+template <class T>
+inline void small_sort_dispatch(T* data, std::size_t n) {
+    std::size_t size = 2;
+    while (size < n)
+        size *= 2;
+    scalar_bitonic_sort(data, n, size);
+}
+
+#endif
+
+// Moves NaNs behind every other value and returns how many values precede them. The padding a
+// network adds sorts after every number but not after NaN, so NaNs must not enter the network.
+template <class T>
+inline std::size_t partition_nans(T* data, std::size_t n) noexcept {
+    std::size_t ordered = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const T value = data[i];
+        data[i] = data[ordered];
+        data[ordered] = value;
+        ordered += value == value;
+    }
+    return ordered;
+}
+
+} // namespace extl::detail
+
+// Sorts data[0, n) in ascending order with a branch-free bitonic sorting network.
+//
+// Intended for many tiny arrays, where insertion sort spends most of its time on mispredicted
+// branches. Uses AVX-512 or AVX2 kernels when the target supports them and a scalar network
+// otherwise. The sort is not stable; NaN values end up after all other values, in unspecified order.
+// Precondition: n <= small_sort_max<T>.
+template <small_sortable T>
+inline void small_sort(T* data, std::size_t n) noexcept {
+    EXTL_ASSERT(n <= small_sort_max<T>);
+    if constexpr (std::is_floating_point_v<T>)
+        n = detail::partition_nans(data, n);
+    if (n < 2)
+        return;
+    detail::small_sort_dispatch(data, n);
+}
+
+template <small_sortable T>
+inline void small_sort(std::span<T> data) noexcept {
+    small_sort(data.data(), data.size());
+}
+
+} // namespace extl
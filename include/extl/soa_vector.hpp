@@ -0,0 +1,399 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+template <class... Fields>
+class soa_vector;
+
+// ---------------------------------------------------------------------------------------
+// soa_vector_iterator
+// Random-access iterator yielding proxy references (tuples of references into each column), so
+// like std::vector<bool>'s it does not model std::random_access_iterator and has no operator->.
+// ---------------------------------------------------------------------------------------
+template <bool Const, class... Fields>
+class soa_vector_iterator {
+    using container = std::conditional_t<Const, const soa_vector<Fields...>, soa_vector<Fields...>>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::tuple<Fields...>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, std::tuple<const Fields&...>, std::tuple<Fields&...>>;
+    using pointer = void;
+
+    soa_vector_iterator() noexcept = default;
+
+    template <bool OtherConst>
+        requires(Const && !OtherConst)
+    soa_vector_iterator(const soa_vector_iterator<OtherConst, Fields...>& other) noexcept
+        : vector_(other.vector_), index_(other.index_) {}
+
+    reference operator*() const noexcept { return (*vector_)[index_]; }
+    reference operator[](difference_type n) const noexcept { return (*vector_)[index_ + static_cast<std::size_t>(n)]; }
+
+    soa_vector_iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+    soa_vector_iterator operator++(int) noexcept { return soa_vector_iterator(vector_, index_++); }
+    soa_vector_iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+    soa_vector_iterator operator--(int) noexcept { return soa_vector_iterator(vector_, index_--); }
+
+    soa_vector_iterator& operator+=(difference_type n) noexcept {
+        index_ += static_cast<std::size_t>(n);
+        return *this;
+    }
+    soa_vector_iterator& operator-=(difference_type n) noexcept {
+        index_ -= static_cast<std::size_t>(n);
+        return *this;
+    }
+    friend soa_vector_iterator operator+(soa_vector_iterator it, difference_type n) noexcept { return it += n; }
+    friend soa_vector_iterator operator+(difference_type n, soa_vector_iterator it) noexcept { return it += n; }
+    friend soa_vector_iterator operator-(soa_vector_iterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(const soa_vector_iterator& a, const soa_vector_iterator& b) noexcept {
+        return static_cast<difference_type>(a.index_ - b.index_);
+    }
+
+    friend bool operator==(const soa_vector_iterator& a, const soa_vector_iterator& b) noexcept {
+        return a.index_ == b.index_;
+    }
+    friend std::strong_ordering operator<=>(const soa_vector_iterator& a, const soa_vector_iterator& b) noexcept {
+        return a.index_ <=> b.index_;
+    }
+
+private:
+    friend class soa_vector<Fields...>;
+    template <bool, class...>
+    friend class soa_vector_iterator;
+
+    soa_vector_iterator(container* v, std::size_t index) noexcept : vector_(v), index_(index) {}
+
+    container* vector_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+// ---------------------------------------------------------------------------------------
+// soa_vector
+// Vector of records stored as a structure of arrays: field I of every element lives in its own
+// contiguous column, so a pass that reads two of twelve fields streams only those two columns.
+// All columns share one allocation and each starts on a cache-line boundary, which lets
+// column<I>() feed aligned SIMD loads. Element access returns proxy tuples of references;
+// get<I>(i) and column<I>() are the fast paths. Growth is fallible and leaves the vector
+// unchanged on failure.
+// ---------------------------------------------------------------------------------------
+template <class... Fields>
+class soa_vector {
+    static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+    static_assert((std::is_object_v<Fields> && ...), "soa_vector fields must be object types");
+
+    static constexpr std::size_t field_count = sizeof...(Fields);
+    using columns = std::tuple<Fields*...>;
+    using indices = std::index_sequence_for<Fields...>;
+
+public:
+    template <std::size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator = soa_vector_iterator<false, Fields...>;
+    using const_iterator = soa_vector_iterator<true, Fields...>;
+
+    // Alignment of the start of every column.
+    static constexpr size_type column_alignment = std::max({cache_line_size, alignof(Fields)...});
+
+    soa_vector() noexcept = default;
+
+    soa_vector(const soa_vector&) = delete;
+    soa_vector& operator=(const soa_vector&) = delete;
+
+    soa_vector(soa_vector&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr)), columns_(std::exchange(other.columns_, columns{})),
+          size_(std::exchange(other.size_, 0)), capacity_(std::exchange(other.capacity_, 0)) {}
+
+    soa_vector& operator=(soa_vector&& other) noexcept {
+        if (this != &other) {
+            release();
+            block_ = std::exchange(other.block_, nullptr);
+            columns_ = std::exchange(other.columns_, columns{});
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~soa_vector() { release(); }
+
+    // Creates a vector of n value-initialized elements.
+    static expected<soa_vector, errc> create(size_type n) noexcept
+        requires(std::is_default_constructible_v<Fields> && ...)
+    {
+        soa_vector v;
+        if (auto result = v.try_resize(n); !result)
+            return unexpected(result.error());
+        return v;
+    }
+
+    static expected<soa_vector, errc> copy(const soa_vector& other) noexcept
+        requires(std::is_copy_constructible_v<Fields> && ...)
+    {
+        soa_vector v;
+        if (auto result = v.try_reserve(other.size_); !result)
+            return unexpected(result.error());
+        for_each_column([&]<std::size_t I>() {
+            std::uninitialized_copy_n(other.template data<I>(), other.size_, v.template data<I>());
+        });
+        v.size_ = other.size_;
+        return v;
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return capacity_; }
+
+    template <std::size_t I>
+    field_type<I>* data() noexcept {
+        return std::get<I>(columns_);
+    }
+    template <std::size_t I>
+    const field_type<I>* data() const noexcept {
+        return std::get<I>(columns_);
+    }
+
+    // Field I of every element, contiguous and aligned to column_alignment.
+    template <std::size_t I>
+    std::span<field_type<I>> column() noexcept {
+        return {data<I>(), size_};
+    }
+    template <std::size_t I>
+    std::span<const field_type<I>> column() const noexcept {
+        return {data<I>(), size_};
+    }
+
+    template <std::size_t I>
+    field_type<I>& get(size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        return data<I>()[i];
+    }
+    template <std::size_t I>
+    const field_type<I>& get(size_type i) const noexcept {
+        EXTL_ASSERT(i < size_);
+        return data<I>()[i];
+    }
+
+    reference operator[](size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        return [&]<std::size_t... I>(std::index_sequence<I...>) { return reference(data<I>()[i]...); }(indices{});
+    }
+    const_reference operator[](size_type i) const noexcept {
+        EXTL_ASSERT(i < size_);
+        return [&]<std::size_t... I>(std::index_sequence<I...>) { return const_reference(data<I>()[i]...); }(indices{});
+    }
+
+    reference front() noexcept { return (*this)[0]; }
+    const_reference front() const noexcept { return (*this)[0]; }
+    reference back() noexcept { return (*this)[size_ - 1]; }
+    const_reference back() const noexcept { return (*this)[size_ - 1]; }
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    expected<void, errc> try_push_back(const value_type& value) noexcept
+        requires(std::is_copy_constructible_v<Fields> && ...)
+    {
+        return std::apply([this](const Fields&... fields) { return try_emplace_back(fields...); }, value);
+    }
+
+    expected<void, errc> try_push_back(value_type&& value) noexcept {
+        return std::apply([this](Fields&... fields) { return try_emplace_back(std::move(fields)...); }, value);
+    }
+
+    // Appends an element whose field I is constructed from args...[I]. args may refer to fields
+    // of this vector.
+    template <class... Args>
+        requires(sizeof...(Args) == field_count && (std::is_constructible_v<Fields, Args &&> && ...))
+    expected<void, errc> try_emplace_back(Args&&... args) noexcept {
+        if (size_ == capacity_)
+            return grow_and_emplace_back(std::forward<Args>(args)...);
+        construct_at_end(columns_, std::forward<Args>(args)...);
+        ++size_;
+        return {};
+    }
+
+    void pop_back() noexcept {
+        EXTL_ASSERT(!empty());
+        --size_;
+        for_each_column([&]<std::size_t I>() { std::destroy_at(data<I>() + size_); });
+    }
+
+    // Removes element i in O(1) by moving the last element into its place.
+    void erase_unordered(size_type i) noexcept {
+        EXTL_ASSERT(i < size_);
+        if (i != size_ - 1)
+            for_each_column([&]<std::size_t I>() { data<I>()[i] = std::move(data<I>()[size_ - 1]); });
+        pop_back();
+    }
+
+    // Grows the capacity to at least `capacity` elements.
+    expected<void, errc> try_reserve(size_type capacity) noexcept {
+        if (capacity <= capacity_)
+            return {};
+        if (capacity > max_size())
+            return unexpected(errc::length_error);
+        return reallocate(capacity);
+    }
+
+    // Resizes to n elements, value-initializing new ones.
+    expected<void, errc> try_resize(size_type n) noexcept
+        requires(std::is_default_constructible_v<Fields> && ...)
+    {
+        if (n > capacity_) {
+            if (n > max_size())
+                return unexpected(errc::length_error);
+            if (auto result = reallocate(std::min(detail::grow_capacity(capacity_, n), max_size())); !result)
+                return result;
+        }
+        while (size_ > n)
+            pop_back();
+        if (n > size_) {
+            for_each_column([&]<std::size_t I>() {
+                std::uninitialized_value_construct_n(data<I>() + size_, n - size_);
+            });
+            size_ = n;
+        }
+        return {};
+    }
+
+    void clear() noexcept {
+        for_each_column([&]<std::size_t I>() { std::destroy_n(data<I>(), size_); });
+        size_ = 0;
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return (std::numeric_limits<size_type>::max() / 2) / (sizeof(Fields) + ...);
+    }
+
+private:
+    template <class F>
+    static void for_each_column(F&& f) noexcept {
+        [&]<std::size_t... I>(std::index_sequence<I...>) { (f.template operator()<I>(), ...); }(indices{});
+    }
+
+    static constexpr size_type align_up(size_type n) noexcept {
+        return (n + column_alignment - 1) & ~(column_alignment - 1);
+    }
+
+    // Bytes needed for `capacity` elements, with the offset of each column.
+    static size_type layout(size_type capacity, std::array<size_type, field_count>& offsets) noexcept {
+        constexpr std::array<size_type, field_count> sizes{sizeof(Fields)...};
+        size_type bytes = 0;
+        for (std::size_t i = 0; i < field_count; ++i) {
+            offsets[i] = bytes;
+            bytes = align_up(bytes + capacity * sizes[i]);
+        }
+        return bytes;
+    }
+
+    template <class... Args>
+    void construct_at_end(const columns& target, Args&&... args) noexcept {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (std::construct_at(std::get<I>(target) + size_, std::forward<Args>(args)), ...);
+        }(indices{});
+    }
+
+    struct storage {
+        unsigned char* block;
+        columns cols;
+    };
+
+    // Growth happens in two steps so try_emplace_back can construct the new element in between,
+    // while the old columns are still alive.
+    static expected<storage, errc> allocate_storage(size_type capacity) noexcept {
+        std::array<size_type, field_count> offsets;
+        const size_type bytes = layout(capacity, offsets);
+        auto* block = static_cast<unsigned char*>(allocate_bytes(bytes, column_alignment));
+        if (block == nullptr)
+            return unexpected(errc::out_of_memory);
+        storage result{block, {}};
+        for_each_column([&]<std::size_t I>() {
+            std::get<I>(result.cols) = reinterpret_cast<field_type<I>*>(block + offsets[I]);
+        });
+        return result;
+    }
+
+    // Moves the elements to s and frees the old block.
+    void adopt_storage(const storage& s, size_type capacity) noexcept {
+        for_each_column([&]<std::size_t I>() { detail::relocate(data<I>(), size_, std::get<I>(s.cols)); });
+        if (block_ != nullptr)
+            deallocate_bytes(block_, column_alignment);
+        block_ = s.block;
+        columns_ = s.cols;
+        capacity_ = capacity;
+    }
+
+    // Out of line: growth is the cold path and keeps push_back small enough to inline.
+    EXTL_NO_INLINE expected<void, errc> reallocate(size_type capacity) noexcept {
+        auto grown = allocate_storage(capacity);
+        if (!grown)
+            return unexpected(grown.error());
+        adopt_storage(*grown, capacity);
+        return {};
+    }
+
+    template <class... Args>
+    EXTL_NO_INLINE expected<void, errc> grow_and_emplace_back(Args&&... args) noexcept {
+        if (size_ == max_size())
+            return unexpected(errc::length_error);
+        const size_type capacity = std::min(detail::grow_capacity(capacity_, size_ + 1), max_size());
+        auto grown = allocate_storage(capacity);
+        if (!grown)
+            return unexpected(grown.error());
+        construct_at_end(grown->cols, std::forward<Args>(args)...);
+        adopt_storage(*grown, capacity);
+        ++size_;
+        return {};
+    }
+
+    void release() noexcept {
+        clear();
+        if (block_ != nullptr)
+            deallocate_bytes(block_, column_alignment);
+        block_ = nullptr;
+        columns_ = columns{};
+        capacity_ = 0;
+    }
+
+    unsigned char* block_ = nullptr;
+    columns columns_{};
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+};
+
+} // namespace extl
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/compare.hpp"
+#include "extl/small_sort.hpp"
+
+namespace extl {
+
+namespace detail {
+
+// Below this size a partition is finished by insertion sort.
+inline constexpr std::ptrdiff_t insertion_sort_threshold = 16;
+
+template <class It, class Compare>
+inline constexpr bool use_small_sort_v =
+    std::contiguous_iterator<It> && small_sortable<std::iter_value_t<It>> &&
+    is_less_compare_v<Compare, std::iter_value_t<It>>;
+
+template <class It, class Compare>
+inline void insertion_sort(It first, It last, Compare& comp) {
+    if (first == last)
+        return;
+    for (It i = std::next(first); i != last; ++i) {
+        std::iter_value_t<It> value = std::ranges::iter_move(i);
+        It hole = i;
+        while (hole != first) {
+            It prev = std::prev(hole);
+            if (!std::invoke(comp, value, *prev))
+                break;
+            *hole = std::ranges::iter_move(prev);
+            hole = prev;
+        }
+        *hole = std::move(value);
+    }
+}
+
+// Moves the median of *a, *b, *c into *a.
+template <class It, class Compare>
+inline void move_median_to_first(It a, It b, It c, Compare& comp) {
+    if (std::invoke(comp, *b, *a))
+        std::iter_swap(a, b);
+    if (std::invoke(comp, *c, *b)) {
+        std::iter_swap(b, c);
+        if (std::invoke(comp, *b, *a))
+            std::iter_swap(a, b);
+    }
+    std::iter_swap(a, b);
+}
+
+// Hoare partition around *first. Returns the split point; [first, cut) <= pivot <= [cut, last).
+template <class It, class Compare>
+inline It partition_around_first(It first, It last, Compare& comp) {
+    It lo = std::next(first);
+    It hi = last;
+    while (true) {
+        while (std::invoke(comp, *lo, *first))
+            ++lo;
+        --hi;
+        while (std::invoke(comp, *first, *hi))
+            --hi;
+        if (!(lo < hi))
+            return lo;
+        std::iter_swap(lo, hi);
+        ++lo;
+    }
+}
+
+template <class It, class Compare>
+inline void introsort_loop(It first, It last, int depth_limit, Compare& comp) {
+    using value_type = std::iter_value_t<It>;
+    constexpr bool small = use_small_sort_v<It, Compare>;
+    constexpr std::ptrdiff_t threshold = [] {
+        if constexpr (small)
+            return static_cast<std::ptrdiff_t>(small_sort_max<value_type>);
+        else
+            return insertion_sort_threshold;
+    }();
+
+    while (last - first > threshold) {
+        if (depth_limit == 0) {
+            std::make_heap(first, last, std::ref(comp));
+            std::sort_heap(first, last, std::ref(comp));
+            return;
+        }
+        --depth_limit;
+
+        It mid = first + (last - first) / 2;
+        move_median_to_first(first, mid, std::prev(last), comp);
+        It cut = partition_around_first(first, last, comp);
+
+        // Recurse into the smaller half and loop on the larger one to bound stack depth.
+        if (cut - first < last - cut) {
+            introsort_loop(first, cut, depth_limit, comp);
+            first = cut;
+        } else {
+            introsort_loop(cut, last, depth_limit, comp);
+            last = cut;
+        }
+    }
+
+    if constexpr (small)
+        small_sort(std::to_address(first), static_cast<std::size_t>(last - first));
+    else
+        insertion_sort(first, last, comp);
+}
+
+} // namespace detail
+
+// Sorts [first, last) with introsort: median-of-three quicksort, a heapsort fallback once the
+// recursion gets too deep, and a small-array base case. Ascending sorts of contiguous int32,
+// int64, float and double sequences finish each partition with small_sort's sorting networks;
+// everything else uses insertion sort. Not stable.
+template <std::random_access_iterator It, std::sentinel_for<It> S, class Compare = std::ranges::less>
+    requires std::sortable<It, Compare>
+inline It sort(It first, S last, Compare comp = {}) {
+    It end = std::ranges::next(first, last);
+    const auto n = end - first;
+    if (n > 1) {
+        const int depth_limit = 2 * std::bit_width(static_cast<std::make_unsigned_t<decltype(n)>>(n));
+        detail::introsort_loop(first, end, depth_limit, comp);
+    }
+    return end;
+}
+
+template <std::ranges::random_access_range R, class Compare = std::ranges::less>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare>
+inline std::ranges::borrowed_iterator_t<R> sort(R&& range, Compare comp = {}) {
+    return extl::sort(std::ranges::begin(range), std::ranges::end(range), std::move(comp));
+}
+
+} // namespace extl
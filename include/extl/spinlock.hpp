@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "extl/config.hpp"
+#include "extl/detail/wait.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// Spin locks
+// For critical sections of a few dozen instructions, where putting a waiter to sleep costs more
+// than the wait itself. None of these ever blocks in the kernel, so they must not be held across
+// anything that can sleep; a waiter that has spun for long yields its CPU, which keeps an
+// oversubscribed machine from livelocking but is no substitute for a sleeping mutex. The locks
+// are not padded; give a hot lock its own cache line, or put it on the line of the data it
+// protects.
+//
+// spinlock     1 byte, unfair. Test-and-test-and-set with exponential backoff.
+// ticket_lock  8 bytes, FIFO. Waiters still all poll one word, so every handover invalidates
+//              the line in every waiting core.
+// mcs_lock     8 bytes, FIFO. Each waiter spins on its own queue node, so a handover touches only
+//              the next waiter's line; this is the one that scales to many contending cores.
+// ---------------------------------------------------------------------------------------
+class spinlock {
+public:
+    spinlock() noexcept = default;
+    spinlock(const spinlock&) = delete;
+    spinlock& operator=(const spinlock&) = delete;
+
+    void lock() noexcept {
+        if (EXTL_LIKELY(!locked_.exchange(true, std::memory_order_acquire)))
+            return;
+        lock_slow();
+    }
+
+    bool try_lock() noexcept {
+        return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+private:
+    EXTL_NO_INLINE void lock_slow() noexcept {
+        detail::backoff wait;
+        do {
+            // Spin on a plain load so the line stays shared until the holder releases it.
+            while (locked_.load(std::memory_order_relaxed))
+                wait.pause();
+        } while (locked_.exchange(true, std::memory_order_acquire));
+    }
+
+    std::atomic<bool> locked_{false};
+};
+
+class ticket_lock {
+public:
+    ticket_lock() noexcept = default;
+    ticket_lock(const ticket_lock&) = delete;
+    ticket_lock& operator=(const ticket_lock&) = delete;
+
+    void lock() noexcept {
+        const std::uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+        std::uint32_t spun = 0;
+        for (;;) {
+            const std::uint32_t serving = serving_.load(std::memory_order_acquire);
+            if (serving == ticket)
+                return;
+            // A FIFO lock cannot be passed over a preempted waiter, so once spinning has clearly
+            // stopped paying off, give the CPU away.
+            if (spun >= max_spins) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Proportional backoff: the further back in the queue, the longer until our turn,
+            // and the less often we need to look.
+            const std::uint32_t pauses = (ticket - serving) * spins_per_waiter;
+            for (std::uint32_t i = 0; i < pauses; ++i)
+                detail::cpu_relax();
+            spun += pauses;
+        }
+    }
+
+    bool try_lock() noexcept {
+        std::uint32_t ticket = serving_.load(std::memory_order_acquire);
+        return next_.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        // Only the holder writes serving_, so a plain increment is enough.
+        serving_.store(serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::uint32_t spins_per_waiter = 32;
+    static constexpr std::uint32_t max_spins = 256;
+
+    std::atomic<std::uint32_t> next_{0};
+    std::atomic<std::uint32_t> serving_{0};
+};
+
+// Each acquisition needs a queue node that stays alive, and unmoved, until the matching unlock.
+// The node is usually on the stack; mcs_lock::guard provides one.
+class mcs_lock {
+public:
+    struct alignas(cache_line_size) node {
+        std::atomic<node*> next{nullptr};
+        std::atomic<bool> waiting{false};
+    };
+
+    // RAII holder with its own queue node.
+    class guard {
+    public:
+        explicit guard(mcs_lock& lock) noexcept : lock_(lock) { lock_.lock(node_); }
+        ~guard() { lock_.unlock(node_); }
+
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+
+    private:
+        mcs_lock& lock_;
+        node node_;
+    };
+
+    mcs_lock() noexcept = default;
+    mcs_lock(const mcs_lock&) = delete;
+    mcs_lock& operator=(const mcs_lock&) = delete;
+
+    void lock(node& n) noexcept {
+        n.next.store(nullptr, std::memory_order_relaxed);
+        n.waiting.store(true, std::memory_order_relaxed);
+        node* prev = tail_.exchange(&n, std::memory_order_acq_rel);
+        if (prev == nullptr)
+            return;
+        prev->next.store(&n, std::memory_order_release);
+        detail::backoff wait;
+        while (n.waiting.load(std::memory_order_acquire))
+            wait.pause();
+    }
+
+    bool try_lock(node& n) noexcept {
+        n.next.store(nullptr, std::memory_order_relaxed);
+        node* expected = nullptr;
+        return tail_.compare_exchange_strong(expected, &n, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock(node& n) noexcept {
+        node* successor = n.next.load(std::memory_order_acquire);
+        if (successor == nullptr) {
+            node* expected = &n;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                              std::memory_order_relaxed))
+                return;
+            // A successor swapped itself in but has not linked behind us yet.
+            detail::backoff wait;
+            while ((successor = n.next.load(std::memory_order_acquire)) == nullptr)
+                wait.pause();
+        }
+        successor->waiting.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<node*> tail_{nullptr};
+};
+
+} // namespace extl
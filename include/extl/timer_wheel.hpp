@@ -0,0 +1,254 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "extl/config.hpp"
+
+namespace extl {
+
+template <std::size_t Levels, std::size_t SlotBits>
+class basic_timer_wheel;
+
+// ---------------------------------------------------------------------------------------
+// timer
+// Intrusive hook for a timer wheel. Embed it in the object that owns the timeout and recover
+// the owner inside the callback. A timer must be cancelled (or have fired) before it is
+// destroyed, and a scheduled timer must not be moved.
+// ---------------------------------------------------------------------------------------
+class timer {
+public:
+    using callback_type = void (*)(timer&) noexcept;
+
+    explicit timer(callback_type callback) noexcept : callback_(callback) {}
+
+    timer(const timer&) = delete;
+    timer& operator=(const timer&) = delete;
+
+    ~timer() { EXTL_ASSERT(!scheduled()); }
+
+    bool scheduled() const noexcept { return pprev_ != nullptr; }
+
+    // Tick at which the timer fires. Only meaningful while scheduled.
+    std::uint64_t deadline() const noexcept { return deadline_; }
+
+    void set_callback(callback_type callback) noexcept { callback_ = callback; }
+
+private:
+    template <std::size_t, std::size_t>
+    friend class basic_timer_wheel;
+
+    timer* next_ = nullptr;
+    timer** pprev_ = nullptr;
+    std::uint64_t deadline_ = 0;
+    std::uint32_t slot_ = 0;
+    callback_type callback_;
+};
+
+// ---------------------------------------------------------------------------------------
+// basic_timer_wheel
+// Hierarchical timing wheel (Varghese & Lauck) with Levels levels of 2^SlotBits slots each.
+// Level l covers deadlines up to 2^(SlotBits * (l + 1)) ticks ahead; when a lower level wraps,
+// the matching slot of the level above is cascaded down. Deadlines beyond the top level are
+// parked in its last slot and re-examined once per top-level rotation.
+//
+// schedule() and cancel() are O(1) and never allocate: slots are intrusive lists of timer hooks.
+// advance() jumps over empty stretches using per-level occupancy bitmaps, so its cost depends
+// on the number of occupied slots and level wraps rather than on the number of elapsed ticks.
+// Ticks are an abstract unit; callers choose the resolution (for example one millisecond).
+// ---------------------------------------------------------------------------------------
+template <std::size_t Levels = 4, std::size_t SlotBits = 8>
+class basic_timer_wheel {
+    static_assert(Levels >= 1 && SlotBits >= 1, "a wheel needs at least one level and two slots");
+    static_assert(Levels * SlotBits <= 64, "the wheel cannot span more than 64 bits of ticks");
+
+public:
+    static constexpr std::size_t levels = Levels;
+    static constexpr std::size_t slots_per_level = std::size_t(1) << SlotBits;
+
+    explicit basic_timer_wheel(std::uint64_t now = 0) noexcept : now_(now) {}
+
+    basic_timer_wheel(const basic_timer_wheel&) = delete;
+    basic_timer_wheel& operator=(const basic_timer_wheel&) = delete;
+
+    ~basic_timer_wheel() { clear(); }
+
+    std::uint64_t now() const noexcept { return now_; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Schedules t to fire at tick `deadline`, rescheduling it if it is already pending.
+    // Deadlines that are not in the future fire on the next advance().
+    void schedule(timer& t, std::uint64_t deadline) noexcept {
+        if (t.scheduled())
+            cancel(t);
+        t.deadline_ = deadline > now_ ? deadline : now_ + 1;
+        insert(t);
+        ++size_;
+    }
+
+    void schedule_after(timer& t, std::uint64_t delay) noexcept { schedule(t, now_ + delay); }
+
+    // Removes t from the wheel. Returns false if it was not scheduled.
+    bool cancel(timer& t) noexcept {
+        if (!t.scheduled())
+            return false;
+        unlink(t);
+        if (slots_[t.slot_] == nullptr)
+            clear_bit(t.slot_);
+        --size_;
+        return true;
+    }
+
+    // Moves the wheel forward to tick `now`, firing every timer whose deadline is at or before
+    // it in deadline order (timers sharing a tick fire in unspecified order). Callbacks may
+    // schedule or cancel any timer, including themselves. Returns the number of timers fired.
+    std::size_t advance(std::uint64_t now) noexcept {
+        std::size_t fired = 0;
+        while (now_ < now) {
+            if (size_ == 0) {
+                now_ = now;
+                break;
+            }
+
+            // Next tick that needs work: an occupied level-0 slot or a level-0 wrap.
+            const std::uint64_t wrap = (now_ | level_mask) + 1;
+            std::uint64_t tick = wrap;
+            const std::size_t from = static_cast<std::size_t>((now_ + 1) & level_mask);
+            if (from != 0) {
+                const std::size_t slot = next_occupied(0, from);
+                if (slot != slots_per_level)
+                    tick = now_ + (slot - from) + 1;
+            }
+            if (tick > now) {
+                now_ = now;
+                break;
+            }
+
+            now_ = tick;
+            if ((tick & level_mask) == 0)
+                cascade(tick);
+            fired += fire(static_cast<std::uint32_t>(tick & level_mask));
+        }
+        return fired;
+    }
+
+    // Unschedules every timer without firing it.
+    void clear() noexcept {
+        for (std::size_t i = 0; i < Levels * slots_per_level; ++i) {
+            while (timer* t = slots_[i])
+                unlink(*t);
+        }
+        for (auto& word : occupied_)
+            word = 0;
+        size_ = 0;
+    }
+
+private:
+    static constexpr std::uint64_t level_mask = slots_per_level - 1;
+
+    static constexpr std::uint32_t slot_index(std::size_t level, std::uint64_t slot) noexcept {
+        return static_cast<std::uint32_t>(level * slots_per_level + slot);
+    }
+
+    void insert(timer& t) noexcept {
+        const std::uint64_t delta = t.deadline_ - now_;
+        const std::size_t level = delta == 0 ? 0 : (std::bit_width(delta) - 1) / SlotBits;
+
+        std::uint32_t index;
+        if (level < Levels) {
+            index = slot_index(level, (t.deadline_ >> (SlotBits * level)) & level_mask);
+        } else {
+            // Beyond the wheel's span: park in the top level slot that is cascaded last.
+            constexpr std::size_t top = Levels - 1;
+            index = slot_index(top, ((now_ >> (SlotBits * top)) - 1) & level_mask);
+        }
+
+        t.slot_ = index;
+        t.next_ = slots_[index];
+        if (t.next_ != nullptr)
+            t.next_->pprev_ = &t.next_;
+        slots_[index] = &t;
+        t.pprev_ = &slots_[index];
+        set_bit(index);
+    }
+
+    static void unlink(timer& t) noexcept {
+        *t.pprev_ = t.next_;
+        if (t.next_ != nullptr)
+            t.next_->pprev_ = t.pprev_;
+        t.next_ = nullptr;
+        t.pprev_ = nullptr;
+    }
+
+    // Detaches a slot's list so callbacks can safely reschedule into the same slot.
+    timer* detach(std::uint32_t index) noexcept {
+        timer* head = slots_[index];
+        slots_[index] = nullptr;
+        clear_bit(index);
+        return head;
+    }
+
+    // Redistributes the higher-level slots that come due at `tick`, a multiple of the level-0 span.
+    void cascade(std::uint64_t tick) noexcept {
+        for (std::size_t level = 1; level < Levels; ++level) {
+            const std::uint64_t slot = (tick >> (SlotBits * level)) & level_mask;
+            timer* head = detach(slot_index(level, slot));
+            while (head != nullptr) {
+                timer* t = head;
+                head = head->next_;
+                insert(*t);
+            }
+            if (slot != 0)
+                break;
+        }
+    }
+
+    std::size_t fire(std::uint32_t index) noexcept {
+        timer* pending = detach(index);
+        if (pending == nullptr)
+            return 0;
+        pending->pprev_ = &pending;
+
+        std::size_t fired = 0;
+        while (pending != nullptr) {
+            timer& t = *pending;
+            unlink(t);
+            --size_;
+            ++fired;
+            t.callback_(t);
+        }
+        return fired;
+    }
+
+    void set_bit(std::uint32_t index) noexcept { occupied_[index / 64] |= std::uint64_t(1) << (index % 64); }
+    void clear_bit(std::uint32_t index) noexcept { occupied_[index / 64] &= ~(std::uint64_t(1) << (index % 64)); }
+
+    // First occupied slot >= from on `level`, or slots_per_level if there is none.
+    std::size_t next_occupied(std::size_t level, std::size_t from) const noexcept {
+        const std::size_t base = level * slots_per_level;
+        std::size_t i = from;
+        while (i < slots_per_level) {
+            const std::size_t bit = base + i;
+            const std::size_t available = 64 - bit % 64;
+            std::uint64_t word = occupied_[bit / 64] >> (bit % 64);
+            if (slots_per_level - i < available)
+                word &= (std::uint64_t(1) << (slots_per_level - i)) - 1;
+            if (word != 0)
+                return i + static_cast<std::size_t>(std::countr_zero(word));
+            i += available;
+        }
+        return slots_per_level;
+    }
+
+    timer* slots_[Levels * slots_per_level] = {};
+    std::uint64_t occupied_[(Levels * slots_per_level + 63) / 64] = {};
+    std::uint64_t now_;
+    std::size_t size_ = 0;
+};
+
+using timer_wheel = basic_timer_wheel<>;
+
+} // namespace extl
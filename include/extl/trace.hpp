@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+
+#include "extl/config.hpp"
+#include "extl/detail/cpu.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+#include "extl/mutex.hpp"
+
+// Events kept per thread; the oldest are overwritten once a thread has recorded this many.
+#ifndef EXTL_TRACE_BUFFER_EVENTS
+#define EXTL_TRACE_BUFFER_EVENTS 16384
+#endif
+
+namespace extl::trace {
+
+namespace detail {
+
+inline constexpr std::size_t buffer_events = EXTL_TRACE_BUFFER_EVENTS;
+static_assert(buffer_events >= 2 && (buffer_events & (buffer_events - 1)) == 0,
+              "EXTL_TRACE_BUFFER_EVENTS must be a power of two");
+
+enum phase : std::uint64_t { begin = 0, end = 1, instant = 2 };
+inline constexpr unsigned phase_bits = 2;
+
+// 16 bytes: the cycle count shifted left by phase_bits with the phase in the low bits, and the
+// name. Both are atomics so an exporter may read a slot the owner is overwriting; such slots are
+// detected and dropped (see thread_buffer::snapshot).
+struct event {
+    std::atomic<std::uint64_t> stamp{0};
+    std::atomic<const char*> name{nullptr};
+};
+
+struct snapshot_event {
+    std::uint64_t stamp;
+    const char* name;
+};
+
+// A single-writer flight recorder. Only the owning thread pushes; head counts every event ever
+// pushed, so slot head % buffer_events is the next one overwritten.
+struct alignas(cache_line_size) thread_buffer {
+    EXTL_FORCE_INLINE void push(const char* name, phase ph) noexcept {
+        const std::uint64_t h = head.load(std::memory_order_relaxed);
+        // Orders the publication of head == h before the slot is overwritten, so an exporter that
+        // reads any part of the new event also sees head > h and discards the slot.
+        std::atomic_thread_fence(std::memory_order_release);
+        event& e = events[h & (buffer_events - 1)];
+        e.stamp.store((extl::detail::read_cycle_counter() << phase_bits) | ph, std::memory_order_relaxed);
+        e.name.store(name, std::memory_order_relaxed);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Copies the events still intact, oldest first, into out (room for buffer_events) and returns
+    // how many were copied. Events before `floor` are skipped.
+    std::size_t snapshot(snapshot_event* out) const noexcept {
+        const std::uint64_t last = head.load(std::memory_order_acquire);
+        const std::uint64_t first = std::max(floor, last > buffer_events ? last - buffer_events : 0);
+        for (std::uint64_t i = first; i < last; ++i) {
+            const event& e = events[i & (buffer_events - 1)];
+            out[i - first] = {e.stamp.load(std::memory_order_relaxed), e.name.load(std::memory_order_relaxed)};
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Slots of events at or below now - buffer_events may have been rewritten while copying; the
+        // owner may be rewriting the oldest slot, so a full ring yields buffer_events - 1 events.
+        const std::uint64_t now = head.load(std::memory_order_relaxed);
+        const std::uint64_t intact = now >= buffer_events ? now - buffer_events + 1 : 0;
+        if (intact <= first)
+            return static_cast<std::size_t>(last - first);
+        if (intact >= last)
+            return 0;
+        const std::size_t skipped = static_cast<std::size_t>(intact - first);
+        std::copy(out + skipped, out + (last - first), out);
+        return static_cast<std::size_t>(last - intact);
+    }
+
+    std::atomic<std::uint64_t> head{0};
+    // The fields below are guarded by the registry mutex.
+    std::uint64_t floor = 0;
+    const char* thread_name = nullptr;
+    std::uint32_t tid = 0;
+    bool attached = false;
+    thread_buffer* next = nullptr;
+    event events[buffer_events];
+};
+
+// Owns every thread buffer. Buffers outlive their threads so an export after a thread exits still
+// shows its events; a buffer is handed to a new thread only once its owner has exited. The
+// registry is never destroyed, so threads may trace during static destruction.
+struct registry {
+    adaptive_mutex mutex;
+    thread_buffer* buffers = nullptr;
+    std::uint32_t next_tid = 1;
+    std::atomic<bool> enabled{true};
+    // Cycle counter and steady_clock taken together when tracing starts, to convert cycles to
+    // time at export.
+    const std::uint64_t origin_cycles = extl::detail::read_cycle_counter();
+    const std::chrono::steady_clock::time_point origin_time = std::chrono::steady_clock::now();
+};
+
+inline registry& global() noexcept {
+    alignas(registry) static unsigned char storage[sizeof(registry)];
+    static registry* const r = ::new (static_cast<void*>(storage)) registry;
+    return *r;
+}
+
+inline thread_local thread_buffer* current = nullptr;
+
+// Releases the calling thread's buffer for reuse when the thread exits.
+struct detach_on_exit {
+    ~detach_on_exit() {
+        if (current == nullptr)
+            return;
+        std::lock_guard lock(global().mutex);
+        current->attached = false;
+        current = nullptr;
+    }
+};
+
+// Returns null if a new buffer cannot be allocated; the thread then records nothing.
+EXTL_NO_INLINE inline thread_buffer* attach() noexcept {
+    thread_local detach_on_exit detach;
+    registry& r = global();
+    std::lock_guard lock(r.mutex);
+    thread_buffer* buffer = r.buffers;
+    while (buffer != nullptr && buffer->attached)
+        buffer = buffer->next;
+    if (buffer == nullptr) {
+        buffer = allocate<thread_buffer>(1);
+        if (buffer == nullptr)
+            return nullptr;
+        std::construct_at(buffer);
+        buffer->next = r.buffers;
+        r.buffers = buffer;
+    }
+    // A recycled buffer still holds its previous thread's events; hide them.
+    buffer->floor = buffer->head.load(std::memory_order_relaxed);
+    buffer->thread_name = nullptr;
+    buffer->tid = r.next_tid++;
+    buffer->attached = true;
+    current = buffer;
+    return buffer;
+}
+
+EXTL_FORCE_INLINE thread_buffer* local() noexcept {
+    thread_buffer* buffer = current;
+    return EXTL_LIKELY(buffer != nullptr) ? buffer : attach();
+}
+
+inline void record(const char* name, phase ph) noexcept {
+    if (thread_buffer* buffer = local(); buffer != nullptr)
+        buffer->push(name, ph);
+}
+
+// Writes s as the body of a JSON string.
+template <class Sink>
+void write_escaped(Sink& sink, const char* s) {
+    static constexpr char hex[] = "0123456789abcdef";
+    const char* run = s;
+    for (; *s != '\0'; ++s) {
+        const auto c = static_cast<unsigned char>(*s);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        sink(std::string_view(run, static_cast<std::size_t>(s - run)));
+        const char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+        sink(std::string_view(escaped, sizeof(escaped)));
+        run = s + 1;
+    }
+    sink(std::string_view(run, static_cast<std::size_t>(s - run)));
+}
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------
+// Hot-path tracing
+// EXTL_TRACE_SCOPE("name") records a begin event where it is declared and an end event when the
+// scope exits; EXTL_TRACE_INSTANT("name") records a point event. Each thread records into its own
+// ring of EXTL_TRACE_BUFFER_EVENTS 16-byte events (256 KiB by default) holding the most recent
+// activity, so tracing can stay on in production: an event is a cycle-counter read and three
+// uncontended stores, with no locks, allocation or system calls after a thread's first event.
+//
+// export_chrome_json() writes what the rings currently hold in the Chrome trace event format,
+// which chrome://tracing and ui.perfetto.dev load directly. End events whose begin has been
+// overwritten are dropped; scopes still open show as running to the end of the trace.
+//
+// Names must be string literals or otherwise outlive every export: only the pointer is stored.
+// Define EXTL_TRACE_DISABLE to compile the macros out entirely.
+// ---------------------------------------------------------------------------------------
+
+// Turns recording on or off for all threads; on by default. Scopes already entered still record
+// their end.
+inline void set_enabled(bool on) noexcept { detail::global().enabled.store(on, std::memory_order_relaxed); }
+inline bool enabled() noexcept { return detail::global().enabled.load(std::memory_order_relaxed); }
+
+// Names the calling thread in exported traces. The name must outlive every export.
+inline void set_thread_name(const char* name) noexcept {
+    if (detail::thread_buffer* buffer = detail::local(); buffer != nullptr) {
+        std::lock_guard lock(detail::global().mutex);
+        buffer->thread_name = name;
+    }
+}
+
+// Hides every event recorded so far from later exports.
+inline void clear() noexcept {
+    detail::registry& r = detail::global();
+    std::lock_guard lock(r.mutex);
+    for (detail::thread_buffer* b = r.buffers; b != nullptr; b = b->next)
+        b->floor = b->head.load(std::memory_order_acquire);
+}
+
+inline void instant(const char* name) noexcept {
+    if (enabled())
+        detail::record(name, detail::instant);
+}
+
+class scope {
+public:
+    explicit scope(const char* name) noexcept : name_(enabled() ? name : nullptr) {
+        if (name_ != nullptr)
+            detail::record(name_, detail::begin);
+    }
+    ~scope() {
+        if (name_ != nullptr)
+            detail::record(name_, detail::end);
+    }
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+private:
+    const char* name_;
+};
+
+// Streams the recorded events as Chrome trace JSON by calling sink(std::string_view) with
+// consecutive pieces of the document. Threads keep recording meanwhile; registering new threads
+// waits until the export finishes, so the sink must not trace from a thread that has not traced
+// before. Fails with out_of_memory if the scratch copy of a ring cannot be allocated.
+template <class Sink>
+expected<void, errc> export_chrome_json(Sink&& sink) {
+    auto* scratch = allocate<detail::snapshot_event>(detail::buffer_events);
+    if (scratch == nullptr)
+        return unexpected(errc::out_of_memory);
+
+    detail::registry& r = detail::global();
+    std::lock_guard lock(r.mutex);
+    // Calibrate the cycle counter against steady_clock over the whole time traced so far, and
+    // over at least a few milliseconds.
+    const auto min_span = std::chrono::milliseconds(5);
+    if (std::chrono::steady_clock::now() - r.origin_time < min_span)
+        std::this_thread::sleep_for(min_span);
+    const std::uint64_t now_cycles = extl::detail::read_cycle_counter();
+    const double elapsed_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - r.origin_time).count();
+    const double us_per_cycle =
+        now_cycles > r.origin_cycles ? elapsed_ns / 1000.0 / static_cast<double>(now_cycles - r.origin_cycles) : 0.0;
+
+    char text[128];
+    bool first = true;
+    auto separator = [&] {
+        sink(std::string_view(first ? "\n" : ",\n"));
+        first = false;
+    };
+    sink(std::string_view("{\"traceEvents\":["));
+    for (const detail::thread_buffer* b = r.buffers; b != nullptr; b = b->next) {
+        if (b->thread_name != nullptr) {
+            separator();
+            std::snprintf(text, sizeof(text),
+                          "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"",
+                          static_cast<unsigned>(b->tid));
+            sink(std::string_view(text));
+            detail::write_escaped(sink, b->thread_name);
+            sink(std::string_view("\"}}"));
+        }
+        const std::size_t n = b->snapshot(scratch);
+        std::size_t depth = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto ph = static_cast<detail::phase>(scratch[i].stamp & ((1u << detail::phase_bits) - 1));
+            if (ph == detail::end) {
+                if (depth == 0)
+                    continue;
+                --depth;
+            } else if (ph == detail::begin) {
+                ++depth;
+            }
+            const std::uint64_t cycles = scratch[i].stamp >> detail::phase_bits;
+            const double us =
+                cycles > r.origin_cycles ? static_cast<double>(cycles - r.origin_cycles) * us_per_cycle : 0.0;
+            separator();
+            std::snprintf(text, sizeof(text), "{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"name\":\"",
+                          ph == detail::begin ? "B" : ph == detail::end ? "E" : "i\",\"s\":\"t",
+                          static_cast<unsigned>(b->tid), us);
+            sink(std::string_view(text));
+            detail::write_escaped(sink, scratch[i].name);
+            sink(std::string_view("\"}"));
+        }
+    }
+    sink(std::string_view("\n],\"displayTimeUnit\":\"ns\"}\n"));
+    deallocate(scratch);
+    return {};
+}
+
+// export_chrome_json() into a file; fails with invalid_argument if writing fails.
+inline expected<void, errc> write_chrome_json(std::FILE* file) {
+    auto exported =
+        export_chrome_json([file](std::string_view piece) { std::fwrite(piece.data(), 1, piece.size(), file); });
+    if (!exported)
+        return exported;
+    if (std::fflush(file) != 0 || std::ferror(file) != 0)
+        return unexpected(errc::invalid_argument);
+    return {};
+}
+
+} // namespace extl::trace
+
+#define EXTL_TRACE_CONCAT_(a, b) a##b
+#define EXTL_TRACE_CONCAT(a, b) EXTL_TRACE_CONCAT_(a, b)
+
+#ifdef EXTL_TRACE_DISABLE
+#define EXTL_TRACE_SCOPE(name) ((void)0)
+#define EXTL_TRACE_INSTANT(name) ((void)0)
+#else
+#define EXTL_TRACE_SCOPE(name) const ::extl::trace::scope EXTL_TRACE_CONCAT(extl_trace_scope_, __COUNTER__)(name)
+#define EXTL_TRACE_INSTANT(name) ::extl::trace::instant(name)
+#endif
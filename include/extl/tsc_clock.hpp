@@ -0,0 +1,244 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+#include <thread>
+
+#include "extl/config.hpp"
+#include "extl/detail/cpu.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define EXTL_HAS_TSC 1
+#else
+#define EXTL_HAS_TSC 0
+#endif
+
+namespace extl {
+
+namespace detail::tsc {
+
+inline std::int64_t monotonic_ns() noexcept {
+#if defined(CLOCK_MONOTONIC)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+#if EXTL_HAS_TSC
+inline void cpuid(unsigned leaf, unsigned regs[4]) noexcept {
+#if defined(_MSC_VER)
+    int out[4];
+    __cpuid(out, static_cast<int>(leaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<unsigned>(out[i]);
+#else
+    __cpuid(leaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+#endif
+
+// What the CPU says about its time-stamp counter.
+struct features {
+    bool invariant = false; // ticks at a constant rate in every P-, C- and T-state
+    bool rdtscp = false;
+};
+
+inline features detect() noexcept {
+    features f;
+#if EXTL_HAS_TSC
+    unsigned regs[4];
+    cpuid(0x80000000u, regs);
+    const unsigned max_extended = regs[0];
+    if (max_extended >= 0x80000001u) {
+        cpuid(0x80000001u, regs);
+        f.rdtscp = (regs[3] >> 27) & 1;
+    }
+    if (max_extended >= 0x80000007u) {
+        cpuid(0x80000007u, regs);
+        f.invariant = (regs[3] >> 8) & 1;
+    }
+#elif defined(__aarch64__)
+    // The generic timer runs at the fixed rate in CNTFRQ_EL0 by architecture.
+    f.invariant = true;
+#endif
+    return f;
+}
+
+// How tsc_clock turns ticks into nanoseconds, fixed on first use.
+struct calibration {
+    features cpu;
+    bool uses_counter = false;
+    std::uint64_t base_ticks = 0;
+    std::int64_t base_ns = 0;
+    double ns_per_tick = 0.0;
+};
+
+// One (counter, CLOCK_MONOTONIC) pair: the counter midpoint of the tightest of a few brackets
+// around a clock_gettime call, which keeps preemption and vDSO jitter out of the pairing.
+struct sample {
+    std::uint64_t ticks;
+    std::int64_t ns;
+};
+
+inline sample take_sample() noexcept {
+    sample best{0, 0};
+    std::uint64_t best_width = ~std::uint64_t{0};
+    for (int i = 0; i < 8; ++i) {
+        const std::uint64_t before = read_cycle_counter();
+        const std::int64_t ns = monotonic_ns();
+        const std::uint64_t after = read_cycle_counter();
+        if (after >= before && after - before < best_width) {
+            best_width = after - before;
+            best = {before + (after - before) / 2, ns};
+        }
+    }
+    return best;
+}
+
+// The rate is measured even for a TSC that is not invariant, so tick differences taken over a
+// short section still convert sensibly; only now() insists on an invariant counter.
+inline calibration calibrate() noexcept {
+    calibration c;
+    c.cpu = detect();
+#if defined(__aarch64__)
+    std::uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    if (frequency == 0)
+        return c;
+    const sample start = take_sample();
+    c.ns_per_tick = 1e9 / static_cast<double>(frequency);
+#elif EXTL_HAS_TSC
+    // Ten milliseconds bound the rate error by roughly the pairing error over that span, a few
+    // parts per million.
+    const sample start = take_sample();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const sample end = take_sample();
+    if (end.ticks <= start.ticks || end.ns <= start.ns)
+        return c;
+    c.ns_per_tick = static_cast<double>(end.ns - start.ns) / static_cast<double>(end.ticks - start.ticks);
+#else
+    // read_cycle_counter() is steady_clock here.
+    const sample start = take_sample();
+    c.ns_per_tick = static_cast<double>(std::chrono::steady_clock::period::num) * 1e9 /
+                    static_cast<double>(std::chrono::steady_clock::period::den);
+#endif
+    c.base_ticks = start.ticks;
+    c.base_ns = start.ns;
+    c.uses_counter = c.cpu.invariant;
+    return c;
+}
+
+inline const calibration& global() noexcept {
+    static const calibration c = calibrate();
+    return c;
+}
+
+} // namespace detail::tsc
+
+// ---------------------------------------------------------------------------------------
+// tsc_clock
+// A steady std::chrono clock read from the CPU's time-stamp counter: now() is one rdtsc, a
+// subtraction and a multiply, several times cheaper than steady_clock::now() through the vDSO.
+// Readings use the CLOCK_MONOTONIC epoch but run at the rate measured once at calibration, so the
+// two clocks drift apart: by the calibration error, typically around one part per million (a few
+// milliseconds per hour), plus any rate correction NTP applies to CLOCK_MONOTONIC afterwards, which
+// while slewing may reach 500 ppm. Compare tsc_clock readings with each other, not with other clocks.
+//
+// The counter is used only when the CPU reports an invariant TSC (constant rate across frequency
+// and sleep states, synchronized between cores); AArch64's generic timer always qualifies.
+// Otherwise now() falls back to clock_gettime(CLOCK_MONOTONIC). On x86 the first use calibrates the
+// rate against CLOCK_MONOTONIC over 10 ms; call now() once at startup to keep that off hot paths.
+//
+// For measuring short code sections, ticks_begin() and ticks_end() order the counter read against
+// the surrounding instructions, and to_duration() converts a tick difference.
+// ---------------------------------------------------------------------------------------
+class tsc_clock {
+public:
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<tsc_clock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        const auto& c = detail::tsc::global();
+        if (EXTL_UNLIKELY(!c.uses_counter))
+            return time_point(duration(detail::tsc::monotonic_ns()));
+        // Signed, in case this core's counter trails the calibrating core's by a few ticks.
+        const auto delta = static_cast<std::int64_t>(detail::read_cycle_counter() - c.base_ticks);
+        const auto elapsed = static_cast<double>(delta) * c.ns_per_tick;
+        return time_point(duration(c.base_ns + static_cast<rep>(elapsed)));
+    }
+
+    // The raw counter. The CPU may execute the read before earlier instructions finish or after
+    // later ones start, which matters only when timing a few dozen instructions.
+    static std::uint64_t ticks() noexcept { return detail::read_cycle_counter(); }
+
+    // Reads the counter after every earlier instruction has completed and before any later one
+    // starts: take it at the start of a measured section.
+    static std::uint64_t ticks_begin() noexcept {
+#if EXTL_HAS_TSC
+        _mm_lfence();
+        const std::uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+#elif defined(__aarch64__)
+        std::uint64_t t;
+        asm volatile("isb\n\tmrs %0, cntvct_el0\n\tisb" : "=r"(t) : : "memory");
+        return t;
+#else
+        return ticks();
+#endif
+    }
+
+    // Reads the counter once the measured section has completed, without letting code after it
+    // start early: rdtscp followed by lfence, or lfence on both sides where rdtscp is missing.
+    static std::uint64_t ticks_end() noexcept {
+#if EXTL_HAS_TSC
+        std::uint64_t t;
+        if (EXTL_LIKELY(detail::tsc::global().cpu.rdtscp)) {
+            unsigned aux;
+            t = __rdtscp(&aux);
+        } else {
+            _mm_lfence();
+            t = __rdtsc();
+        }
+        _mm_lfence();
+        return t;
+#else
+        return ticks_begin();
+#endif
+    }
+
+    // Converts a difference of ticks()/ticks_begin()/ticks_end() readings to nanoseconds, using the
+    // calibrated rate even when now() does not use the counter; zero if the rate is unknown.
+    static duration to_duration(std::uint64_t tick_delta) noexcept {
+        return duration(static_cast<rep>(static_cast<double>(tick_delta) * detail::tsc::global().ns_per_tick));
+    }
+
+    // True when now() reads the counter rather than calling clock_gettime.
+    static bool uses_counter() noexcept { return detail::tsc::global().uses_counter; }
+    static bool invariant_tsc() noexcept { return detail::tsc::global().cpu.invariant; }
+    // Calibrated counter rate; 0 if it could not be measured.
+    static double ticks_per_second() noexcept {
+        const double ns_per_tick = detail::tsc::global().ns_per_tick;
+        return ns_per_tick > 0.0 ? 1e9 / ns_per_tick : 0.0;
+    }
+};
+
+} // namespace extl
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "extl/config.hpp"
+#include "extl/detail/hash.hpp"
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+#include "extl/memory.hpp"
+
+namespace extl {
+
+// ---------------------------------------------------------------------------------------
+// xor_filter
+// Static membership filter (Graf and Lemire's xor filter). Each key owns three slots, one in each
+// third of a table of about 1.23 fingerprints per key, and the table is solved so that the
+// three slots xor to the key's fingerprint. A probe reads three fingerprints and compares once.
+// With 8-bit fingerprints the false positive rate is about 0.4% at 9.84 bits per key, with
+// 16-bit ones about 0.0015% at 19.7 bits per key: smaller than a Bloom filter of equal rate.
+// The key set is fixed at construction.
+// ---------------------------------------------------------------------------------------
+template <class Key, class Hash = std::hash<Key>, class Fingerprint = std::uint8_t>
+class xor_filter {
+    static_assert(std::is_unsigned_v<Fingerprint> && sizeof(Fingerprint) <= 4);
+
+public:
+    using key_type = Key;
+    using hasher = Hash;
+    using fingerprint_type = Fingerprint;
+    using size_type = std::size_t;
+
+    xor_filter() noexcept = default;
+
+    xor_filter(const xor_filter&) = delete;
+    xor_filter& operator=(const xor_filter&) = delete;
+
+    xor_filter(xor_filter&& other) noexcept
+        : fingerprints_(std::exchange(other.fingerprints_, nullptr)),
+          segment_length_(std::exchange(other.segment_length_, 0)), seed_(other.seed_), hash_(std::move(other.hash_)) {}
+
+    xor_filter& operator=(xor_filter&& other) noexcept {
+        if (this != &other) {
+            deallocate(fingerprints_);
+            fingerprints_ = std::exchange(other.fingerprints_, nullptr);
+            segment_length_ = std::exchange(other.segment_length_, 0);
+            seed_ = other.seed_;
+            hash_ = std::move(other.hash_);
+        }
+        return *this;
+    }
+
+    ~xor_filter() { deallocate(fingerprints_); }
+
+    // Builds a filter for keys; duplicate keys are allowed. Construction retries with a new seed
+    // in the rare case the slot graph cannot be peeled (a few percent of attempts); running out
+    // of attempts is reported as invalid_argument.
+    static expected<xor_filter, errc> create(std::span<const Key> keys, const Hash& hash = Hash()) noexcept {
+        xor_filter filter;
+        filter.hash_ = hash;
+        if (keys.size() > max_size())
+            return unexpected(errc::length_error);
+
+        std::uint64_t* hashes = allocate<std::uint64_t>(keys.size() == 0 ? 1 : keys.size());
+        if (hashes == nullptr)
+            return unexpected(errc::out_of_memory);
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            hashes[i] = detail::mix64(static_cast<std::uint64_t>(hash(keys[i])));
+        std::sort(hashes, hashes + keys.size());
+        const auto n = static_cast<std::size_t>(std::unique(hashes, hashes + keys.size()) - hashes);
+
+        auto result = filter.build(hashes, n);
+        deallocate(hashes);
+        if (!result)
+            return unexpected(result.error());
+        return filter;
+    }
+
+    static expected<xor_filter, errc> copy(const xor_filter& other) noexcept {
+        xor_filter filter;
+        filter.hash_ = other.hash_;
+        filter.seed_ = other.seed_;
+        if (other.fingerprints_ != nullptr) {
+            filter.fingerprints_ = allocate<Fingerprint>(other.slot_count());
+            if (filter.fingerprints_ == nullptr)
+                return unexpected(errc::out_of_memory);
+            std::memcpy(filter.fingerprints_, other.fingerprints_, other.size_in_bytes());
+            filter.segment_length_ = other.segment_length_;
+        }
+        return filter;
+    }
+
+    // Always true for the keys the filter was built from.
+    bool contains(const Key& key) const noexcept {
+        if (fingerprints_ == nullptr)
+            return false;
+        const std::uint64_t h = derive(detail::mix64(static_cast<std::uint64_t>(hash_(key))), seed_);
+        return fingerprint(h) == (fingerprints_[slot(h, 0)] ^ fingerprints_[slot(h, 1)] ^ fingerprints_[slot(h, 2)]);
+    }
+
+    size_type slot_count() const noexcept { return 3 * size_type(segment_length_); }
+    size_type size_in_bytes() const noexcept { return slot_count() * sizeof(Fingerprint); }
+
+    static constexpr size_type max_size() noexcept { return size_type{1} << 31; }
+
+private:
+    static constexpr int max_attempts = 64;
+
+    // Seeded per-attempt hash derived from a key's mixed hash.
+    static std::uint64_t derive(std::uint64_t h, std::uint64_t seed) noexcept { return detail::mix64(h + seed); }
+
+    static Fingerprint fingerprint(std::uint64_t h) noexcept { return static_cast<Fingerprint>(h ^ (h >> 32)); }
+
+    std::uint32_t slot(std::uint64_t h, int i) const noexcept {
+        const auto r = static_cast<std::uint32_t>(std::rotl(h, 21 * i));
+        return detail::reduce(r, segment_length_) + static_cast<std::uint32_t>(i) * segment_length_;
+    }
+
+    // Peels the hypergraph whose edges are the keys' slot triples: repeatedly removes a key that
+    // is alone in one of its slots, then assigns fingerprints in reverse removal order.
+    expected<void, errc> build(const std::uint64_t* hashes, std::size_t n) noexcept {
+        segment_length_ = static_cast<std::uint32_t>((32 + n + n / 4 - n / 50) / 3 + 1); // ~1.23 slots per key
+        const std::size_t slots = slot_count();
+
+        fingerprints_ = allocate<Fingerprint>(slots);
+        std::uint32_t* counts = allocate<std::uint32_t>(slots);
+        std::uint64_t* xors = allocate<std::uint64_t>(slots);
+        std::uint32_t* queue = allocate<std::uint32_t>(slots);
+        std::uint64_t* stack_hashes = allocate<std::uint64_t>(n == 0 ? 1 : n);
+        std::uint32_t* stack_slots = allocate<std::uint32_t>(n == 0 ? 1 : n);
+        expected<void, errc> result = unexpected(errc::out_of_memory);
+        if (fingerprints_ != nullptr && counts != nullptr && xors != nullptr && queue != nullptr &&
+            stack_hashes != nullptr && stack_slots != nullptr) {
+            result = unexpected(errc::invalid_argument);
+            std::uint64_t seed = 0;
+            for (int attempt = 0; attempt < max_attempts; ++attempt) {
+                seed += 0x9e3779b97f4a7c15ull;
+                if (peel(hashes, n, seed, counts, xors, queue, stack_hashes, stack_slots)) {
+                    seed_ = seed;
+                    assign(n, stack_hashes, stack_slots);
+                    result = {};
+                    break;
+                }
+            }
+        }
+        deallocate(counts);
+        deallocate(xors);
+        deallocate(queue);
+        deallocate(stack_hashes);
+        deallocate(stack_slots);
+        if (!result) {
+            deallocate(fingerprints_);
+            fingerprints_ = nullptr;
+            segment_length_ = 0;
+        }
+        return result;
+    }
+
+    bool peel(const std::uint64_t* hashes, std::size_t n, std::uint64_t seed, std::uint32_t* counts, std::uint64_t* xors,
+              std::uint32_t* queue, std::uint64_t* stack_hashes, std::uint32_t* stack_slots) const noexcept {
+        const std::size_t slots = slot_count();
+        std::fill_n(counts, slots, 0u);
+        std::fill_n(xors, slots, std::uint64_t{0});
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::uint64_t h = derive(hashes[i], seed);
+            for (int j = 0; j < 3; ++j) {
+                const std::uint32_t s = slot(h, j);
+                ++counts[s];
+                xors[s] ^= h;
+            }
+        }
+
+        std::size_t queued = 0;
+        for (std::size_t s = 0; s < slots; ++s) {
+            if (counts[s] == 1)
+                queue[queued++] = static_cast<std::uint32_t>(s);
+        }
+        std::size_t stacked = 0;
+        while (queued != 0) {
+            const std::uint32_t s = queue[--queued];
+            if (counts[s] != 1)
+                continue; // Emptied since it was queued.
+            const std::uint64_t h = xors[s];
+            stack_hashes[stacked] = h;
+            stack_slots[stacked] = s;
+            ++stacked;
+            for (int j = 0; j < 3; ++j) {
+                const std::uint32_t t = slot(h, j);
+                xors[t] ^= h;
+                if (--counts[t] == 1)
+                    queue[queued++] = t;
+            }
+        }
+        return stacked == n;
+    }
+
+    void assign(std::size_t n, const std::uint64_t* stack_hashes, const std::uint32_t* stack_slots) noexcept {
+        std::fill_n(fingerprints_, slot_count(), Fingerprint{0});
+        for (std::size_t i = n; i-- != 0;) {
+            const std::uint64_t h = stack_hashes[i];
+            Fingerprint f = fingerprint(h);
+            for (int j = 0; j < 3; ++j) {
+                const std::uint32_t t = slot(h, j);
+                if (t != stack_slots[i])
+                    f ^= fingerprints_[t];
+            }
+            fingerprints_[stack_slots[i]] = f;
+        }
+    }
+
+    Fingerprint* fingerprints_ = nullptr;
+    std::uint32_t segment_length_ = 0;
+    std::uint64_t seed_ = 0;
+    [[no_unique_address]] Hash hash_{};
+};
+
+} // namespace extl
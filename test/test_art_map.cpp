@@ -0,0 +1,184 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "extl/art_map.hpp"
+
+namespace {
+
+using string_map = extl::art_map<std::string_view, int>;
+
+// Keys with long shared prefixes, keys that are prefixes of other keys, and the empty key.
+std::vector<std::string> tricky_keys(std::size_t n, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    const std::vector<std::string> stems = {"", "a", "ab", "abc", "user/profile/settings/", "user/profile/",
+                                            "user/profile/settings/theme/dark/"};
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::string key = stems[rng() % stems.size()];
+        const std::size_t extra = rng() % 6;
+        for (std::size_t j = 0; j < extra; ++j)
+            key.push_back(static_cast<char>('a' + rng() % (j == 0 ? 26 : 3)));
+        keys.push_back(std::move(key));
+    }
+    return keys;
+}
+
+std::vector<std::pair<std::string, int>> collect(const string_map& map) {
+    std::vector<std::pair<std::string, int>> out;
+    map.for_each([&](std::string_view key, const int& value) { out.emplace_back(key, value); });
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("art_map matches std::map under random inserts and erases") {
+    const auto keys = tricky_keys(4000, 65);
+    string_map map;
+    std::map<std::string, int> reference;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto result = map.try_emplace(keys[i], static_cast<int>(i));
+        REQUIRE(result);
+        const bool inserted = reference.emplace(keys[i], static_cast<int>(i)).second;
+        REQUIRE(result->second == inserted);
+        REQUIRE(*result->first == reference[keys[i]]);
+    }
+    CHECK(map.size() == reference.size());
+    for (const auto& [key, value] : reference) {
+        const int* found = map.find(key);
+        REQUIRE(found != nullptr);
+        REQUIRE(*found == value);
+    }
+    CHECK_FALSE(map.contains("user/profile/settings/theme/dark/zzzzzz"));
+    CHECK_FALSE(map.contains("user/prof"));
+
+    const std::vector<std::pair<std::string, int>> expected(reference.begin(), reference.end());
+    CHECK(collect(map) == expected);
+
+    for (std::size_t i = 0; i < keys.size(); i += 3) {
+        REQUIRE(map.erase(keys[i]) == (reference.erase(keys[i]) == 1));
+        REQUIRE(map.size() == reference.size());
+    }
+    const std::vector<std::pair<std::string, int>> remaining(reference.begin(), reference.end());
+    CHECK(collect(map) == remaining);
+    for (const auto& [key, value] : reference)
+        REQUIRE(map.contains(key));
+
+    auto copied = string_map::copy(map);
+    REQUIRE(copied);
+    CHECK(collect(*copied) == remaining);
+
+    for (const auto& key : keys)
+        map.erase(key);
+    CHECK(map.empty());
+    CHECK(collect(map).empty());
+    CHECK(copied->size() == remaining.size());
+}
+
+TEST_CASE("art_map nodes grow to 256 children and shrink back") {
+    extl::art_map<std::string_view, int> map;
+    std::vector<std::string> keys;
+    for (int b = 0; b < 256; ++b)
+        keys.push_back(std::string("k") + static_cast<char>(b));
+    for (int b = 0; b < 256; ++b) {
+        REQUIRE(map.try_emplace(keys[b], b));
+        for (int c = 0; c <= b; c += 17)
+            REQUIRE(*map.find(keys[c]) == c);
+    }
+    for (int b = 255; b >= 0; --b) {
+        REQUIRE(map.erase(keys[b]));
+        for (int c = 0; c < b; c += 13)
+            REQUIRE(*map.find(keys[c]) == c);
+        REQUIRE_FALSE(map.contains(keys[b]));
+    }
+    CHECK(map.empty());
+
+    REQUIRE(map.try_insert_or_assign("x", 1));
+    auto assigned = map.try_insert_or_assign("x", 2);
+    REQUIRE(assigned);
+    CHECK_FALSE(*assigned);
+    CHECK(*map.find("x") == 2);
+}
+
+TEST_CASE("art_map orders integer keys numerically") {
+    extl::art_map<std::int32_t, std::int64_t> map;
+    std::map<std::int32_t, std::int64_t> reference;
+    std::mt19937 rng(7);
+    for (int i = 0; i < 5000; ++i) {
+        const auto key = static_cast<std::int32_t>(rng());
+        REQUIRE(map.try_emplace(key, std::int64_t{key} * 2));
+        reference.emplace(key, std::int64_t{key} * 2);
+    }
+    for (std::int32_t key : {-1, 0, 1, INT32_MIN, INT32_MAX}) {
+        REQUIRE(map.try_emplace(key, std::int64_t{key} * 2));
+        reference.emplace(key, std::int64_t{key} * 2);
+    }
+    CHECK(map.size() == reference.size());
+
+    std::vector<std::int32_t> order;
+    map.for_each([&](std::int32_t key, std::int64_t& value) {
+        REQUIRE(value == std::int64_t{key} * 2);
+        order.push_back(key);
+    });
+    std::vector<std::int32_t> expected;
+    for (const auto& entry : reference)
+        expected.push_back(entry.first);
+    CHECK(order == expected);
+
+    std::vector<std::int32_t> in_range;
+    map.scan_range(-1000000, 1000000, [&](std::int32_t key, std::int64_t&) { in_range.push_back(key); });
+    std::vector<std::int32_t> expected_range;
+    for (auto it = reference.lower_bound(-1000000); it != reference.lower_bound(1000000); ++it)
+        expected_range.push_back(it->first);
+    CHECK(in_range == expected_range);
+    CHECK(in_range.size() >= 3);
+}
+
+TEST_CASE("art_map prefix and range scans match std::map") {
+    const auto keys = tricky_keys(3000, 11);
+    string_map map;
+    std::map<std::string, int> reference;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(map.try_emplace(keys[i], static_cast<int>(i)));
+        reference.emplace(keys[i], static_cast<int>(i));
+    }
+
+    for (std::string_view prefix : {"", "a", "ab", "abq", "user/", "user/profile/settings/t", "user/profile/x", "zz"}) {
+        std::vector<std::string> found;
+        map.scan_prefix(prefix, [&](std::string_view key, int&) { found.emplace_back(key); });
+        std::vector<std::string> expected;
+        for (auto it = reference.lower_bound(std::string(prefix));
+             it != reference.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            expected.push_back(it->first);
+        CHECK(found == expected);
+    }
+
+    std::mt19937 rng(2);
+    for (int round = 0; round < 200; ++round) {
+        std::string lo = keys[rng() % keys.size()];
+        std::string hi = keys[rng() % keys.size()];
+        if (round % 4 == 0)
+            lo.push_back('m');
+        if (hi < lo)
+            std::swap(lo, hi);
+        std::vector<std::string> found;
+        map.scan_range(lo, hi, [&](std::string_view key, const int&) { found.emplace_back(key); });
+        std::vector<std::string> expected;
+        for (auto it = reference.lower_bound(lo); it != reference.lower_bound(hi); ++it)
+            expected.push_back(it->first);
+        REQUIRE(found == expected);
+    }
+
+    // Returning false stops the scan.
+    std::size_t visited = 0;
+    map.scan_prefix("user/", [&](std::string_view, int&) { return ++visited < 5; });
+    CHECK(visited == 5);
+    visited = 0;
+    map.scan_range("", "zzz", [&](std::string_view, int&) { return ++visited < 3; });
+    CHECK(visited == 3);
+}
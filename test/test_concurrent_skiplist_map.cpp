@@ -0,0 +1,149 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "extl/concurrent_skiplist_map.hpp"
+
+TEST_CASE("concurrent_skiplist_map behaves as an ordered map on one thread") {
+    extl::concurrent_skiplist_map<int, std::string> map(1024);
+    std::map<int, std::string> reference;
+    std::mt19937 rng(66);
+    for (int i = 0; i < 20000; ++i) {
+        const int key = static_cast<int>(rng() % 2000);
+        if (rng() % 3 == 0) {
+            REQUIRE(map.erase(key) == (reference.erase(key) == 1));
+        } else {
+            auto inserted = map.try_emplace(key, std::to_string(key));
+            REQUIRE(inserted);
+            REQUIRE(*inserted == reference.emplace(key, std::to_string(key)).second);
+        }
+    }
+    CHECK(map.size() == reference.size());
+
+    std::vector<std::pair<int, std::string>> seen;
+    map.for_each([&](const int& key, const std::string& value) { seen.emplace_back(key, value); });
+    CHECK(seen == std::vector<std::pair<int, std::string>>(reference.begin(), reference.end()));
+
+    for (int key = 0; key < 2000; ++key)
+        REQUIRE(map.contains(key) == (reference.count(key) == 1));
+    std::string found;
+    const int present = reference.begin()->first;
+    CHECK(map.visit(present, [&](const std::string& value) { found = value; }));
+    CHECK(found == std::to_string(present));
+    CHECK_FALSE(map.visit(-1, [&](const std::string&) {}));
+
+    // scan() starts at the lower bound and stops when the callback returns false.
+    std::vector<int> scanned;
+    map.scan(1000, [&](const int& key, const std::string&) {
+        scanned.push_back(key);
+        return scanned.size() < 10;
+    });
+    std::vector<int> expected;
+    for (auto it = reference.lower_bound(1000); it != reference.end() && expected.size() < 10; ++it)
+        expected.push_back(it->first);
+    CHECK(scanned == expected);
+
+    // Erased nodes are recycled, so churn on a fixed key set does not keep growing the arena.
+    const std::size_t reserved = map.arena_bytes();
+    for (int round = 0; round < 20; ++round) {
+        for (int key = 0; key < 2000; ++key)
+            map.erase(key);
+        for (int key = 0; key < 2000; ++key)
+            REQUIRE(map.try_emplace(key, "x"));
+    }
+    CHECK(map.size() == 2000);
+    CHECK(map.arena_bytes() < reserved * 3);
+}
+
+TEST_CASE("concurrent_skiplist_map keeps every entry under concurrent writers and readers") {
+    extl::concurrent_skiplist_map<std::uint64_t, std::uint64_t> map;
+    constexpr unsigned writers = 4;
+    constexpr std::uint64_t per_writer = 20000;
+    std::atomic<bool> done{false};
+    std::atomic<unsigned> unordered_scans{0};
+
+    std::vector<std::thread> readers;
+    for (unsigned r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                std::uint64_t last = 0;
+                bool first = true;
+                map.for_each([&](const std::uint64_t& key, const std::uint64_t& value) {
+                    if ((!first && key <= last) || value != key * 3)
+                        unordered_scans.fetch_add(1);
+                    first = false;
+                    last = key;
+                });
+            }
+        });
+    }
+
+    // Writer w owns keys congruent to w modulo writers: it inserts them all, erases the odd
+    // multiples, and fights over a shared hot range with the other writers.
+    std::vector<std::thread> threads;
+    for (unsigned w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            for (std::uint64_t i = 0; i < per_writer; ++i) {
+                const std::uint64_t key = i * writers + w + 1000;
+                (void)map.try_emplace(key, key * 3);
+                (void)map.try_emplace(i % 64, (i % 64) * 3);
+                map.erase((i * 7) % 64);
+            }
+            for (std::uint64_t i = 1; i < per_writer; i += 2)
+                map.erase(i * writers + w + 1000);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers)
+        t.join();
+
+    CHECK(unordered_scans.load() == 0);
+    for (std::uint64_t i = 0; i < per_writer * writers; ++i) {
+        const std::uint64_t key = i + 1000;
+        REQUIRE(map.contains(key) == ((i / writers) % 2 == 0));
+    }
+    std::size_t counted = 0;
+    map.for_each([&](const std::uint64_t&, const std::uint64_t&) { ++counted; });
+    CHECK(counted == map.size());
+    CHECK(map.size() >= per_writer * writers / 2);
+}
+
+TEST_CASE("concurrent_skiplist_map stays cheap while a reader stalls reclamation") {
+    extl::concurrent_skiplist_map<std::uint64_t, std::uint64_t> map;
+    std::atomic<bool> pinned{false};
+    std::atomic<bool> release{false};
+    std::thread reader([&] {
+        auto guard = extl::epoch::pin();
+        pinned.store(true, std::memory_order_release);
+        while (!release.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    });
+    while (!pinned.load(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    // Every erase retires a node the stalled reader keeps alive; walking the whole limbo list on
+    // each operation would make this loop quadratic.
+    constexpr std::uint64_t rounds = 200000;
+    for (std::uint64_t i = 0; i < rounds; ++i) {
+        (void)map.try_emplace(i % 1000, i);
+        map.erase(i % 1000);
+    }
+    release.store(true, std::memory_order_release);
+    reader.join();
+
+    const std::size_t reserved = map.arena_bytes();
+    for (std::uint64_t i = 0; i < rounds; ++i) {
+        (void)map.try_emplace(i % 1000, i);
+        map.erase(i % 1000);
+    }
+    CHECK(map.empty());
+    CHECK(map.arena_bytes() == reserved);
+}
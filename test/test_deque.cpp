@@ -0,0 +1,105 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "extl/deque.hpp"
+
+static_assert(std::random_access_iterator<extl::deque<int>::iterator>);
+static_assert(std::random_access_iterator<extl::deque<int>::const_iterator>);
+
+namespace {
+
+struct record {
+    char payload[200];
+    int id;
+};
+
+} // namespace
+
+TEST_CASE("deque block size follows BlockBytes") {
+    CHECK(extl::deque<record>::block_size == 4096 / sizeof(record));
+    CHECK(extl::deque<record, 64>::block_size == 1);
+    CHECK(extl::deque<int, 64>::block_size == 16);
+}
+
+TEST_CASE("deque matches std::deque under random pushes and pops at both ends") {
+    extl::deque<int, 64> d;
+    std::deque<int> reference;
+    std::mt19937 rng(9);
+    for (int step = 0; step < 50000; ++step) {
+        const unsigned op = rng() % 10;
+        if (op < 3) {
+            REQUIRE(d.try_push_back(step));
+            reference.push_back(step);
+        } else if (op < 6) {
+            REQUIRE(d.try_push_front(step));
+            reference.push_front(step);
+        } else if (op < 8 && !reference.empty()) {
+            d.pop_back();
+            reference.pop_back();
+        } else if (!reference.empty()) {
+            d.pop_front();
+            reference.pop_front();
+        }
+        REQUIRE(d.size() == reference.size());
+        if (!reference.empty()) {
+            REQUIRE(d.front() == reference.front());
+            REQUIRE(d.back() == reference.back());
+        }
+    }
+    CHECK(std::equal(d.begin(), d.end(), reference.begin(), reference.end()));
+    const std::size_t mid = d.size() / 2;
+    CHECK(d[mid] == reference[mid]);
+}
+
+TEST_CASE("deque iterators support algorithms and spans cover every element") {
+    extl::deque<int, 32> d;
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(d.try_push_front(i));
+    std::sort(d.begin(), d.end());
+    CHECK(std::is_sorted(d.begin(), d.end()));
+    CHECK(d.end() - d.begin() == 100);
+    CHECK(*(d.begin() + 42) == 42);
+
+    long long sum = 0;
+    std::size_t spans = 0;
+    d.for_each_span([&](std::span<int> s) {
+        ++spans;
+        sum += std::accumulate(s.begin(), s.end(), 0LL);
+    });
+    CHECK(sum == 4950);
+    CHECK(spans >= 100 / extl::deque<int, 32>::block_size);
+}
+
+TEST_CASE("deque with large records, move-only values and copy") {
+    extl::deque<record> records;
+    for (int i = 0; i < 1000; ++i) {
+        record r{};
+        r.id = i;
+        REQUIRE(records.try_push_back(r));
+    }
+    CHECK(records[999].id == 999);
+
+    extl::deque<std::unique_ptr<std::string>, 128> owners;
+    REQUIRE(owners.try_emplace_back(std::make_unique<std::string>("b")));
+    REQUIRE(owners.try_emplace_front(std::make_unique<std::string>("a")));
+    CHECK(*owners.front() == "a");
+    CHECK(*owners.back() == "b");
+
+    extl::deque<int> ints;
+    for (int i = 0; i < 5000; ++i)
+        REQUIRE(ints.try_push_back(i));
+    auto copy = extl::deque<int>::copy(ints);
+    REQUIRE(copy);
+    CHECK(std::equal(ints.begin(), ints.end(), copy->begin(), copy->end()));
+    ints.clear();
+    CHECK(ints.empty());
+    REQUIRE(ints.try_push_front(1));
+    CHECK(ints.front() == 1);
+}
@@ -0,0 +1,167 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "extl/dynamic_bitset.hpp"
+
+namespace {
+
+extl::dynamic_bitset random_bits(std::size_t n, std::mt19937& rng, unsigned density) {
+    auto bits = extl::dynamic_bitset::create(n);
+    REQUIRE(bits);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (rng() % 100 < density)
+            bits->set(i);
+    }
+    return std::move(*bits);
+}
+
+std::vector<bool> to_vector(const extl::dynamic_bitset& bits) {
+    std::vector<bool> out(bits.size());
+    for (std::size_t i = 0; i < bits.size(); ++i)
+        out[i] = bits[i];
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("dynamic_bitset single-bit access and resize") {
+    auto created = extl::dynamic_bitset::create(70);
+    REQUIRE(created);
+    auto bits = std::move(*created);
+    CHECK(bits.size() == 70);
+    CHECK(bits.word_count() == 2);
+    CHECK(bits.none());
+
+    bits.set(0);
+    bits.set(69);
+    bits.set(5, true);
+    bits.flip(6);
+    bits.reset(5);
+    CHECK(bits.test(0));
+    CHECK_FALSE(bits.test(5));
+    CHECK(bits.test(6));
+    CHECK(bits.count() == 3);
+
+    bits.set();
+    CHECK(bits.all());
+    CHECK(bits.count() == 70);
+    CHECK(bits.words()[1] == (std::uint64_t(1) << 6) - 1);
+
+    bits.flip();
+    CHECK(bits.none());
+
+    REQUIRE(bits.try_resize(130, true));
+    CHECK(bits.count() == 60);
+    CHECK_FALSE(bits.test(69));
+    CHECK(bits.test(70));
+    CHECK(bits.test(129));
+    REQUIRE(bits.try_resize(100));
+    CHECK(bits.count() == 30);
+    REQUIRE(bits.try_resize(200));
+    CHECK(bits.count() == 30);
+    REQUIRE(bits.try_push_back(true));
+    CHECK(bits.size() == 201);
+    CHECK(bits.test(200));
+
+    auto copied = extl::dynamic_bitset::copy(bits);
+    REQUIRE(copied);
+    CHECK(*copied == bits);
+    copied->reset(200);
+    CHECK_FALSE(*copied == bits);
+}
+
+TEST_CASE("dynamic_bitset find_first and find_next visit every set bit") {
+    std::mt19937 rng(61);
+    auto bits = random_bits(5000, rng, 3);
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        if (bits[i])
+            expected.push_back(i);
+    }
+    std::vector<std::size_t> found;
+    for (std::size_t i = bits.find_first(); i != extl::dynamic_bitset::npos; i = bits.find_next(i))
+        found.push_back(i);
+    CHECK(found == expected);
+
+    std::vector<std::size_t> visited;
+    bits.for_each_set([&](std::size_t i) { visited.push_back(i); });
+    CHECK(visited == expected);
+
+    auto empty = extl::dynamic_bitset::create(100);
+    REQUIRE(empty);
+    CHECK(empty->find_first() == extl::dynamic_bitset::npos);
+    empty->set(99);
+    CHECK(empty->find_first() == 99);
+    CHECK(empty->find_next(99) == extl::dynamic_bitset::npos);
+}
+
+TEST_CASE("dynamic_bitset bulk operations match bitwise reference") {
+    std::mt19937 rng(7);
+    for (std::size_t n : {1u, 63u, 64u, 65u, 511u, 4096u, 100000u}) {
+        auto a = random_bits(n, rng, 50);
+        auto b = random_bits(n, rng, 30);
+        const auto va = to_vector(a);
+        const auto vb = to_vector(b);
+
+        std::size_t expect_and = 0, expect_or = 0, expect_xor = 0, expect_and_not = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            expect_and += va[i] && vb[i];
+            expect_or += va[i] || vb[i];
+            expect_xor += va[i] != vb[i];
+            expect_and_not += va[i] && !vb[i];
+        }
+        CHECK(extl::dynamic_bitset::count_and(a, b) == expect_and);
+        CHECK(extl::dynamic_bitset::count_or(a, b) == expect_or);
+        CHECK(extl::dynamic_bitset::count_xor(a, b) == expect_xor);
+        CHECK(extl::dynamic_bitset::count_and_not(a, b) == expect_and_not);
+
+        auto c = extl::dynamic_bitset::copy(a);
+        REQUIRE(c);
+        *c &= b;
+        CHECK(c->count() == expect_and);
+        c = extl::dynamic_bitset::copy(a);
+        REQUIRE(c);
+        *c |= b;
+        CHECK(c->count() == expect_or);
+        c = extl::dynamic_bitset::copy(a);
+        REQUIRE(c);
+        *c ^= b;
+        CHECK(c->count() == expect_xor);
+        c = extl::dynamic_bitset::copy(a);
+        REQUIRE(c);
+        c->and_not(b);
+        CHECK(c->count() == expect_and_not);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(c->test(i) == (va[i] && !vb[i]));
+    }
+}
+
+TEST_CASE("rank_select_index agrees with a linear scan") {
+    std::mt19937 rng(3);
+    for (unsigned density : {0u, 1u, 50u, 100u}) {
+        auto bits = random_bits(10000, rng, density);
+        auto index = extl::rank_select_index::create(bits);
+        REQUIRE(index);
+        CHECK(index->count() == bits.count());
+
+        std::size_t rank = 0;
+        for (std::size_t i = 0; i <= bits.size(); ++i) {
+            REQUIRE(index->rank1(i) == rank);
+            REQUIRE(index->rank0(i) == i - rank);
+            if (i < bits.size() && bits[i]) {
+                REQUIRE(index->select1(rank) == i);
+                ++rank;
+            }
+        }
+        CHECK(index->select1(rank) == extl::rank_select_index::npos);
+    }
+
+    extl::dynamic_bitset empty;
+    auto index = extl::rank_select_index::create(empty);
+    REQUIRE(index);
+    CHECK(index->rank1(0) == 0);
+    CHECK(index->select1(0) == extl::rank_select_index::npos);
+}
@@ -0,0 +1,166 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "extl/epoch.hpp"
+
+namespace {
+
+std::atomic<int> reclaimed{0};
+
+struct tracked : extl::epoch_node {
+    explicit tracked(int v) noexcept : value(v) {}
+    int value;
+};
+
+void reclaim_tracked(extl::epoch_node* n) noexcept {
+    delete static_cast<tracked*>(n);
+    reclaimed.fetch_add(1);
+}
+
+// Treiber stack whose popped nodes are retired through the epoch.
+struct stack {
+    struct node : extl::epoch_node {
+        std::uint64_t value;
+        node* next;
+    };
+
+    std::atomic<node*> head{nullptr};
+
+    void push(std::uint64_t value) {
+        auto guard = extl::epoch::pin();
+        node* n = new node;
+        n->value = value;
+        n->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    bool pop(std::uint64_t& value) {
+        auto guard = extl::epoch::pin();
+        node* n = head.load(std::memory_order_acquire);
+        while (n != nullptr && !head.compare_exchange_weak(n, n->next, std::memory_order_acquire)) {
+        }
+        if (n == nullptr)
+            return false;
+        value = n->value;
+        guard.retire(n, [](extl::epoch_node* p) noexcept {
+            delete static_cast<node*>(p);
+            reclaimed.fetch_add(1);
+        });
+        return true;
+    }
+};
+
+} // namespace
+
+TEST_CASE("epoch reclaims retired nodes after a grace period") {
+    extl::epoch::synchronize();
+    reclaimed.store(0);
+    {
+        auto outer = extl::epoch::pin();
+        auto inner = extl::epoch::pin();
+        for (int i = 0; i < 10; ++i)
+            inner.retire(new tracked(i), reclaim_tracked);
+    }
+    CHECK(reclaimed.load() == 0);
+    extl::epoch::synchronize();
+    CHECK(reclaimed.load() == 10);
+
+    // A pinned reader on another thread holds reclamation back until it unpins.
+    std::atomic<int> phase{0};
+    std::thread reader([&] {
+        auto guard = extl::epoch::pin();
+        phase.store(1);
+        while (phase.load() != 2)
+            std::this_thread::yield();
+    });
+    while (phase.load() != 1)
+        std::this_thread::yield();
+    {
+        auto guard = extl::epoch::pin();
+        guard.retire(new tracked(0), reclaim_tracked);
+    }
+    for (int i = 0; i < 10; ++i)
+        extl::epoch::collect();
+    CHECK(reclaimed.load() == 10);
+    phase.store(2);
+    reader.join();
+    extl::epoch::synchronize();
+    CHECK(reclaimed.load() == 11);
+}
+
+TEST_CASE("epoch_limbo holds nodes until their grace period has passed") {
+    extl::epoch_limbo limbo;
+    std::vector<tracked*> freed;
+    auto collect_into = [&](extl::epoch_node* n) noexcept { freed.push_back(static_cast<tracked*>(n)); };
+    tracked a(1), b(2);
+    {
+        auto guard = extl::epoch::pin();
+        limbo.push(&a);
+        limbo.push(&b);
+    }
+    CHECK(limbo.size() == 2);
+    CHECK(a.retired_epoch() == b.retired_epoch());
+    limbo.collect(collect_into);
+    CHECK(limbo.size() + freed.size() == 2);
+    extl::epoch::synchronize();
+    limbo.collect(collect_into);
+    CHECK(freed.size() == 2);
+    CHECK(limbo.size() == 0);
+
+    tracked c(3);
+    {
+        auto guard = extl::epoch::pin();
+        limbo.push(&c);
+    }
+    limbo.drain(collect_into);
+    CHECK(freed.size() == 3);
+}
+
+TEST_CASE("epoch keeps a lock-free stack safe under concurrent pops") {
+    extl::epoch::synchronize();
+    reclaimed.store(0);
+    stack s;
+    constexpr int threads = 4;
+    constexpr std::uint64_t per_thread = 20000;
+    std::atomic<std::uint64_t> popped_sum{0};
+    std::atomic<std::uint64_t> popped_count{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::uint64_t sum = 0;
+            std::uint64_t count = 0;
+            for (std::uint64_t i = 0; i < per_thread; ++i) {
+                s.push(i * threads + t);
+                std::uint64_t value;
+                if (s.pop(value)) {
+                    sum += value;
+                    ++count;
+                }
+            }
+            popped_sum.fetch_add(sum);
+            popped_count.fetch_add(count);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    std::uint64_t value;
+    std::uint64_t sum = popped_sum.load();
+    std::uint64_t count = popped_count.load();
+    while (s.pop(value)) {
+        sum += value;
+        ++count;
+    }
+    const std::uint64_t n = per_thread * threads;
+    CHECK(count == n);
+    CHECK(sum == n * (n - 1) / 2);
+
+    // Nodes left in the exited threads' limbo lists are orphans that synchronize() frees.
+    extl::epoch::synchronize();
+    CHECK(reclaimed.load() == static_cast<int>(n));
+}
@@ -0,0 +1,51 @@
+#include <doctest/doctest.h>
+
+#include <memory>
+#include <string>
+
+#include "extl/error.hpp"
+#include "extl/expected.hpp"
+
+namespace {
+
+extl::expected<int, extl::errc> parse_digit(char c) {
+    if (c < '0' || c > '9')
+        return extl::unexpected(extl::errc::invalid_argument);
+    return c - '0';
+}
+
+} // namespace
+
+TEST_CASE("expected holds a value or an error") {
+    auto ok = parse_digit('7');
+    REQUIRE(ok.has_value());
+    CHECK(*ok == 7);
+    CHECK(ok.value_or(-1) == 7);
+
+    auto bad = parse_digit('x');
+    REQUIRE_FALSE(bad);
+    CHECK(bad.error() == extl::errc::invalid_argument);
+    CHECK(bad.value_or(-1) == -1);
+}
+
+TEST_CASE("expected supports move-only values") {
+    extl::expected<std::unique_ptr<std::string>, extl::errc> e = std::make_unique<std::string>("hello");
+    REQUIRE(e);
+    auto moved = std::move(e);
+    REQUIRE(moved);
+    CHECK(**moved == "hello");
+
+    moved = extl::unexpected(extl::errc::out_of_memory);
+    CHECK_FALSE(moved);
+    CHECK(moved.error() == extl::errc::out_of_memory);
+}
+
+TEST_CASE("expected<void, E>") {
+    extl::expected<void, extl::errc> ok;
+    CHECK(ok.has_value());
+
+    extl::expected<void, extl::errc> bad = extl::unexpected(extl::errc::length_error);
+    CHECK_FALSE(bad.has_value());
+    CHECK(bad.error() == extl::errc::length_error);
+    CHECK(std::string(extl::to_string(bad.error())) == "length error");
+}
@@ -0,0 +1,140 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "extl/bloom_filter.hpp"
+#include "extl/cuckoo_filter.hpp"
+#include "extl/xor_filter.hpp"
+
+namespace {
+
+// Distinct random keys; the first half is inserted, the second half probes for false positives.
+std::vector<std::uint64_t> random_keys(std::size_t n, std::uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint64_t> keys(n);
+    for (std::size_t i = 0; i < n; ++i)
+        keys[i] = (rng() << 20) | i;
+    return keys;
+}
+
+template <class Filter>
+double false_positive_rate(const Filter& filter, const std::vector<std::uint64_t>& absent) {
+    std::size_t hits = 0;
+    for (std::uint64_t key : absent)
+        hits += filter.contains(key);
+    return static_cast<double>(hits) / static_cast<double>(absent.size());
+}
+
+} // namespace
+
+TEST_CASE("bloom_filter has no false negatives and meets its false positive rate") {
+    const auto keys = random_keys(200000, 63);
+    const std::vector<std::uint64_t> present(keys.begin(), keys.begin() + 100000);
+    const std::vector<std::uint64_t> absent(keys.begin() + 100000, keys.end());
+
+    for (double fpr : {0.1, 0.01, 0.001}) {
+        auto filter = extl::bloom_filter<std::uint64_t>::create(present.size(), fpr);
+        REQUIRE(filter);
+        for (std::uint64_t key : present)
+            filter->insert(key);
+        for (std::uint64_t key : present)
+            REQUIRE(filter->contains(key));
+        const double measured = false_positive_rate(*filter, absent);
+        CHECK(measured <= fpr * 1.2);
+        CHECK(measured >= fpr * 0.3);
+
+        auto copied = extl::bloom_filter<std::uint64_t>::copy(*filter);
+        REQUIRE(copied);
+        CHECK(copied->contains(present[0]));
+        filter->clear();
+        CHECK(false_positive_rate(*filter, present) == 0.0);
+    }
+
+    CHECK(extl::bloom_filter<int>::create(10, 0.0).error() == extl::errc::invalid_argument);
+    CHECK(extl::bloom_filter<int>::create(10, 1.0).error() == extl::errc::invalid_argument);
+    auto empty = extl::bloom_filter<int>::create(0, 0.01);
+    REQUIRE(empty);
+    CHECK(empty->block_count() == 1);
+    CHECK_FALSE(empty->contains(1));
+}
+
+TEST_CASE("xor_filter answers every built key") {
+    const auto keys = random_keys(200000, 17);
+    const std::vector<std::uint64_t> present(keys.begin(), keys.begin() + 100000);
+    const std::vector<std::uint64_t> absent(keys.begin() + 100000, keys.end());
+
+    auto filter8 = extl::xor_filter<std::uint64_t>::create(present);
+    REQUIRE(filter8);
+    for (std::uint64_t key : present)
+        REQUIRE(filter8->contains(key));
+    CHECK(false_positive_rate(*filter8, absent) < 0.006);
+    CHECK(filter8->size_in_bytes() < present.size() * 13 / 10);
+
+    auto filter16 = extl::xor_filter<std::uint64_t, std::hash<std::uint64_t>, std::uint16_t>::create(present);
+    REQUIRE(filter16);
+    for (std::uint64_t key : present)
+        REQUIRE(filter16->contains(key));
+    CHECK(false_positive_rate(*filter16, absent) < 0.0002);
+
+    // Duplicates and tiny inputs still build.
+    const std::vector<std::uint64_t> duplicated = {5, 9, 5, 5, 9, 1};
+    auto small = extl::xor_filter<std::uint64_t>::create(duplicated);
+    REQUIRE(small);
+    CHECK(small->contains(1));
+    CHECK(small->contains(5));
+    CHECK(small->contains(9));
+
+    auto empty = extl::xor_filter<std::uint64_t>::create({});
+    REQUIRE(empty);
+    auto copied = extl::xor_filter<std::uint64_t>::copy(*small);
+    REQUIRE(copied);
+    CHECK(copied->contains(9));
+}
+
+TEST_CASE("cuckoo_filter inserts, erases and reports when full") {
+    const auto keys = random_keys(200000, 5);
+    const std::vector<std::uint64_t> present(keys.begin(), keys.begin() + 100000);
+    const std::vector<std::uint64_t> absent(keys.begin() + 100000, keys.end());
+
+    auto created = extl::cuckoo_filter<std::uint64_t>::create(present.size(), 0.001);
+    REQUIRE(created);
+    auto filter = std::move(*created);
+    for (std::uint64_t key : present)
+        REQUIRE(filter.insert(key));
+    CHECK(filter.size() == present.size());
+    for (std::uint64_t key : present)
+        REQUIRE(filter.contains(key));
+    CHECK(false_positive_rate(filter, absent) < 0.001);
+
+    for (std::size_t i = 0; i < present.size(); i += 2)
+        REQUIRE(filter.erase(present[i]));
+    CHECK(filter.size() == present.size() / 2);
+    for (std::size_t i = 1; i < present.size(); i += 2)
+        REQUIRE(filter.contains(present[i]));
+    std::size_t still_found = 0;
+    for (std::size_t i = 0; i < present.size(); i += 2)
+        still_found += filter.contains(present[i]);
+    CHECK(still_found < 100);
+
+    // Fill past capacity: no inserted key is ever lost, and the overflow is reported.
+    auto tiny = extl::cuckoo_filter<std::uint64_t, std::hash<std::uint64_t>, std::uint8_t>::create(64, 0.05);
+    REQUIRE(tiny);
+    std::size_t inserted = 0;
+    while (inserted < keys.size() && tiny->insert(keys[inserted]))
+        ++inserted;
+    CHECK(inserted <= tiny->slot_count() + 1);
+    CHECK(tiny->load_factor() > 0.9);
+    CHECK(tiny->insert(keys[inserted]).error() == extl::errc::length_error);
+    for (std::size_t i = 0; i < inserted; ++i)
+        REQUIRE(tiny->contains(keys[i]));
+    REQUIRE(tiny->erase(keys[0]));
+    REQUIRE(tiny->insert(keys[inserted]));
+    for (std::size_t i = 1; i <= inserted; ++i)
+        REQUIRE(tiny->contains(keys[i]));
+
+    CHECK(extl::cuckoo_filter<std::uint64_t, std::hash<std::uint64_t>, std::uint8_t>::create(10, 0.001).error() ==
+          extl::errc::invalid_argument);
+}
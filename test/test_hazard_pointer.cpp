@@ -0,0 +1,122 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "extl/hazard_pointer.hpp"
+
+namespace {
+
+std::atomic<int> deleted{0};
+
+struct object : extl::hazard_pointer_obj_base<object> {
+    explicit object(std::uint64_t v) noexcept : value(v) {}
+    ~object() {
+        value = 0;
+        deleted.fetch_add(1);
+    }
+    std::uint64_t value;
+};
+
+} // namespace
+
+TEST_CASE("hazard_pointer keeps a protected object alive until it is released") {
+    extl::hazard_pointer_clean_up();
+    deleted.store(0);
+
+    extl::hazard_pointer empty;
+    CHECK(empty.empty());
+    auto hp = extl::make_hazard_pointer();
+    REQUIRE(hp);
+    CHECK_FALSE(hp->empty());
+
+    std::atomic<object*> shared{new object(1)};
+    object* protected_object = hp->protect(shared);
+    CHECK(protected_object->value == 1);
+
+    shared.store(new object(2));
+    protected_object->retire();
+    extl::hazard_pointer_clean_up();
+    CHECK(deleted.load() == 0);
+    CHECK(protected_object->value == 1);
+
+    // try_protect reports a stale pointer and reloads it.
+    object* stale = protected_object;
+    CHECK_FALSE(hp->try_protect(stale, shared));
+    CHECK(stale == shared.load());
+    CHECK(hp->try_protect(stale, shared));
+
+    extl::hazard_pointer_clean_up();
+    CHECK(deleted.load() == 1);
+
+    hp->reset_protection();
+    shared.load()->retire();
+    extl::hazard_pointer_clean_up();
+    CHECK(deleted.load() == 2);
+
+    // Moving transfers the slot; destroying returns it.
+    extl::hazard_pointer moved = std::move(*hp);
+    CHECK(hp->empty());
+    CHECK_FALSE(moved.empty());
+}
+
+TEST_CASE("make_hazard_pointer reports exhaustion") {
+    std::vector<extl::hazard_pointer> all;
+    for (;;) {
+        auto hp = extl::make_hazard_pointer();
+        if (!hp) {
+            CHECK(hp.error() == extl::errc::length_error);
+            break;
+        }
+        all.push_back(std::move(*hp));
+    }
+    CHECK(all.size() == extl::max_hazard_pointers);
+    all.pop_back();
+    CHECK(extl::make_hazard_pointer());
+}
+
+TEST_CASE("hazard_pointer protects readers against concurrent retirement") {
+    extl::hazard_pointer_clean_up();
+    deleted.store(0);
+    std::atomic<object*> shared{new object(1)};
+    std::atomic<bool> done{false};
+    std::atomic<int> bad_reads{0};
+    constexpr int swaps_per_writer = 20000;
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < 3; ++r) {
+        threads.emplace_back([&] {
+            auto hp = extl::make_hazard_pointer();
+            if (!hp)
+                return;
+            while (!done.load(std::memory_order_acquire)) {
+                object* p = hp->protect(shared);
+                if (p->value == 0)
+                    bad_reads.fetch_add(1);
+                hp->reset_protection();
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&] {
+            for (int i = 0; i < swaps_per_writer; ++i) {
+                object* old = shared.exchange(new object(static_cast<std::uint64_t>(i) + 2));
+                old->retire();
+            }
+        });
+    }
+    for (auto& t : writers)
+        t.join();
+    done.store(true, std::memory_order_release);
+    for (auto& t : threads)
+        t.join();
+
+    CHECK(bad_reads.load() == 0);
+    // Writers exited with objects still listed; the clean-up adopts those orphans.
+    extl::hazard_pointer_clean_up();
+    CHECK(deleted.load() == 2 * swaps_per_writer);
+    delete shared.load();
+}
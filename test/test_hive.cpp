@@ -0,0 +1,151 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "extl/hive.hpp"
+
+static_assert(std::bidirectional_iterator<extl::hive<int>::iterator>);
+static_assert(std::bidirectional_iterator<extl::hive<int>::const_iterator>);
+
+TEST_CASE("hive inserts, iterates and erases") {
+    extl::hive<std::string> hive;
+    CHECK(hive.begin() == hive.end());
+    std::vector<std::string*> addresses;
+    for (int i = 0; i < 100; ++i) {
+        auto it = hive.try_insert(std::to_string(i));
+        REQUIRE(it);
+        addresses.push_back(&**it);
+    }
+    CHECK(hive.size() == 100);
+    CHECK(std::distance(hive.begin(), hive.end()) == 100);
+
+    // Erase every even element; the odd ones keep their addresses.
+    for (auto it = hive.begin(); it != hive.end();) {
+        if (std::stoi(*it) % 2 == 0)
+            it = hive.erase(it);
+        else
+            ++it;
+    }
+    CHECK(hive.size() == 50);
+    for (int i = 1; i < 100; i += 2)
+        CHECK(*addresses[static_cast<std::size_t>(i)] == std::to_string(i));
+
+    // Inserts reuse erased slots before growing.
+    const auto capacity = hive.capacity();
+    for (int i = 0; i < 50; ++i)
+        REQUIRE(hive.try_insert("new"));
+    CHECK(hive.capacity() == capacity);
+    CHECK(std::count(hive.begin(), hive.end(), "new") == 50);
+}
+
+TEST_CASE("hive matches a multiset under random churn") {
+    extl::hive<int> hive;
+    std::multiset<int> reference;
+    std::vector<extl::hive<int>::iterator> handles;
+    std::mt19937 rng(3);
+    for (int step = 0; step < 30000; ++step) {
+        if (handles.empty() || rng() % 5 < 3) {
+            const int v = static_cast<int>(rng() % 1000);
+            auto it = hive.try_insert(v);
+            REQUIRE(it);
+            handles.push_back(*it);
+            reference.insert(v);
+        } else {
+            const std::size_t pick = rng() % handles.size();
+            reference.erase(reference.find(*handles[pick]));
+            hive.erase(handles[pick]);
+            handles[pick] = handles.back();
+            handles.pop_back();
+        }
+        if (step % 1000 == 0) {
+            std::vector<int> forward(hive.begin(), hive.end());
+            REQUIRE(forward.size() == reference.size());
+            std::vector<int> backward;
+            for (auto it = hive.end(); it != hive.begin();)
+                backward.push_back(*--it);
+            std::reverse(backward.begin(), backward.end());
+            REQUIRE(forward == backward);
+            std::sort(forward.begin(), forward.end());
+            REQUIRE(std::equal(forward.begin(), forward.end(), reference.begin()));
+        }
+    }
+    CHECK(hive.size() == reference.size());
+
+    // Erasing everything releases all blocks but one spare.
+    for (auto& it : handles)
+        hive.erase(it);
+    CHECK(hive.empty());
+    CHECK(hive.capacity() <= extl::hive<int>::max_block_capacity);
+    CHECK(hive.begin() == hive.end());
+    hive.trim_capacity();
+    CHECK(hive.capacity() == 0);
+}
+
+TEST_CASE("hive reuses an emptied block across a block boundary") {
+    extl::hive<int> hive;
+    for (int i = 0; i < extl::hive<int>::min_block_capacity; ++i)
+        REQUIRE(hive.try_insert(i));
+    const auto full = hive.capacity();
+
+    // Each insert needs a second block and each erase empties it; the spare keeps the same block.
+    auto first = hive.try_insert(-1);
+    REQUIRE(first);
+    const int* address = &**first;
+    const auto grown = hive.capacity();
+    CHECK(grown > full);
+    hive.erase(*first);
+    for (int round = 0; round < 100; ++round) {
+        auto it = hive.try_insert(round);
+        REQUIRE(it);
+        REQUIRE(&**it == address);
+        hive.erase(*it);
+    }
+    CHECK(hive.capacity() == grown);
+    CHECK(hive.size() == extl::hive<int>::min_block_capacity);
+    std::vector<int> values(hive.begin(), hive.end());
+    std::sort(values.begin(), values.end());
+    CHECK(values == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7});
+
+    hive.trim_capacity();
+    CHECK(hive.capacity() == full);
+}
+
+TEST_CASE("hive erase returns the following element") {
+    extl::hive<int> hive;
+    std::vector<extl::hive<int>::iterator> its;
+    for (int i = 0; i < 40; ++i)
+        its.push_back(*hive.try_insert(i));
+    // Build runs on both sides of 10, then erase it so the runs merge.
+    hive.erase(its[9]);
+    hive.erase(its[11]);
+    hive.erase(its[12]);
+    auto next = hive.erase(its[10]);
+    CHECK(*next == 13);
+    CHECK(*--next == 8);
+    std::vector<int> values(hive.begin(), hive.end());
+    CHECK(values.size() == 36);
+    CHECK(std::find(values.begin(), values.end(), 10) == values.end());
+}
+
+TEST_CASE("hive with move-only elements and copy") {
+    extl::hive<std::unique_ptr<int>> owners;
+    REQUIRE(owners.try_emplace(std::make_unique<int>(1)));
+    REQUIRE(owners.try_emplace(new int(2)));
+    int sum = 0;
+    for (auto& p : owners)
+        sum += *p;
+    CHECK(sum == 3);
+
+    extl::hive<int> hive;
+    for (int i = 0; i < 20; ++i)
+        REQUIRE(hive.try_insert(i));
+    auto copy = extl::hive<int>::copy(hive);
+    REQUIRE(copy);
+    CHECK(std::equal(hive.begin(), hive.end(), copy->begin(), copy->end()));
+}
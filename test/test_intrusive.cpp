@@ -0,0 +1,300 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "extl/intrusive/hash_table.hpp"
+#include "extl/intrusive/list.hpp"
+#include "extl/intrusive/rbtree.hpp"
+#include "extl/intrusive/slist.hpp"
+
+namespace {
+
+struct connection {
+    explicit connection(std::uint64_t i = 0) : id(i) {}
+
+    std::uint64_t id;
+    extl::intrusive::list_hook lru_hook;
+    extl::intrusive::slist_hook pending_hook;
+    extl::intrusive::rbtree_hook by_id_hook;
+    extl::intrusive::hash_hook lookup_hook;
+};
+
+struct by_id {
+    using is_transparent = void;
+    bool operator()(const connection& a, const connection& b) const { return a.id < b.id; }
+    bool operator()(const connection& a, std::uint64_t b) const { return a.id < b; }
+    bool operator()(std::uint64_t a, const connection& b) const { return a < b.id; }
+};
+
+struct id_of {
+    std::uint64_t operator()(const connection& c) const { return c.id; }
+};
+
+using lru_list = extl::intrusive::list<connection, &connection::lru_hook>;
+using pending_list = extl::intrusive::slist<connection, &connection::pending_hook>;
+using id_tree = extl::intrusive::rbtree<connection, &connection::by_id_hook, by_id>;
+using id_table = extl::intrusive::hash_table<connection, &connection::lookup_hook, id_of>;
+
+std::vector<std::uint64_t> ids(const auto& range) {
+    std::vector<std::uint64_t> out;
+    for (const connection& c : range)
+        out.push_back(c.id);
+    return out;
+}
+
+} // namespace
+
+static_assert(std::bidirectional_iterator<lru_list::iterator>);
+static_assert(std::forward_iterator<pending_list::iterator>);
+static_assert(std::bidirectional_iterator<id_tree::const_iterator>);
+static_assert(std::forward_iterator<id_table::iterator>);
+
+TEST_CASE("intrusive list links and unlinks in place") {
+    std::vector<connection> conns;
+    for (std::uint64_t i = 0; i < 5; ++i)
+        conns.emplace_back(i);
+    lru_list lru;
+    for (connection& c : conns)
+        lru.push_back(c);
+    CHECK(lru.size() == 5);
+    CHECK(ids(lru) == std::vector<std::uint64_t>{0, 1, 2, 3, 4});
+
+    // Touching an element moves it to the back without any allocation.
+    lru.erase(conns[1]);
+    lru.push_back(conns[1]);
+    CHECK(ids(lru) == std::vector<std::uint64_t>{0, 2, 3, 4, 1});
+    CHECK(lru.front().id == 0);
+    CHECK(lru.back().id == 1);
+
+    auto it = lru.erase(lru.iterator_to(conns[3]));
+    CHECK(it->id == 4);
+    CHECK_FALSE(conns[3].lru_hook.is_linked());
+    lru.insert(it, conns[3]);
+    CHECK(ids(lru) == std::vector<std::uint64_t>{0, 2, 3, 4, 1});
+
+    lru_list other;
+    other.splice_back(lru);
+    CHECK(lru.empty());
+    CHECK(other.size() == 5);
+    CHECK(std::prev(other.end())->id == 1);
+    other.pop_front();
+    other.pop_back();
+    CHECK(ids(other) == std::vector<std::uint64_t>{2, 3, 4});
+
+    lru_list moved(std::move(other));
+    CHECK(moved.size() == 3);
+    moved.clear();
+    for (const connection& c : conns)
+        CHECK_FALSE(c.lru_hook.is_linked());
+}
+
+TEST_CASE("intrusive slist works as a FIFO") {
+    std::vector<connection> conns;
+    for (std::uint64_t i = 0; i < 6; ++i)
+        conns.emplace_back(i);
+    pending_list pending;
+    for (connection& c : conns)
+        pending.push_back(c);
+    CHECK(pending.size() == 6);
+    CHECK(ids(pending) == std::vector<std::uint64_t>{0, 1, 2, 3, 4, 5});
+
+    auto before = pending.begin(); // 0
+    pending.erase_after(before);   // removes 1
+    CHECK(ids(pending) == std::vector<std::uint64_t>{0, 2, 3, 4, 5});
+
+    // Erasing the last element moves the tail back so push_back keeps working.
+    auto it = pending.begin();
+    std::advance(it, 3); // 4
+    pending.erase_after(it);
+    CHECK(pending.back().id == 4);
+    pending.push_back(conns[1]);
+    CHECK(ids(pending) == std::vector<std::uint64_t>{0, 2, 3, 4, 1});
+
+    while (!pending.empty())
+        pending.pop_front();
+    CHECK(pending.begin() == pending.end());
+    pending.push_back(conns[2]);
+    CHECK(pending.front().id == 2);
+    CHECK(pending.back().id == 2);
+}
+
+TEST_CASE("intrusive rbtree matches std::multiset under random updates") {
+    std::vector<connection> conns;
+    for (std::uint64_t i = 0; i < 2000; ++i)
+        conns.emplace_back(i % 700);
+    id_tree tree;
+    std::multiset<std::uint64_t> reference;
+    std::mt19937 rng(59);
+    for (int step = 0; step < 20000; ++step) {
+        connection& c = conns[rng() % conns.size()];
+        if (c.by_id_hook.is_linked()) {
+            tree.erase(c);
+            reference.erase(reference.find(c.id));
+        } else {
+            tree.insert_equal(c);
+            reference.insert(c.id);
+        }
+        if (step % 500 == 0)
+            REQUIRE(tree.check_invariants());
+    }
+    REQUIRE(tree.check_invariants());
+    REQUIRE(tree.size() == reference.size());
+    CHECK(ids(tree) == std::vector<std::uint64_t>(reference.begin(), reference.end()));
+
+    std::vector<std::uint64_t> backwards;
+    for (auto it = tree.end(); it != tree.begin();)
+        backwards.push_back((--it)->id);
+    CHECK(std::equal(backwards.begin(), backwards.end(), reference.rbegin(), reference.rend()));
+
+    for (std::uint64_t key : {0ull, 13ull, 350ull, 699ull, 1000ull}) {
+        auto lower = tree.lower_bound(key);
+        auto expected_lower = reference.lower_bound(key);
+        if (expected_lower == reference.end())
+            CHECK(lower == tree.end());
+        else
+            CHECK(lower->id == *expected_lower);
+        CHECK(tree.contains(key) == reference.contains(key));
+        CHECK(static_cast<std::size_t>(std::distance(lower, tree.upper_bound(key))) == reference.count(key));
+    }
+
+    const std::size_t removed = tree.erase_key(std::uint64_t{13});
+    CHECK(removed == reference.erase(13));
+    CHECK_FALSE(tree.contains(std::uint64_t{13}));
+    CHECK(tree.check_invariants());
+    tree.clear();
+    CHECK(tree.empty());
+    for (const connection& c : conns)
+        CHECK_FALSE(c.by_id_hook.is_linked());
+}
+
+TEST_CASE("intrusive rbtree insert_unique rejects duplicates") {
+    connection a(7), b(7), c(3);
+    id_tree tree;
+    CHECK(tree.insert_unique(a).second);
+    auto [it, inserted] = tree.insert_unique(b);
+    CHECK_FALSE(inserted);
+    CHECK(&*it == &a);
+    CHECK(tree.insert_unique(c).second);
+    CHECK(tree.front().id == 3);
+    CHECK(tree.back().id == 7);
+    CHECK(&*tree.find(std::uint64_t{7}) == &a);
+    CHECK(tree.find(std::uint64_t{5}) == tree.end());
+    CHECK(tree.check_invariants());
+    tree.clear();
+}
+
+TEST_CASE("intrusive rbtree stays balanced under sorted inserts and erases") {
+    // Ascending and descending runs hit every rotation case of the insert and erase fixups.
+    std::vector<connection> conns;
+    for (std::uint64_t i = 0; i < 1024; ++i)
+        conns.emplace_back(i);
+    id_tree tree;
+    for (connection& c : conns) {
+        tree.insert_equal(c);
+        REQUIRE(tree.check_invariants());
+    }
+    for (std::size_t i = 0; i < conns.size(); i += 2) {
+        tree.erase(conns[i]);
+        REQUIRE(tree.check_invariants());
+    }
+    for (std::size_t i = conns.size(); i-- > 0;) {
+        if (conns[i].by_id_hook.is_linked()) {
+            tree.erase(conns[i]);
+            REQUIRE(tree.check_invariants());
+        }
+    }
+    CHECK(tree.empty());
+    CHECK(tree.check_invariants());
+    for (std::size_t i = conns.size(); i-- > 0;)
+        tree.insert_equal(conns[i]);
+    CHECK(tree.check_invariants());
+    CHECK(tree.front().id == 0);
+    CHECK(tree.back().id == 1023);
+    tree.clear();
+}
+
+TEST_CASE("intrusive hash_table finds, erases and rehashes without allocating per element") {
+    auto created = id_table::create(16);
+    REQUIRE(created);
+    id_table table = std::move(*created);
+    CHECK(table.bucket_count() == 16);
+
+    std::vector<connection> conns;
+    for (std::uint64_t i = 0; i < 300; ++i)
+        conns.emplace_back(i * 7919);
+    for (connection& c : conns)
+        REQUIRE(table.insert_unique(c).second);
+    CHECK(table.size() == 300);
+    CHECK(table.load_factor() > 10.0f);
+
+    connection duplicate(7919);
+    auto [existing, inserted] = table.insert_unique(duplicate);
+    CHECK_FALSE(inserted);
+    CHECK(&*existing == &conns[1]);
+
+    REQUIRE(table.try_rehash(512));
+    CHECK(table.bucket_count() == 512);
+    for (const connection& c : conns)
+        REQUIRE(&*table.find(c.id) == &c);
+    CHECK(table.find(std::uint64_t{1}) == table.end());
+
+    table.erase(conns[10]);
+    CHECK_FALSE(table.contains(conns[10].id));
+    CHECK(table.size() == 299);
+
+    std::set<std::uint64_t> seen;
+    for (const connection& c : table)
+        seen.insert(c.id);
+    CHECK(seen.size() == 299);
+    CHECK_FALSE(seen.contains(conns[10].id));
+
+    table.insert_equal(duplicate);
+    CHECK(table.count(std::uint64_t{7919}) == 2);
+    CHECK(table.erase_key(std::uint64_t{7919}) == 2);
+    CHECK(table.size() == 298);
+
+    table.clear();
+    for (const connection& c : conns)
+        CHECK_FALSE(c.lookup_hook.is_linked());
+    CHECK_FALSE(duplicate.lookup_hook.is_linked());
+}
+
+TEST_CASE("one object sits in every intrusive container at once") {
+    std::vector<connection> conns;
+    for (std::uint64_t i = 0; i < 64; ++i)
+        conns.emplace_back(1000 - i);
+    auto created = id_table::create(64);
+    REQUIRE(created);
+    id_table table = std::move(*created);
+    lru_list lru;
+    pending_list pending;
+    id_tree tree;
+    for (connection& c : conns) {
+        lru.push_back(c);
+        pending.push_back(c);
+        tree.insert_unique(c);
+        table.insert_unique(c);
+    }
+
+    // Closing a connection found by id unlinks it from every index in O(1) or O(log n).
+    connection& closing = *table.find(std::uint64_t{990});
+    table.erase(closing);
+    tree.erase(closing);
+    lru.erase(closing);
+    CHECK(lru.size() == 63);
+    CHECK(tree.size() == 63);
+    CHECK(table.size() == 63);
+    CHECK(tree.front().id == 937);
+    CHECK(tree.back().id == 1000);
+    CHECK(std::is_sorted(tree.begin(), tree.end(), by_id{}));
+
+    pending.clear();
+    lru.clear();
+    tree.clear();
+    table.clear();
+}
@@ -0,0 +1,193 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "extl/latency_histogram.hpp"
+
+TEST_CASE("latency_histogram keeps values to the configured precision") {
+    CHECK(extl::latency_histogram::create(1000, 0).error() == extl::errc::invalid_argument);
+    CHECK(extl::latency_histogram::create(1000, 6).error() == extl::errc::invalid_argument);
+    CHECK(extl::latency_histogram::create(1).error() == extl::errc::invalid_argument);
+
+    constexpr std::uint64_t hour_ns = 3'600'000'000'000;
+    auto created = extl::latency_histogram::create(hour_ns, 3);
+    REQUIRE(created);
+    auto& h = *created;
+    CHECK(h.count() == 0);
+    CHECK(h.min() == 0);
+    CHECK(h.max() == 0);
+    CHECK(h.value_at_percentile(99.0) == 0);
+    CHECK(h.bucket_count() < 40000);
+
+    // Small values are exact; every equivalence range stays within 0.1% of its values.
+    for (std::uint64_t v = 0; v < 2048; ++v)
+        CHECK(h.lowest_equivalent(v) == v);
+    for (std::uint64_t v = 2048; v < hour_ns; v = v * 3 + 7) {
+        const std::uint64_t low = h.lowest_equivalent(v);
+        const std::uint64_t high = h.highest_equivalent(v);
+        CHECK(low <= v);
+        CHECK(v <= high);
+        CHECK((high - low) * 1000 < low);
+        if (high < hour_ns)
+            CHECK(h.lowest_equivalent(high + 1) == high + 1);
+    }
+    CHECK(h.highest_equivalent(hour_ns) >= hour_ns);
+    CHECK(h.lowest_equivalent(hour_ns + 12345) == h.lowest_equivalent(hour_ns));
+}
+
+TEST_CASE("latency_histogram reports percentiles, extremes and mean") {
+    auto created = extl::latency_histogram::create(10'000'000);
+    REQUIRE(created);
+    auto& h = *created;
+    for (std::uint64_t v = 1; v <= 10000; ++v)
+        h.record(v * 100);
+    CHECK(h.count() == 10000);
+    CHECK(h.min() == 100);
+    CHECK(h.max() == 1'000'000);
+    CHECK(h.mean() == 500050.0);
+    CHECK(h.value_at_percentile(0.0) == 100);
+    CHECK(h.value_at_percentile(100.0) == 1'000'000);
+    CHECK(h.value_at_percentile(50.0) == h.highest_equivalent(500'000));
+    CHECK(h.value_at_percentile(99.0) == h.highest_equivalent(990'000));
+    CHECK(h.value_at_percentile(99.9) == h.highest_equivalent(999'000));
+
+    h.record(50'000'000, 10);
+    CHECK(h.count() == 10010);
+    CHECK(h.max() == 10'000'000);
+
+    std::uint64_t bucket_total = 0;
+    h.for_each_bucket([&](std::uint64_t, std::uint64_t, std::uint64_t n) { bucket_total += n; });
+    CHECK(bucket_total == h.count());
+
+    h.reset();
+    CHECK(h.count() == 0);
+    CHECK(h.max() == 0);
+    CHECK(h.value_at_percentile(50.0) == 0);
+}
+
+TEST_CASE("latency_histogram records concurrently and merges") {
+    auto created = extl::latency_histogram::create(1'000'000, 2);
+    REQUIRE(created);
+    auto& h = *created;
+    constexpr int threads = 4;
+    constexpr std::uint64_t per_thread = 20000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&h, t] {
+            for (std::uint64_t i = 0; i < per_thread; ++i)
+                h.record(1 + (i + static_cast<std::uint64_t>(t)) % 5000);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    CHECK(h.count() == threads * per_thread);
+    CHECK(h.min() == 1);
+    CHECK(h.max() == 5000);
+
+    auto copied = extl::latency_histogram::copy(h);
+    REQUIRE(copied);
+    CHECK(copied->count() == h.count());
+    CHECK(copied->value_at_percentile(90.0) == h.value_at_percentile(90.0));
+
+    // Merging across configurations re-buckets at the target's precision and clamps to its range.
+    auto coarse = extl::latency_histogram::create(1000, 1);
+    REQUIRE(coarse);
+    coarse->record(7);
+    coarse->merge(h);
+    CHECK(coarse->count() == h.count() + 1);
+    CHECK(coarse->min() == 1);
+    CHECK(coarse->max() == 1000);
+    CHECK(coarse->value_at_percentile(100.0) == 1000);
+}
+
+TEST_CASE("latency_histogram serializes compactly and rejects corrupt input") {
+    auto created = extl::latency_histogram::create(3'600'000'000'000, 3);
+    REQUIRE(created);
+    auto& h = *created;
+    for (std::uint64_t v : {0ull, 5ull, 5ull, 12'345ull, 987'654'321ull, 3'000'000'000'000ull})
+        h.record(v);
+
+    std::vector<std::byte> bytes(h.serialized_size());
+    CHECK(bytes.size() < 64);
+    auto written = h.serialize(bytes);
+    REQUIRE(written);
+    CHECK(*written == bytes.size());
+    std::vector<std::byte> short_buffer(bytes.size() - 1);
+    CHECK(h.serialize(short_buffer).error() == extl::errc::length_error);
+
+    auto restored = extl::latency_histogram::deserialize(bytes);
+    REQUIRE(restored);
+    CHECK(restored->count() == h.count());
+    CHECK(restored->min() == 0);
+    CHECK(restored->max() == 3'000'000'000'000);
+    CHECK(restored->mean() == h.mean());
+    CHECK(restored->significant_digits() == 3);
+    CHECK(restored->highest_value() == h.highest_value());
+    for (double p : {0.0, 25.0, 50.0, 75.0, 99.9, 100.0})
+        CHECK(restored->value_at_percentile(p) == h.value_at_percentile(p));
+
+    auto zeros = extl::latency_histogram::create(100);
+    REQUIRE(zeros);
+    zeros->record(0, 3);
+    std::vector<std::byte> zero_bytes(zeros->serialized_size());
+    REQUIRE(zeros->serialize(zero_bytes));
+    auto zeros_restored = extl::latency_histogram::deserialize(zero_bytes);
+    REQUIRE(zeros_restored);
+    CHECK(zeros_restored->count() == 3);
+
+    for (std::size_t cut = 0; cut + 1 < bytes.size(); ++cut)
+        CHECK_FALSE(extl::latency_histogram::deserialize(std::span(bytes).first(cut)));
+    std::vector<std::byte> bad_magic = bytes;
+    bad_magic[0] = std::byte{'Y'};
+    CHECK(extl::latency_histogram::deserialize(bad_magic).error() == extl::errc::corrupt_data);
+    std::vector<std::byte> bad_digits = bytes;
+    bad_digits[4] = std::byte{9};
+    CHECK(extl::latency_histogram::deserialize(bad_digits).error() == extl::errc::corrupt_data);
+}
+
+TEST_CASE("latency_histogram round-trips after mixed-precision merges and concurrent records") {
+    auto coarse = extl::latency_histogram::create(1'000'000, 1);
+    auto fine = extl::latency_histogram::create(1'000'000, 3);
+    REQUIRE(coarse);
+    REQUIRE(fine);
+    coarse->record(5003);
+    coarse->record(9000);
+    fine->merge(*coarse);
+    CHECK(fine->count() == 2);
+    // The samples were re-recorded at their coarse buckets' lowest values, 4864 and 8704; the
+    // extremes are clamped into the fine buckets those landed in.
+    CHECK(fine->min() == fine->highest_equivalent(4864));
+    CHECK(fine->max() == fine->highest_equivalent(8704));
+
+    std::vector<std::byte> bytes(fine->serialized_size());
+    REQUIRE(fine->serialize(bytes));
+    auto restored = extl::latency_histogram::deserialize(bytes);
+    REQUIRE(restored);
+    CHECK(restored->count() == 2);
+    CHECK(restored->min() == fine->min());
+    CHECK(restored->max() == fine->max());
+    CHECK(restored->value_at_percentile(100.0) == fine->value_at_percentile(100.0));
+
+    // Snapshots taken while another thread records must always deserialize.
+    auto live = extl::latency_histogram::create(1'000'000, 2);
+    REQUIRE(live);
+    std::atomic<bool> done{false};
+    std::thread recorder([&] {
+        for (std::uint64_t i = 0; !done.load(std::memory_order_relaxed); ++i)
+            live->record((i * 7919) % 1'000'000);
+    });
+    int failures = 0;
+    std::vector<std::byte> snapshot(live->bucket_count() * 10 + 64);
+    for (int round = 0; round < 200; ++round) {
+        auto written = live->serialize(snapshot);
+        if (!written || !extl::latency_histogram::deserialize(std::span(snapshot).first(*written)))
+            ++failures;
+    }
+    done.store(true, std::memory_order_relaxed);
+    recorder.join();
+    CHECK(failures == 0);
+}
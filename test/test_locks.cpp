@@ -0,0 +1,166 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "extl/mutex.hpp"
+#include "extl/spinlock.hpp"
+
+namespace {
+
+constexpr int threads = 4;
+constexpr int increments_per_thread = 20000;
+
+// Runs `threads` threads that each increment a plain counter under the lock, and returns the
+// final count. Any lost update means the lock let two threads in.
+template <class Lock>
+std::uint64_t contend() {
+    Lock lock;
+    std::uint64_t counter = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < increments_per_thread; ++i) {
+                std::lock_guard hold(lock);
+                ++counter;
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    return counter;
+}
+
+} // namespace
+
+TEST_CASE("exclusive locks never admit two holders at once") {
+    constexpr std::uint64_t expected = std::uint64_t{threads} * increments_per_thread;
+    CHECK(contend<extl::spinlock>() == expected);
+    CHECK(contend<extl::ticket_lock>() == expected);
+    CHECK(contend<extl::adaptive_mutex>() == expected);
+    CHECK(contend<extl::rw_lock>() == expected);
+}
+
+TEST_CASE("try_lock fails while the lock is held") {
+    extl::spinlock spin;
+    REQUIRE(spin.try_lock());
+    CHECK_FALSE(spin.try_lock());
+    spin.unlock();
+    CHECK(spin.try_lock());
+    spin.unlock();
+
+    extl::ticket_lock ticket;
+    REQUIRE(ticket.try_lock());
+    CHECK_FALSE(ticket.try_lock());
+    ticket.unlock();
+    ticket.lock();
+    ticket.unlock();
+    CHECK(ticket.try_lock());
+    ticket.unlock();
+
+    extl::adaptive_mutex mutex;
+    REQUIRE(mutex.try_lock());
+    CHECK_FALSE(mutex.try_lock());
+    mutex.unlock();
+    CHECK(mutex.try_lock());
+    mutex.unlock();
+
+    extl::mcs_lock mcs;
+    extl::mcs_lock::node first;
+    extl::mcs_lock::node second;
+    REQUIRE(mcs.try_lock(first));
+    CHECK_FALSE(mcs.try_lock(second));
+    mcs.unlock(first);
+    CHECK(mcs.try_lock(second));
+    mcs.unlock(second);
+}
+
+TEST_CASE("mcs_lock hands the lock down its queue") {
+    extl::mcs_lock lock;
+    std::uint64_t counter = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < increments_per_thread; ++i) {
+                extl::mcs_lock::guard hold(lock);
+                ++counter;
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    CHECK(counter == std::uint64_t{threads} * increments_per_thread);
+}
+
+TEST_CASE("rw_lock admits readers together and writers alone") {
+    extl::rw_lock lock;
+    REQUIRE(lock.try_lock_shared());
+    REQUIRE(lock.try_lock_shared());
+    CHECK_FALSE(lock.try_lock());
+    lock.unlock_shared();
+    lock.unlock_shared();
+    REQUIRE(lock.try_lock());
+    CHECK_FALSE(lock.try_lock_shared());
+    lock.unlock();
+
+    // Writers keep the two halves equal; a reader that sees them differ overlapped a writer.
+    std::uint64_t left = 0;
+    std::uint64_t right = 0;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                std::shared_lock hold(lock);
+                if (left != right)
+                    torn.fetch_add(1);
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&] {
+            for (int i = 0; i < increments_per_thread; ++i) {
+                std::lock_guard hold(lock);
+                ++left;
+                ++right;
+            }
+        });
+    }
+    for (auto& w : writers)
+        w.join();
+    done.store(true, std::memory_order_release);
+    for (auto& r : readers)
+        r.join();
+
+    CHECK(torn.load() == 0);
+    CHECK(left == 2u * increments_per_thread);
+    CHECK(right == left);
+}
+
+TEST_CASE("rw_lock lets a waiting writer in ahead of new readers") {
+    extl::rw_lock lock;
+    lock.lock_shared();
+    std::atomic<bool> writer_done{false};
+    std::thread writer([&] {
+        lock.lock();
+        writer_done.store(true, std::memory_order_release);
+        lock.unlock();
+    });
+    // Once the writer is queued behind our read lock, new readers are turned away.
+    while (lock.try_lock_shared()) {
+        lock.unlock_shared();
+        std::this_thread::yield();
+    }
+    CHECK_FALSE(writer_done.load(std::memory_order_acquire));
+    lock.unlock_shared();
+    writer.join();
+    CHECK(writer_done.load());
+    CHECK(lock.try_lock_shared());
+    lock.unlock_shared();
+}
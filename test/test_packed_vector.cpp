@@ -0,0 +1,104 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "extl/packed_vector.hpp"
+
+TEST_CASE("packed_vector stores values in a fixed bit width") {
+    auto created = extl::packed_vector<5>::create(3);
+    REQUIRE(created);
+    auto v = std::move(*created);
+    CHECK(v.width() == 5);
+    CHECK(v.max_value() == 31);
+    CHECK(v.get(0) == 0);
+    CHECK(v.get(2) == 0);
+
+    for (std::uint32_t i = 0; i < 1000; ++i)
+        REQUIRE(v.try_push_back(i % 32));
+    CHECK(v.size() == 1003);
+    CHECK(v.size_in_bytes() == (1003 * 5 + 63) / 64 * 8);
+    for (std::uint32_t i = 0; i < 1000; ++i)
+        REQUIRE(v[3 + i] == i % 32);
+
+    v.set(500, 31);
+    v.set(501, 0);
+    CHECK(v[499] == 496 % 32);
+    CHECK(v[500] == 31);
+    CHECK(v[501] == 0);
+    CHECK(v[502] == 499 % 32);
+
+    // Shrinking then growing zero-fills the reused bits.
+    REQUIRE(v.try_resize(10));
+    REQUIRE(v.try_resize(20));
+    CHECK(v[9] == 6);
+    for (std::size_t i = 10; i < 20; ++i)
+        REQUIRE(v[i] == 0);
+
+    auto copied = extl::packed_vector<5>::copy(v);
+    REQUIRE(copied);
+    CHECK(copied->size() == 20);
+    CHECK((*copied)[9] == 6);
+
+    auto full = extl::packed_vector<32>::create(2);
+    REQUIRE(full);
+    full->set(0, 0xffffffffu);
+    full->set(1, 0x12345678u);
+    CHECK(full->get(0) == 0xffffffffu);
+    CHECK(full->get(1) == 0x12345678u);
+}
+
+TEST_CASE("packed_vector unpack matches get for every width and alignment") {
+    std::mt19937 rng(64);
+    for (unsigned width = 1; width <= 32; ++width) {
+        const std::size_t n = 300;
+        auto v = extl::dynamic_packed_vector::create(n, width);
+        REQUIRE(v);
+        std::vector<std::uint32_t> expected(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            expected[i] = static_cast<std::uint32_t>(rng()) & v->max_value();
+            v->set(i, expected[i]);
+        }
+        for (std::size_t first : {0u, 1u, 7u, 16u, 33u}) {
+            const std::size_t count = n - first - (first % 5);
+            std::vector<std::uint32_t> out(count);
+            v->unpack(first, count, out.data());
+            for (std::size_t k = 0; k < count; ++k)
+                REQUIRE(out[k] == expected[first + k]);
+        }
+    }
+    CHECK(extl::dynamic_packed_vector::create(4, 0).error() == extl::errc::invalid_argument);
+    CHECK(extl::dynamic_packed_vector::create(4, 33).error() == extl::errc::invalid_argument);
+}
+
+TEST_CASE("frame_of_reference_vector packs offsets from the minimum") {
+    std::mt19937 rng(3);
+    std::vector<std::uint32_t> values(1000);
+    for (auto& x : values)
+        x = 1700000000u + rng() % 3600;
+    auto encoded = extl::frame_of_reference_vector::create(values);
+    REQUIRE(encoded);
+    CHECK(encoded->size() == values.size());
+    CHECK(encoded->width() == 12);
+    CHECK(encoded->base() >= 1700000000u);
+    CHECK(encoded->size_in_bytes() <= values.size() * 12 / 8 + 8);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        REQUIRE(encoded->get(i) == values[i]);
+
+    std::vector<std::uint32_t> decoded(values.size() - 3);
+    encoded->decode(3, decoded.size(), decoded.data());
+    for (std::size_t i = 0; i < decoded.size(); ++i)
+        REQUIRE(decoded[i] == values[3 + i]);
+
+    const std::vector<std::uint32_t> constant(10, 42);
+    auto flat = extl::frame_of_reference_vector::create(constant);
+    REQUIRE(flat);
+    CHECK(flat->width() == 1);
+    CHECK(flat->get(9) == 42);
+
+    auto empty = extl::frame_of_reference_vector::create({});
+    REQUIRE(empty);
+    CHECK(empty->empty());
+}
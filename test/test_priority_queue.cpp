@@ -0,0 +1,199 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "extl/priority_queue.hpp"
+
+TEST_CASE("priority_queue pops in priority order") {
+    extl::priority_queue<int> queue;
+    std::priority_queue<int> reference;
+    std::mt19937 rng(1);
+    for (int i = 0; i < 5000; ++i) {
+        const int v = static_cast<int>(rng() % 1000);
+        REQUIRE(queue.try_push(v));
+        reference.push(v);
+        if (i % 3 == 0) {
+            REQUIRE(queue.top() == reference.top());
+            queue.pop();
+            reference.pop();
+        }
+    }
+    REQUIRE(queue.size() == reference.size());
+    while (!queue.empty()) {
+        REQUIRE(queue.take_top() == reference.top());
+        reference.pop();
+    }
+}
+
+TEST_CASE("priority_queue with a custom arity, comparator and move-only type") {
+    auto cmp = [](const std::unique_ptr<int>& a, const std::unique_ptr<int>& b) { return *a > *b; };
+    auto created = extl::priority_queue<std::unique_ptr<int>, 8, decltype(cmp)>::create(4, cmp);
+    REQUIRE(created);
+    auto queue = std::move(*created);
+    CHECK(queue.capacity() >= 4);
+    for (int v : {5, 3, 9, 1, 7, 2, 8})
+        REQUIRE(queue.try_emplace(std::make_unique<int>(v)));
+    std::vector<int> order;
+    while (!queue.empty())
+        order.push_back(*queue.take_top());
+    CHECK(order == std::vector<int>{1, 2, 3, 5, 7, 8, 9});
+}
+
+TEST_CASE("priority_queue copy and reserve failures") {
+    extl::priority_queue<int, 2> queue;
+    for (int v : {4, 8, 1})
+        REQUIRE(queue.try_push(v));
+    auto copy = extl::priority_queue<int, 2>::copy(queue);
+    REQUIRE(copy);
+    CHECK(copy->top() == 8);
+    CHECK(copy->size() == 3);
+
+    auto too_big = queue.try_reserve(std::numeric_limits<std::size_t>::max());
+    REQUIRE_FALSE(too_big);
+    CHECK(too_big.error() == extl::errc::length_error);
+    CHECK(queue.size() == 3);
+}
+
+TEST_CASE("priority_queues push their own top() while growing") {
+    auto created = extl::priority_queue<std::string>::create(8);
+    REQUIRE(created);
+    auto queue = std::move(*created);
+    while (queue.size() < queue.capacity())
+        REQUIRE(queue.try_push("a fairly long string to defeat SSO " + std::to_string(queue.size())));
+    REQUIRE(queue.try_push(queue.top()));
+    CHECK(queue.size() == 9);
+    const std::string top = queue.take_top();
+    CHECK(queue.top() == top);
+
+    auto indexed_created = extl::indexed_priority_queue<std::string>::create(8);
+    REQUIRE(indexed_created);
+    auto indexed = std::move(*indexed_created);
+    while (indexed.size() < indexed.capacity())
+        REQUIRE(indexed.try_push("a fairly long string to defeat SSO " + std::to_string(indexed.size())));
+    const auto handle = indexed.try_push(indexed.top());
+    REQUIRE(handle);
+    CHECK(indexed[*handle] == indexed.top());
+    indexed.pop();
+    CHECK(indexed.top() == indexed[*handle]);
+}
+
+TEST_CASE("indexed_priority_queue supports promote and erase") {
+    extl::indexed_priority_queue<int, 4, std::greater<int>> queue;
+    std::vector<extl::indexed_priority_queue<int, 4, std::greater<int>>::handle> handles;
+    for (int v : {50, 40, 30, 20, 10})
+        handles.push_back(*queue.try_push(v));
+    CHECK(queue.top() == 10);
+
+    queue.promote(handles[0], 5);
+    CHECK(queue.top() == 5);
+    CHECK(queue.top_handle() == handles[0]);
+
+    queue.update(handles[0], 45);
+    CHECK(queue.top() == 10);
+    CHECK(queue[handles[0]] == 45);
+
+    queue.erase(handles[4]);
+    CHECK_FALSE(queue.contains(handles[4]));
+    CHECK(queue.top() == 20);
+
+    std::vector<int> order;
+    while (!queue.empty()) {
+        order.push_back(queue.top());
+        queue.pop();
+    }
+    CHECK(order == std::vector<int>{20, 30, 40, 45});
+}
+
+TEST_CASE("indexed_priority_queue promote moves toward the top under std::less") {
+    extl::indexed_priority_queue<int> queue;
+    std::vector<extl::indexed_priority_queue<int>::handle> handles;
+    for (int v : {10, 20, 30, 40, 50})
+        handles.push_back(*queue.try_push(v));
+    CHECK(queue.top() == 50);
+
+    queue.promote(handles[0], 35);
+    CHECK(queue.top() == 50);
+    CHECK(queue[handles[0]] == 35);
+    queue.promote(handles[0], 60);
+    CHECK(queue.top_handle() == handles[0]);
+
+    std::vector<int> order;
+    while (!queue.empty()) {
+        order.push_back(queue.top());
+        queue.pop();
+    }
+    CHECK(order == std::vector<int>{60, 50, 40, 30, 20});
+}
+
+TEST_CASE("indexed_priority_queue runs Dijkstra on a grid") {
+    constexpr int side = 30;
+    constexpr int n = side * side;
+    std::mt19937 rng(3);
+    std::vector<int> weight(n);
+    for (auto& w : weight)
+        w = static_cast<int>(rng() % 9) + 1;
+
+    auto neighbours = [&](int v, auto&& f) {
+        const int x = v % side, y = v / side;
+        if (x > 0) f(v - 1);
+        if (x + 1 < side) f(v + 1);
+        if (y > 0) f(v - side);
+        if (y + 1 < side) f(v + side);
+    };
+
+    // Reference: lazy-deletion Dijkstra with std::priority_queue.
+    std::vector<int> expected(n, std::numeric_limits<int>::max());
+    {
+        using item = std::pair<int, int>;
+        std::priority_queue<item, std::vector<item>, std::greater<item>> pq;
+        expected[0] = 0;
+        pq.push({0, 0});
+        while (!pq.empty()) {
+            auto [d, v] = pq.top();
+            pq.pop();
+            if (d != expected[v])
+                continue;
+            neighbours(v, [&](int u) {
+                if (d + weight[u] < expected[u]) {
+                    expected[u] = d + weight[u];
+                    pq.push({expected[u], u});
+                }
+            });
+        }
+    }
+
+    using item = std::pair<int, int>;
+    extl::indexed_priority_queue<item, 4, std::greater<item>> queue;
+    using handle = decltype(queue)::handle;
+    std::vector<int> dist(n, std::numeric_limits<int>::max());
+    std::vector<handle> where(n, handle{std::numeric_limits<std::uint32_t>::max()});
+    std::vector<bool> queued(n, false), done(n, false);
+    dist[0] = 0;
+    where[0] = *queue.try_push(item{0, 0});
+    queued[0] = true;
+    while (!queue.empty()) {
+        auto [d, v] = queue.top();
+        queue.pop();
+        queued[v] = false;
+        done[v] = true;
+        neighbours(v, [&](int u) {
+            if (done[u] || d + weight[u] >= dist[u])
+                return;
+            dist[u] = d + weight[u];
+            if (queued[u]) {
+                queue.promote(where[u], item{dist[u], u});
+            } else {
+                where[u] = *queue.try_push(item{dist[u], u});
+                queued[u] = true;
+            }
+        });
+    }
+    CHECK(dist == expected);
+}
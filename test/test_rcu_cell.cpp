@@ -0,0 +1,157 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "extl/rcu_cell.hpp"
+
+namespace {
+
+// A copy that fails on demand, standing in for ExTL containers that copy through T::copy().
+struct fragile {
+    static inline bool fail_copy = false;
+
+    int value = 0;
+
+    static extl::expected<fragile, extl::errc> copy(const fragile& other) noexcept {
+        if (fail_copy)
+            return extl::unexpected(extl::errc::out_of_memory);
+        return fragile{other.value};
+    }
+};
+
+// Counts the versions alive at once.
+struct counted {
+    static inline std::atomic<int> live{0};
+
+    int value = 0;
+
+    explicit counted(int v) noexcept : value(v) { live.fetch_add(1); }
+    counted(const counted& other) noexcept : value(other.value) { live.fetch_add(1); }
+    ~counted() { live.fetch_sub(1); }
+};
+
+} // namespace
+
+TEST_CASE("rcu_cell frees old versions once no snapshot can see them") {
+    {
+        auto created = extl::rcu_cell<counted>::create(0);
+        REQUIRE(created);
+        auto cell = std::move(*created);
+
+        for (int i = 0; i < 64; ++i)
+            REQUIRE(cell.update([](counted& c) { ++c.value; }));
+        CHECK(counted::live.load() <= 3);
+
+        // A snapshot on this thread keeps every version since it was taken.
+        {
+            auto held = cell.read();
+            for (int i = 0; i < 10; ++i)
+                REQUIRE(cell.update([](counted& c) { ++c.value; }));
+            CHECK(held->value == 64);
+            CHECK(counted::live.load() >= 11);
+        }
+        for (int i = 0; i < 3; ++i)
+            REQUIRE(cell.store(i));
+        CHECK(counted::live.load() <= 3);
+
+        // The same holds for a reader on another thread.
+        std::atomic<bool> pinned{false};
+        std::atomic<bool> release{false};
+        std::thread reader([&] {
+            auto held = cell.read();
+            pinned.store(true);
+            while (!release.load())
+                std::this_thread::yield();
+        });
+        while (!pinned.load())
+            std::this_thread::yield();
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(cell.update([](counted& c) { ++c.value; }));
+        CHECK(counted::live.load() >= 11);
+        release.store(true);
+        reader.join();
+        for (int i = 0; i < 3; ++i)
+            REQUIRE(cell.update([](counted& c) { ++c.value; }));
+        CHECK(counted::live.load() <= 3);
+        CHECK(cell.read()->value == 15);
+    }
+    extl::epoch::synchronize();
+    CHECK(counted::live.load() == 0);
+}
+
+TEST_CASE("rcu_cell publishes new versions while snapshots keep the old one") {
+    auto created = extl::rcu_cell<std::vector<int>>::create(3, 7);
+    REQUIRE(created);
+    auto cell = std::move(*created);
+
+    auto before = cell.read();
+    CHECK(before->size() == 3);
+    REQUIRE(cell.update([](std::vector<int>& v) { v.push_back(8); }));
+    CHECK(before->size() == 3);
+    CHECK(cell.read()->size() == 4);
+    CHECK((*cell.read())[3] == 8);
+
+    REQUIRE(cell.store(std::vector<int>{1, 2}));
+    CHECK(cell.read()->size() == 2);
+
+    // An update that reports an error publishes nothing.
+    auto rejected = cell.update([](std::vector<int>& v) -> extl::expected<void, extl::errc> {
+        v.clear();
+        return extl::unexpected(extl::errc::invalid_argument);
+    });
+    CHECK(rejected.error() == extl::errc::invalid_argument);
+    CHECK(cell.read()->size() == 2);
+
+    auto fragile_cell = extl::rcu_cell<fragile>::create(fragile{5});
+    REQUIRE(fragile_cell);
+    fragile::fail_copy = true;
+    CHECK(fragile_cell->update([](fragile& f) { ++f.value; }).error() == extl::errc::out_of_memory);
+    fragile::fail_copy = false;
+    REQUIRE(fragile_cell->update([](fragile& f) { ++f.value; }));
+    CHECK(fragile_cell->read()->value == 6);
+}
+
+TEST_CASE("rcu_cell readers always see a consistent version under concurrent updates") {
+    auto created = extl::rcu_cell<std::vector<int>>::create(64, 0);
+    REQUIRE(created);
+    auto& cell = *created;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    constexpr int writers = 2;
+    constexpr int updates_per_writer = 2000;
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                auto snap = cell.read();
+                for (int x : *snap) {
+                    if (x != snap->front())
+                        torn.fetch_add(1);
+                }
+            }
+        });
+    }
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < updates_per_writer; ++i) {
+                (void)cell.update([](std::vector<int>& v) {
+                    for (int& x : v)
+                        ++x;
+                });
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers)
+        t.join();
+
+    CHECK(torn.load() == 0);
+    CHECK(cell.read()->front() == writers * updates_per_writer);
+    extl::epoch::synchronize();
+}
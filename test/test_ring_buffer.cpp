@@ -0,0 +1,115 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "extl/ring_buffer.hpp"
+
+static_assert(std::random_access_iterator<extl::ring_buffer<int>::iterator>);
+
+TEST_CASE("ring_buffer grows to powers of two and keeps FIFO order") {
+    extl::ring_buffer<int> ring;
+    std::deque<int> reference;
+    std::mt19937 rng(4);
+    for (int step = 0; step < 20000; ++step) {
+        if (reference.empty() || rng() % 3 != 0) {
+            REQUIRE(ring.try_push_back(step));
+            reference.push_back(step);
+        } else {
+            REQUIRE(ring.front() == reference.front());
+            ring.pop_front();
+            reference.pop_front();
+        }
+        REQUIRE(std::has_single_bit(ring.capacity()));
+    }
+    CHECK(std::equal(ring.begin(), ring.end(), reference.begin(), reference.end()));
+}
+
+TEST_CASE("ring_buffer as_spans exposes both halves") {
+    auto created = extl::ring_buffer<int>::create(6);
+    REQUIRE(created);
+    auto ring = std::move(*created);
+    CHECK(ring.capacity() == 8);
+    for (int i = 0; i < 8; ++i)
+        REQUIRE(ring.try_push_back(i));
+    ring.pop_front(5);
+    for (int i = 8; i < 12; ++i)
+        REQUIRE(ring.try_push_back(i));
+    CHECK(ring.capacity() == 8);
+
+    auto [first, second] = ring.as_spans();
+    CHECK(first.size() == 3);
+    CHECK(second.size() == 4);
+    std::vector<int> joined(first.begin(), first.end());
+    joined.insert(joined.end(), second.begin(), second.end());
+    CHECK(joined == std::vector<int>{5, 6, 7, 8, 9, 10, 11});
+
+    // Growing linearizes the contents.
+    REQUIRE(ring.try_reserve(9));
+    CHECK(ring.capacity() == 16);
+    auto [a, b] = ring.as_spans();
+    CHECK(a.size() == 7);
+    CHECK(b.empty());
+    CHECK(std::equal(a.begin(), a.end(), joined.begin(), joined.end()));
+}
+
+TEST_CASE("ring_buffer overwrite mode keeps the newest elements") {
+    auto ring = std::move(*extl::ring_buffer<int>::create(4));
+    for (int i = 0; i < 10; ++i)
+        ring.push_back_overwrite(i);
+    CHECK(ring.size() == 4);
+    CHECK(ring.capacity() == 4);
+    CHECK(std::vector<int>(ring.begin(), ring.end()) == std::vector<int>{6, 7, 8, 9});
+    const auto [a, b] = std::as_const(ring).as_spans();
+    CHECK(std::accumulate(a.begin(), a.end(), 0) + std::accumulate(b.begin(), b.end(), 0) == 30);
+}
+
+TEST_CASE("ring_buffer bulk append, pop_back and non-trivial types") {
+    extl::ring_buffer<char> bytes;
+    const std::string message = "hello, ring buffer";
+    REQUIRE(bytes.try_append(std::span<const char>(message.data(), message.size())));
+    bytes.pop_front(7);
+    CHECK(std::string(bytes.begin(), bytes.end()) == "ring buffer");
+    bytes.pop_back();
+    CHECK(bytes.back() == 'e');
+
+    extl::ring_buffer<std::unique_ptr<int>> owners;
+    for (int i = 0; i < 20; ++i)
+        REQUIRE(owners.try_emplace_back(std::make_unique<int>(i)));
+    owners.pop_front(15);
+    CHECK(*owners.front() == 15);
+    owners.push_back_overwrite(std::make_unique<int>(99));
+    CHECK(*owners.back() == 99);
+
+    extl::ring_buffer<std::string> strings;
+    REQUIRE(strings.try_push_back("a"));
+    REQUIRE(strings.try_push_back("b"));
+    auto copy = extl::ring_buffer<std::string>::copy(strings);
+    REQUIRE(copy);
+    CHECK((*copy)[1] == "b");
+}
+
+TEST_CASE("ring_buffer appends from its own storage while growing") {
+    extl::ring_buffer<std::string> ring;
+    for (int i = 0; i < 8; ++i)
+        REQUIRE(ring.try_push_back("element " + std::to_string(i)));
+    REQUIRE(ring.full());
+
+    // The span points into the storage that growing replaces.
+    const auto [front, back] = std::as_const(ring).as_spans();
+    CHECK(back.empty());
+    REQUIRE(ring.try_append(front));
+    CHECK(ring.size() == 16);
+    for (std::size_t i = 0; i < 16; ++i)
+        REQUIRE(ring[i] == "element " + std::to_string(i % 8));
+
+    while (!ring.full())
+        REQUIRE(ring.try_push_back("filler"));
+    REQUIRE(ring.try_push_back(ring.front()));
+    CHECK(ring.back() == "element 0");
+}
@@ -0,0 +1,276 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "extl/roaring_bitmap.hpp"
+
+namespace {
+
+template <class Bitmap>
+std::vector<std::uint32_t> values_of(const Bitmap& bitmap) {
+    std::vector<std::uint32_t> out;
+    bitmap.for_each([&](std::uint32_t x) { out.push_back(x); });
+    return out;
+}
+
+// Mixes sparse values, a dense chunk and long ranges so all three container kinds appear.
+extl::roaring_bitmap mixed_bitmap(std::mt19937& rng, std::set<std::uint32_t>& reference) {
+    extl::roaring_bitmap bitmap;
+    for (int i = 0; i < 2000; ++i) {
+        const std::uint32_t x = rng() % (1u << 22);
+        REQUIRE(bitmap.try_add(x));
+        reference.insert(x);
+    }
+    for (int i = 0; i < 20000; ++i) {
+        const std::uint32_t x = (7u << 16) | (rng() & 0xffff);
+        REQUIRE(bitmap.try_add(x));
+        reference.insert(x);
+    }
+    const std::uint32_t first = (rng() % 64) << 16 | (rng() & 0xffff);
+    const std::uint32_t last = first + rng() % 300000;
+    REQUIRE(bitmap.try_add_range(first, last));
+    for (std::uint32_t x = first; x <= last; ++x)
+        reference.insert(x);
+    REQUIRE(bitmap.try_optimize());
+    return bitmap;
+}
+
+} // namespace
+
+TEST_CASE("roaring_bitmap add and remove match std::set") {
+    std::mt19937 rng(62);
+    extl::roaring_bitmap bitmap;
+    std::set<std::uint32_t> reference;
+    CHECK(bitmap.empty());
+
+    // Narrow value range so chunks pass through array, bitmap and back.
+    for (int i = 0; i < 60000; ++i) {
+        const std::uint32_t x = rng() % (3u << 16);
+        if (rng() % 3 == 0) {
+            auto removed = bitmap.try_remove(x);
+            REQUIRE(removed);
+            REQUIRE(*removed == (reference.erase(x) == 1));
+        } else {
+            auto added = bitmap.try_add(x);
+            REQUIRE(added);
+            REQUIRE(*added == reference.insert(x).second);
+        }
+    }
+    CHECK(bitmap.cardinality() == reference.size());
+    CHECK(values_of(bitmap) == std::vector<std::uint32_t>(reference.begin(), reference.end()));
+    for (std::uint32_t x = 0; x < (3u << 16); x += 7)
+        REQUIRE(bitmap.contains(x) == (reference.count(x) == 1));
+
+    for (std::uint32_t x : reference)
+        REQUIRE(bitmap.try_remove(x));
+    CHECK(bitmap.empty());
+    CHECK(bitmap.container_count() == 0);
+}
+
+TEST_CASE("roaring_bitmap ranges become run containers") {
+    extl::roaring_bitmap bitmap;
+    REQUIRE(bitmap.try_add_range(100, 200000));
+    CHECK(bitmap.cardinality() == 199901);
+    CHECK(bitmap.container_count() == 4);
+    CHECK_FALSE(bitmap.contains(99));
+    CHECK(bitmap.contains(100));
+    CHECK(bitmap.contains(65536));
+    CHECK(bitmap.contains(200000));
+    CHECK_FALSE(bitmap.contains(200001));
+    for (std::size_t i = 0; i < bitmap.container_count(); ++i)
+        CHECK(bitmap.container_at(i).type == extl::detail::roaring::container_type::run);
+
+    // Editing runs: split, shrink at both ends, extend and merge.
+    REQUIRE(bitmap.try_remove(1000));
+    REQUIRE(bitmap.try_remove(100));
+    REQUIRE(bitmap.try_remove(200000));
+    CHECK(bitmap.cardinality() == 199898);
+    CHECK_FALSE(bitmap.contains(1000));
+    CHECK(bitmap.contains(999));
+    CHECK(bitmap.contains(1001));
+    REQUIRE(bitmap.try_add(1000));
+    REQUIRE(bitmap.try_add(100));
+    CHECK(bitmap.cardinality() == 199900);
+    CHECK(bitmap.container_at(0).size == 1);
+
+    // A range overlapping existing values is merged into the chunk.
+    REQUIRE(bitmap.try_add(300000));
+    REQUIRE(bitmap.try_add_range(299990, 300010));
+    CHECK(bitmap.cardinality() == 199921);
+
+    // Scattered values stay an array after optimize; a dense alternating chunk a bitmap.
+    extl::roaring_bitmap scattered;
+    for (std::uint32_t x = 0; x < 65536; x += 2)
+        REQUIRE(scattered.try_add(x));
+    for (std::uint32_t x = 65536; x < 65536 + 3000; x += 3)
+        REQUIRE(scattered.try_add(x));
+    REQUIRE(scattered.try_optimize());
+    CHECK(scattered.container_at(0).type == extl::detail::roaring::container_type::bitmap);
+    CHECK(scattered.container_at(1).type == extl::detail::roaring::container_type::array);
+}
+
+TEST_CASE("roaring_bitmap set operations match a reference") {
+    std::mt19937 rng(5);
+    for (int round = 0; round < 4; ++round) {
+        std::set<std::uint32_t> ra;
+        std::set<std::uint32_t> rb;
+        const auto a = mixed_bitmap(rng, ra);
+        const auto b = mixed_bitmap(rng, rb);
+
+        std::vector<std::uint32_t> both;
+        std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(), std::back_inserter(both));
+        std::vector<std::uint32_t> either;
+        std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(), std::back_inserter(either));
+
+        auto intersection = extl::roaring_bitmap::intersect(a, b);
+        REQUIRE(intersection);
+        CHECK(values_of(*intersection) == both);
+        CHECK(extl::roaring_bitmap::intersect_cardinality(a, b) == both.size());
+
+        auto united = extl::roaring_bitmap::unite(a, b);
+        REQUIRE(united);
+        CHECK(values_of(*united) == either);
+        CHECK(united->cardinality() == either.size());
+    }
+}
+
+TEST_CASE("roaring_bitmap serializes to the portable format and views it in place") {
+    std::mt19937 rng(11);
+    std::set<std::uint32_t> reference;
+    auto bitmap = mixed_bitmap(rng, reference);
+
+    std::vector<std::byte> bytes(bitmap.serialized_size());
+    CHECK(bitmap.serialize(bytes) == bytes.size());
+
+    auto frozen = extl::frozen_roaring_bitmap::view(bytes);
+    REQUIRE(frozen);
+    CHECK(frozen->serialized_size() == bytes.size());
+    CHECK(frozen->cardinality() == reference.size());
+    CHECK(values_of(*frozen) == std::vector<std::uint32_t>(reference.begin(), reference.end()));
+    for (std::uint32_t x = 0; x < (1u << 22); x += 97)
+        REQUIRE(frozen->contains(x) == (reference.count(x) == 1));
+
+    // Frozen and owned bitmaps combine directly.
+    CHECK(extl::roaring_bitmap::intersect_cardinality(*frozen, bitmap) == reference.size());
+    auto united = extl::roaring_bitmap::unite(bitmap, *frozen);
+    REQUIRE(united);
+    CHECK(united->cardinality() == reference.size());
+
+    auto restored = extl::roaring_bitmap::deserialize(bytes);
+    REQUIRE(restored);
+    CHECK(values_of(*restored) == values_of(bitmap));
+    REQUIRE(restored->try_add(1u << 31));
+    CHECK(restored->contains(1u << 31));
+
+    // Without run containers the no-run layout is used; unaligned buffers are fine.
+    extl::roaring_bitmap small;
+    REQUIRE(small.try_add(3));
+    REQUIRE(small.try_add(70000));
+    std::vector<std::byte> small_bytes(small.serialized_size() + 1);
+    const std::size_t written = small.serialize(std::span(small_bytes).subspan(1));
+    CHECK(written == 8 + 8 + 8 + 4);
+    CHECK(small_bytes[1] == std::byte{0x3a});
+    CHECK(small_bytes[2] == std::byte{0x30});
+    auto small_view = extl::frozen_roaring_bitmap::view(std::span(small_bytes).subspan(1));
+    REQUIRE(small_view);
+    CHECK(values_of(*small_view) == std::vector<std::uint32_t>{3, 70000});
+
+    extl::roaring_bitmap empty;
+    std::vector<std::byte> empty_bytes(empty.serialized_size());
+    empty.serialize(empty_bytes);
+    auto empty_view = extl::frozen_roaring_bitmap::view(empty_bytes);
+    REQUIRE(empty_view);
+    CHECK(empty_view->empty());
+}
+
+TEST_CASE("frozen_roaring_bitmap rejects malformed input") {
+    extl::roaring_bitmap bitmap;
+    REQUIRE(bitmap.try_add_range(10, 5000));
+    REQUIRE(bitmap.try_add(1u << 20));
+    std::vector<std::byte> bytes(bitmap.serialized_size());
+    bitmap.serialize(bytes);
+    REQUIRE(extl::frozen_roaring_bitmap::view(bytes));
+
+    for (std::size_t n = 0; n < bytes.size(); ++n) {
+        auto truncated = extl::frozen_roaring_bitmap::view(std::span(bytes).first(n));
+        REQUIRE_FALSE(truncated);
+        CHECK(truncated.error() == extl::errc::corrupt_data);
+    }
+
+    auto bad_cookie = bytes;
+    bad_cookie[0] = std::byte{0};
+    CHECK_FALSE(extl::frozen_roaring_bitmap::view(bad_cookie));
+
+    auto bad_order = bytes;
+    std::swap(bad_order[5], bad_order[9]); // Container keys out of order.
+    CHECK_FALSE(extl::frozen_roaring_bitmap::view(bad_order));
+}
+
+namespace {
+
+// Little-endian bytes of the given 16-bit words.
+std::vector<std::byte> le16(std::initializer_list<std::uint16_t> words) {
+    std::vector<std::byte> out;
+    for (std::uint16_t w : words) {
+        out.push_back(static_cast<std::byte>(w & 0xff));
+        out.push_back(static_cast<std::byte>(w >> 8));
+    }
+    return out;
+}
+
+// One run container with key 0 and no offsets: cookie, one flag byte, header, then the runs.
+std::vector<std::byte> single_run_container(std::uint16_t cardinality_minus_one,
+                                            std::initializer_list<std::uint16_t> runs) {
+    auto out = le16({12347, 0});
+    out.push_back(std::byte{1});
+    auto rest = le16({0, cardinality_minus_one, static_cast<std::uint16_t>(runs.size() / 2)});
+    auto body = le16(runs);
+    out.insert(out.end(), rest.begin(), rest.end());
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+// One array container with key 0 in the no-run format, which always carries offsets.
+std::vector<std::byte> single_array_container(std::initializer_list<std::uint16_t> values) {
+    auto out = le16({12346, 0, 1, 0, 0, static_cast<std::uint16_t>(values.size() - 1), 16, 0});
+    auto body = le16(values);
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("roaring_bitmap::deserialize rejects malformed container contents") {
+    auto reject = [](const std::vector<std::byte>& bytes) {
+        auto restored = extl::roaring_bitmap::deserialize(bytes);
+        return !restored && restored.error() == extl::errc::corrupt_data;
+    };
+
+    auto valid_run = single_run_container(4, {10, 4});
+    CHECK(valid_run.size() == 15);
+    auto restored = extl::roaring_bitmap::deserialize(valid_run);
+    REQUIRE(restored);
+    CHECK(values_of(*restored) == std::vector<std::uint32_t>{10, 11, 12, 13, 14});
+    auto valid_array = extl::roaring_bitmap::deserialize(single_array_container({3, 7, 9}));
+    REQUIRE(valid_array);
+    CHECK(values_of(*valid_array) == std::vector<std::uint32_t>{3, 7, 9});
+
+    CHECK(reject(single_run_container(65535, {65520, 65535})));  // Run past the end of the chunk.
+    CHECK(reject(single_run_container(9, {10, 5, 12, 3})));      // Overlapping runs.
+    CHECK(reject(single_run_container(1, {100, 0, 10, 0})));     // Unsorted runs.
+    CHECK(reject(single_run_container(3, {10, 4})));             // Cardinality too small.
+    CHECK(reject(single_run_container(5, {10, 4})));             // Cardinality too large.
+    CHECK(reject(single_array_container({5, 5})));               // Duplicate values.
+    CHECK(reject(single_array_container({7, 3})));               // Unsorted values.
+
+    // A bitmap container whose header cardinality disagrees with its bits.
+    auto bitmap = le16({12346, 0, 1, 0, 0, 4999, 16, 0});
+    bitmap.resize(bitmap.size() + 8192);
+    CHECK(reject(bitmap));
+}
@@ -0,0 +1,129 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <forward_list>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "extl/select.hpp"
+
+namespace {
+
+template <class T>
+std::vector<T> random_values(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<T> values(n);
+    for (auto& v : values) {
+        if constexpr (std::is_floating_point_v<T>)
+            v = static_cast<T>(std::uniform_real_distribution<double>(0.0, 1.0)(rng));
+        else
+            v = static_cast<T>(rng() % 100000);
+    }
+    return values;
+}
+
+template <class T, class Compare>
+void check_top_k(std::size_t n, std::size_t k, Compare comp) {
+    auto values = random_values<T>(n, n * 31 + k);
+    std::vector<T> out(k);
+    auto end = extl::top_k(values, k, out.begin(), comp);
+
+    auto expected = values;
+    std::sort(expected.begin(), expected.end(), comp);
+    expected.resize(std::min(n, k));
+    out.erase(end, out.end());
+    REQUIRE(out == expected);
+}
+
+} // namespace
+
+TEST_CASE("top_k on arithmetic types matches a full sort") {
+    for (std::size_t n : {0u, 5u, 100u, 1000u, 100003u}) {
+        for (std::size_t k : {1u, 10u, 100u}) {
+            check_top_k<std::int32_t>(n, k, std::ranges::greater{});
+            check_top_k<std::int64_t>(n, k, std::ranges::less{});
+            check_top_k<float>(n, k, std::greater<>{});
+            check_top_k<double>(n, k, std::less<double>{});
+        }
+    }
+}
+
+TEST_CASE("top_k into a different output type compares in the output type") {
+    // double(INT64_MAX) is 2^63, which does not convert back to int64_t.
+    constexpr auto big = std::numeric_limits<std::int64_t>::max();
+    std::vector<std::int64_t> values(4, big);
+    for (std::int64_t i = 0; i < 100; ++i)
+        values.push_back(i + 1);
+    std::vector<double> out(4);
+    auto end = extl::top_k(values, 4, out.begin(), std::less<>{});
+    CHECK(end == out.end());
+    CHECK(out == std::vector<double>{1.0, 2.0, 3.0, 4.0});
+}
+
+TEST_CASE("top_k with zero k writes nothing") {
+    std::vector<int> values{3, 1, 2};
+    std::vector<int> out(1, -1);
+    CHECK(extl::top_k(values, 0, out.begin()) == out.begin());
+    CHECK(out[0] == -1);
+}
+
+TEST_CASE("top_k with a custom comparator over a forward range") {
+    std::forward_list<std::string> words{"delta", "alpha", "echo", "charlie", "bravo", "foxtrot"};
+    std::vector<std::string> out(3);
+    auto by_length = [](const std::string& a, const std::string& b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    };
+    auto end = extl::top_k(words, 3, out.begin(), by_length);
+    CHECK(end == out.end());
+    CHECK(out == std::vector<std::string>{"echo", "alpha", "bravo"});
+}
+
+TEST_CASE("nth_element places the k-th element") {
+    for (std::size_t n : {1u, 2u, 10u, 601u, 5000u, 100000u}) {
+        auto values = random_values<std::int32_t>(n, n);
+        auto sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        for (std::size_t k : {std::size_t(0), n / 3, n / 2, n - 1}) {
+            auto work = values;
+            extl::nth_element(work, work.begin() + static_cast<std::ptrdiff_t>(k));
+            REQUIRE(work[k] == sorted[k]);
+            CHECK(std::all_of(work.begin(), work.begin() + static_cast<std::ptrdiff_t>(k),
+                              [&](int v) { return v <= work[k]; }));
+            CHECK(std::all_of(work.begin() + static_cast<std::ptrdiff_t>(k), work.end(),
+                              [&](int v) { return v >= work[k]; }));
+        }
+    }
+}
+
+TEST_CASE("nth_element handles duplicates and a custom order") {
+    std::vector<int> values(10000);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = static_cast<int>(i % 7);
+    auto sorted = values;
+    std::sort(sorted.begin(), sorted.end(), std::greater<>());
+    extl::nth_element(values.begin(), values.begin() + 4321, values.end(), std::greater<>());
+    CHECK(values[4321] == sorted[4321]);
+}
+
+TEST_CASE("heap_select places the k-th element from either side") {
+    for (std::size_t n : {1u, 2u, 17u, 1000u}) {
+        auto values = random_values<std::int32_t>(n, n + 7);
+        auto sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        for (std::size_t k : {std::size_t(0), n / 4, n / 2, n - 1 - n / 4, n - 1}) {
+            auto work = values;
+            auto comp = std::ranges::less{};
+            const auto nth = static_cast<std::ptrdiff_t>(k);
+            extl::detail::heap_select(work.begin(), 0, static_cast<std::ptrdiff_t>(n) - 1, nth, comp);
+            REQUIRE(work[k] == sorted[k]);
+            CHECK(std::all_of(work.begin(), work.begin() + nth, [&](int v) { return v <= work[k]; }));
+            CHECK(std::all_of(work.begin() + nth, work.end(), [&](int v) { return v >= work[k]; }));
+            std::sort(work.begin(), work.end());
+            CHECK(work == sorted);
+        }
+    }
+}
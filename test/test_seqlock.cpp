@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "extl/seqlock.hpp"
+
+namespace {
+
+// Every field derives from `sequence`, so a copy mixing two writes is detectable.
+struct quote {
+    std::uint64_t sequence = 0;
+    double bid = 0;
+    double ask = 1;
+    std::uint32_t size = 0;
+    bool open = false;
+
+    static quote make(std::uint64_t s) noexcept {
+        return {s, static_cast<double>(s), static_cast<double>(s) + 1, static_cast<std::uint32_t>(s * 3), s % 2 == 1};
+    }
+    bool consistent() const noexcept {
+        return bid == static_cast<double>(sequence) && ask == bid + 1 &&
+               size == static_cast<std::uint32_t>(sequence * 3) && open == (sequence % 2 == 1);
+    }
+};
+
+constexpr std::uint64_t stores = 50000;
+
+// One writer stores quotes 1..stores while readers check that every copy is whole and that the
+// sequence they observe never goes backwards.
+template <class Lock>
+int torn_reads(Lock& lock) {
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            std::uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const quote q = lock.load();
+                if (!q.consistent() || q.sequence < last)
+                    bad.fetch_add(1);
+                last = q.sequence;
+            }
+        });
+    }
+    std::thread writer([&] {
+        for (std::uint64_t s = 1; s <= stores; ++s)
+            lock.store(quote::make(s));
+    });
+    writer.join();
+    done.store(true, std::memory_order_release);
+    for (auto& r : readers)
+        r.join();
+    return bad.load();
+}
+
+} // namespace
+
+TEST_CASE("seqlock stores and loads whole values") {
+    extl::seqlock<quote> lock;
+    CHECK(lock.version() == 0);
+    CHECK(lock.load().ask == 1);
+
+    lock.store(quote::make(7));
+    CHECK(lock.version() == 1);
+    CHECK(lock.load().sequence == 7);
+    CHECK(lock.load().consistent());
+
+    lock.update([](quote& q) { q = quote::make(q.sequence + 1); });
+    CHECK(lock.version() == 2);
+    auto loaded = lock.try_load();
+    REQUIRE(loaded);
+    CHECK(loaded->sequence == 8);
+
+    extl::seqlock_ring<quote, 3> ring(quote::make(1));
+    CHECK(ring.load().sequence == 1);
+    for (std::uint64_t s = 2; s <= 10; ++s)
+        ring.store(quote::make(s));
+    CHECK(ring.version() == 9);
+    CHECK(ring.load().sequence == 10);
+    ring.update([](quote& q) { q = quote::make(q.sequence * 2); });
+    CHECK(ring.load().sequence == 20);
+}
+
+TEST_CASE("seqlock readers never see a torn value") {
+    extl::seqlock<quote> lock;
+    CHECK(torn_reads(lock) == 0);
+    CHECK(lock.load().sequence == stores);
+
+    extl::seqlock<quote> bounded;
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            // A bounded read either gives up or returns a whole value.
+            auto q = bounded.try_load(2);
+            if (q.has_value() ? !q->consistent() : q.error() != extl::errc::busy)
+                bad.fetch_add(1);
+        }
+    });
+    for (std::uint64_t s = 1; s <= stores; ++s)
+        bounded.store(quote::make(s));
+    done.store(true, std::memory_order_release);
+    reader.join();
+    CHECK(bad.load() == 0);
+}
+
+TEST_CASE("seqlock_ring readers never see a torn value") {
+    extl::seqlock_ring<quote> ring;
+    CHECK(torn_reads(ring) == 0);
+    CHECK(ring.load().sequence == stores);
+    CHECK(ring.version() == stores);
+}
@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "extl/sharded_counter.hpp"
+
+TEST_CASE("sharded_counter sums adds from many threads") {
+    auto created = extl::sharded_counter::create();
+    REQUIRE(created);
+    auto& counter = *created;
+    CHECK(counter.value() == 0);
+    CHECK(counter.shard_count() >= 1);
+
+    constexpr int threads = 4;
+    constexpr int adds_per_thread = 50000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < adds_per_thread; ++i)
+                counter.add();
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    CHECK(counter.value() == std::uint64_t{threads} * adds_per_thread);
+
+    counter.sub(5);
+    CHECK(counter.value() == std::uint64_t{threads} * adds_per_thread - 5);
+    CHECK(counter.reset() == std::uint64_t{threads} * adds_per_thread - 5);
+    CHECK(counter.value() == 0);
+
+    auto rounded = extl::sharded_counter::create(3);
+    REQUIRE(rounded);
+    CHECK(rounded->shard_count() == 4);
+    CHECK(extl::sharded_counter::create(extl::detail::shard::max_shards + 1).error() == extl::errc::length_error);
+}
+
+TEST_CASE("stats aggregates count, sum, extremes and a log2 histogram") {
+    auto created = extl::stats::create(2);
+    REQUIRE(created);
+    auto& s = *created;
+    auto empty = s.summary();
+    CHECK(empty.count == 0);
+    CHECK(empty.min == 0);
+    CHECK(empty.max == 0);
+    CHECK(empty.mean() == 0.0);
+
+    for (std::uint64_t v : {0u, 1u, 3u, 4u, 1000u})
+        s.record(v);
+    auto single = s.summary();
+    CHECK(single.count == 5);
+    CHECK(single.sum == 1008);
+    CHECK(single.min == 0);
+    CHECK(single.max == 1000);
+    CHECK(single.histogram[0] == 1);
+    CHECK(single.histogram[1] == 1);
+    CHECK(single.histogram[2] == 1);
+    CHECK(single.histogram[3] == 1);
+    CHECK(single.histogram[10] == 1);
+    CHECK(extl::stats_summary::bucket_lower_bound(10) == 512);
+
+    s.reset();
+    CHECK(s.summary().count == 0);
+
+    constexpr int threads = 4;
+    constexpr std::uint64_t per_thread = 20000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (std::uint64_t i = 1; i <= per_thread; ++i)
+                s.record(i * static_cast<std::uint64_t>(t + 1));
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    auto merged = s.summary();
+    CHECK(merged.count == threads * per_thread);
+    CHECK(merged.sum == (per_thread * (per_thread + 1) / 2) * 10);
+    CHECK(merged.min == 1);
+    CHECK(merged.max == per_thread * threads);
+    std::uint64_t bucketed = 0;
+    for (auto b : merged.histogram)
+        bucketed += b;
+    CHECK(bucketed == merged.count);
+}
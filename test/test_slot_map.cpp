@@ -0,0 +1,116 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "extl/slot_map.hpp"
+
+TEST_CASE("slot_map insert, lookup and erase") {
+    extl::slot_map<std::string> map;
+    auto a = map.try_insert("alpha");
+    auto b = map.try_emplace(3, 'b');
+    REQUIRE(a);
+    REQUIRE(b);
+    CHECK(map.size() == 2);
+    CHECK(map[*a] == "alpha");
+    CHECK(*map.find(*b) == "bbb");
+
+    REQUIRE(map.erase(*a));
+    CHECK_FALSE(map.contains(*a));
+    CHECK(map.find(*a) == nullptr);
+    auto again = map.erase(*a);
+    REQUIRE_FALSE(again);
+    CHECK(again.error() == extl::errc::stale_handle);
+
+    // The freed slot is reused with a new generation; the old key stays stale.
+    auto c = map.try_insert("gamma");
+    REQUIRE(c);
+    CHECK(c->index == a->index);
+    CHECK_FALSE(map.contains(*a));
+    CHECK(map[*c] == "gamma");
+    CHECK(map[*b] == "bbb");
+}
+
+TEST_CASE("slot_map inserts a copy of its own value while growing") {
+    auto created = extl::slot_map<std::string>::create(4);
+    REQUIRE(created);
+    auto map = std::move(*created);
+    std::vector<extl::slot_map<std::string>::key> keys;
+    while (map.size() < map.capacity())
+        keys.push_back(*map.try_insert("a value long enough to live on the heap " + std::to_string(map.size())));
+
+    auto copy = map.try_insert(map[keys[1]]);
+    REQUIRE(copy);
+    CHECK(map.capacity() > 4);
+    CHECK(map[*copy] == "a value long enough to live on the heap 1");
+    CHECK(map[keys[1]] == map[*copy]);
+}
+
+TEST_CASE("slot_map default key is never valid") {
+    extl::slot_map<int> map;
+    REQUIRE(map.try_insert(1));
+    CHECK_FALSE(map.contains(extl::slot_map<int>::key{}));
+}
+
+TEST_CASE("slot_map stays dense and consistent under churn") {
+    extl::slot_map<int> map;
+    std::unordered_map<int, extl::slot_map<int>::key> live;
+    std::vector<extl::slot_map<int>::key> dead;
+    std::mt19937 rng(11);
+    int next = 0;
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || rng() % 3 != 0) {
+            auto k = map.try_insert(next);
+            REQUIRE(k);
+            live.emplace(next++, *k);
+        } else {
+            auto it = std::next(live.begin(), static_cast<std::ptrdiff_t>(rng() % live.size()));
+            auto taken = map.take(it->second);
+            REQUIRE(taken);
+            CHECK(*taken == it->first);
+            dead.push_back(it->second);
+            live.erase(it);
+        }
+    }
+    CHECK(map.size() == live.size());
+    for (auto& [value, k] : live)
+        REQUIRE(map[k] == value);
+    for (auto k : dead)
+        REQUIRE_FALSE(map.contains(k));
+
+    // Dense iteration visits each live value once and key_at maps back to it.
+    std::size_t visited = 0;
+    for (std::size_t i = 0; i < map.size(); ++i) {
+        REQUIRE(map[map.key_at(i)] == map.data()[i]);
+        ++visited;
+    }
+    CHECK(visited == live.size());
+    CHECK(static_cast<std::size_t>(map.end() - map.begin()) == live.size());
+}
+
+TEST_CASE("slot_map copy preserves keys and clear invalidates them") {
+    extl::slot_map<std::unique_ptr<int>> owners;
+    auto k = owners.try_insert(std::make_unique<int>(5));
+    REQUIRE(k);
+    CHECK(**owners.find(*k) == 5);
+
+    extl::slot_map<int> map;
+    auto k1 = *map.try_insert(1);
+    auto k2 = *map.try_insert(2);
+    REQUIRE(map.erase(k1));
+    auto copy = extl::slot_map<int>::copy(map);
+    REQUIRE(copy);
+    CHECK((*copy)[k2] == 2);
+    CHECK_FALSE(copy->contains(k1));
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK_FALSE(map.contains(k2));
+    auto k3 = map.try_insert(3);
+    REQUIRE(k3);
+    CHECK_FALSE(map.contains(k2));
+}
@@ -0,0 +1,131 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <tuple>
+
+#include "extl/soa_vector.hpp"
+
+namespace {
+
+using particles = extl::soa_vector<float, float, std::uint32_t, std::string>;
+enum { x, v, id, name };
+
+bool is_aligned(const void* p) {
+    return reinterpret_cast<std::uintptr_t>(p) % extl::cache_line_size == 0;
+}
+
+} // namespace
+
+TEST_CASE("soa_vector stores each field in its own aligned column") {
+    particles ps;
+    for (std::uint32_t i = 0; i < 1000; ++i)
+        REQUIRE(ps.try_emplace_back(float(i), 1.0f, i, std::to_string(i)));
+    CHECK(ps.size() == 1000);
+    CHECK(ps.capacity() >= 1000);
+    CHECK(is_aligned(ps.data<x>()));
+    CHECK(is_aligned(ps.data<v>()));
+    CHECK(is_aligned(ps.data<id>()));
+    CHECK(is_aligned(ps.data<name>()));
+
+    // A pass over two columns, as a SIMD loop would do it.
+    auto xs = ps.column<x>();
+    auto vs = ps.column<v>();
+    for (std::size_t i = 0; i < xs.size(); ++i)
+        xs[i] += 0.5f * vs[i];
+    CHECK(ps.get<x>(10) == 10.5f);
+    CHECK(ps.get<name>(999) == "999");
+
+    auto [px, pv, pid, pname] = ps[42];
+    CHECK(px == 42.5f);
+    CHECK(pid == 42u);
+    pv = 3.0f;
+    CHECK(ps.get<v>(42) == 3.0f);
+
+    ps[7] = std::tuple<float, float, std::uint32_t, std::string>(0.0f, 0.0f, 70u, "seven");
+    particles::value_type copy = ps[7];
+    CHECK(std::get<id>(copy) == 70u);
+    CHECK(std::get<name>(copy) == "seven");
+}
+
+TEST_CASE("soa_vector iterates with proxy references") {
+    extl::soa_vector<int, double> v;
+    for (int i = 0; i < 5; ++i)
+        REQUIRE(v.try_push_back({i, i * 0.5}));
+    int sum = 0;
+    for (auto [a, b] : v) {
+        sum += a;
+        b *= 2;
+    }
+    CHECK(sum == 10);
+    CHECK(v.get<1>(4) == 4.0);
+    CHECK(v.end() - v.begin() == 5);
+    const auto& cv = v;
+    CHECK(std::get<0>(*(cv.begin() + 3)) == 3);
+    CHECK(std::get<0>(cv.back()) == 4);
+}
+
+TEST_CASE("soa_vector resize, erase_unordered and copy") {
+    auto created = extl::soa_vector<int, std::string>::create(4);
+    REQUIRE(created);
+    auto v = std::move(*created);
+    CHECK(v.size() == 4);
+    CHECK(v.get<0>(3) == 0);
+    CHECK(v.get<1>(3).empty());
+
+    std::iota(v.column<0>().begin(), v.column<0>().end(), 10);
+    v.get<1>(0) = "first";
+    v.get<1>(3) = "last";
+    v.erase_unordered(0);
+    CHECK(v.size() == 3);
+    CHECK(v.get<0>(0) == 13);
+    CHECK(v.get<1>(0) == "last");
+
+    REQUIRE(v.try_resize(100));
+    CHECK(v.size() == 100);
+    CHECK(v.get<0>(2) == 12);
+    CHECK(v.get<0>(99) == 0);
+    REQUIRE(v.try_resize(2));
+    CHECK(v.size() == 2);
+
+    auto copied = decltype(v)::copy(v);
+    REQUIRE(copied);
+    CHECK(copied->size() == 2);
+    CHECK(copied->get<1>(0) == "last");
+    v.clear();
+    CHECK(v.empty());
+    CHECK(copied->get<0>(1) == 11);
+
+    decltype(v) moved = std::move(*copied);
+    CHECK(moved.size() == 2);
+    moved.pop_back();
+    CHECK(moved.size() == 1);
+}
+
+TEST_CASE("soa_vector appends its own fields while growing") {
+    extl::soa_vector<int, std::string> v;
+    REQUIRE(v.try_push_back({7, "a string long enough to live on the heap"}));
+    while (v.size() < v.capacity())
+        REQUIRE(v.try_push_back({static_cast<int>(v.size()), "filler"}));
+
+    const auto capacity = v.capacity();
+    REQUIRE(v.try_emplace_back(v.get<0>(0), v.get<1>(0)));
+    CHECK(v.capacity() > capacity);
+    CHECK(v.get<0>(v.size() - 1) == 7);
+    CHECK(v.get<1>(v.size() - 1) == "a string long enough to live on the heap");
+
+    while (v.size() < v.capacity())
+        REQUIRE(v.try_push_back({0, "filler"}));
+    REQUIRE(v.try_push_back(v[0]));
+    CHECK(std::get<1>(v.back()) == "a string long enough to live on the heap");
+}
+
+TEST_CASE("soa_vector reports length errors") {
+    extl::soa_vector<int, char> v;
+    auto result = v.try_reserve(v.max_size() + 1);
+    REQUIRE_FALSE(result);
+    CHECK(result.error() == extl::errc::length_error);
+    CHECK(v.capacity() == 0);
+}
@@ -0,0 +1,128 @@
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "extl/small_sort.hpp"
+#include "extl/sort.hpp"
+
+namespace {
+
+template <class T>
+std::vector<T> random_values(std::size_t n, std::mt19937_64& rng) {
+    std::vector<T> values(n);
+    for (auto& v : values) {
+        if constexpr (std::is_floating_point_v<T>)
+            v = static_cast<T>(std::uniform_real_distribution<double>(-1e6, 1e6)(rng));
+        else
+            v = static_cast<T>(rng() % 1000) - 500;
+    }
+    return values;
+}
+
+template <class T>
+void check_small_sort_all_sizes() {
+    std::mt19937_64 rng(42);
+    for (std::size_t n = 0; n <= extl::small_sort_max<T>; ++n) {
+        for (int round = 0; round < 8; ++round) {
+            auto values = random_values<T>(n, rng);
+            // Guard element to catch writes past the end.
+            values.push_back(T(123));
+            auto expected = values;
+            std::sort(expected.begin(), expected.end() - 1);
+            extl::small_sort(values.data(), n);
+            REQUIRE(values == expected);
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("small_sort sorts every size up to the limit") {
+    check_small_sort_all_sizes<std::int32_t>();
+    check_small_sort_all_sizes<std::int64_t>();
+    check_small_sort_all_sizes<float>();
+    check_small_sort_all_sizes<double>();
+}
+
+TEST_CASE("small_sort handles extreme values") {
+    std::vector<std::int32_t> ints{INT32_MAX, INT32_MIN, 0, INT32_MAX, -1, INT32_MIN};
+    extl::small_sort(std::span(ints));
+    CHECK(std::is_sorted(ints.begin(), ints.end()));
+
+    std::vector<double> doubles{1.0, -std::numeric_limits<double>::infinity(), 0.0,
+                                std::numeric_limits<double>::infinity(), -0.5};
+    extl::small_sort(std::span(doubles));
+    CHECK(std::is_sorted(doubles.begin(), doubles.end()));
+}
+
+TEST_CASE("small_sort keeps every value when NaNs are present") {
+    std::mt19937_64 rng(7);
+    for (std::size_t n = 1; n <= extl::small_sort_max<double>; ++n) {
+        auto values = random_values<double>(n, rng);
+        for (std::size_t i = 0; i < n; i += 1 + rng() % 5)
+            values[i] = std::numeric_limits<double>::quiet_NaN();
+        const auto nans = static_cast<std::size_t>(std::count_if(values.begin(), values.end(), [](double v) {
+            return v != v;
+        }));
+        std::vector<double> numbers;
+        for (double v : values)
+            if (v == v)
+                numbers.push_back(v);
+        std::sort(numbers.begin(), numbers.end());
+
+        extl::small_sort(std::span(values));
+        REQUIRE(std::equal(numbers.begin(), numbers.end(), values.begin()));
+        REQUIRE(std::all_of(values.begin() + static_cast<std::ptrdiff_t>(numbers.size()), values.end(),
+                            [](double v) { return v != v; }));
+        REQUIRE(static_cast<std::size_t>(std::count_if(values.begin(), values.end(), [](double v) {
+                    return v != v;
+                })) == nans);
+    }
+
+    std::vector<float> floats(extl::small_sort_max<float>, std::numeric_limits<float>::quiet_NaN());
+    floats[3] = 2.0f;
+    floats[70] = -1.0f;
+    extl::small_sort(std::span(floats));
+    CHECK(floats[0] == -1.0f);
+    CHECK(floats[1] == 2.0f);
+    CHECK(std::count_if(floats.begin(), floats.end(), [](float v) { return v != v; }) == 126);
+}
+
+TEST_CASE("sort uses small_sort for arithmetic ranges") {
+    std::mt19937_64 rng(7);
+    for (std::size_t n : {0u, 1u, 17u, 129u, 1000u, 100000u}) {
+        auto values = random_values<std::int64_t>(n, rng);
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+        extl::sort(values);
+        CHECK(values == expected);
+    }
+}
+
+TEST_CASE("sort with a custom comparator and non-arithmetic types") {
+    std::vector<std::string> words{"pear", "apple", "fig", "kiwi", "banana", "cherry", "date"};
+    for (int i = 0; i < 5; ++i)
+        words.insert(words.end(), words.begin(), words.end());
+    auto expected = words;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    extl::sort(words.begin(), words.end(), std::greater<>());
+    CHECK(words == expected);
+}
+
+TEST_CASE("sort handles adversarial inputs") {
+    std::vector<int> sorted(5000), reversed(5000), equal(5000, 3), organ(5000);
+    for (int i = 0; i < 5000; ++i) {
+        sorted[i] = i;
+        reversed[i] = 5000 - i;
+        organ[i] = i < 2500 ? i : 5000 - i;
+    }
+    for (auto* v : {&sorted, &reversed, &equal, &organ}) {
+        extl::sort(*v);
+        CHECK(std::is_sorted(v->begin(), v->end()));
+    }
+}
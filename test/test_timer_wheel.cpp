@@ -0,0 +1,126 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "extl/timer_wheel.hpp"
+
+namespace {
+
+struct connection {
+    extl::timer timeout{&on_timeout};
+    std::uint64_t fired_at = 0;
+    int fire_count = 0;
+
+    static inline std::uint64_t* clock = nullptr;
+
+    static void on_timeout(extl::timer& t) noexcept {
+        auto* self = reinterpret_cast<connection*>(reinterpret_cast<char*>(&t) - offsetof(connection, timeout));
+        self->fired_at = *clock;
+        ++self->fire_count;
+    }
+};
+
+} // namespace
+
+TEST_CASE("timer_wheel fires timers at their deadlines") {
+    std::uint64_t now = 0;
+    connection::clock = &now;
+    extl::basic_timer_wheel<3, 4> wheel; // small levels so cascades and parking are exercised
+
+    std::mt19937_64 rng(5);
+    std::vector<std::unique_ptr<connection>> conns;
+    std::vector<std::uint64_t> deadlines;
+    for (int i = 0; i < 2000; ++i) {
+        conns.push_back(std::make_unique<connection>());
+        const std::uint64_t deadline = 1 + rng() % 20000; // well past the 2^12-tick span
+        deadlines.push_back(deadline);
+        wheel.schedule(conns.back()->timeout, deadline);
+    }
+    CHECK(wheel.size() == 2000);
+
+    std::size_t fired = 0;
+    while (now < 20000) {
+        now += 1 + rng() % 37;
+        fired += wheel.advance(now);
+        CHECK(wheel.now() == now);
+    }
+    CHECK(fired == 2000);
+    CHECK(wheel.empty());
+    for (std::size_t i = 0; i < conns.size(); ++i) {
+        REQUIRE(conns[i]->fire_count == 1);
+        // Fired during the advance() call that first crossed the deadline.
+        CHECK(conns[i]->fired_at >= deadlines[i]);
+        CHECK(conns[i]->fired_at < deadlines[i] + 37);
+    }
+}
+
+TEST_CASE("timer_wheel fires in deadline order when advanced tick by tick") {
+    std::uint64_t now = 100;
+    connection::clock = &now;
+    extl::timer_wheel wheel(now);
+    std::vector<connection> conns(300);
+    for (std::size_t i = 0; i < conns.size(); ++i)
+        wheel.schedule_after(conns[i].timeout, 1 + (i * 7919) % 70000);
+    while (!wheel.empty()) {
+        ++now;
+        wheel.advance(now);
+    }
+    for (std::size_t i = 0; i < conns.size(); ++i)
+        CHECK(conns[i].fired_at == 100 + 1 + (i * 7919) % 70000);
+}
+
+TEST_CASE("timer_wheel cancel and reschedule") {
+    std::uint64_t now = 0;
+    connection::clock = &now;
+    extl::timer_wheel wheel;
+    connection a, b, c;
+    wheel.schedule(a.timeout, 10);
+    wheel.schedule(b.timeout, 10);
+    wheel.schedule(c.timeout, 300);
+    CHECK(wheel.cancel(b.timeout));
+    CHECK_FALSE(wheel.cancel(b.timeout));
+    wheel.schedule(c.timeout, 5); // reschedule earlier
+
+    now = 5;
+    CHECK(wheel.advance(now) == 1);
+    CHECK(c.fire_count == 1);
+    now = 1000;
+    CHECK(wheel.advance(now) == 1);
+    CHECK(a.fire_count == 1);
+    CHECK(b.fire_count == 0);
+    CHECK(c.fire_count == 1);
+
+    // Past deadlines fire on the next advance.
+    wheel.schedule(b.timeout, 3);
+    CHECK(b.timeout.deadline() == 1001);
+    CHECK(wheel.advance(now + 1) == 1);
+}
+
+TEST_CASE("timer_wheel callbacks may reschedule and cancel") {
+    static extl::timer_wheel* wheel_ptr = nullptr;
+    static extl::timer* victim = nullptr;
+    static int periodic_fires = 0;
+
+    extl::timer_wheel wheel;
+    wheel_ptr = &wheel;
+    extl::timer periodic([](extl::timer& t) noexcept {
+        ++periodic_fires;
+        if (periodic_fires < 5)
+            wheel_ptr->schedule(t, wheel_ptr->now() + 256); // same level-0 slot
+    });
+    extl::timer canceller([](extl::timer&) noexcept { wheel_ptr->cancel(*victim); });
+    extl::timer cancelled([](extl::timer&) noexcept { CHECK(false); });
+    victim = &cancelled;
+
+    wheel.schedule(periodic, 1);
+    wheel.schedule(canceller, 7);
+    wheel.schedule(cancelled, 8);
+    wheel.advance(2000);
+    CHECK(periodic_fires == 5);
+    CHECK(wheel.empty());
+    CHECK_FALSE(cancelled.scheduled());
+}
@@ -0,0 +1,82 @@
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "extl/trace.hpp"
+
+namespace {
+
+std::string export_trace() {
+    std::string json;
+    auto exported = extl::trace::export_chrome_json([&](std::string_view piece) { json.append(piece); });
+    return exported ? json : std::string();
+}
+
+std::size_t occurrences(const std::string& text, std::string_view needle) {
+    std::size_t n = 0;
+    for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + needle.size()))
+        ++n;
+    return n;
+}
+
+void traced_work(int depth) {
+    EXTL_TRACE_SCOPE("traced_work");
+    if (depth > 0)
+        traced_work(depth - 1);
+}
+
+} // namespace
+
+TEST_CASE("trace records nested scopes from several threads as Chrome JSON") {
+    extl::trace::clear();
+    extl::trace::set_thread_name("main \"thread\"");
+    {
+        EXTL_TRACE_SCOPE("outer");
+        traced_work(2);
+        EXTL_TRACE_INSTANT("checkpoint");
+    }
+    std::thread worker([] {
+        extl::trace::set_thread_name("worker");
+        for (int i = 0; i < 10; ++i)
+            traced_work(0);
+    });
+    worker.join();
+
+    const std::string json = export_trace();
+    CHECK(json.rfind("{\"traceEvents\":[", 0) == 0);
+    CHECK(json.find("\"displayTimeUnit\":\"ns\"}") != std::string::npos);
+    CHECK(occurrences(json, "\"name\":\"outer\"") == 2);
+    CHECK(occurrences(json, "\"name\":\"traced_work\"") == 2 * 3 + 2 * 10);
+    CHECK(occurrences(json, "\"ph\":\"B\"") == occurrences(json, "\"ph\":\"E\""));
+    CHECK(occurrences(json, "\"ph\":\"i\",\"s\":\"t\"") == 1);
+    CHECK(json.find("\"args\":{\"name\":\"main \\u0022thread\\u0022\"}") != std::string::npos);
+    CHECK(json.find("\"args\":{\"name\":\"worker\"}") != std::string::npos);
+
+    extl::trace::clear();
+    const std::string cleared = export_trace();
+    CHECK(cleared.find("\"ph\":\"B\"") == std::string::npos);
+}
+
+TEST_CASE("trace keeps the most recent events and can be switched off") {
+    extl::trace::clear();
+    extl::trace::set_enabled(false);
+    CHECK_FALSE(extl::trace::enabled());
+    traced_work(3);
+    CHECK(occurrences(export_trace(), "traced_work") == 0);
+
+    extl::trace::set_enabled(true);
+    {
+        // The ring overwrites this begin; its end must not appear unmatched.
+        EXTL_TRACE_SCOPE("evicted");
+        for (std::size_t i = 0; i < extl::trace::detail::buffer_events; ++i)
+            EXTL_TRACE_INSTANT("tick");
+    }
+    const std::string json = export_trace();
+    CHECK(occurrences(json, "\"name\":\"evicted\"") == 0);
+    // The oldest slot counts as being overwritten, since the owner may be writing it.
+    CHECK(occurrences(json, "\"name\":\"tick\"") == extl::trace::detail::buffer_events - 2);
+    extl::trace::clear();
+}
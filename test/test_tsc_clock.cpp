@@ -0,0 +1,56 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "extl/tsc_clock.hpp"
+
+static_assert(std::chrono::is_clock_v<extl::tsc_clock>);
+
+TEST_CASE("tsc_clock is monotonic and tracks the monotonic clock") {
+    using namespace std::chrono_literals;
+    if (extl::tsc_clock::uses_counter()) {
+        CHECK(extl::tsc_clock::invariant_tsc());
+        CHECK(extl::tsc_clock::ticks_per_second() > 1e6);
+    }
+
+    auto previous = extl::tsc_clock::now();
+    bool monotonic = true;
+    for (int i = 0; i < 100000; ++i) {
+        const auto now = extl::tsc_clock::now();
+        if (now < previous)
+            monotonic = false;
+        previous = now;
+    }
+    CHECK(monotonic);
+
+    // Both clocks measure the same sleep; the tolerance covers the reads around it, not the rate.
+    const auto steady_begin = std::chrono::steady_clock::now();
+    const auto tsc_begin = extl::tsc_clock::now();
+    const std::uint64_t ticks_begin = extl::tsc_clock::ticks_begin();
+    std::this_thread::sleep_for(20ms);
+    const std::uint64_t ticks_end = extl::tsc_clock::ticks_end();
+    const auto tsc_end = extl::tsc_clock::now();
+    const auto steady_end = std::chrono::steady_clock::now();
+
+    const auto steady_elapsed = steady_end - steady_begin;
+    const auto tsc_elapsed = tsc_end - tsc_begin;
+    CHECK(tsc_elapsed >= 20ms);
+    CHECK(tsc_elapsed <= steady_elapsed + 1ms);
+    CHECK(tsc_elapsed >= steady_elapsed - 1ms);
+
+    CHECK(ticks_end > ticks_begin);
+    const auto converted = extl::tsc_clock::to_duration(ticks_end - ticks_begin);
+    CHECK(converted >= 19ms);
+    CHECK(converted <= steady_elapsed + 1ms);
+
+#if defined(__linux__)
+    // steady_clock is CLOCK_MONOTONIC on Linux, so the two share an epoch.
+    const auto before = std::chrono::steady_clock::now().time_since_epoch();
+    const auto reading = extl::tsc_clock::now().time_since_epoch();
+    const auto after = std::chrono::steady_clock::now().time_since_epoch();
+    CHECK(reading >= before - 1ms);
+    CHECK(reading <= after + 1ms);
+#endif
+}